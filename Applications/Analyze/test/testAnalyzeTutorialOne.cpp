@@ -24,15 +24,56 @@
 // INCLUDE
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Tools/AnalyzeTool.h>
+#include <OpenSim/Common/ResultCache.h>
+#include <OpenSim/Analyses/MuscleAnalysis.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
 using namespace std;
 
+// The muscle equilibria kept by a first run are reused by a run whose
+// analyses differ, but not by one whose states differ, and the fiber lengths
+// match the standard either way.
+void testResultCache()
+{
+    const string cacheDir = "testAnalyze_result_cache";
+    ResultCache::clear(cacheDir);
+    const int numFrames = Storage("plotterGeneratedStates.sto").getSize();
+    Storage standardFiberLength("std_BothLegs_fiberLength.sto");
+
+    for (int i = 0; i < 2; ++i) {
+        AnalyzeTool analyze("PlotterTool.xml");
+        analyze.updResultCacheSettings().setDirectory(cacheDir);
+        analyze.setName("BothLegsCached" + string(i == 0 ? "" : "Moments"));
+        // Change one analysis setting on the second run.
+        MuscleAnalysis& muscleAnalysis = dynamic_cast<MuscleAnalysis&>(
+            analyze.getModel().updAnalysisSet().get(0));
+        muscleAnalysis.setComputeMoments(i == 1);
+        analyze.run();
+        ASSERT(analyze.getNumResultCacheHits() == (i == 0 ? 0 : numFrames),
+               __FILE__, __LINE__, "testResultCache: wrong number of frames reused");
+        Storage resultFiberLength("testPlotterTool/" + analyze.getName() + "__FiberLength.sto");
+        CHECK_STORAGE_AGAINST_STANDARD(resultFiberLength, standardFiberLength, Array<double>(0.0001, 100), __FILE__, __LINE__, "testResultCache failed");
+    }
+
+    AnalyzeTool analyze("PlotterTool.xml");
+    analyze.updResultCacheSettings().setDirectory(cacheDir);
+    analyze.setStatesFileName("plotterGeneratedStatesHip45.sto");
+    analyze.setName("BothLegsHip45Cached");
+    analyze.run();
+    ASSERT(analyze.getNumResultCacheHits() == 0,
+           __FILE__, __LINE__, "testResultCache: reused equilibria of other states");
+    Storage resultFiberLength("testPlotterTool/BothLegsHip45Cached__FiberLength.sto");
+    Storage standardFiberLength45("std_BothLegsHip45__FiberLength.sto");
+    CHECK_STORAGE_AGAINST_STANDARD(resultFiberLength, standardFiberLength45, Array<double>(0.0001, 100), __FILE__, __LINE__, "testResultCache at Hip45 failed");
+    cout << "testResultCache passed" << endl;
+}
+
 int main()
 {
     try {
         AnalyzeTool analyze1("PlotterTool.xml");
+        analyze1.updResultCacheSettings().setUse(false);
         analyze1.getModel().print("testAnalyzeTutorialOne.osim");
         analyze1.run();
         /* Once this runs to completion we'll make the test more meaningful by comparing output 
@@ -50,6 +91,8 @@ int main()
         Storage standardFiberLength45("std_BothLegsHip45__FiberLength.sto");
         CHECK_STORAGE_AGAINST_STANDARD(resultFiberLengthHip45, standardFiberLength45, Array<double>(0.0001, 100), __FILE__, __LINE__, "testAnalyzeTutorialOne at Hip45 failed");        
         cout << "testAnalyzeTutorialOne passed" << endl;
+
+        testResultCache();
     }
     catch (const exception& e) {
         cout << "testAnalyzeTutorialOne Failed: " << e.what() << endl;
@@ -50,6 +50,7 @@ int main()
         testDoublePendulum();
 
         AnalyzeTool analyze("subject02_Setup_IAA_02_232.xml");
+        analyze.updResultCacheSettings().setUse(false);
         analyze.run();
         Storage result1("ResultsInducedAccelerations/subject02_running_arms_InducedAccelerations_center_of_mass.sto"), standard1("std_subject02_running_arms_InducedAccelerations_CENTER_OF_MASS.sto");
         CHECK_STORAGE_AGAINST_STANDARD(result1, standard1, Array<double>(0.15, result1.getSmallestNumberOfStates()), __FILE__, __LINE__, "Induced Accelerations of Running failed");
@@ -158,6 +159,7 @@ void testDoublePendulum()
 {
     std::clock_t startTime = std::clock();
     AnalyzeTool analyze("double_pendulum_Setup_IAA.xml");
+    analyze.updResultCacheSettings().setUse(false);
     analyze.run();
     Storage statesStore("double_pendulum_states.sto");
     Array<double> time;
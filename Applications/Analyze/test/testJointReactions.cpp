@@ -28,20 +28,27 @@
 using namespace OpenSim;
 using namespace std;
 
+void testForcesFile();
+
 int main()
 {
     try {
         AnalyzeTool analyze("SinglePin_Setup_JointReaction.xml");
+        analyze.updResultCacheSettings().setUse(false);
         analyze.run();
         Storage result1("SinglePin_JointReaction_ReactionLoads.sto"), standard1("std_SinglePin_JointReaction_ReactionLoads.sto");
         CHECK_STORAGE_AGAINST_STANDARD(result1, standard1, Array<double>(1e-5, 24), __FILE__, __LINE__, "SinglePin failed");
         cout << "SinglePin passed" << endl;
 
         AnalyzeTool analyze2("DoublePendulum3D_Setup_JointReaction.xml");
+        analyze2.updResultCacheSettings().setUse(false);
         analyze2.run();
         Storage result2("DoublePendulum3D_JointReaction_ReactionLoads.sto"), standard2("std_DoublePendulum3D_JointReaction_ReactionLoads.sto");
         CHECK_STORAGE_AGAINST_STANDARD(result2, standard2, Array<double>(1e-5, 24), __FILE__, __LINE__, "DoublePendulum3D failed");
         cout << "DoublePendulum3D passed" << endl;
+
+        testForcesFile();
+        cout << "Forces file passed" << endl;
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -50,3 +57,83 @@ int main()
     cout << "Done" << endl;
     return 0;
 }
+
+// Write a forces file giving every actuator of the model the same force.
+void writeForcesFile(const Model& model, double force, const string& fileName)
+{
+    Storage forces;
+    Array<string> labels;
+    labels.append("time");
+    const Set<Actuator>& actuators = model.getActuators();
+    for (int i = 0; i < actuators.getSize(); ++i)
+        labels.append(actuators[i].getName());
+    forces.setColumnLabels(labels);
+    Array<double> row(force, actuators.getSize());
+    forces.append(0.0, row.getSize(), &row[0]);
+    forces.append(1.0, row.getSize(), &row[0]);
+    forces.print(fileName);
+}
+
+// Run a JointReaction analysis of all joints of arm26 over its inverse
+// kinematics, and return its reaction loads.
+Storage runJointReaction(const string& name, const string& modelFile,
+                         const string& forcesFile)
+{
+    AnalyzeTool setup;
+    setup.setName(name);
+    setup.setModelFilename(modelFile);
+    setup.setCoordinatesFileName("arm26_InverseKinematics.mot");
+    setup.setLowpassCutoffFrequency(6.0);
+    setup.setInitialTime(0.5);
+    setup.setFinalTime(1.0);
+    JointReaction* reaction = new JointReaction();
+    reaction->setName("JointReaction");
+    reaction->setForcesFileName(forcesFile);
+    setup.getAnalysisSet().adoptAndAppend(reaction);
+    setup.setResultsDir("Results_ForcesFile");
+    setup.updResultCacheSettings().setUse(false);
+    setup.print(name + "_Setup_JointReaction.xml");
+
+    AnalyzeTool analyze(name + "_Setup_JointReaction.xml");
+    analyze.run();
+    return Storage("Results_ForcesFile/" + name +
+                   "_JointReaction_ReactionLoads.sto");
+}
+
+// The reactions computed with the actuator forces of a forces file must be
+// those of the model applying exactly those forces: with zero forces, those
+// of the model with its muscles disabled.
+void testForcesFile()
+{
+    Model model("arm26.osim");
+    model.initSystem();
+    writeForcesFile(model, 0.0, "arm26_zero_forces.sto");
+    writeForcesFile(model, 100.0, "arm26_constant_forces.sto");
+    for (int i = 0; i < model.getMuscles().getSize(); ++i)
+        model.updMuscles()[i].set_isDisabled(true);
+    model.print("arm26_disabled_muscles.osim");
+
+    Storage zero = runJointReaction("arm26_zero_forces", "arm26.osim",
+                                    "arm26_zero_forces.sto");
+    Storage disabled = runJointReaction("arm26_disabled_muscles",
+                                        "arm26_disabled_muscles.osim", "");
+    const int numColumns = disabled.getColumnLabels().getSize() - 1;
+    ASSERT(numColumns > 0);
+    CHECK_STORAGE_AGAINST_STANDARD(zero, disabled,
+        Array<double>(1e-8, numColumns), __FILE__, __LINE__,
+        "Zero forces from a file differ from disabled muscles.");
+
+    // Other forces in the file give other reactions.
+    Storage constant = runJointReaction("arm26_constant_forces",
+                                        "arm26.osim",
+                                        "arm26_constant_forces.sto");
+    double difference = 0;
+    for (int i = 0; i < constant.getSize(); ++i) {
+        const Array<double>& a = constant.getStateVector(i)->getData();
+        const Array<double>& b = zero.getStateVector(i)->getData();
+        for (int j = 0; j < numColumns; ++j)
+            difference = max(difference, fabs(a[j] - b[j]));
+    }
+    ASSERT(difference > 1.0, __FILE__, __LINE__,
+        "Forces from the file did not change the reactions.");
+}
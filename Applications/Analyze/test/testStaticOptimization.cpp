@@ -121,6 +121,7 @@ void testArm26(const string& muscleModelClassName, double actTol, double forceTo
     const string& muscName = muscleModelClassName;
 
     AnalyzeTool analyze1("arm26_Setup_StaticOptimization.xml");
+    analyze1.updResultCacheSettings().setUse(false);
     analyze1.setResultsDir(resultsDir);
     analyze1.run();
 
@@ -149,6 +150,7 @@ void testArm26(const string& muscleModelClassName, double actTol, double forceTo
     cout << "=============================================================\n" << endl;
 
     AnalyzeTool analyze2("arm26_bounds_Setup_StaticOptimization.xml");
+    analyze2.updResultCacheSettings().setUse(false);
     analyze2.setResultsDir(resultsDir);
     analyze2.run();
 
@@ -179,6 +181,7 @@ void testArm26(const string& muscleModelClassName, double actTol, double forceTo
 
 void testModelWithPassiveForces() {
     AnalyzeTool analyze("staticoptimization_spring_Setup.xml");
+    analyze.updResultCacheSettings().setUse(false);
     analyze.run();
     std::string resultsDir("ResultsSO_spring");
     Storage activations(resultsDir + "/walk_subject01_ankle_spring_StaticOptimization_activation.sto");
@@ -216,6 +219,7 @@ void testLapackErrorDLASD4() {
     // [1] The error was:
     //     "** On entry to DLASD4 parameter number -1 had an illegal value"
     AnalyzeTool analyze("subject01_Setup_StaticOptimization.xml");
+    analyze.updResultCacheSettings().setUse(false);
     analyze.setResultsDir("Results_subject01_StaticOptimization_LapackError");
     analyze.run();
 }
@@ -0,0 +1,173 @@
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  batch.cpp                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+// INCLUDES
+#include <string>
+#include <cstdlib>
+#include <fstream>
+#include <OpenSim/version.h>
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Tools/BatchToolRunner.h>
+#include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Tools/ScaleTool.h>
+
+using namespace std;
+using namespace OpenSim;
+
+static void PrintUsage(const char *aProgName, ostream &aOStream);
+//______________________________________________________________________________
+/**
+ * Run the trials given by many Scale, IK, ID and Analyze setup files in one
+ * process, reading each model once, and report the outcome of each trial.
+ *
+ * @return EXIT_FAILURE if any trial failed, else EXIT_SUCCESS.
+ */
+int main(int argc,char **argv)
+{
+    //----------------------
+    // Surrounding try block
+    //----------------------
+    try {
+    //----------------------
+
+    // REGISTER TYPES
+    Object::registerType(ScaleTool());
+    ScaleTool::registerTypes();
+    InverseKinematicsTool::registerTypes();
+
+    // PARSE COMMAND LINE
+    string option = "";
+    Array<string> setupFileNames;
+    int numThreads = 0;
+    if(argc<2) {
+        PrintUsage(argv[0], cout);
+        return(-1);
+    }
+    // Load libraries first
+    LoadOpenSimLibraries(argc,argv);
+
+    for(int i=1;i<argc;i++) {
+        option = argv[i];
+
+        // PRINT THE USAGE OPTIONS
+        if((option=="-help")||(option=="-h")||(option=="-Help")||(option=="-H")||
+            (option=="-usage")||(option=="-u")||(option=="-Usage")||(option=="-U")) {
+            PrintUsage(argv[0], cout);
+            return(0);
+
+        // IDENTIFY SETUP FILES, UP TO THE NEXT OPTION
+        } else if((option=="-Setup")||(option=="-S")) {
+            while(i+1<argc && argv[i+1][0]!='-') setupFileNames.append(argv[++i]);
+
+        // READ SETUP FILE NAMES, ONE PER LINE
+        } else if((option=="-SetupList")||(option=="-SL")) {
+            if(i+1>=argc) {
+                cout<<"batch: ERROR- "<<option<<" requires a file name.\n";
+                return(-1);
+            }
+            ifstream list(argv[++i]);
+            if(!list) {
+                cout<<"batch: ERROR- Could not open "<<argv[i]<<".\n";
+                return(-1);
+            }
+            string line;
+            while(getline(list,line)) {
+                IO::TrimWhitespace(line);
+                if(!line.empty() && line[0]!='#') setupFileNames.append(line);
+            }
+
+        // NUMBER OF THREADS
+        } else if((option=="-Threads")||(option=="-T")) {
+            if(i+1>=argc) {
+                cout<<"batch: ERROR- "<<option<<" requires a number of threads.\n";
+                return(-1);
+            }
+            numThreads = atoi(argv[++i]);
+
+        // LIBRARIES ARE LOADED ABOVE
+        } else if((option=="-Library")||(option=="-L")) {
+            i++;
+
+        // UNRECOGNIZED
+        } else {
+            cout << "Unrecognized option " << option << " on command line... Ignored" << endl;
+            PrintUsage(argv[0], cout);
+            return(0);
+        }
+    }
+
+    // ERROR CHECK
+    if(setupFileNames.getSize()==0) {
+        cout<<"\n\nbatch: ERROR- At least one setup file must be specified.\n";
+        PrintUsage(argv[0], cout);
+        return(-1);
+    }
+
+    //Load dlls that register Built in Actuator classes.
+    LoadOpenSimLibrary("osimActuators");
+
+    // RUN
+    BatchToolRunner runner(numThreads);
+    for(int i=0;i<setupFileNames.getSize();i++) runner.addSetupFile(setupFileNames[i]);
+    cout<<"Running "<<runner.getNumSetupFiles()<<" trials on "<<runner.getNumThreads()<<" threads.\n\n";
+    runner.run();
+
+    // REPORT
+    cout<<"\n\nBatch results:\n";
+    runner.printReport(cout);
+    // The number of failures would wrap around as an exit status.
+    const int numFailures = runner.getNumFailures();
+    if(numFailures>0) {
+        cout<<"\nbatch: "<<numFailures<<" of "<<runner.getNumSetupFiles()<<" trials failed.\n";
+        return(EXIT_FAILURE);
+    }
+    return(EXIT_SUCCESS);
+
+    //----------------------------
+    // Catch any thrown exceptions
+    //----------------------------
+    } catch(const std::exception& x) {
+        cout << "Exception in batch: " << x.what() << endl;
+        return -1;
+    }
+    //----------------------------
+}
+
+//_____________________________________________________________________________
+/**
+ * Print the usage for this application
+ */
+void PrintUsage(const char *aProgName, ostream &aOStream)
+{
+    string progName=IO::GetFileNameFromURI(aProgName);
+    aOStream<<"\n\n"<<progName<<":\n"<<GetVersionAndDate()<<"\n\n";
+    aOStream<<"Option             Argument         Action / Notes\n";
+    aOStream<<"------             --------         --------------\n";
+    aOStream<<"-Help, -H                           Print the command-line options for "<<progName<<".\n";
+    aOStream<<"-Setup, -S         SetupFileNames   Specify one or more Scale, IK, ID or Analyze xml setup files.\n";
+    aOStream<<"-SetupList, -SL    ListFileName     Specify a file listing setup files, one per line.\n";
+    aOStream<<"-Threads, -T       NumThreads       Number of trials to run at once (default: number of cores).\n";
+    aOStream<<"-Library, -L       LibraryName      Specify a library to load before running the trials.\n";
+    aOStream<<"\nScale trials run first, then IK, ID and Analyze trials. The exit code is nonzero if any trial failed.\n";
+}
@@ -30,7 +30,7 @@
 using namespace OpenSim;
 using namespace std;
 
-void testArm26();
+void testArm26(bool useWarmStart=false);
 
 int main() {
 
@@ -40,6 +40,10 @@ int main() {
     catch (const std::exception& e)
         {  cout << e.what() <<endl; failures.push_back("testArm26"); }
 
+    try {testArm26(true);}
+    catch (const std::exception& e)
+        {  cout << e.what() <<endl; failures.push_back("testArm26_WarmStart"); }
+
     // redo with the Millard2012EquilibriumMuscle 
     Object::renameType("Thelen2003Muscle", "Millard2012EquilibriumMuscle");
     
@@ -57,20 +61,58 @@ int main() {
     return 0;
 }
 
-void testArm26() {
+void testArm26(bool useWarmStart) {
     cout<<"\n******************************************************************" << endl;
     cout << "*                             testArm26                          *" << endl;
     cout << "******************************************************************\n" << endl;
     CMCTool cmc("arm26_Setup_CMC.xml");
+    string resultsDir = "Results_Arm26";
+    if(useWarmStart) {
+        resultsDir += "_WarmStart";
+        cmc.setResultsDir(resultsDir);
+        cmc.setUseWarmStart(true);
+    }
     cmc.run();
 
-    Storage results("Results_Arm26/arm26_states.sto"), temp("std_arm26_states.sto");
+    // One row of optimization statistics per control interval.
+    Storage stats(resultsDir + "/arm26_optimizationStatistics.sto");
+    ASSERT(stats.getSize() > 0, __FILE__, __LINE__,
+        "Expected optimization statistics for each interval.");
+    if(useWarmStart) {
+        // The previous interval's active set solves some intervals without
+        // optimizing, so the run evaluates the objective fewer times than
+        // the run without warm start.
+        Array<double> solved, evaluations, coldEvaluations;
+        stats.getDataColumn("solved_directly", solved);
+        stats.getDataColumn("num_objective_evaluations", evaluations);
+        Storage coldStats("Results_Arm26/arm26_optimizationStatistics.sto");
+        coldStats.getDataColumn("num_objective_evaluations", coldEvaluations);
+        int numSolved = 0;
+        double numEvaluations = 0, numColdEvaluations = 0;
+        for(int i=0; i<solved.getSize(); ++i) {
+            if(solved[i] == 1.0) ++numSolved;
+            numEvaluations += evaluations[i];
+        }
+        for(int i=0; i<coldEvaluations.getSize(); ++i)
+            numColdEvaluations += coldEvaluations[i];
+        cout << numSolved << " of " << solved.getSize()
+             << " intervals solved directly; " << numEvaluations
+             << " objective evaluations with warm start, "
+             << numColdEvaluations << " without." << endl;
+        ASSERT(numSolved > 0, __FILE__, __LINE__,
+            "Expected the warm start to solve some intervals directly.");
+        ASSERT(numEvaluations < numColdEvaluations, __FILE__, __LINE__,
+            "Expected fewer objective evaluations with the warm start.");
+    }
+
+    Storage results(resultsDir + "/arm26_states.sto"), temp("std_arm26_states.sto");
     Storage *standard = new Storage();
     cmc.getModel().formStateStorage(temp, *standard);
 
     Array<double> rms_tols(0.02, 2*2+2*6); // activations within 2%, angles within .6 degrees
     const string& muscleType = cmc.getModel().getMuscles()[0].getConcreteClassName();
     string base = "testArm26 "+ muscleType;
+    if(useWarmStart) base += " with warm start";
 
     if(muscleType != "Thelen2003Muscle"){
         rms_tols[6] = 0.05;
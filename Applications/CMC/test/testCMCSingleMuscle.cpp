@@ -31,6 +31,7 @@ using namespace OpenSim;
 using namespace std;
 
 void testSingleMuscle();
+void testCheckpointResume();
 
 int main() {
 
@@ -40,6 +41,10 @@ int main() {
     catch (const std::exception& e)
         {  cout << e.what() <<endl; failures.push_back("testSingleMuscle"); }
 
+    try {testCheckpointResume();}
+    catch (const std::exception& e)
+        {  cout << e.what() <<endl; failures.push_back("testCheckpointResume"); }
+
     // redo with the Millard2012EquilibriumMuscle 
     Object::renameType("Thelen2003Muscle", "Millard2012EquilibriumMuscle");
 
@@ -79,3 +84,47 @@ void testSingleMuscle() {
     
     cout << "\n" << base << " passed\n" << endl;
 }
+
+void testCheckpointResume() {
+    cout<<"\n******************************************************************" << endl;
+    cout << "*                       testCheckpointResume                     *" << endl;
+    cout << "******************************************************************\n" << endl;
+    // Tracks the forward results written by testSingleMuscle.
+    const double finalTime = 1.0;
+    const string uninterruptedDir = "block_hanging_from_muscle_ResultsCMC_uninterrupted";
+    const string resumedDir = "block_hanging_from_muscle_ResultsCMC_resumed";
+
+    CMCTool uninterrupted("block_hanging_from_muscle_Setup_CMC.xml");
+    uninterrupted.setResultsDir(uninterruptedDir);
+    uninterrupted.setFinalTime(finalTime);
+    ASSERT(uninterrupted.run());
+
+    // Stop a run with checkpoints part way, as if it had been interrupted,
+    // and resume it from its last checkpoint, at t = 0.5.
+    CMCTool interrupted("block_hanging_from_muscle_Setup_CMC.xml");
+    interrupted.setResultsDir(resumedDir);
+    interrupted.setFinalTime(0.57);
+    interrupted.setCheckpointInterval(0.25);
+    ASSERT(interrupted.run());
+
+    CMCTool resumed("block_hanging_from_muscle_Setup_CMC.xml");
+    resumed.setResultsDir(resumedDir);
+    resumed.setFinalTime(finalTime);
+    resumed.setResumeFromCheckpoint(true);
+    ASSERT(resumed.run());
+
+    // The controller continues from the same internal state, so the resumed
+    // run computes the same states and controls as the uninterrupted one.
+    const char* results[] = { "_states.sto", "_controls.sto" };
+    for (const char* result : results) {
+        Storage expected(uninterruptedDir + "/block_hanging_from_muscle" + result);
+        Storage actual(resumedDir + "/block_hanging_from_muscle" + result);
+        ASSERT(actual.getSize() == expected.getSize(), __FILE__, __LINE__,
+            string("Resumed CMC has other rows in ") + result);
+        CHECK_STORAGE_AGAINST_STANDARD(actual, expected,
+            Array<double>(1e-12, expected.getColumnLabels().getSize()-1),
+            __FILE__, __LINE__, string("Resumed CMC differs in ") + result);
+    }
+
+    cout << "\ntestCheckpointResume passed\n" << endl;
+}
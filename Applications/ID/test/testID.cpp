@@ -23,11 +23,13 @@
 // INCLUDE
 #include <string>
 #include <iostream>
+#include <fstream>
 #include <OpenSim/version.h>
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/ForceSet.h>
 #include <OpenSim/Tools/InverseDynamicsTool.h>
+#include <OpenSim/Common/ResultCache.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -37,12 +39,31 @@ int main()
 {
     try {
         InverseDynamicsTool id1("arm26_Setup_InverseDynamics.xml");
+        id1.updResultCacheSettings().setUse(false);
         id1.run();
         Storage result1("Results/arm26_InverseDynamics.sto"), standard1("std_arm26_InverseDynamics.sto");
         CHECK_STORAGE_AGAINST_STANDARD( result1, standard1, Array<double>(1e-2, 23), __FILE__, __LINE__, "testArm failed");
         cout << "testArm passed" << endl;
 
+        // The first run with the result cache keeps the generalized forces
+        // of all frames and the second reuses them; both must match the
+        // results computed without the cache.
+        ResultCache::clear("testID_result_cache");
+        for (int i = 0; i < 2; ++i) {
+            InverseDynamicsTool id3("arm26_Setup_InverseDynamics.xml");
+            id3.updResultCacheSettings().setDirectory("testID_result_cache");
+            id3.setOutputGenForceFileName("arm26_InverseDynamics_cached.sto");
+            id3.run();
+            Storage result3("Results/arm26_InverseDynamics_cached.sto");
+            CHECK_STORAGE_AGAINST_STANDARD(result3, result1, Array<double>(1e-8, 23), __FILE__, __LINE__, "testArmResultCache failed");
+            ASSERT(id3.getNumResultCacheHits() == (i == 0 ? 0 : result1.getSize()),
+                   __FILE__, __LINE__, "testArmResultCache: wrong number of frames reused");
+        }
+        ASSERT(ifstream("testID_result_cache/index.txt").good());
+        cout << "testArmResultCache passed" << endl;
+
         InverseDynamicsTool id2("subject01_Setup_InverseDynamics.xml");
+        id2.updResultCacheSettings().setUse(false);
         id2.run();
         Storage result2("Results/subject01_InverseDynamics.sto"), standard2("std_subject01_InverseDynamics.sto");
         CHECK_STORAGE_AGAINST_STANDARD(result2, standard2, Array<double>(2.0, 23), __FILE__, __LINE__, "testGait failed");
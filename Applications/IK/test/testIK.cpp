@@ -24,10 +24,12 @@
 
 // INCLUDES
 #include <string>
+#include <fstream>
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Common/ScaleSet.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Common/ResultCache.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -38,12 +40,14 @@ int main()
     try {
 
         InverseKinematicsTool ik1("subject01_Setup_InverseKinematics.xml");
+        ik1.updResultCacheSettings().setUse(false);
         ik1.run();
         Storage result1(ik1.getOutputMotionFileName()), standard("std_subject01_walk1_ik.mot");
         CHECK_STORAGE_AGAINST_STANDARD(result1, standard, Array<double>(0.2, 24), __FILE__, __LINE__, "testInverseKinematicsGait2354 failed");
         cout << "testInverseKinematicsGait2354 passed" << endl;
 
         InverseKinematicsTool ik2("subject01_Setup_InverseKinematics_NoModel.xml");
+        ik2.updResultCacheSettings().setUse(false);
         Model mdl("subject01_simbody.osim");
         mdl.initSystem();
         ik2.setModel(mdl);
@@ -53,8 +57,27 @@ int main()
         cout << "testInverseKinematicsGait2354 GUI workflow passed" << endl;
 
         InverseKinematicsTool ik3("constraintTest_setup_ik.xml");
+        ik3.updResultCacheSettings().setUse(false);
         ik3.run();
         cout << "testInverseKinematicsCosntraintTest passed" << endl;
+
+        // The first run with the result cache keeps the solutions of all
+        // frames and the second reuses them; both must match the results
+        // computed without the cache.
+        Storage result3(ik3.getOutputMotionFileName());
+        ResultCache::clear("testIK_result_cache");
+        for (int i = 0; i < 2; ++i) {
+            InverseKinematicsTool ik4("constraintTest_setup_ik.xml");
+            ik4.updResultCacheSettings().setDirectory("testIK_result_cache");
+            ik4.setOutputMotionFileName("constraintTest_ik_cached.mot");
+            ik4.run();
+            Storage result4(ik4.getOutputMotionFileName());
+            CHECK_STORAGE_AGAINST_STANDARD(result4, result3, Array<double>(1e-8, 24), __FILE__, __LINE__, "testInverseKinematicsResultCache failed");
+            ASSERT(ik4.getNumResultCacheHits() == (i == 0 ? 0 : result3.getSize()),
+                   __FILE__, __LINE__, "testInverseKinematicsResultCache: wrong number of frames reused");
+        }
+        ASSERT(ifstream("testIK_result_cache/index.txt").good());
+        cout << "testInverseKinematicsResultCache passed" << endl;
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -16,6 +16,7 @@ own project.
 %{
 #define SWIG_FILE_WITH_INIT
 #include <Bindings/OpenSimHeaders.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
 %}
 %{
 using namespace OpenSim;
@@ -307,7 +308,63 @@ EXPOSE_JOINT_CONSTRUCTORS_HELPER(PlanarJoint);
 }
 */
 
-// %include "numpy.i"
+// NumPy
+// =====
+// NumPy arrays are used to pass bulk numerical data in and out of OpenSim
+// without a Python call per element. See the asNumPy() methods below.
+%include "numpy.i"
+%init %{
+    import_array();
+%}
+%apply (double* IN_ARRAY1, int DIM1) {(double* values, int size)};
+%apply (double* IN_ARRAY1, int DIM1) {(double* times, int numTimes)};
+%apply (double* IN_ARRAY2, int DIM1, int DIM2)
+        {(double* values, int nrow, int ncol)};
+
+%{
+// Create a NumPy array that refers to nd-dimensional data owned by the
+// Python object owner, without copying the data. Strides are in elements.
+// The array keeps owner alive; it is read-only unless writeable is true.
+static PyObject* createNumPyView(PyObject* owner, double* data, int nd,
+        const npy_intp* dims, const npy_intp* strides, bool writeable) {
+    if (!data) return PyArray_SimpleNew(nd, const_cast<npy_intp*>(dims),
+                                        NPY_DOUBLE);
+    npy_intp byteStrides[2];
+    for (int i = 0; i < nd; ++i)
+        byteStrides[i] = strides[i] * (npy_intp)sizeof(double);
+    int flags = NPY_ARRAY_ALIGNED | (writeable ? NPY_ARRAY_WRITEABLE : 0);
+    PyObject* array = PyArray_New(&PyArray_Type, nd,
+            const_cast<npy_intp*>(dims), NPY_DOUBLE, byteStrides, data,
+            0, flags, NULL);
+    if (!array) return NULL;
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject((PyArrayObject*)array, owner) < 0) {
+        Py_DECREF(array);
+        return NULL;
+    }
+    return array;
+}
+
+// View a SimTK matrix, whose elements may be stored by columns or by rows,
+// as a 2-dimensional NumPy array.
+static PyObject* createNumPyView(PyObject* owner,
+        const SimTK::MatrixBase<double>& m, bool writeable) {
+    const int nrow = m.nrow(), ncol = m.ncol();
+    npy_intp dims[2] = {nrow, ncol};
+    if (nrow == 0 || ncol == 0)
+        return PyArray_SimpleNew(2, dims, NPY_DOUBLE);
+    const double* first = &m(0, 0);
+    npy_intp strides[2] = {nrow > 1 ? &m(1, 0) - first : ncol,
+                           ncol > 1 ? &m(0, 1) - first : 1};
+    if (&m(nrow-1, ncol-1) != first + (nrow-1)*strides[0]
+                                    + (ncol-1)*strides[1])
+        throw OpenSim::Exception("The matrix is not stored with regular "
+                "strides and cannot be viewed as a NumPy array; copy it "
+                "first.", __FILE__, __LINE__);
+    return createNumPyView(owner, const_cast<double*>(first), 2, dims,
+                           strides, writeable);
+}
+%}
 
 // Pythonic operators
 // ==================
@@ -403,6 +460,212 @@ EXPOSE_JOINT_CONSTRUCTORS_HELPER(PlanarJoint);
     }
 };
 
+// NumPy views and conversions
+// ===========================
+// The asNumPy() methods return NumPy arrays that refer to OpenSim's memory
+// rather than copies of it, so that large results can be post-processed
+// without a Python call per element. A view keeps its owner alive, but is
+// invalidated by anything that reallocates the owner's storage (resizing a
+// Vector, appending to an Array or a table). The proxy objects do not tell
+// whether they wrap a const reference, so views are read-only unless
+// writeable=True is passed; only ask for a writeable view of an object that
+// may be modified. The toNumPy() methods return
+// copies, and the createFromNumPy() and *FromNumPy() methods copy NumPy
+// arrays into OpenSim in one call.
+%extend SimTK::Vector_<double> {
+    PyObject* _asNumPy(PyObject* owner, bool writeable) {
+        const int size = $self->size();
+        npy_intp dims[1] = {size};
+        npy_intp strides[1] = {size > 1 ? &(*$self)[1] - &(*$self)[0] : 1};
+        return createNumPyView(owner, size > 0 ? &(*$self)[0] : NULL, 1,
+                               dims, strides, writeable);
+    }
+    static SimTK::Vector_<double> createFromNumPy(double* values, int size) {
+        return SimTK::Vector_<double>(size, values);
+    }
+%pythoncode %{
+    def asNumPy(self, writeable=False):
+        """A 1-dimensional NumPy array that refers to the elements of this
+        Vector without copying them. It is read-only unless writeable is
+        True."""
+        return self._asNumPy(self, writeable)
+
+    def toNumPy(self):
+        """A 1-dimensional NumPy array holding a copy of this Vector."""
+        return self._asNumPy(self, False).copy()
+%}
+};
+
+%extend SimTK::Matrix_<double> {
+    PyObject* _asNumPy(PyObject* owner, bool writeable) {
+        return createNumPyView(owner, *$self, writeable);
+    }
+    static SimTK::Matrix_<double> createFromNumPy(double* values,
+                                                 int nrow, int ncol) {
+        SimTK::Matrix_<double> m(nrow, ncol);
+        for (int i = 0; i < nrow; ++i)
+            for (int j = 0; j < ncol; ++j)
+                m(i, j) = values[i*ncol + j];
+        return m;
+    }
+%pythoncode %{
+    def asNumPy(self, writeable=False):
+        """A 2-dimensional NumPy array that refers to the elements of this
+        Matrix without copying them. SimTK stores matrices by columns, so
+        the array is in Fortran order. It is read-only unless writeable is
+        True."""
+        return self._asNumPy(self, writeable)
+
+    def toNumPy(self):
+        """A 2-dimensional NumPy array holding a copy of this Matrix."""
+        return self._asNumPy(self, False).copy()
+%}
+};
+
+%extend OpenSim::Array<double> {
+    PyObject* _asNumPy(PyObject* owner, bool writeable) {
+        npy_intp dims[1] = {$self->getSize()};
+        npy_intp strides[1] = {1};
+        return createNumPyView(owner, $self->get(), 1, dims, strides,
+                               writeable);
+    }
+%pythoncode %{
+    def asNumPy(self, writeable=False):
+        """A NumPy array that refers to the elements of this Array without
+        copying them. It is read-only unless writeable is True. Appending to
+        the Array may invalidate the view."""
+        return self._asNumPy(self, writeable)
+%}
+};
+
+// Each row of a Storage is a separate StateVector, so a column of a Storage
+// is not contiguous in memory: rows can be viewed, columns are copied.
+%extend OpenSim::Storage {
+    PyObject* _getRowAsNumPy(PyObject* owner, int index, bool writeable) {
+        SimTK_INDEXCHECK_ALWAYS(index, $self->getSize(),
+                                "Storage.getRowAsNumPy()");
+        OpenSim::Array<double>& data = $self->getStateVector(index)->getData();
+        npy_intp dims[1] = {data.getSize()};
+        npy_intp strides[1] = {1};
+        return createNumPyView(owner, data.get(), 1, dims, strides,
+                               writeable);
+    }
+    PyObject* getTimeAsNumPy() const {
+        npy_intp dims[1] = {$self->getSize()};
+        PyObject* array = PyArray_SimpleNew(1, dims, NPY_DOUBLE);
+        if (!array) return NULL;
+        double* out = (double*)PyArray_DATA((PyArrayObject*)array);
+        for (int i = 0; i < $self->getSize(); ++i)
+            out[i] = $self->getStateVector(i)->getTime();
+        return array;
+    }
+    PyObject* getDataAsNumPy() const {
+        int ncol = 0;
+        for (int i = 0; i < $self->getSize(); ++i)
+            ncol = std::max(ncol, $self->getStateVector(i)->getSize());
+        npy_intp dims[2] = {$self->getSize(), ncol};
+        PyObject* array = PyArray_SimpleNew(2, dims, NPY_DOUBLE);
+        if (!array) return NULL;
+        double* out = (double*)PyArray_DATA((PyArrayObject*)array);
+        for (int i = 0; i < $self->getSize(); ++i) {
+            const OpenSim::Array<double>& row =
+                    $self->getStateVector(i)->getData();
+            for (int j = 0; j < ncol; ++j)
+                out[i*ncol + j] = j < row.getSize() ? row[j] : SimTK::NaN;
+        }
+        return array;
+    }
+    PyObject* getDataColumnAsNumPy(int index) const {
+        SimTK_APIARGCHECK_ALWAYS(index >= 0, "Storage",
+                "getDataColumnAsNumPy", "index must be non-negative.");
+        npy_intp dims[1] = {$self->getSize()};
+        PyObject* array = PyArray_SimpleNew(1, dims, NPY_DOUBLE);
+        if (!array) return NULL;
+        double* out = (double*)PyArray_DATA((PyArrayObject*)array);
+        for (int i = 0; i < $self->getSize(); ++i) {
+            const OpenSim::Array<double>& row =
+                    $self->getStateVector(i)->getData();
+            out[i] = index < row.getSize() ? row[index] : SimTK::NaN;
+        }
+        return array;
+    }
+    void setDataColumnFromNumPy(int index, double* values, int size) {
+        if (size != $self->getSize())
+            throw OpenSim::Exception("Storage.setDataColumnFromNumPy: "
+                    "expected " + std::to_string($self->getSize()) +
+                    " values but received " + std::to_string(size) + ".",
+                    __FILE__, __LINE__);
+        for (int i = 0; i < size; ++i)
+            SimTK_INDEXCHECK_ALWAYS(index, $self->getStateVector(i)->getSize(),
+                                    "Storage.setDataColumnFromNumPy()");
+        for (int i = 0; i < size; ++i)
+            $self->getStateVector(i)->getData()[index] = values[i];
+    }
+    void appendFromNumPy(double* times, int numTimes,
+                         double* values, int nrow, int ncol) {
+        if (numTimes != nrow)
+            throw OpenSim::Exception("Storage.appendFromNumPy: received " +
+                    std::to_string(numTimes) + " times but " +
+                    std::to_string(nrow) + " rows.", __FILE__, __LINE__);
+        for (int i = 0; i < nrow; ++i)
+            $self->append(times[i], ncol, values + i*ncol);
+    }
+%pythoncode %{
+    def getRowAsNumPy(self, index, writeable=False):
+        """A NumPy array that refers to the values of row index of this
+        Storage without copying them. It is read-only unless writeable is
+        True."""
+        return self._getRowAsNumPy(self, index, writeable)
+%}
+};
+
+// Tables
+// ======
+%ignore OpenSim::AbstractDataTable::clone;
+%ignore OpenSim::DataTable_::clone;
+%ignore OpenSim::DataTable_::getMatrix;
+%ignore OpenSim::DataTable_::updMatrix;
+
+%extend OpenSim::DataTable_<double, double> {
+    PyObject* _getMatrixAsNumPy(PyObject* owner, bool writeable) {
+        return createNumPyView(owner, $self->updMatrix(), writeable);
+    }
+    PyObject* _getIndependentColumnAsNumPy(PyObject* owner) {
+        const std::vector<double>& column = $self->getIndependentColumn();
+        npy_intp dims[1] = {(npy_intp)column.size()};
+        npy_intp strides[1] = {1};
+        return createNumPyView(owner,
+                const_cast<double*>(column.data()), 1, dims, strides, false);
+    }
+    void appendRowsFromNumPy(double* times, int numTimes,
+                             double* values, int nrow, int ncol) {
+        SimTK::Matrix_<double> rows(nrow, ncol);
+        for (int i = 0; i < nrow; ++i)
+            for (int j = 0; j < ncol; ++j)
+                rows(i, j) = values[i*ncol + j];
+        $self->appendRows(std::vector<double>(times, times + numTimes),
+                          rows);
+    }
+%pythoncode %{
+    def getMatrixAsNumPy(self, writeable=False):
+        """A 2-dimensional NumPy array, one row per row of this table, that
+        refers to the dependent columns without copying them. It is
+        read-only unless writeable is True. The view is invalidated by
+        appending rows."""
+        return self._getMatrixAsNumPy(self, writeable)
+
+    def getIndependentColumnAsNumPy(self):
+        """A read-only NumPy array that refers to the independent column
+        without copying it. The view is invalidated by appending rows."""
+        return self._getIndependentColumnAsNumPy(self)
+%}
+};
+
+%include <OpenSim/Common/DataTable.h>
+%template(DataTable) OpenSim::DataTable_<double, double>;
+%include <OpenSim/Common/TimeSeriesTable.h>
+%template(TimeSeriesTable) OpenSim::TimeSeriesTable_<double>;
+
 // Memory management
 // =================
 
@@ -0,0 +1,142 @@
+"""The tests here ensure that NumPy arrays obtained from OpenSim refer to
+OpenSim's memory without copying it, and compare the time taken to read
+numerical data element by element with the time taken through NumPy.
+
+"""
+from __future__ import print_function
+
+import timeit
+import unittest
+
+import numpy as np
+
+import opensim as osim
+
+class TestNumPyViews(unittest.TestCase):
+    def test_vector(self):
+        v = osim.Vector(5, 1.5)
+        a = v.asNumPy(writeable=True)
+        self.assertEqual(a.shape, (5,))
+        assert np.all(a == 1.5)
+
+        # Writes through the view and through the Vector are shared.
+        a[2] = -3
+        self.assertEqual(v.get(2), -3)
+        v.set(4, 7)
+        self.assertEqual(a[4], 7)
+
+        # Views are read-only by default, and a copy is independent.
+        r = v.asNumPy()
+        self.assertRaises(ValueError, r.__setitem__, 0, 1)
+        self.assertEqual(r[4], 7)
+        c = v.toNumPy()
+        c[0] = 100
+        self.assertEqual(v.get(0), 1.5)
+
+        # The view keeps the Vector alive.
+        a = osim.Vector(3, 2.0).asNumPy()
+        assert np.all(a == 2.0)
+
+        w = osim.Vector.createFromNumPy(np.arange(4.0))
+        self.assertEqual(w.size(), 4)
+        self.assertEqual(w.get(3), 3)
+        self.assertEqual(osim.Vector().asNumPy().shape, (0,))
+
+    def test_matrix(self):
+        values = np.arange(12.0).reshape(3, 4)
+        m = osim.Matrix.createFromNumPy(values)
+        self.assertEqual(m.nrow(), 3)
+        self.assertEqual(m.ncol(), 4)
+        self.assertRaises(ValueError, m.asNumPy().__setitem__, (0, 0), 1)
+        a = m.asNumPy(writeable=True)
+        assert np.all(a == values)
+        a[1, 2] = -1
+        self.assertEqual(m.get(1, 2), -1)
+        assert np.all(m.toNumPy() == a)
+
+    def test_array(self):
+        arr = osim.ArrayDouble()
+        for i in range(4):
+            arr.append(i)
+        self.assertRaises(ValueError, arr.asNumPy().__setitem__, 0, 1)
+        a = arr.asNumPy(writeable=True)
+        assert np.all(a == np.arange(4.0))
+        a[0] = 10
+        self.assertEqual(arr.get(0), 10)
+
+    def test_storage(self):
+        sto = osim.Storage()
+        times = np.linspace(0, 1, 11)
+        data = np.random.rand(11, 3)
+        sto.appendFromNumPy(times, data)
+        self.assertEqual(sto.getSize(), 11)
+        assert np.all(sto.getTimeAsNumPy() == times)
+        assert np.all(sto.getDataAsNumPy() == data)
+        assert np.all(sto.getDataColumnAsNumPy(1) == data[:, 1])
+
+        # Rows are views; columns are copied in and out.
+        self.assertRaises(ValueError, sto.getRowAsNumPy(4).__setitem__, 2, 1)
+        row = sto.getRowAsNumPy(4, writeable=True)
+        row[2] = -5
+        self.assertEqual(sto.getDataAsNumPy()[4, 2], -5)
+        sto.setDataColumnFromNumPy(0, np.zeros(11))
+        assert np.all(sto.getDataColumnAsNumPy(0) == 0)
+        self.assertRaises(RuntimeError, sto.setDataColumnFromNumPy, 0,
+                          np.zeros(3))
+
+    def test_table(self):
+        table = osim.TimeSeriesTable()
+        times = np.linspace(0, 1, 11)
+        data = np.random.rand(11, 3)
+        table.appendRowsFromNumPy(times, data)
+        self.assertEqual(table.getNumRows(), 11)
+        self.assertEqual(table.getNumColumns(), 3)
+
+        self.assertRaises(ValueError,
+                          table.getMatrixAsNumPy().__setitem__, (3, 1), 0)
+        m = table.getMatrixAsNumPy(writeable=True)
+        assert np.all(m == data)
+        m[3, 1] = -2
+        assert table.getMatrixAsNumPy()[3, 1] == -2
+
+        t = table.getIndependentColumnAsNumPy()
+        assert np.all(t == times)
+        self.assertRaises(ValueError, t.__setitem__, 0, 5)
+
+    def test_benchmark(self):
+        """Compare reading a large Vector and a column of a large Storage
+        element by element with reading them through NumPy."""
+        num_rows = 100000
+        v = osim.Vector(num_rows, 1.0)
+        sto = osim.Storage()
+        sto.appendFromNumPy(np.arange(num_rows) * 0.001,
+                            np.ones((num_rows, 10)))
+        table = osim.TimeSeriesTable()
+        table.appendRowsFromNumPy(np.arange(num_rows) * 0.001,
+                                  np.ones((num_rows, 10)))
+
+        def vector_element_wise():
+            return sum(v.get(i) for i in range(v.size()))
+        def vector_view():
+            return v.asNumPy().sum()
+        def storage_element_wise():
+            return sum(sto.getStateVector(i).getData().get(3)
+                       for i in range(sto.getSize()))
+        def storage_bulk():
+            return sto.getDataColumnAsNumPy(3).sum()
+        def table_view():
+            return table.getMatrixAsNumPy()[:, 3].sum()
+
+        self.assertEqual(vector_element_wise(), vector_view())
+        self.assertEqual(storage_element_wise(), storage_bulk())
+        self.assertEqual(storage_bulk(), table_view())
+        methods = [('Vector, element-wise', vector_element_wise),
+                   ('Vector, NumPy view', vector_view),
+                   ('Storage, element-wise', storage_element_wise),
+                   ('Storage, NumPy copy', storage_bulk),
+                   ('table, NumPy view', table_view)]
+        timings = [(name, min(timeit.repeat(f, number=1, repeat=3)))
+                   for name, f in methods]
+        print()
+        for name, seconds in timings:
+            print('%-24s %10.6f s for %d values' % (name, seconds, num_rows))
@@ -519,19 +519,25 @@ computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const
         return;
     }
 
+    // Initialize activation and fiber length provided by the State s
+    _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+    applyFiberEquilibrium(s, solveFiberEquilibrium(s));
+}
+
+Muscle::FiberEquilibrium Millard2012EquilibriumMuscle::
+solveFiberEquilibrium(const SimTK::State& s, double initialFiberLength) const
+{
+    FiberEquilibrium equilibrium;
+    equilibrium.solved = true;
+    if(get_ignore_tendon_compliance()) {                    // rigid tendon
+        equilibrium.status = 0;
+        return equilibrium;
+    }
+
     // Elastic tendon initialization routine.
     try {
-        // Initialize activation and fiber length provided by the State s
-        _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
-
         // Compute the fiber length where the fiber and tendon are in static
         // equilibrium. Fiber and tendon velocity are set to zero.
-        int flag_status      = -1;
-        double solnErr       = SimTK::NaN;
-        int iterations       = 0;
-        double fiberLength   = SimTK::NaN;
-        double fiberVelocity = 0.0;
-        double tendonForce   = SimTK::NaN;
 
         // tol is the desired tolerance in Newtons.
         double tol = 1e-8*getMaxIsometricForce();
@@ -547,81 +553,110 @@ computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const
         SimTK::Vector soln;
         soln = estimateMuscleFiberState(activation, pathLength,
                                         pathLengtheningSpeed, tol, maxIter,
-                                        true);
-        flag_status   = (int)soln[0];
-        solnErr       = soln[1];
-        iterations    = (int)soln[2];
-        fiberLength   = soln[3];
-        fiberVelocity = soln[4];
-        tendonForce   = soln[5];
-
-        switch(flag_status) {
-            case 0: //converged
-            {
-                setActuation(s, tendonForce);
-                setFiberLength(s,fiberLength);
-
-            }break;
-
-            case 1: //lower bound on fiber length was reached
-            {
-                setActuation(s, tendonForce);
-                setFiberLength(s,fiberLength);
-                printf("\n\nMillard2012EquilibriumMuscle static solution:"
-                       "%s is at its minimum length of %f\n",
-                       getName().c_str(), getMinimumFiberLength());
-            }break;
-
-            case 2: //maximum number of iterations reached
-            {
-                setActuation(s, 0.0);
-                setFiberLength(s, get_optimal_fiber_length());
+                                        true, initialFiberLength);
+        int iterations = (int)soln[2];
+        if((int)soln[0] != 0 && !SimTK::isNaN(initialFiberLength)) {
+            // The warm start did not converge; start from the default guess.
+            soln = estimateMuscleFiberState(activation, pathLength,
+                                            pathLengtheningSpeed, tol, maxIter,
+                                            true);
+            iterations += (int)soln[2];
+        }
+        equilibrium.status      = (int)soln[0];
+        equilibrium.error       = soln[1];
+        equilibrium.iterations  = iterations;
+        equilibrium.fiberLength = soln[3];
+        equilibrium.tendonForce = soln[5];
 
-                char msgBuffer[1000];
-                int n = sprintf(msgBuffer,
-                    "WARNING: No suitable static solution found for %s by "
-                    "computeFiberEquilibriumAtZeroVelocity().\n"
-                    "Continuing with an initial fiber force of 0 and an "
-                    "initial length of %f.\n"
-                    "Here is a report from the routine:\n\n"
-                    "   Solution Error:    %f > tol (%f)\n"
-                    "   Newton Iterations: %d of max. iterations (%d)\n"
-                    "Verify that the default activation is valid and that the "
-                    "length of the musculotendon actuator\n"
-                    "doesn't produce a pennation angle of 90 degrees or a "
-                    "fiber length less than zero:\n"
-                    "   Activation:      %f\n"
-                    "   Actuator length: %f\n\n",
-                    getName().c_str(),
-                    get_optimal_fiber_length(),
-                    abs(solnErr), tol,
-                    iterations, maxIter,
-                    activation,
-                    fiberLength);
+    } catch (const std::exception& e) {
+        equilibrium.status = -1;
+        equilibrium.message = e.what();
+    }
+    return equilibrium;
+}
 
-                    cerr << msgBuffer << endl;
-            }break;
+void Millard2012EquilibriumMuscle::
+applyFiberEquilibrium(SimTK::State& s,
+                      const FiberEquilibrium& equilibrium) const
+{
+    if(get_ignore_tendon_compliance()) {                    // rigid tendon
+        return;
+    }
 
-            default:
-                printf("\n\nWARNING: invalid error flag returned from "
-                       "static solution for %s."
-                       "Setting tendon force to 0.0 and fiber length to the "
-                       "optimal fiber length.",
-                       getName().c_str());
-                setActuation(s, 0.0);
-                setFiberLength(s, get_optimal_fiber_length());
-        }
+    switch(equilibrium.status) {
+        case 0: //converged
+        {
+            setActuation(s, equilibrium.tendonForce);
+            setFiberLength(s, equilibrium.fiberLength);
+
+        }break;
+
+        case 1: //lower bound on fiber length was reached
+        {
+            setActuation(s, equilibrium.tendonForce);
+            setFiberLength(s, equilibrium.fiberLength);
+            printf("\n\nMillard2012EquilibriumMuscle static solution:"
+                   "%s is at its minimum length of %f\n",
+                   getName().c_str(), getMinimumFiberLength());
+        }break;
+
+        case 2: //maximum number of iterations reached
+        {
+            setActuation(s, 0.0);
+            setFiberLength(s, get_optimal_fiber_length());
+
+            // tol is the desired tolerance in Newtons.
+            double tol = 1e-8*getMaxIsometricForce();
+            if(tol < SimTK::SignificantReal*10) {
+                tol = SimTK::SignificantReal*10;
+            }
 
-    } catch (const std::exception& e) {
-        // If the initialization routine fails in some unexpected way, tell the
-        // user and continue with some valid initial conditions.
-        cerr << "\n\nWARNING: Millard2012EquilibriumMuscle static solution "
-                "exception caught:" << endl;
-        cerr << e.what() << endl;
-        cerr << "Continuing with initial tendon force of 0 and a fiber length "
-                "equal to the optimal fiber length.\n\n" << endl;
-        setActuation(s, 0);
-        setFiberLength(s,getOptimalFiberLength());
+            char msgBuffer[1000];
+            int n = sprintf(msgBuffer,
+                "WARNING: No suitable static solution found for %s by "
+                "computeFiberEquilibriumAtZeroVelocity().\n"
+                "Continuing with an initial fiber force of 0 and an "
+                "initial length of %f.\n"
+                "Here is a report from the routine:\n\n"
+                "   Solution Error:    %f > tol (%f)\n"
+                "   Newton Iterations: %d of max. iterations (%d)\n"
+                "Verify that the default activation is valid and that the "
+                "length of the musculotendon actuator\n"
+                "doesn't produce a pennation angle of 90 degrees or a "
+                "fiber length less than zero:\n"
+                "   Activation:      %f\n"
+                "   Actuator length: %f\n\n",
+                getName().c_str(),
+                get_optimal_fiber_length(),
+                abs(equilibrium.error), tol,
+                equilibrium.iterations, 200,
+                getActivation(s),
+                equilibrium.fiberLength);
+
+                cerr << msgBuffer << endl;
+        }break;
+
+        case -1: //exception
+        {
+            // If the initialization routine fails in some unexpected way, tell
+            // the user and continue with some valid initial conditions.
+            cerr << "\n\nWARNING: Millard2012EquilibriumMuscle static "
+                    "solution exception caught:" << endl;
+            cerr << equilibrium.message << endl;
+            cerr << "Continuing with initial tendon force of 0 and a fiber "
+                    "length equal to the optimal fiber length.\n\n" << endl;
+            setActuation(s, 0);
+            setFiberLength(s,getOptimalFiberLength());
+        }break;
+
+        default:
+            printf("\n\nWARNING: invalid error flag returned from "
+                   "static solution for %s."
+                   "Setting tendon force to 0.0 and fiber length to the "
+                   "optimal fiber length.",
+                   getName().c_str());
+            setActuation(s, 0.0);
+            setFiberLength(s, get_optimal_fiber_length());
     }
 }
 
@@ -1395,7 +1430,8 @@ estimateMuscleFiberState(double aActivation,
                          double pathLengtheningSpeed,
                          double aSolTolerance,
                          int aMaxIterations,
-                         bool staticSolution) const
+                         bool staticSolution,
+                         double initialFiberLength) const
 {
     // If seeking a static solution, set velocities to zero and avoid the
     // velocity-sharing algorithm below, as it can produce nonzero fiber and
@@ -1444,6 +1480,16 @@ estimateMuscleFiberState(double aActivation,
     double phi    = penMdl.calcPennationAngle(lce);
     double cosphi = cos(phi);
     double sinphi = sin(phi);
+
+    // Warm start: begin with the given fiber length instead, and the tendon
+    // length that is consistent with it.
+    if(!SimTK::isNaN(initialFiberLength)) {
+        lce    = clampFiberLength(initialFiberLength);
+        phi    = penMdl.calcPennationAngle(lce);
+        cosphi = cos(phi);
+        sinphi = sin(phi);
+        tl     = penMdl.calcTendonLength(cosphi,lce,ml);
+    }
     double tlN    = tl/tsl;
     double lceN   = lce/ofl;
 
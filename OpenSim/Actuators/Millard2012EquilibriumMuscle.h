@@ -406,6 +406,21 @@ public:
     void computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const 
         override;
 
+    /** Solves for the static equilibrium found by
+    computeFiberEquilibriumAtZeroVelocity() without modifying the state.
+        @param[in] s The state of the system.
+        @param[in] initialFiberLength The fiber length from which to start,
+    or NaN to use the default initial guess. */
+    FiberEquilibrium solveFiberEquilibrium(const SimTK::State& s,
+        double initialFiberLength = SimTK::NaN) const override;
+
+    /** Sets the fiber length and tendon force found by
+    solveFiberEquilibrium().
+        @param[in,out] s The state of the system.
+        @param[in] equilibrium The solution. */
+    void applyFiberEquilibrium(SimTK::State& s,
+        const FiberEquilibrium& equilibrium) const override;
+
 //==============================================================================
 // TO BE DEPRECATED
 //==============================================================================
@@ -710,13 +725,17 @@ private:
         @param aMaxIterations the maximum number of Newton steps allowed before
     we give up attempting to initialize the model and throw an exception
         @param staticSolution set to true to calculate the static equilibrium
-    solution, setting fiber and tendon velocities to zero */
+    solution, setting fiber and tendon velocities to zero
+        @param initialFiberLength the fiber length from which to start, or
+    NaN to start from a slightly stretched tendon */
     SimTK::Vector estimateMuscleFiberState(double aActivation,
                                            double pathLength,
                                            double pathLengtheningSpeed,
                                            double aSolTolerance,
                                            int aMaxIterations,
-                                           bool staticSolution=false) const;
+                                           bool staticSolution=false,
+                                           double initialFiberLength=SimTK::NaN)
+                                           const;
 
 };
 } //end of namespace OpenSim
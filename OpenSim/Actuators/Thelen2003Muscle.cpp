@@ -355,14 +355,23 @@ double  Thelen2003Muscle::computeActuation(const SimTK::State& s) const
 
 void Thelen2003Muscle::computeInitialFiberEquilibrium(SimTK::State& s) const
 {
+    //Initial activation and fiber length from input State, s.
+    _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+    applyFiberEquilibrium(s, solveFiberEquilibrium(s));
+}
+
+Muscle::FiberEquilibrium Thelen2003Muscle::
+    solveFiberEquilibrium(const SimTK::State& s,
+                          double initialFiberLength) const
+{
+    FiberEquilibrium equilibrium;
+    equilibrium.solved = true;
     try{
 
         SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
                     "Thelen2003Muscle: Muscle is not"
                     " to date with properties");
 
-        //Initial activation and fiber length from input State, s.
-        _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
         double activation = getActivation(s);
 
         //Tolerance, in Newtons, of the desired equilibrium
@@ -372,104 +381,128 @@ void Thelen2003Muscle::computeInitialFiberEquilibrium(SimTK::State& s) const
         }
         int maxIter = 200;  //Should this be user settable?
 
-    
-        SimTK::Vector soln = initMuscleState(s, activation, tol, maxIter);
-    
-        int flag_status    = (int)soln[0];
-        double solnErr        = soln[1];
-        int iterations     = (int)soln[2];
-        double fiberLength    = soln[3];
-        double passiveForce   = soln[4];
-        double tendonForce    = soln[5];
-
-
-        switch(flag_status){
-
-            case 0: //converged, all is normal
-            {
-                setActuation(s,tendonForce);
-                setFiberLength(s,fiberLength);
-            }break;
-
-            case 1: //lower fiber length bound hit
-            {
-                setActuation(s,tendonForce);
-                setFiberLength(s,fiberLength);
-            
-                std::string muscleName = getName();            
-                printf( "\n\nThelen2003Muscle Initialization Message:"
-                        " %s is at its minimum length of %f",
-                        muscleName.c_str(), get_MuscleFixedWidthPennationModel()
-                                            .getMinimumFiberLength());
-            }break;
-
-            case 2: //Maximum number of iterations exceeded.
-            {
-                setActuation(s, 0.0);
-                setFiberLength(s, get_optimal_fiber_length());
-
-                std::string muscleName = getName();
-                std::string fcnName = "\n\nWARNING: Thelen2003Muscle::"
-                                 "computeInitialFiberEquilibrium(SimTK::State& s)";
-                    char msgBuffer[1000];
-                    int n = sprintf(msgBuffer,
-                        "WARNING: No suitable initial conditions found for\n"
-                        "  %s: \n"
-                        "  by %s \n"
-                        "Continuing with an initial fiber force and "
-                            "length of 0 and %f\n"
-                        "    Here is a report from the routine:\n \n"
-                        "        Solution Error      : %f > tol (%f) \n"
-                        "        Newton Iterations   : %d of max. iterations (%d)\n"
-                        "    Check that the initial activation is valid,"
-                            " and that the whole \n"
-                        "    length doesn't produce a pennation"
-                            " angle of 90 degrees, nor a fiber\n"
-                        "    length less than 0:\n"
-                        "        Activation          : %f \n" 
-                        "        Whole muscle length : %f \n\n", 
-                        muscleName.c_str(),
-                        fcnName.c_str(), 
-                        get_optimal_fiber_length(),
-                        abs(solnErr),
-                        tol,
-                        iterations,
-                        maxIter,
-                        activation, 
-                        fiberLength);
-
-                    cerr << msgBuffer << endl;
-        
-            }break;
-
-            default:
-                std::string muscleName = getName();            
-                printf( "\n\nWARNING: Thelen2003Muscle Initialization:"
-                        " %s invalid error flag. Continuing with an initial "
-                        "tendon force of 0, and a fiber length equal to the "
-                        "optimal fiber length",
-                        muscleName.c_str());
-
-                setActuation(s, 0.0);
-                setFiberLength(s, get_optimal_fiber_length());
+        SimTK::Vector soln = initMuscleState(s, activation, tol, maxIter,
+                                             initialFiberLength);
+        int iterations = (int)soln[2];
+        if ((int)soln[0] != 0 && !SimTK::isNaN(initialFiberLength)) {
+            //The warm start did not converge; start from the default guess
+            soln = initMuscleState(s, activation, tol, maxIter);
+            iterations += (int)soln[2];
         }
- 
 
+        equilibrium.status      = (int)soln[0];
+        equilibrium.error       = soln[1];
+        equilibrium.iterations  = iterations;
+        equilibrium.fiberLength = soln[3];
+        equilibrium.tendonForce = soln[5];
 
     }catch (const std::exception& e) { 
-        //If the initialization routine fails in some unexpected way, tell
-        //the user and continue with some valid initial conditions
-        cerr    << "\n\nWARNING: Thelen2003Muscle initialization exception caught:" 
-                << endl;
-        cerr << e.what() << endl;
+        equilibrium.status = -1;
+        equilibrium.message = e.what();
+    }
+    return equilibrium;
+}
+
+void Thelen2003Muscle::applyFiberEquilibrium(SimTK::State& s,
+                                const FiberEquilibrium& equilibrium) const
+{
+    const int flag_status     = equilibrium.status;
+    const double solnErr      = equilibrium.error;
+    const int iterations      = equilibrium.iterations;
+    const double fiberLength  = equilibrium.fiberLength;
+    const double tendonForce  = equilibrium.tendonForce;
+    const double activation   = getActivation(s);
+    double tol = 1e-8*getMaxIsometricForce();
+    if(tol < SimTK::SignificantReal*10){
+        tol = SimTK::SignificantReal*10;
+    }
+    const int maxIter = 200;
+
+    switch(flag_status){
+
+        case 0: //converged, all is normal
+        {
+            setActuation(s,tendonForce);
+            setFiberLength(s,fiberLength);
+        }break;
+
+        case 1: //lower fiber length bound hit
+        {
+            setActuation(s,tendonForce);
+            setFiberLength(s,fiberLength);
         
-        cerr << "    Continuing with initial tendon force of 0 " << endl;
-        cerr << "    and a fiber length equal to the optimal fiber length ..." 
-             << endl;
+            std::string muscleName = getName();            
+            printf( "\n\nThelen2003Muscle Initialization Message:"
+                    " %s is at its minimum length of %f",
+                    muscleName.c_str(), get_MuscleFixedWidthPennationModel()
+                                        .getMinimumFiberLength());
+        }break;
+
+        case 2: //Maximum number of iterations exceeded.
+        {
+            setActuation(s, 0.0);
+            setFiberLength(s, get_optimal_fiber_length());
+
+            std::string muscleName = getName();
+            std::string fcnName = "\n\nWARNING: Thelen2003Muscle::"
+                             "computeInitialFiberEquilibrium(SimTK::State& s)";
+                char msgBuffer[1000];
+                int n = sprintf(msgBuffer,
+                    "WARNING: No suitable initial conditions found for\n"
+                    "  %s: \n"
+                    "  by %s \n"
+                    "Continuing with an initial fiber force and "
+                        "length of 0 and %f\n"
+                    "    Here is a report from the routine:\n \n"
+                    "        Solution Error      : %f > tol (%f) \n"
+                    "        Newton Iterations   : %d of max. iterations (%d)\n"
+                    "    Check that the initial activation is valid,"
+                        " and that the whole \n"
+                    "    length doesn't produce a pennation"
+                        " angle of 90 degrees, nor a fiber\n"
+                    "    length less than 0:\n"
+                    "        Activation          : %f \n" 
+                    "        Whole muscle length : %f \n\n", 
+                    muscleName.c_str(),
+                    fcnName.c_str(), 
+                    get_optimal_fiber_length(),
+                    abs(solnErr),
+                    tol,
+                    iterations,
+                    maxIter,
+                    activation, 
+                    fiberLength);
+
+                cerr << msgBuffer << endl;
+    
+        }break;
+
+        case -1: //the solver threw an exception
+        {
+            //If the initialization routine fails in some unexpected way,
+            //tell the user and continue with some valid initial conditions
+            cerr    << "\n\nWARNING: Thelen2003Muscle initialization exception caught:" 
+                    << endl;
+            cerr << equilibrium.message << endl;
 
-        setActuation(s, 0.0);
-        setFiberLength(s, get_optimal_fiber_length());
+            cerr << "    Continuing with initial tendon force of 0 " << endl;
+            cerr << "    and a fiber length equal to the optimal fiber length ..." 
+                 << endl;
+
+            setActuation(s, 0.0);
+            setFiberLength(s, get_optimal_fiber_length());
+        }break;
 
+        default:
+            std::string muscleName = getName();            
+            printf( "\n\nWARNING: Thelen2003Muscle Initialization:"
+                    " %s invalid error flag. Continuing with an initial "
+                    "tendon force of 0, and a fiber length equal to the "
+                    "optimal fiber length",
+                    muscleName.c_str());
+
+            setActuation(s, 0.0);
+            setFiberLength(s, get_optimal_fiber_length());
     }
 }
 
@@ -898,10 +931,11 @@ double Thelen2003Muscle::calcActivationRate(const SimTK::State& s) const
 // Numerical Guts: Initialization
 //==============================================================================
 SimTK::Vector Thelen2003Muscle::
-    initMuscleState(    SimTK::State& s, 
+    initMuscleState(    const SimTK::State& s, 
                         double aActivation, 
                         double aSolTolerance, 
-                        int aMaxIterations) const
+                        int aMaxIterations,
+                        double aInitialFiberLength) const
 {
     //results vector format
     //1: flag (0 = converged 
@@ -954,6 +988,18 @@ SimTK::Vector Thelen2003Muscle::
     double cosphi   = cos(phi);
     double sinphi   = sin(phi);  
 
+    //Warm start: begin with the given fiber length instead, and the tendon
+    //length that is consistent with it.
+    if(!SimTK::isNaN(aInitialFiberLength)){
+        lce = std::max(aInitialFiberLength, get_MuscleFixedWidthPennationModel()
+                                        .getMinimumFiberLength());
+        phi    = get_MuscleFixedWidthPennationModel().calcPennationAngle(lce);
+        cosphi = cos(phi);
+        sinphi = sin(phi);
+        tl     = get_MuscleFixedWidthPennationModel()
+                    .calcTendonLength(cosphi, lce, ml);
+    }
+
     //Normalized quantities
     double tlN  = tl/tsl;
     double lceN = lce/ofl;
@@ -219,6 +219,17 @@ public:
         Part of the Muscle.h interface
     */
     void computeInitialFiberEquilibrium(SimTK::State& s) const override;
+
+    /** Solve for the equilibrium found by computeInitialFiberEquilibrium()
+        without modifying the state, optionally starting from a given fiber
+        length. Part of the Muscle.h interface */
+    FiberEquilibrium solveFiberEquilibrium(const SimTK::State& s,
+        double initialFiberLength = SimTK::NaN) const override;
+
+    /** Set the fiber length and tendon force found by
+        solveFiberEquilibrium(). Part of the Muscle.h interface */
+    void applyFiberEquilibrium(SimTK::State& s,
+        const FiberEquilibrium& equilibrium) const override;
        
     ///@cond TO BE DEPRECATED. 
     /*  Once the ignore_tendon_compliance flag is implemented correctly get rid 
@@ -298,8 +309,9 @@ private:
     //=====================================================================
 
     //Initialization
-    SimTK::Vector initMuscleState(SimTK::State& s, double aActivation,
-                             double aSolTolerance, int aMaxIterations) const;
+    SimTK::Vector initMuscleState(const SimTK::State& s, double aActivation,
+                             double aSolTolerance, int aMaxIterations,
+                             double aInitialFiberLength = SimTK::NaN) const;
 
     
     double calcFm(double ma, double fal, double fv, 
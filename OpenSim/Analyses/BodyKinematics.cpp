@@ -265,6 +265,13 @@ allocateStorage()
     _pStore = new Storage(1000,"Positions");
     _pStore->setDescription(getDescription());
     _pStore->setColumnLabels(getColumnLabels());
+
+    // The storages are deleted by deleteStorage().
+    _storageList.setMemoryOwner(false);
+    _storageList.setSize(0);
+    _storageList.append(_aStore);
+    _storageList.append(_vStore);
+    _storageList.append(_pStore);
 }
 
 
@@ -281,6 +288,7 @@ deleteStorage()
     if(_aStore!=NULL) { delete _aStore;  _aStore=NULL; }
     if(_vStore!=NULL) { delete _vStore;  _vStore=NULL; }
     if(_pStore!=NULL) { delete _pStore;  _pStore=NULL; }
+    _storageList.setSize(0);
 }
 
 //_____________________________________________________________________________
@@ -315,7 +323,8 @@ updateBodiesToRecord()
             throw Exception("BodyKinematics: ERR- Could not find body named '"+_bodies[i]+"'",__FILE__,__LINE__);
         _bodyIndices.append(index);
     }
-    _kin.setSize(6*_bodyIndices.getSize()+(_recordCenterOfMass?3:0));
+    // One row each of positions, velocities and accelerations.
+    _kin.setSize(3*(6*_bodyIndices.getSize()+(_recordCenterOfMass?3:0)));
 
     if(_kin.getSize()==0) cout << "WARNING: BodyKinematics analysis has no bodies to record kinematics for" << endl;
 }
@@ -445,156 +454,83 @@ record(const SimTK::State& s)
 
     // Realize to Acceleration first since we'll ask for Accelerations 
     _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
-    // VARIABLES
-    double dirCos[3][3];
-    SimTK::Vec3 vec,angVec;
-    double Mass = 0.0;
-
-    // GROUND BODY
-    const Ground &ground = _model->getGround();
-
-    // POSITION
-    BodySet& bs = _model->updBodySet();
-
-    for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
-        // GET POSITIONS AND EULER ANGLES
-        _model->getSimbodyEngine().getPosition(s, body,com,vec);
-        _model->getSimbodyEngine().getDirectionCosines(s, body,dirCos);
-        _model->getSimbodyEngine().convertDirectionCosinesToAngles(dirCos,
-            &angVec[0],&angVec[1],&angVec[2]);
-
-        // CONVERT TO DEGREES?
-        if(getInDegrees()) {
-            angVec[0] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[1] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[2] *= SimTK_RADIAN_TO_DEGREE;
-        }           
-
-        // FILL KINEMATICS ARRAY
-        int I=6*i;
-        memcpy(&_kin[I],&vec[0],3*sizeof(double));
-        memcpy(&_kin[I+3],&angVec[0],3*sizeof(double));
-    }
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    const BodySet& bs = _model->getBodySet();
 
-    if(_recordCenterOfMass) {
-        double rP[3] = { 0.0, 0.0, 0.0 };
-        for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            _model->getSimbodyEngine().getPosition(s, body,com,vec);
-            // ADD TO WHOLE BODY MASS
-            Mass += body.get_mass();
-            rP[0] += body.get_mass() * vec[0];
-            rP[1] += body.get_mass() * vec[1];
-            rP[2] += body.get_mass() * vec[2];
-        }
+    // _kin holds the position, velocity and acceleration rows back to back;
+    // they are filled in one sweep over the bodies.
+    const int rowSize = _kin.getSize()/3;
+    double* pRow = &_kin[0];
+    double* vRow = pRow + rowSize;
+    double* aRow = vRow + rowSize;
+    const double scale = getInDegrees() ? SimTK_RADIAN_TO_DEGREE : 1.0;
 
-        //COMPUTE COM OF WHOLE BODY AND ADD TO ARRAY
-        rP[0] /= Mass;
-        rP[1] /= Mass;
-        rP[2] /= Mass;
-        int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rP,3*sizeof(double));
-    }
-    
-    _pStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
-
-    // VELOCITY
     for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
-        // GET VELOCITIES AND ANGULAR VELOCITIES
-        _model->getSimbodyEngine().getVelocity(s, body,com,vec);
+        const Body& body = bs.get(_bodyIndices[i]);
+        const SimTK::MobilizedBody& mobod =
+            matter.getMobilizedBody(body.getMobilizedBodyIndex());
+        const SimTK::Transform& X_GB = mobod.getBodyTransform(s);
+        const SimTK::SpatialVec& V_GB = mobod.getBodyVelocity(s);
+        const SimTK::SpatialVec& A_GB = mobod.getBodyAcceleration(s);
+
+        // Kinematics of the mass center, and angular kinematics.
+        const SimTK::Vec3 r = X_GB.R()*body.get_mass_center();
+        const SimTK::Vec3 pos = X_GB.p() + r;
+        const SimTK::Vec3 angles =
+            scale*X_GB.R().convertRotationToBodyFixedXYZ();
+        SimTK::Vec3 vel = V_GB[1] + V_GB[0] % r;
+        SimTK::Vec3 acc = A_GB[1] + A_GB[0] % r + V_GB[0] % (V_GB[0] % r);
         if(_expressInLocalFrame) {
-            _model->getSimbodyEngine().transform(s, ground,vec,body,vec);
-            _model->getSimbodyEngine().getAngularVelocityBodyLocal(s, body,angVec);
-        } else {
-            _model->getSimbodyEngine().getAngularVelocity(s, body,angVec);
+            // Only the linear quantities are re-expressed in the body.
+            vel = ~X_GB.R()*vel;
+            acc = ~X_GB.R()*acc;
         }
+        const SimTK::Vec3 angVel = scale*V_GB[0];
+        const SimTK::Vec3 angAcc = scale*A_GB[0];
 
-        // CONVERT TO DEGREES?
-        if(getInDegrees()) {
-            angVec[0] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[1] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[2] *= SimTK_RADIAN_TO_DEGREE;
-        }           
-
-        // FILL KINEMATICS ARRAY
-        int I = 6*i;
-        memcpy(&_kin[I],&vec[0],3*sizeof(double));
-        memcpy(&_kin[I+3],&angVec[0],3*sizeof(double));
+        // FILL KINEMATICS ROWS
+        int I=6*i;
+        memcpy(&pRow[I],&pos[0],3*sizeof(double));
+        memcpy(&pRow[I+3],&angles[0],3*sizeof(double));
+        memcpy(&vRow[I],&vel[0],3*sizeof(double));
+        memcpy(&vRow[I+3],&angVel[0],3*sizeof(double));
+        memcpy(&aRow[I],&acc[0],3*sizeof(double));
+        memcpy(&aRow[I+3],&angAcc[0],3*sizeof(double));
     }
 
     if(_recordCenterOfMass) {
-        double rV[3] = { 0.0, 0.0, 0.0 };
+        double Mass = 0.0;
+        SimTK::Vec3 rP(0), rV(0), rA(0);
         for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            _model->getSimbodyEngine().getVelocity(s, body,com,vec);
-            rV[0] += body.get_mass() * vec[0];
-            rV[1] += body.get_mass() * vec[1];
-            rV[2] += body.get_mass() * vec[2];
-        }
-
-        //COMPUTE VELOCITY OF COM OF WHOLE BODY AND ADD TO ARRAY
-        rV[0] /= Mass;
-        rV[1] /= Mass;
-        rV[2] /= Mass;
-        int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rV,3*sizeof(double));
-    }
-
-    _vStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
-
-    // ACCELERATIONS
-    for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
+            const Body& body = bs.get(i);
+            const SimTK::MobilizedBody& mobod =
+                matter.getMobilizedBody(body.getMobilizedBodyIndex());
+            const SimTK::Transform& X_GB = mobod.getBodyTransform(s);
+            const SimTK::SpatialVec& V_GB = mobod.getBodyVelocity(s);
+            const SimTK::SpatialVec& A_GB = mobod.getBodyAcceleration(s);
+            const SimTK::Vec3 r = X_GB.R()*body.get_mass_center();
 
-        // GET ACCELERATIONS AND ANGULAR ACCELERATIONS
-        _model->getSimbodyEngine().getAcceleration(s, body,com,vec);
-        if(_expressInLocalFrame) {
-            _model->getSimbodyEngine().transform(s, ground,vec,body,vec);
-            _model->getSimbodyEngine().getAngularAccelerationBodyLocal(s, body,angVec);
-        } else {
-            _model->getSimbodyEngine().getAngularAcceleration(s, body,angVec);
-        }
-
-        // CONVERT TO DEGREES?
-        if(getInDegrees()) {
-            angVec[0] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[1] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[2] *= SimTK_RADIAN_TO_DEGREE;
-        }           
-
-        // FILL KINEMATICS ARRAY
-        int I = 6*i;
-        memcpy(&_kin[I],&vec[0],3*sizeof(double));
-        memcpy(&_kin[I+3],&angVec[0],3*sizeof(double));
-    }
-
-    if(_recordCenterOfMass) {
-        double rA[3] = { 0.0, 0.0, 0.0 };
-        for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            _model->getSimbodyEngine().getAcceleration(s, body,com,vec);
-            rA[0] += body.get_mass() * vec[0];
-            rA[1] += body.get_mass() * vec[1];
-            rA[2] += body.get_mass() * vec[2];
+            // ADD TO WHOLE BODY MASS
+            const double m = body.get_mass();
+            Mass += m;
+            rP += m*(X_GB.p() + r);
+            rV += m*(V_GB[1] + V_GB[0] % r);
+            rA += m*(A_GB[1] + A_GB[0] % r + V_GB[0] % (V_GB[0] % r));
         }
 
-        //COMPUTE ACCELERATION OF COM OF WHOLE BODY AND ADD TO ARRAY
-        rA[0] /= Mass;
-        rA[1] /= Mass;
-        rA[2] /= Mass;
+        //COMPUTE COM OF WHOLE BODY AND ADD TO ROWS
+        rP /= Mass;
+        rV /= Mass;
+        rA /= Mass;
         int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rA,3*sizeof(double));
+        memcpy(&pRow[I],&rP[0],3*sizeof(double));
+        memcpy(&vRow[I],&rV[0],3*sizeof(double));
+        memcpy(&aRow[I],&rA[0],3*sizeof(double));
     }
 
-    _aStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
+    _pStore->append(s.getTime(),rowSize,pRow);
+    _vStore->append(s.getTime(),rowSize,vRow);
+    _aStore->append(s.getTime(),rowSize,aRow);
 
     //printf("BodyKinematics:\taT:\t%.16f\trA[1]:\t%.16f\n",s.getTime(),rA[1]);
     return(0);
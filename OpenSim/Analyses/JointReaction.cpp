@@ -413,6 +413,8 @@ void JointReaction::loadForcesFromFile()
         // check if actuator set and forces file have the same actuators
         bool _containsAllActuators = true;
         int actuatorSetSize = _model->getActuators().getSize();
+        _actuationIndices.setSize(actuatorSetSize);
+        _actuation.setSize(storeSize);
         if(actuatorSetSize > storeSize){
             cout << "The forces file does not contain enough actuators." << endl;
             _containsAllActuators = false;
@@ -422,6 +424,7 @@ void JointReaction::loadForcesFromFile()
             {
                 std::string actuatorName = _model->getActuators().get(actuatorIndex).getName();
                 int storageIndex = _storeActuation->getStateIndex(actuatorName,0);
+                _actuationIndices[actuatorIndex] = storageIndex;
                 if(storageIndex == -1) {
                     cout << "\nThe actuator " << actuatorName << " was not found in the forces file." << endl;
                     _containsAllActuators = false;
@@ -522,47 +525,36 @@ int JointReaction::
 record(const SimTK::State& s)
 {
     /** if a forces file is specified replace the computed actuation with the 
-        forces from storage.*/
-    SimTK::State s_analysis = s;
-
-    _model->updMultibodySystem().realize(s_analysis, s.getSystemStage());
+        forces from storage, in a copy of the state. Otherwise the reactions
+        are computed from the given state, which is realized as needed.*/
     if(_useForceStorage){
+        _analysisState = s;
 
-        const Set<Actuator> *actuatorSet = &_model->getActuators();
-        int nA = actuatorSet->getSize();
-        Array<double> forces(0,nA);
-        _storeActuation->getDataAtTime(s.getTime(),nA,forces);
-        int storageIndex = -1;
+        const Set<Actuator>& actuatorSet = _model->getActuators();
+        int nA = actuatorSet.getSize();
+        _storeActuation->getDataAtTime(s.getTime(),_actuation.getSize(),_actuation);
         for(int actuatorIndex=0;actuatorIndex<nA;actuatorIndex++)
         {
-            //Actuator* act = dynamic_cast<Actuator*>(&_forceSet->get(actuatorIndex));
-            std::string actuatorName = actuatorSet->get(actuatorIndex).getName();
-            storageIndex = _storeActuation->getStateIndex(actuatorName, 0);
-            if(storageIndex == -1){
-                cout << "The actuator, " << actuatorName << ", was not found in the forces file." << endl;
-                break;
-            }
-            const ScalarActuator* act = dynamic_cast<const ScalarActuator*>(&actuatorSet[actuatorIndex]);
+            const ScalarActuator* act = 
+                dynamic_cast<const ScalarActuator*>(&actuatorSet[actuatorIndex]);
             if (act){
-                act->overrideActuation(s_analysis, true);
-                act->setOverrideActuation(s_analysis, forces[storageIndex]);
+                act->overrideActuation(_analysisState, true);
+                act->setOverrideActuation(_analysisState,
+                    _actuation[_actuationIndices[actuatorIndex]]);
             }
         }
     }
+    const SimTK::State& s_analysis = _useForceStorage ? _analysisState : s;
+
     // VARIABLES
     const Ground& ground = _model->getGround();
-    int numJoints = _model->getNumJoints();
-
-    /** define 2 variable length vectors of Vec3 vectors to contain calculated  
-    *   forces and moments for all the bodies in the model */
-    Vector_<Vec3> allForcesVec(numJoints);
-    Vector_<Vec3> allMomentsVec(numJoints);
 
-    /* Calculate All joint reaction forces and moments.
+    /* Calculate all joint reaction forces and moments in one pass.
     *  Applied to child bodies, expressed in ground frame.  
-    *  computeReactions realizes to the acceleration stage internally
+    *  calcJointReactions realizes to the acceleration stage internally
     *  so you don't have to call realize in this analysis.*/ 
-    _model->getSimbodyEngine().computeReactions(s_analysis, allForcesVec, allMomentsVec);
+    _model->calcJointReactions(s_analysis, _allReactions,
+                               _mobilizerReactions);
 
     /* retrieved desired joint reactions, convert to desired bodies, and convert
     *  to desired reference frames*/
@@ -571,8 +563,8 @@ record(const SimTK::State& s)
     for(int i=0; i<numOutputJoints; i++) {
         JointReactionKey currentKey = _reactionList[i];
         const Joint& joint = *currentKey.joint;
-        Vec3 force = allForcesVec[currentKey.jointIndex];
-        Vec3 moment = allMomentsVec[currentKey.jointIndex];
+        Vec3 force = _allReactions[currentKey.jointIndex][1];
+        Vec3 moment = _allReactions[currentKey.jointIndex][0];
         const PhysicalFrame& expressedInBody = *currentKey.expressedInFrame;
         
         // find the point of application of the joint load on the child
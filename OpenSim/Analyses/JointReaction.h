@@ -74,7 +74,7 @@ private:
     {
         /* The index of the joint to be reported on in the Model's JointSet.
            This corresponds to the index in the Vector of reaction forces/moments
-           returned by the SimbodyEngine::computeReactions() method. */
+           returned by the Model::calcJointReactions() method. */
         int jointIndex;
         /* Joint reference*/
         const Joint* joint;
@@ -143,6 +143,23 @@ protected:
 
     bool _useForceStorage;
 
+    /** Internal work arrays for the actuator forces read from the forces
+    *   storage, and for the column of each actuator in that storage. */
+    Array<double> _actuation;
+    Array<int> _actuationIndices;
+
+    /** Internal work state in which actuation is overridden by the forces
+    *   storage. It is reused from frame to frame. */
+    SimTK::State _analysisState;
+
+    /** Internal work vector of the reaction loads of all joints in the
+    *   model. */
+    SimTK::Vector_<SimTK::SpatialVec> _allReactions;
+
+    /** Internal work vector of the reaction loads of all mobilizers, from
+    *   which _allReactions is filled. */
+    SimTK::Vector_<SimTK::SpatialVec> _mobilizerReactions;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -277,6 +277,13 @@ allocateStorage()
     _pStore = new Storage(1000,"PointPosition");
     _pStore->setDescription(getDescription());
     _pStore->setColumnLabels(getColumnLabels());
+
+    // The storages are deleted by deleteStorage().
+    _storageList.setMemoryOwner(false);
+    _storageList.setSize(0);
+    _storageList.append(_aStore);
+    _storageList.append(_vStore);
+    _storageList.append(_pStore);
 }
 
 
@@ -293,6 +300,7 @@ deleteStorage()
     if(_aStore!=NULL) { delete _aStore;  _aStore=NULL; }
     if(_vStore!=NULL) { delete _vStore;  _vStore=NULL; }
     if(_pStore!=NULL) { delete _pStore;  _pStore=NULL; }
+    _storageList.setSize(0);
 }
 
 
@@ -522,37 +530,32 @@ setStorageCapacityIncrements(int aIncrement)
 int PointKinematics::
 record(const SimTK::State& s)
 {
-    const SimbodyEngine& de = _model->getSimbodyEngine();
-
-    // VARIABLES
-    SimTK::Vec3 vec;
-
-    const double& time = s.getTime();
-
-    // POSITION
-    de.getPosition(s, *_body,_point,vec);
-    if(_relativeToBody){
-        de.transformPosition(s, _model->getGround(), vec, *_relativeToBody, vec);
-    }
-
-    _pStore->append(time, vec);
-
-    // VELOCITY
-    de.getVelocity(s, *_body,_point,vec);
-    if(_relativeToBody){
-        de.transform(s, _model->getGround(), vec, *_relativeToBody, vec);
-    }
-
-    _vStore->append(time, vec);
-
-    // ACCELERATIONS
+    // Read the body's kinematics from the realized matter subsystem once,
+    // and find the point's position, velocity and acceleration from them.
     _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
-    de.getAcceleration(s, *_body,_point,vec);
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    const SimTK::MobilizedBody& mobod =
+        matter.getMobilizedBody(_body->getMobilizedBodyIndex());
+    const SimTK::Transform& X_GB = mobod.getBodyTransform(s);
+    const SimTK::SpatialVec& V_GB = mobod.getBodyVelocity(s);
+    const SimTK::SpatialVec& A_GB = mobod.getBodyAcceleration(s);
+
+    const SimTK::Vec3 r = X_GB.R()*_point;
+    SimTK::Vec3 pos = X_GB.p() + r;
+    SimTK::Vec3 vel = V_GB[1] + V_GB[0] % r;
+    SimTK::Vec3 acc = A_GB[1] + A_GB[0] % r + V_GB[0] % (V_GB[0] % r);
     if(_relativeToBody){
-        de.transform(s, _model->getGround(), vec, *_relativeToBody, vec);
+        const SimTK::Transform& X_GR = matter.getMobilizedBody(
+            _relativeToBody->getMobilizedBodyIndex()).getBodyTransform(s);
+        pos = ~X_GR*pos;
+        vel = ~X_GR.R()*vel;
+        acc = ~X_GR.R()*acc;
     }
 
-    _aStore->append(time, vec);
+    const double& time = s.getTime();
+    _pStore->append(time, pos);
+    _vStore->append(time, vel);
+    _aStore->append(time, acc);
 
     return(0);
 }
@@ -36,7 +36,9 @@
 #include <OpenSim/Simulation/Model/ForceSet.h>
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
 #include "StaticOptimizationTarget.h"
+#include <OpenSim/Common/FiniteDifferences.h>
 #include <iostream>
+#include <vector>
 
 using namespace OpenSim;
 using namespace std;
@@ -130,18 +132,19 @@ prepareToOptimize(SimTK::State& s, double *x)
     _constraintMatrix.resize(nc,np);
     _constraintVector.resize(nc);
 
-    Vector pVector(np), cVector(nc);
-
-    // Build linear constraint matrix and constant constraint vector
-    pVector = 0;
-    computeConstraintVector(s, pVector,_constraintVector);
-
-    for(int p=0; p<np; p++) {
-        pVector[p] = 1;
-        computeConstraintVector(s, pVector, cVector);
-        for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
-        pVector[p] = 0;
-    }
+    // Build linear constraint matrix and constant constraint vector:
+    // forward differences about zero activation with unit perturbations,
+    // each column evaluated on a copy of the state.
+    Vector pVector(np, 0.0);
+    std::vector<double> unitDX(np, 1.0);
+    FiniteDifferences::Function constraints =
+        [this](SimTK::State& ws, const Vector& p, Vector& c) {
+            computeConstraintVector(ws, p, c);
+            return 0;
+        };
+    FiniteDifferences::calcJacobian(s, constraints,
+        FiniteDifferences::ForwardDifference, pVector, &unitDX[0],
+        _constraintMatrix, &_constraintVector);
 #endif
 
     // return false to indicate that we still need to proceed with optimization
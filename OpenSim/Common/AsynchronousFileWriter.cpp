@@ -0,0 +1,125 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  AsynchronousFileWriter.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "AsynchronousFileWriter.h"
+
+using namespace OpenSim;
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+std::shared_ptr<AsynchronousFileWriter> AsynchronousFileWriter::acquire()
+{
+    // Only a weak reference is kept here, so the writer is destroyed, and
+    // its thread joined, by its last owner rather than at exit.
+    static std::mutex sharedMutex;
+    static std::weak_ptr<AsynchronousFileWriter> shared;
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    std::shared_ptr<AsynchronousFileWriter> writer = shared.lock();
+    if (!writer) {
+        writer = std::make_shared<AsynchronousFileWriter>();
+        shared = writer;
+    }
+    return writer;
+}
+
+AsynchronousFileWriter::AsynchronousFileWriter(int aMaxQueuedRows) :
+    _maxQueuedRows(aMaxQueuedRows<1 ? 1 : aMaxQueuedRows),
+    _stopping(false)
+{
+}
+
+AsynchronousFileWriter::~AsynchronousFileWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _rowQueued.notify_all();
+    if (_thread.joinable())
+        _thread.join();
+}
+
+//=============================================================================
+// WRITING
+//=============================================================================
+void AsynchronousFileWriter::writeRow(FILE *aFile, const StateVector &aRow)
+{
+    writeRow(aFile, aRow, IO::GetNumberFormat());
+}
+
+void AsynchronousFileWriter::writeRow(FILE *aFile, const StateVector &aRow,
+                                      const IO::NumberFormat &aFormat)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_thread.joinable())
+        _thread = std::thread(&AsynchronousFileWriter::run, this);
+
+    _rowWritten.wait(lock,
+        [this] { return (int)_rows.size() < _maxQueuedRows; });
+
+    Row row;
+    row.file = aFile;
+    row.data = aRow;
+    row.format = aFormat;
+    _rows.push_back(row);
+    _pending[aFile]++;
+    lock.unlock();
+    _rowQueued.notify_one();
+}
+
+void AsynchronousFileWriter::flush(FILE *aFile)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _rowWritten.wait(lock, [this, aFile] {
+        std::map<FILE*,int>::const_iterator it = _pending.find(aFile);
+        return it == _pending.end() || it->second == 0;
+    });
+    _pending.erase(aFile);
+    lock.unlock();
+    fflush(aFile);
+}
+
+void AsynchronousFileWriter::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _rowQueued.wait(lock, [this] { return _stopping || !_rows.empty(); });
+        if (_rows.empty())
+            return; // stopping, and every row has been written
+
+        Row row = _rows.front();
+        _rows.pop_front();
+
+        // Format and write without holding the lock so that rows can be
+        // queued meanwhile.
+        lock.unlock();
+        row.data.print(row.file, row.format);
+        lock.lock();
+
+        _pending[row.file]--;
+        _rowWritten.notify_all();
+    }
+}
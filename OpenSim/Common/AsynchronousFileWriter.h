@@ -0,0 +1,110 @@
+#ifndef OPENSIM_ASYNCHRONOUS_FILE_WRITER_H_
+#define OPENSIM_ASYNCHRONOUS_FILE_WRITER_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  AsynchronousFileWriter.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "IO.h"
+#include "StateVector.h"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Formats and writes rows of results to files on a background thread, so
+ * that writing results overlaps with computing them rather than following
+ * it. Storage objects writing to their output files asynchronously (see
+ * Storage::setAsynchronousOutput()) share one writer, which each of them
+ * owns, through acquire(), from its first queued row until its file is
+ * closed. The writer writes the rows still queued and stops its thread when
+ * the last owner releases it, so the thread does not outlive the files it
+ * writes to or run while static objects are destroyed at exit.
+ *
+ * Each row is formatted with the number output format in effect when it was
+ * queued (see IO::GetNumberFormat()), so that changes to the format by other
+ * threads, e.g. by a tool setting its output precision, do not affect rows
+ * already queued.
+ *
+ * Rows are written to each file in the order they are queued. The number of
+ * rows waiting to be written is bounded; writeRow() blocks while the limit
+ * is reached, so a writer that cannot keep up slows the computation down
+ * rather than holding an unbounded number of rows in memory.
+ *
+ * A file must not be written to by other means, or closed, until flush()
+ * has been called for it.
+ */
+class OSIMCOMMON_API AsynchronousFileWriter {
+public:
+    /** The writer shared by Storage objects, created if no one owns it.
+    Release the returned pointer once the rows queued through it have been
+    flushed. */
+    static std::shared_ptr<AsynchronousFileWriter> acquire();
+
+    /** @param aMaxQueuedRows Number of rows that may wait to be written. */
+    explicit AsynchronousFileWriter(int aMaxQueuedRows=10000);
+    /** Writes the rows that are still queued and stops the thread. */
+    ~AsynchronousFileWriter();
+
+    /** Queue a copy of aRow to be written to aFile (see StateVector::print()).
+    The thread is started when the first row is queued. */
+    void writeRow(FILE *aFile,const StateVector &aRow);
+    /** Queue a copy of aRow to be written to aFile with a number format
+    captured before (see IO::GetNumberFormat()). */
+    void writeRow(FILE *aFile,const StateVector &aRow,
+                  const IO::NumberFormat &aFormat);
+    /** Wait until all rows queued for aFile have been written, and flush
+    it. */
+    void flush(FILE *aFile);
+
+private:
+    struct Row {
+        FILE *file;
+        StateVector data;
+        IO::NumberFormat format;
+    };
+
+    void run();
+
+    int _maxQueuedRows;
+    std::deque<Row> _rows;
+    // Number of rows queued for, or being written to, each file.
+    std::map<FILE*,int> _pending;
+    bool _stopping;
+    std::mutex _mutex;
+    std::condition_variable _rowQueued;
+    std::condition_variable _rowWritten;
+    std::thread _thread;
+
+//=============================================================================
+};  // END of class AsynchronousFileWriter
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_ASYNCHRONOUS_FILE_WRITER_H_
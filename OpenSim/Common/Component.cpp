@@ -75,29 +75,47 @@ public:
     {   return this->getValueZero(); }
 
     void realizeMeasureTopologyVirtual(SimTK::State& s) const override final
-    {   _Component.extendRealizeTopology(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizeTopology);
+        _Component.extendRealizeTopology(s); }
     void realizeMeasureModelVirtual(SimTK::State& s) const override final
-    {   _Component.extendRealizeModel(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizeModel);
+        _Component.extendRealizeModel(s); }
     void realizeMeasureInstanceVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeInstance(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizeInstance);
+        _Component.extendRealizeInstance(s); }
     void realizeMeasureTimeVirtual(const SimTK::State& s) const override final
-    {   _Component.extendRealizeTime(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizeTime);
+        _Component.extendRealizeTime(s); }
     void realizeMeasurePositionVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizePosition(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizePosition);
+        _Component.extendRealizePosition(s); }
     void realizeMeasureVelocityVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeVelocity(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizeVelocity);
+        _Component.extendRealizeVelocity(s); }
     void realizeMeasureDynamicsVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeDynamics(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizeDynamics);
+        _Component.extendRealizeDynamics(s); }
     void realizeMeasureAccelerationVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeAcceleration(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizeAcceleration);
+        _Component.extendRealizeAcceleration(s); }
     void realizeMeasureReportVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeReport(s); }
+    {   ComponentProfiler::Scope scope(_Component,
+            ComponentProfiler::RealizeReport);
+        _Component.extendRealizeReport(s); }
 
 private:
     const Component& _Component;
@@ -127,12 +145,28 @@ Component::Component(SimTK::Xml::Element& element)
     finalizeFromProperties();
 }
 
+// Number of DeferFinalizeOnCopy instances alive on this thread.
+static thread_local int deferFinalizeOnCopyCount = 0;
+
+Component::DeferFinalizeOnCopy::DeferFinalizeOnCopy()
+{
+    ++deferFinalizeOnCopyCount;
+}
+
+Component::DeferFinalizeOnCopy::~DeferFinalizeOnCopy()
+{
+    --deferFinalizeOnCopyCount;
+}
+
 Component::Component(const Component& source) : Object(source)
 {
     //Object copy will handle the properties table.
     //But need to copy Component specific property indices.
     copyProperty_connectors(source);
-    finalizeFromProperties();
+    // The copy remains out-of-date with its properties until its root
+    // finalizes the tree.
+    if (deferFinalizeOnCopyCount == 0)
+        finalizeFromProperties();
 }
 
 Component& Component::operator=(const Component &component)
@@ -146,10 +180,16 @@ Component& Component::operator=(const Component &component)
 
 void Component::finalizeFromProperties()
 {
+    // Subcomponents may be reallocated below so the index held by the root
+    // can no longer be trusted.
+    invalidateComponentIndex();
     reset();
     clearComponents();
     extendFinalizeFromProperties();
     componentsFinalizeFromProperties();
+    // Only the root of the tree maintains the index used to connect.
+    if (!hasParent())
+        buildComponentIndex();
     setObjectIsUpToDateWithProperties();
 }
 
@@ -179,8 +219,20 @@ void Component::connect(Component &root)
         connector.disconnect();
         try{
             const std::string& compName = connector.get_connectee_name();
+            // Try the index of the root's components before searching. It
+            // only answers when the name identifies a unique component.
+            const Component* indexed = findConnecteeInIndex(compName, root);
+            if (indexed) {
+                try { //Could still be the wrong type
+                    connector.connect(*indexed);
+                }
+                catch (const std::exception&) {
+                    // Let the search below report or resolve the mismatch.
+                }
+            }
             std::string::size_type front = compName.find("/");
-            if (front != 0) { // local (not path qualified) name
+            if (!connector.isConnected() && front != 0) {
+                // local (not path qualified) name
                 // A local Component is considered: 
                 // (1) one of this component's children 
                 const Component* comp = findComponent(compName);
@@ -505,6 +557,20 @@ void Component::setParent(const Component& parent)
     _parent.reset(&parent);
 }
 
+void Component::setProfiler(ComponentProfiler* profiler)
+{
+    _profiler.reset(profiler);
+}
+
+ComponentProfiler* Component::getActiveProfiler() const
+{
+    const Component* root = this;
+    while (!root->_parent.empty())
+        root = root->_parent.get();
+    ComponentProfiler* profiler = root->_profiler.get();
+    return (profiler != nullptr && profiler->isEnabled()) ? profiler : nullptr;
+}
+
 const Component& Component::getComponent(const std::string& name) const
 {  
     const Component* found = findComponent(name);
@@ -578,6 +644,107 @@ const Component* Component::findComponent(const std::string& name,
     return found;
 }
 
+void Component::buildComponentIndex()
+{
+    _componentIndex.clear();
+    for (unsigned int i = 0; i < _components.size(); ++i)
+        _components[i]->addToComponentIndex(_componentIndex, "");
+    _componentIndexIsValid = true;
+}
+
+void Component::addToComponentIndex(
+    std::unordered_map<std::string, std::vector<const Component*>>& index,
+    const std::string& parentPath) const
+{
+    const std::string path = parentPath.empty() ? getName() :
+                                                  parentPath + "/" + getName();
+    index[path].push_back(this);
+    if (!parentPath.empty() && !getName().empty())
+        index[getName()].push_back(this);
+
+    for (unsigned int i = 0; i < _components.size(); ++i)
+        _components[i]->addToComponentIndex(index, path);
+}
+
+void Component::invalidateComponentIndex()
+{
+    const Component* root = this;
+    while (root->hasParent())
+        root = &root->getParent();
+
+    Component* mutableRoot = const_cast<Component*>(root);
+    mutableRoot->_componentIndex.clear();
+    mutableRoot->_componentIndexIsValid = false;
+}
+
+bool Component::getPathNameRelativeTo(const Component& root,
+                                      std::string& path) const
+{
+    path = "";
+    const Component* comp = this;
+    while (comp != &root) {
+        if (!comp->hasParent())
+            return false;
+        path = path.empty() ? comp->getName() : comp->getName() + "/" + path;
+        comp = &comp->getParent();
+    }
+    return true;
+}
+
+const Component* Component::findConnecteeInIndex(const std::string& name,
+                                                 const Component& root) const
+{
+    if (!root._componentIndexIsValid || name.empty())
+        return nullptr;
+
+    const auto& index = root._componentIndex;
+
+    // Search in the same order as connect(): first this Component's
+    // subcomponents, then its siblings and finally the whole tree.
+    std::vector<const Component*> scopes{ this };
+    if (hasParent())
+        scopes.push_back(&getParent());
+    scopes.push_back(&root);
+
+    if (name.find("/") != std::string::npos) {
+        // A path is resolved relative to each scope in turn.
+        for (const Component* scope : scopes) {
+            std::string scopePath;
+            if (!scope->getPathNameRelativeTo(root, scopePath))
+                return nullptr;
+            auto it = index.find(scopePath.empty() ? name :
+                                                     scopePath + "/" + name);
+            if (it != index.end())
+                return it->second.size() == 1 ? it->second[0] : nullptr;
+        }
+        return nullptr;
+    }
+
+    auto it = index.find(name);
+    if (it == index.end())
+        return nullptr;
+
+    for (const Component* scope : scopes) {
+        const Component* found = nullptr;
+        int nFound = 0;
+        for (const Component* candidate : it->second) {
+            // Is the candidate a descendant of scope?
+            const Component* ancestor = candidate;
+            while (ancestor != scope && ancestor->hasParent())
+                ancestor = &ancestor->getParent();
+            if (ancestor == scope && candidate != scope) {
+                found = candidate;
+                ++nFound;
+            }
+        }
+        if (nFound == 1)
+            return found;
+        if (nFound > 1) // ambiguous, leave it to the search
+            return nullptr;
+    }
+    return nullptr;
+}
+
 const AbstractConnector* Component::findConnector(const std::string& name) const
 {
     const AbstractConnector* found = nullptr;
@@ -863,6 +1030,7 @@ void Component::addComponent(Component* component)
     }
 
     component->setParent(*this);
+    invalidateComponentIndex();
 }
 
 const int Component::getStateIndex(const std::string& name) const
@@ -1034,7 +1202,11 @@ void Component::extendRealizeAcceleration(const SimTK::State& s) const
         const SimTK::Subsystem& subSys = getDefaultSubsystem();
 
         // evaluate and set component state derivative values (in cache) 
-        computeStateVariableDerivatives(s);
+        {
+            ComponentProfiler::Scope scope(*this,
+                ComponentProfiler::ComputeStateVariableDerivatives);
+            computeStateVariableDerivatives(s);
+        }
     
         std::map<std::string, StateVariableInfo>::const_iterator it;
 
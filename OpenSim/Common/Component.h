@@ -46,10 +46,12 @@
 #include "OpenSim/Common/Object.h"
 #include "OpenSim/Common/ComponentConnector.h"
 #include "OpenSim/Common/ComponentOutput.h"
+#include "OpenSim/Common/ComponentProfiler.h"
 #include "ComponentList.h"
 #include "Simbody.h"
 #include <functional>
 #include <memory>
+#include <unordered_map>
 
 namespace OpenSim {
 
@@ -214,6 +216,21 @@ public:
     /** Destructor is virtual to allow concrete Component to cleanup. **/
     virtual ~Component() {}
 
+    /** While an instance of this class is in scope, Components that are
+        copied on the current thread skip the finalizeFromProperties() that
+        the copy constructor normally performs. Copying a tree of Components
+        otherwise finalizes every subtree once per level of the tree; use this
+        when the copy will be finalized from its root afterwards.
+        @see Model::fork() */
+    class OSIMCOMMON_API DeferFinalizeOnCopy {
+    public:
+        DeferFinalizeOnCopy();
+        ~DeferFinalizeOnCopy();
+    private:
+        DeferFinalizeOnCopy(const DeferFinalizeOnCopy&) = delete;
+        DeferFinalizeOnCopy& operator=(const DeferFinalizeOnCopy&) = delete;
+    };
+
 
     /** @name Component Structural Interface
     The structural interface ensures that deserialization, resolution of 
@@ -1034,6 +1051,16 @@ template <class T> friend class ComponentMeasure;
         }
     }
 
+    /** Build an index of all the descendants of this Component keyed on both
+    their names and their path names relative to this Component. The index is
+    built automatically at the end of finalizeFromProperties() for the root
+    Component of a tree and is used by connect() to resolve Connectors without
+    searching the tree. Like initComponentTreeTraversal(), it must be rebuilt
+    if components are added after finalizeFromProperties(). Any call to
+    addComponent() or finalizeFromProperties() within the tree invalidates the
+    index, in which case connect() falls back to searching the tree. */
+    void buildComponentIndex();
+
     ///@cond
     /** Opportunity to remove connection related information. 
     If you override this method, be sure to invoke the base class method first,
@@ -1571,9 +1598,19 @@ template <class T> friend class ComponentMeasure;
         1) is the root component, or 2) has not been added to its parent. */
     bool hasParent() const;
 
+    /** Get the enabled profiler of the tree this Component belongs to, or
+    nullptr if its root Component has no enabled profiler.
+    @see ComponentProfiler::Scope */
+    ComponentProfiler* getActiveProfiler() const;
+
     /** %Set this Component's reference to its parent Component */
     void setParent(const Component& parent);
 
+    /** %Set the profiler that times the computations of this Component and
+    its descendants. Only the profiler of the root Component is used; pass
+    nullptr to detach it. The profiler is not owned by the Component. */
+    void setProfiler(ComponentProfiler* profiler);
+
     //@} 
 
 private:
@@ -1607,6 +1644,27 @@ private:
     //the return type, @see addOutput()
     virtual void constructOutputs() {}
 
+    // Add this Component and its descendants to the provided index under
+    // their names and their path names starting with parentPath.
+    void addToComponentIndex(
+        std::unordered_map<std::string, std::vector<const Component*>>& index,
+        const std::string& parentPath) const;
+
+    // Discard the component index maintained by the root of the tree that
+    // this Component belongs to.
+    void invalidateComponentIndex();
+
+    // Use the index of the root Component to find the component that this
+    // Component's connectee name refers to. Returns nullptr if root has no
+    // valid index or if the name does not identify a unique component, in
+    // which case the caller must fall back to searching the tree.
+    const Component* findConnecteeInIndex(const std::string& name,
+                                          const Component& root) const;
+
+    // Compute the path name of this Component relative to root. Returns false
+    // if this Component is not a descendant of root.
+    bool getPathNameRelativeTo(const Component& root, std::string& path) const;
+
     /// Invoke finalizeFromProperties() on the (sub)components of this Component.
     void componentsFinalizeFromProperties() const;
 
@@ -1779,6 +1837,12 @@ private:
     // Table of Component's Inputs indexed by name.
     std::map<std::string, std::unique_ptr<const AbstractInput> > _inputsTable;
 
+    // Index of all descendants by name and by relative path name. Only the
+    // root Component of a tree maintains this index.
+    std::unordered_map<std::string, std::vector<const Component*>>
+        _componentIndex;
+    bool _componentIndexIsValid = false;
+
     // Table of Component's Outputs indexed by name.
     std::map<std::string, std::unique_ptr<const AbstractOutput> >
         _outputsTable;
@@ -1790,6 +1854,10 @@ private:
     // subsystem.
     SimTK::ResetOnCopy<SimTK::MeasureIndex> _simTKcomponentIndex;
 
+    // Profiler timing the computations of this tree of Components. Only the
+    // root Component holds one; it is not owned and is not copied.
+    SimTK::ReferencePtr<ComponentProfiler> _profiler;
+
     // Structure to hold modeling option information. Modeling options are
     // integers 0..maxOptionValue. At run time we keep them in a Simbody
     // discrete state variable that invalidates Model stage if changed.
@@ -0,0 +1,251 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  ComponentProfiler.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ComponentProfiler.h"
+#include "Component.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+using namespace OpenSim;
+
+std::atomic<int> ComponentProfiler::_numEnabled(0);
+
+// The innermost Scope that is timing a computation on this thread.
+static thread_local ComponentProfiler::Scope* currentScope = nullptr;
+
+//=============================================================================
+// SCOPE
+//=============================================================================
+ComponentProfiler::Scope::Scope(const Component& component, Category category) :
+    _profiler(nullptr),
+    _component(&component),
+    _category(category),
+    _enclosing(nullptr),
+    _nestedTime(0)
+{
+    if (!ComponentProfiler::isAnyEnabled())
+        return;
+    _profiler = component.getActiveProfiler();
+    if (_profiler == nullptr)
+        return;
+
+    _enclosing = currentScope;
+    currentScope = this;
+    _start = std::chrono::steady_clock::now();
+}
+
+ComponentProfiler::Scope::~Scope()
+{
+    if (_profiler == nullptr)
+        return;
+
+    const double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - _start).count();
+    currentScope = _enclosing;
+    if (_enclosing != nullptr)
+        _enclosing->_nestedTime += elapsed;
+
+    _profiler->record(*_component, _category, elapsed,
+                      std::max(0.0, elapsed - _nestedTime));
+}
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+ComponentProfiler::ComponentProfiler() : _enabled(false)
+{
+}
+
+ComponentProfiler::~ComponentProfiler()
+{
+    setEnabled(false);
+}
+
+void ComponentProfiler::setEnabled(bool aTrueFalse)
+{
+    if (aTrueFalse == _enabled)
+        return;
+    _enabled = aTrueFalse;
+    if (_enabled)
+        ++_numEnabled;
+    else
+        --_numEnabled;
+}
+
+void ComponentProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
+
+//=============================================================================
+// RECORDING
+//=============================================================================
+void ComponentProfiler::record(const Component& component, Category category,
+                               double totalTime, double selfTime)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(std::make_pair(&component, (int)category));
+    if (it == _entries.end()) {
+        // Look up the names once, when the Component is first timed, since
+        // the Component may no longer exist when the report is printed.
+        Entry entry;
+        entry.componentPath = component.getPathName().empty() ?
+            component.getName() : component.getPathName();
+        entry.concreteClassName = component.getConcreteClassName();
+        entry.numCalls = 0;
+        entry.totalTime = 0;
+        entry.selfTime = 0;
+        it = _entries.insert(std::make_pair(
+            std::make_pair(&component, (int)category), entry)).first;
+    }
+    Entry& entry = it->second;
+    ++entry.numCalls;
+    entry.totalTime += totalTime;
+    entry.selfTime += selfTime;
+}
+
+//=============================================================================
+// REPORTING
+//=============================================================================
+std::vector<ComponentProfiler::Record> ComponentProfiler::getRecords() const
+{
+    std::vector<Record> records;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        records.reserve(_entries.size());
+        for (const auto& it : _entries) {
+            const Entry& entry = it.second;
+            Record record;
+            record.componentPath = entry.componentPath;
+            record.concreteClassName = entry.concreteClassName;
+            record.category = (Category)it.first.second;
+            record.numCalls = entry.numCalls;
+            record.totalTime = entry.totalTime;
+            record.selfTime = entry.selfTime;
+            records.push_back(record);
+        }
+    }
+    std::stable_sort(records.begin(), records.end(),
+        [](const Record& a, const Record& b) {
+            return a.selfTime > b.selfTime;
+        });
+    return records;
+}
+
+double ComponentProfiler::getTotalSelfTime() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    double total = 0;
+    for (const auto& it : _entries)
+        total += it.second.selfTime;
+    return total;
+}
+
+void ComponentProfiler::printReport(std::ostream& aOStream, int aMaxRows) const
+{
+    const std::vector<Record> records = getRecords();
+    double total = 0;
+    for (const Record& record : records)
+        total += record.selfTime;
+
+    const std::ios_base::fmtflags flags = aOStream.flags();
+    const std::streamsize precision = aOStream.precision();
+
+    aOStream << "Component profile (" << records.size() << " records, "
+             << total << " s):" << std::endl;
+    aOStream << std::setw(10) << "self (s)" << std::setw(8) << "self %"
+             << std::setw(10) << "total (s)" << std::setw(10) << "calls"
+             << std::setw(12) << "us/call" << "  "
+             << std::left << std::setw(32) << "category"
+             << "component" << std::right << std::endl;
+
+    const size_t numRows = aMaxRows < 0 ? records.size() :
+        std::min(records.size(), (size_t)aMaxRows);
+    aOStream << std::fixed;
+    for (size_t i = 0; i < numRows; ++i) {
+        const Record& record = records[i];
+        aOStream << std::setprecision(4)
+                 << std::setw(10) << record.selfTime
+                 << std::setprecision(1) << std::setw(8)
+                 << (total > 0 ? 100.0*record.selfTime/total : 0.0)
+                 << std::setprecision(4) << std::setw(10) << record.totalTime
+                 << std::setw(10) << record.numCalls
+                 << std::setprecision(2) << std::setw(12)
+                 << 1e6*record.totalTime/std::max(1LL, record.numCalls)
+                 << "  " << std::left << std::setw(32)
+                 << getCategoryName(record.category)
+                 << record.componentPath << " (" << record.concreteClassName
+                 << ")" << std::right << std::endl;
+    }
+    if (numRows < records.size())
+        aOStream << "... " << records.size() - numRows
+                 << " more records." << std::endl;
+
+    aOStream.flags(flags);
+    aOStream.precision(precision);
+}
+
+void ComponentProfiler::printCSV(const std::string& aFileName) const
+{
+    std::ofstream out(aFileName.c_str());
+    if (!out.good())
+        throw Exception("ComponentProfiler: could not open file '" +
+                        aFileName + "'.", __FILE__, __LINE__);
+
+    out << "component,class,category,calls,total_time,self_time" << std::endl;
+    out << std::setprecision(9);
+    for (const Record& record : getRecords()) {
+        out << record.componentPath << "," << record.concreteClassName << ","
+            << getCategoryName(record.category) << "," << record.numCalls
+            << "," << record.totalTime << "," << record.selfTime << std::endl;
+    }
+}
+
+const char* ComponentProfiler::getCategoryName(Category aCategory)
+{
+    switch (aCategory) {
+    case RealizeTopology: return "realizeTopology";
+    case RealizeModel: return "realizeModel";
+    case RealizeInstance: return "realizeInstance";
+    case RealizeTime: return "realizeTime";
+    case RealizePosition: return "realizePosition";
+    case RealizeVelocity: return "realizeVelocity";
+    case RealizeDynamics: return "realizeDynamics";
+    case RealizeAcceleration: return "realizeAcceleration";
+    case RealizeReport: return "realizeReport";
+    case ComputeForce: return "computeForce";
+    case ComputeStateVariableDerivatives:
+        return "computeStateVariableDerivatives";
+    case ComputeControls: return "computeControls";
+    case ComputePath: return "computePath";
+    case ComputeLengtheningSpeed: return "computeLengtheningSpeed";
+    case ApplyWrapObjects: return "applyWrapObjects";
+    default: return "unknown";
+    }
+}
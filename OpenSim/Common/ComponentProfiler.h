@@ -0,0 +1,176 @@
+#ifndef OPENSIM_COMPONENT_PROFILER_H_
+#define OPENSIM_COMPONENT_PROFILER_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  ComponentProfiler.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OpenSim {
+
+class Component;
+
+//=============================================================================
+//=============================================================================
+/**
+ * Accumulates the time spent in, and the number of calls to, the computations
+ * of each Component of a tree: its realize stages, forces, state variable
+ * derivatives, controls and paths. Time is recorded per Component and per
+ * kind of computation (Category), both in total and excluding the time spent
+ * in nested computations of other Components ("self" time), so that the
+ * report points at the Components that are expensive themselves rather than
+ * at the ones that happen to call them.
+ *
+ * A profiler is attached to the root Component of a tree (see
+ * Model::setProfiling()). Computations are timed with a Scope; a Scope whose
+ * Component's tree has no enabled profiler costs a single atomic load.
+ *
+ * Scopes on different threads are timed independently; recording a sample
+ * takes a lock, so expect a small perturbation of timings when forces are
+ * computed in parallel.
+ */
+class OSIMCOMMON_API ComponentProfiler {
+//=============================================================================
+// DATA
+//=============================================================================
+public:
+    /** The kinds of computation that are timed. */
+    enum Category {
+        RealizeTopology,
+        RealizeModel,
+        RealizeInstance,
+        RealizeTime,
+        RealizePosition,
+        RealizeVelocity,
+        RealizeDynamics,
+        RealizeAcceleration,
+        RealizeReport,
+        ComputeForce,
+        ComputeStateVariableDerivatives,
+        ComputeControls,
+        ComputePath,
+        ComputeLengtheningSpeed,
+        ApplyWrapObjects,
+        NumCategories
+    };
+
+    /** The accumulated timings of one kind of computation of one Component.
+    Times are in seconds. */
+    struct Record {
+        std::string componentPath;
+        std::string concreteClassName;
+        Category category;
+        long long numCalls;
+        double totalTime;
+        double selfTime;
+    };
+
+    /** Times a computation from construction to destruction. If the
+    Component's tree has no enabled profiler, nothing is timed. */
+    class OSIMCOMMON_API Scope {
+    public:
+        Scope(const Component& component, Category category);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        ComponentProfiler* _profiler;
+        const Component* _component;
+        Category _category;
+        Scope* _enclosing;
+        std::chrono::steady_clock::time_point _start;
+        double _nestedTime;
+    };
+
+private:
+    struct Entry {
+        std::string componentPath;
+        std::string concreteClassName;
+        long long numCalls;
+        double totalTime;
+        double selfTime;
+    };
+
+    bool _enabled;
+    mutable std::mutex _mutex;
+    std::map<std::pair<const Component*, int>, Entry> _entries;
+
+    // Number of enabled profilers in the process.
+    static std::atomic<int> _numEnabled;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    ComponentProfiler();
+    ~ComponentProfiler();
+
+    ComponentProfiler(const ComponentProfiler&) = delete;
+    ComponentProfiler& operator=(const ComponentProfiler&) = delete;
+
+    /** Start or stop recording. Accumulated timings are kept. */
+    void setEnabled(bool aTrueFalse);
+    bool isEnabled() const { return _enabled; }
+
+    /** Whether any profiler in the process is enabled. */
+    static bool isAnyEnabled() { return _numEnabled.load() > 0; }
+
+    /** Discard all accumulated timings. */
+    void reset();
+
+    /** Get the accumulated timings, sorted by self time, largest first. */
+    std::vector<Record> getRecords() const;
+
+    /** Get the sum of the self times of all records; this is the time spent
+    in all timed computations. */
+    double getTotalSelfTime() const;
+
+    /** Print a table of the records with the largest self times. Pass
+    aMaxRows < 0 to print all records. */
+    void printReport(std::ostream& aOStream, int aMaxRows=30) const;
+
+    /** Write all records to a comma-separated values file. */
+    void printCSV(const std::string& aFileName) const;
+
+    /** Get the name of a Category, as it is printed in reports. */
+    static const char* getCategoryName(Category aCategory);
+
+private:
+    void record(const Component& component, Category category,
+                double totalTime, double selfTime);
+
+//=============================================================================
+};  // END of class ComponentProfiler
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_COMPONENT_PROFILER_H_
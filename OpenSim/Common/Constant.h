@@ -90,6 +90,12 @@ public:
     {
         return _value;
     }
+    void calcValueAndDerivatives(double xUnused, double& rValue,
+        double& rFirstDerivative, double& rSecondDerivative) const override
+    {
+        rValue = _value;
+        rFirstDerivative = rSecondDerivative = 0;
+    }
     const double getValue() const { return _value; }
     SimTK::Function* createSimTKFunction() const override;
 //=============================================================================
@@ -33,6 +33,9 @@ in-memory container for data access and manipulation.                         */
 #include "OpenSim/Common/Exception.h"
 #include "OpenSim/Common/ValueArrayDictionary.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace OpenSim {
 
 class InvalidRow : public Exception {
@@ -55,6 +58,21 @@ public:
     }
 };
 
+class IncorrectNumRows : public InvalidRow {
+public:
+    IncorrectNumRows(const std::string& file,
+                     size_t line,
+                     const std::string& func,
+                     size_t expected,
+                     size_t received) :
+        InvalidRow(file, line, func) {
+        std::string msg = "expected = " + std::to_string(expected);
+        msg += " received = " + std::to_string(received);
+
+        addMessage(msg);
+    }
+};
+
 class RowIndexOutOfRange : public IndexOutOfRange {
 public:
     using IndexOutOfRange::IndexOutOfRange;
@@ -213,6 +231,7 @@ public:
     using RowVector     = SimTK::RowVector_<ETY>;
     using RowVectorView = SimTK::RowVectorView_<ETY>;
     using VectorView    = SimTK::VectorView_<ETY>;
+    using MatrixView    = SimTK::MatrixView_<ETY>;
 
     DataTable_()                             = default;
     DataTable_(const DataTable_&)            = default;
@@ -225,31 +244,77 @@ public:
         return std::unique_ptr<AbstractDataTable>{new DataTable_{*this}};
     }
 
-    /** Append row to the DataTable_.                                         
+    /** Append row to the DataTable_. Storage for rows grows geometrically, so
+    appending N rows takes time linear in N.
 
     \throws IncorrectNumCoilumns If the row added is invalid. Validity of the 
     row added is decided by the derived class.                                */
     void appendRow(const ETX& indRow, const RowVector& depRow) {
         validateRow(_indData.size(), indRow, depRow);
+        validateNumColumns(static_cast<size_t>(depRow.ncol()));
 
         _indData.push_back(indRow);
+        growDependentsToCapacity(static_cast<int>(depRow.ncol()));
+
+        _depData.updRow(static_cast<int>(_indData.size()) - 1) = depRow;
+    }
 
-        if(_depData.nrow() == 0 || _depData.ncol() == 0) {
-            try {
-                auto& labels = 
-                    _dependentsMetaData.getValueArrayForKey("labels");
-                OPENSIM_THROW_IF(depRow.ncol() != labels.size(),
-                                 IncorrectNumColumns, 
-                                 labels.size(), 
-                                 static_cast<size_t>(depRow.ncol()));
-            } catch(KeyNotFound&) {
-                // No "labels". So no operation.
+    /** Append a block of rows to the DataTable_. Row i of depRows corresponds
+    to entry i of indRows. Either all rows are appended or, if any row is 
+    invalid, none are.
+
+    \throws IncorrectNumRows If the number of rows in depRows does not match
+                             the number of entries in indRows.
+    \throws IncorrectNumColumns If depRows has the wrong number of columns.
+    \throws InvalidRow If any row is invalid. Validity of the rows added is
+                       decided by the derived class.                          */
+    void appendRows(const std::vector<ETX>& indRows,
+                    const SimTK::Matrix_<ETY>& depRows) {
+        OPENSIM_THROW_IF(indRows.size() != static_cast<size_t>(depRows.nrow()),
+                         IncorrectNumRows,
+                         indRows.size(),
+                         static_cast<size_t>(depRows.nrow()));
+        if(indRows.empty())
+            return;
+        validateNumColumns(static_cast<size_t>(depRows.ncol()));
+
+        const size_t first = _indData.size();
+        reserve(first + indRows.size());
+        try {
+            for(size_t i = 0; i < indRows.size(); ++i) {
+                validateRow(_indData.size(), indRows[i], 
+                            depRows.row(static_cast<int>(i)));
+                _indData.push_back(indRows[i]);
             }
-            _depData.resize(1, depRow.size());
-        } else
-            _depData.resizeKeep(_depData.nrow() + 1, _depData.ncol());
-            
-        _depData.updRow(_depData.nrow() - 1) = depRow;
+        } catch(...) {
+            _indData.resize(first);
+            throw;
+        }
+        growDependentsToCapacity(depRows.ncol());
+
+        _depData.updBlock(static_cast<int>(first), 0, 
+                          depRows.nrow(), depRows.ncol()) = depRows;
+    }
+
+    /** Reserve storage for at least the given number of rows, so that rows
+    can be appended up to that number without reallocating.                   */
+    void reserve(size_t numRows) {
+        _indData.reserve(numRows);
+        if(_depData.ncol() != 0)
+            growDependentsToCapacity(_depData.ncol());
+    }
+
+    /** Get the number of rows the DataTable_ can hold without reallocating.   */
+    size_t getCapacity() const {
+        return _indData.capacity();
+    }
+
+    /** Release storage reserved for rows that have not been appended.        */
+    void shrink_to_fit() {
+        _indData.shrink_to_fit();
+        if(_depData.ncol() != 0)
+            _depData.resizeKeep(static_cast<int>(_indData.size()),
+                                _depData.ncol());
     }
 
     /** Get row at index.                                                     
@@ -308,7 +373,25 @@ public:
         OPENSIM_THROW_IF(isColumnIndexOutOfRange(index),
                          ColumnIndexOutOfRange, index, 0,
                          static_cast<size_t>(_depData.ncol()));
-        return _depData.col(index);
+        // Exclude rows reserved but not yet appended.
+        return _depData.col(static_cast<int>(index))
+                       (0, static_cast<int>(_indData.size()));
+    }
+
+    /** Get the dependent columns as a matrix with one row per row of the
+    table. The view refers to the table's storage and is invalidated by
+    appending rows, reserve() and shrink_to_fit().                           */
+    MatrixView getMatrix() const {
+        return _depData.block(0, 0, static_cast<int>(_indData.size()),
+                              _depData.ncol());
+    }
+
+    /** Update the dependent columns as a matrix with one row per row of the
+    table. The view refers to the table's storage and is invalidated by
+    appending rows, reserve() and shrink_to_fit().                           */
+    MatrixView updMatrix() {
+        return _depData.updBlock(0, 0, static_cast<int>(_indData.size()),
+                                 _depData.ncol());
     }
 
     /** Set independent column at index.                                      
@@ -334,7 +417,7 @@ protected:
 
     /** Get number of rows.                                                   */
     size_t implementGetNumRows() const override {
-        return _depData.nrow();
+        return _indData.size();
     }
 
     /** Get number of columns.                                                */
@@ -398,6 +481,44 @@ protected:
         // No operation.
     }
 
+    /** Check the number of columns of rows being appended against the 
+    existing rows, or against the "labels" of the dependent columns for the
+    first row.
+
+    \throws IncorrectNumColumns If the number of columns is incorrect.      */
+    void validateNumColumns(size_t numColumns) const {
+        if(_depData.ncol() != 0) {
+            OPENSIM_THROW_IF(numColumns != static_cast<size_t>(_depData.ncol()),
+                             IncorrectNumColumns,
+                             static_cast<size_t>(_depData.ncol()), 
+                             numColumns);
+            return;
+        }
+        try {
+            auto& labels = 
+                _dependentsMetaData.getValueArrayForKey("labels");
+            OPENSIM_THROW_IF(numColumns != labels.size(),
+                             IncorrectNumColumns, 
+                             labels.size(), 
+                             numColumns);
+        } catch(KeyNotFound&) {
+            // No "labels". So no operation.
+        }
+    }
+
+    /** Make the matrix of dependent columns as tall as the capacity of the 
+    independent column. The rows past the number of rows in the table are
+    storage for rows yet to be appended.                                      */
+    void growDependentsToCapacity(int numColumns) {
+        const int capacity = static_cast<int>(_indData.capacity());
+        if(_depData.ncol() == 0)
+            _depData.resize(capacity, numColumns);
+        else if(_depData.nrow() < capacity)
+            _depData.resizeKeep(capacity, _depData.ncol());
+    }
+
+    // The matrix of dependent columns may have more rows than the table; the
+    // number of rows in the table is the size of the independent column.
     std::vector<ETX>    _indData;
     SimTK::Matrix_<ETY> _depData;
 };  // DataTable_
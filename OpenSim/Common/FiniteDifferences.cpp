@@ -0,0 +1,101 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  FiniteDifferences.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "FiniteDifferences.h"
+#include "Exception.h"
+#include <string>
+
+using namespace OpenSim;
+using SimTK::Vector;
+using SimTK::Matrix;
+
+//=============================================================================
+// DERIVATIVES
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Perturb each parameter in turn, evaluating f on one copy of the State.
+ */
+int FiniteDifferences::calcJacobian(const SimTK::State& s,
+    const Function& f, Scheme aScheme, const Vector& x, const double* dx,
+    Matrix& rJacobian, Vector* rF0)
+{
+    const int nx = x.size();
+    const int nf = rJacobian.nrow();
+    if(nx <= 0 || nf <= 0) return -1;
+    if(rJacobian.ncol() != nx)
+        throw Exception("FiniteDifferences::calcJacobian: the Jacobian has " +
+            std::to_string(rJacobian.ncol()) + " columns but there are " +
+            std::to_string(nx) + " parameters.", __FILE__, __LINE__);
+
+    SimTK::State workState = s;
+    Vector xp = x;
+    Vector f0(nf), fp(nf), fb(nf);
+    if(aScheme == ForwardDifference) {
+        int status = f(workState, x, f0);
+        if(status < 0) return status;
+        if(rF0 != NULL) *rF0 = f0;
+    }
+
+    for(int p=0; p<nx; ++p) {
+        // PERTURB FORWARD
+        xp[p] = x[p] + dx[p];
+        int status = f(workState, xp, fp);
+
+        // PERTURB BACKWARD
+        if(status >= 0 && aScheme == CentralDifference) {
+            xp[p] = x[p] - dx[p];
+            status = f(workState, xp, fb);
+        }
+        xp[p] = x[p];
+        if(status < 0) return status;
+
+        // DERIVATIVES
+        const Vector& base = (aScheme==CentralDifference) ? fb : f0;
+        const double rdx = (aScheme==CentralDifference) ?
+            0.5 / dx[p] : 1.0 / dx[p];
+        for(int j=0; j<nf; ++j)
+            rJacobian(j, p) = rdx*(fp[j] - base[j]);
+    }
+    return 0;
+}
+
+int FiniteDifferences::calcGradient(const SimTK::State& s,
+    const ScalarFunction& f, Scheme aScheme, const Vector& x,
+    const double* dx, Vector& rGradient)
+{
+    const int nx = x.size();
+    if(nx <= 0) return -1;
+
+    Function vectorFunction =
+        [&f](SimTK::State& ws, const Vector& xp, Vector& fp) {
+            return f(ws, xp, fp[0]);
+        };
+    Matrix jacobian(1, nx);
+    int status = calcJacobian(s, vectorFunction, aScheme, x, dx, jacobian);
+    if(status < 0) return status;
+    for(int p=0; p<nx; ++p) rGradient[p] = jacobian(0, p);
+    return status;
+}
@@ -0,0 +1,92 @@
+#ifndef OPENSIM_FINITE_DIFFERENCES_H_
+#define OPENSIM_FINITE_DIFFERENCES_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  FiniteDifferences.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "SimTKcommon.h"
+#include <functional>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Computes Jacobians and gradients of functions of a set of parameters by
+ * finite differences, evaluating the functions on a copy of a State so that
+ * the State passed in is left as it was.
+ */
+class OSIMCOMMON_API FiniteDifferences {
+//=============================================================================
+// DATA
+//=============================================================================
+public:
+    /** Finite-difference schemes. Forward differences take one evaluation
+    per parameter plus one at the unperturbed parameters; central
+    differences take two evaluations per parameter and are second-order
+    accurate. */
+    enum Scheme {
+        ForwardDifference,
+        CentralDifference
+    };
+
+    /** A vector function of the parameters x, evaluated using the State s as
+    a workspace. Return a negative status to signal an error. */
+    typedef std::function<int(SimTK::State& s, const SimTK::Vector& x,
+                              SimTK::Vector& f)> Function;
+
+    /** A scalar function of the parameters x, evaluated using the State s as
+    a workspace. Return a negative status to signal an error. */
+    typedef std::function<int(SimTK::State& s, const SimTK::Vector& x,
+                              double& f)> ScalarFunction;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+    /** Compute the Jacobian of f with respect to x.
+    @param s State from which the workspace is copied; it is not modified.
+    @param f The function.
+    @param aScheme The finite-difference scheme.
+    @param x The parameters.
+    @param dx Perturbation size for each parameter.
+    @param rJacobian Must be sized (number of functions) x (number of
+    parameters).
+    @param rF0 If not NULL and aScheme is ForwardDifference, set to f(x).
+    @return -1 if an error is encountered, 0 otherwise. */
+    static int calcJacobian(const SimTK::State& s, const Function& f,
+        Scheme aScheme, const SimTK::Vector& x, const double* dx,
+        SimTK::Matrix& rJacobian, SimTK::Vector* rF0=NULL);
+
+    /** Compute the gradient of a scalar function with respect to x.
+    rGradient must be sized to the number of parameters. */
+    static int calcGradient(const SimTK::State& s, const ScalarFunction& f,
+        Scheme aScheme, const SimTK::Vector& x, const double* dx,
+        SimTK::Vector& rGradient);
+
+//=============================================================================
+};  // END of class FiniteDifferences
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_FINITE_DIFFERENCES_H_
@@ -174,6 +174,21 @@ double Function::calcDerivative(const std::vector<int>& derivComponents, const V
     return _function->calcDerivative(derivComponents, x);
 }
 
+void Function::calcValueAndDerivatives(double x, double& rValue,
+    double& rFirstDerivative, double& rSecondDerivative) const
+{
+    static const std::vector<int> first(1, 0), second(2, 0);
+
+    // A Vector that refers to x, so that no storage is allocated.
+    const Vector xVector(1, &x, true);
+    rValue = calcValue(xVector);
+    const int maxOrder = getMaxDerivativeOrder();
+    rFirstDerivative = (maxOrder >= 1) ?
+        calcDerivative(first, xVector) : SimTK::NaN;
+    rSecondDerivative = (maxOrder >= 2) ?
+        calcDerivative(second, xVector) : SimTK::NaN;
+}
+
 int Function::getArgumentSize() const
 {
     if (_function == NULL)
@@ -120,6 +120,21 @@ public:
      * @param x                the Vector of input arguments.  Its size must equal the value returned by getArgumentSize().
      */
     virtual double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const;
+    /**
+     * Calculate the value and the first and second derivatives of a function
+     * of one argument at a particular point.  This gives the same results as
+     * calcValue() and calcDerivative() with derivComponents {0} and {0, 0},
+     * but functions that must locate x in a table of points (e.g., splines)
+     * override it to do so once rather than three times.
+     *
+     * @param x                  the argument.
+     * @param rValue             the value of the function at x.
+     * @param rFirstDerivative   the first derivative at x.
+     * @param rSecondDerivative  the second derivative at x, or NaN if
+     *                           getMaxDerivativeOrder() is less than 2.
+     */
+    virtual void calcValueAndDerivatives(double x, double& rValue,
+        double& rFirstDerivative, double& rSecondDerivative) const;
     /**
      * Get the number of components expected in the input vector.
      */
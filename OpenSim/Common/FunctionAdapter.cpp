@@ -52,7 +52,19 @@ double FunctionAdapter::calcDerivative(const std::vector<int>& derivComponents,
 }
 
 double FunctionAdapter::calcDerivative(const SimTK::Array_<int>& derivComponents, const SimTK::Vector& x) const{
-    std::vector<int> dcs(derivComponents.begin(), derivComponents.end());
+    // Simbody asks for derivatives of functions of one argument (e.g., the
+    // functions of a CustomJoint) on every realization, so these are passed
+    // on without copying derivComponents.
+    static const std::vector<int> first(1, 0), second(2, 0);
+    const int order = (int)derivComponents.size();
+    if (order == 1 && derivComponents[0] == 0)
+        return _function.calcDerivative(first, x);
+    if (order == 2 && derivComponents[0] == 0 && derivComponents[1] == 0)
+        return _function.calcDerivative(second, x);
+
+    // Other derivatives reuse storage that belongs to the calling thread.
+    thread_local std::vector<int> dcs;
+    dcs.assign(derivComponents.begin(), derivComponents.end());
     return _function.calcDerivative(dcs, x);
 }
 
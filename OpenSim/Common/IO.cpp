@@ -30,6 +30,9 @@
 #include "osimCommonDLL.h"
 #include <time.h>
 #include <math.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <string>
 #include <climits>
 
@@ -58,6 +61,10 @@ using namespace OpenSim;
 using namespace std;
 
 // STATICS
+// The number output format of the calling thread, if it has one (see
+// IO::ThreadPrecision), else NULL.
+static thread_local const IO::NumberFormat *ThreadFormat = NULL;
+
 bool IO::_Scientific = false;
 bool IO::_GFormatForDoubleOutput = false;
 int IO::_Pad = 8;
@@ -240,6 +247,7 @@ SetPrecision(int aPrecision)
 int IO::
 GetPrecision()
 {
+    if(ThreadFormat) return(ThreadFormat->precision);
     return(_Precision);
 }
 
@@ -267,9 +275,118 @@ GetPrecision()
 const char* IO::
 GetDoubleOutputFormat()
 {
+    if(ThreadFormat) return(ThreadFormat->doubleFormat);
     return(_DoubleFormat);
 }
 
+//_____________________________________________________________________________
+/**
+ * Format a number of type double with the given output parameters (see
+ * IO::FormatDouble()).
+ */
+static int
+formatDouble(double aValue,char *rBuffer,int aBufferSize,bool aGFormat,
+             bool aScientific,int aPad,int aPrecision,
+             const char *aDoubleFormat)
+{
+    static const double Pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+                                    1e15 };
+    // Below 2^40, the error in scaling by a power of 10 is less than 2^-13,
+    // so the scaled number rounds as the exact one does unless it is within
+    // that distance of halfway between two integers.
+    static const double MaxScaled = 1099511627776.0;
+
+    if(!aGFormat && !aScientific && aPrecision<=15 &&
+       aValue==aValue && fabs(aValue)<=MaxScaled) {
+        double scaled = fabs(aValue)*Pow10[aPrecision];
+        double whole = floor(scaled);
+        double fraction = scaled - whole;
+        if(scaled<MaxScaled && fabs(fraction-0.5)>1e-3) {
+            unsigned long long n = (unsigned long long)whole;
+            if(fraction>0.5) n++;
+
+            // Digits in reverse order, with at least one before the point.
+            char digits[32];
+            int nDigits = 0;
+            do { digits[nDigits++] = (char)('0' + n%10);  n /= 10; } while(n>0);
+            while(nDigits<aPrecision+1) digits[nDigits++] = '0';
+
+            bool negative = std::signbit(aValue);
+            int length = (negative?1:0) + nDigits + (aPrecision>0?1:0);
+            int width = (aPad<0) ? 0 : aPad+aPrecision;
+            int nPad = (width>length) ? width-length : 0;
+            if(nPad+length<aBufferSize) {
+                char *p = rBuffer;
+                for(int i=0;i<nPad;i++) *p++ = ' ';
+                if(negative) *p++ = '-';
+                for(int i=nDigits-1;i>=0;i--) {
+                    *p++ = digits[i];
+                    if(i==aPrecision && aPrecision>0) *p++ = '.';
+                }
+                *p = '\0';
+                return(nPad+length);
+            }
+        }
+    }
+
+    return(snprintf(rBuffer,aBufferSize,aDoubleFormat,aValue));
+}
+//_____________________________________________________________________________
+/**
+ * Format a number of type double as the current output format does (see
+ * GetDoubleOutputFormat()), producing the same text as sprintf().
+ *
+ * Fixed point output of numbers of moderate size, the common case when
+ * writing results, is formatted directly from the number's digits, which is
+ * several times faster than sprintf(). Other numbers, and the rare numbers
+ * whose last digit cannot be rounded reliably without sprintf()'s exact
+ * arithmetic, are passed to sprintf().
+ *
+ * @param aValue Number to format.
+ * @param rBuffer Buffer to which to write the null-terminated text.
+ * @param aBufferSize Size of rBuffer.
+ * @return Number of characters written, not including the terminating null,
+ * or a negative number on error.
+ */
+int IO::
+FormatDouble(double aValue,char *rBuffer,int aBufferSize)
+{
+    if(ThreadFormat) return(FormatDouble(aValue,rBuffer,aBufferSize,*ThreadFormat));
+    return(formatDouble(aValue,rBuffer,aBufferSize,_GFormatForDoubleOutput,
+                        _Scientific,_Pad,_Precision,_DoubleFormat));
+}
+//_____________________________________________________________________________
+/**
+ * Get the current number output format, to format numbers with later.
+ */
+IO::NumberFormat IO::
+GetNumberFormat()
+{
+    if(ThreadFormat) return(*ThreadFormat);
+    NumberFormat format;
+    format.gFormat = _GFormatForDoubleOutput;
+    format.scientific = _Scientific;
+    format.pad = _Pad;
+    format.precision = _Precision;
+    strncpy(format.doubleFormat,_DoubleFormat,sizeof(format.doubleFormat)-1);
+    format.doubleFormat[sizeof(format.doubleFormat)-1] = '\0';
+    return(format);
+}
+//_____________________________________________________________________________
+/**
+ * Format a number of type double as aFormat does, producing the same text
+ * as FormatDouble() did when aFormat was the current output format.
+ */
+int IO::
+FormatDouble(double aValue,char *rBuffer,int aBufferSize,
+             const NumberFormat &aFormat)
+{
+    return(formatDouble(aValue,rBuffer,aBufferSize,aFormat.gFormat,
+                        aFormat.scientific,aFormat.pad,aFormat.precision,
+                        aFormat.doubleFormat));
+}
+
 //_____________________________________________________________________________
 /**
  * Construct a valid output format for numbers of type double.
@@ -278,25 +395,53 @@ GetDoubleOutputFormat()
  *
  * @see SetScientific(), SetDigitsPad, SetPrecision.
  */
-void IO::
-ConstructDoubleOutputFormat()
-{
-    if(_GFormatForDoubleOutput) {
-        sprintf(_DoubleFormat,"%%g");
-    } else if(_Scientific) {
-        if(_Pad<0) {
-            sprintf(_DoubleFormat,"%%.%dle",_Precision);
+static void
+constructDoubleFormat(char *rFormat,bool aGFormat,bool aScientific,int aPad,
+                      int aPrecision)
+{
+    if(aGFormat) {
+        sprintf(rFormat,"%%g");
+    } else if(aScientific) {
+        if(aPad<0) {
+            sprintf(rFormat,"%%.%dle",aPrecision);
         } else {
-            sprintf(_DoubleFormat,"%%%d.%dle",_Pad+_Precision,_Precision);
+            sprintf(rFormat,"%%%d.%dle",aPad+aPrecision,aPrecision);
         }
     } else {
-        if(_Pad<0) {
-            sprintf(_DoubleFormat,"%%.%dlf",_Precision);
+        if(aPad<0) {
+            sprintf(rFormat,"%%.%dlf",aPrecision);
         } else {
-            sprintf(_DoubleFormat,"%%%d.%dlf",_Pad+_Precision,_Precision);
+            sprintf(rFormat,"%%%d.%dlf",aPad+aPrecision,aPrecision);
         }
     }
 }
+void IO::
+ConstructDoubleOutputFormat()
+{
+    constructDoubleFormat(_DoubleFormat,_GFormatForDoubleOutput,_Scientific,
+                          _Pad,_Precision);
+}
+
+//_____________________________________________________________________________
+/**
+ * Use aPrecision, with the other output parameters in effect, for the
+ * numbers output by the calling thread until this object is destroyed.
+ */
+IO::ThreadPrecision::
+ThreadPrecision(int aPrecision) :
+    _previous(ThreadFormat)
+{
+    _format = GetNumberFormat();
+    _format.precision = aPrecision<0 ? 0 : aPrecision;
+    constructDoubleFormat(_format.doubleFormat,_format.gFormat,
+                          _format.scientific,_format.pad,_format.precision);
+    ThreadFormat = &_format;
+}
+IO::ThreadPrecision::
+~ThreadPrecision()
+{
+    ThreadFormat = _previous;
+}
 
 //=============================================================================
 // Object printing
@@ -480,6 +625,21 @@ makeDir(const string &aDirName)
 #endif
 }
 //_____________________________________________________________________________
+/**
+ * Remove an empty directory. Potentially platform dependent.
+  * @return int 0 on success, error condition otherwise
+*/
+int IO::
+removeDir(const string &aDirName)
+{
+
+#if defined __linux__ || defined __APPLE__
+    return rmdir(aDirName.c_str());
+#else
+    return _rmdir(aDirName.c_str());
+#endif
+}
+//_____________________________________________________________________________
 /**
  * Change working directory. Potentially platform dependent.
   * @return int 0 on success, error condition otherwise
@@ -532,6 +692,24 @@ getParentDirectory(const string& fileName)
 
     return result;
 }
+//_____________________________________________________________________________
+/**
+ * Get the path of a file named relative to a directory, such as the parent
+ * directory of the file that refers to it, without changing the working
+ * directory. The directory, if not empty, ends with a separator as returned
+ * by getParentDirectory().
+ * @return fileName if it is empty or absolute, else directory + fileName
+*/
+string IO::
+resolvePath(const string& fileName, const string& directory)
+{
+    const bool isAbsolute = !fileName.empty() &&
+        (fileName[0] == '/' || fileName[0] == '\\' ||
+         (fileName.size() > 1 && fileName[1] == ':'));
+    if (fileName.empty() || isAbsolute)
+        return fileName;
+    return directory + fileName;
+}
 
 //_____________________________________________________________________________
 /**
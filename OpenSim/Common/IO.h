@@ -84,6 +84,37 @@ public:
     static int GetPrecision();
     static const char*
         GetDoubleOutputFormat();
+    static int FormatDouble(double aValue,char *rBuffer,int aBufferSize);
+#ifndef SWIG
+    /** The number output format in effect at one time, so that numbers can
+    be formatted with it later, e.g. on another thread, even if the format
+    has been changed since. */
+    struct NumberFormat {
+        bool gFormat;
+        bool scientific;
+        int pad;
+        int precision;
+        char doubleFormat[32];
+    };
+    static NumberFormat GetNumberFormat();
+    static int FormatDouble(double aValue,char *rBuffer,int aBufferSize,
+                            const NumberFormat &aFormat);
+    /** While an object of this class exists, numbers output by the thread
+    that created it have its precision rather than the one set by
+    SetPrecision(), so that, e.g., tools running on different threads write
+    their results with their own precision. Objects are destroyed in the
+    reverse order of their creation on a thread. */
+    class OSIMCOMMON_API ThreadPrecision {
+    public:
+        explicit ThreadPrecision(int aPrecision);
+        ~ThreadPrecision();
+    private:
+        ThreadPrecision(const ThreadPrecision&);
+        ThreadPrecision& operator=(const ThreadPrecision&);
+        NumberFormat _format;
+        const NumberFormat *_previous;
+    };
+#endif
 private:
     static void ConstructDoubleOutputFormat();
 
@@ -103,9 +134,11 @@ public:
 #endif
     // Directory management
     static int makeDir(const std::string &aDirName);
+    static int removeDir(const std::string &aDirName);
     static int chDir(const std::string &aDirName);
     static std::string getCwd();
     static std::string getParentDirectory(const std::string& fileName);
+    static std::string resolvePath(const std::string& fileName, const std::string& directory);
     static std::string GetFileNameFromURI(const std::string& aURI);
     static std::string formatText(const std::string& aComment,const std::string& leadingWhitespace,int width,const std::string& endlineTokenToInsert="\n");
 
@@ -54,6 +54,61 @@ void StreamLogCallback::log(const std::string &str)
     *_out << str << std::flush;
 }
 
+//=============================================================================
+// AsynchronousLogCallback
+//=============================================================================
+AsynchronousLogCallback::AsynchronousLogCallback(const std::string &filename)
+    : _out(new std::ofstream(filename.c_str())), _writing(false), _done(false)
+{
+    _thread = std::thread(&AsynchronousLogCallback::writeMessages, this);
+}
+
+AsynchronousLogCallback::~AsynchronousLogCallback()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+    }
+    _queued.notify_one();
+    _thread.join();
+    delete _out;
+}
+
+void AsynchronousLogCallback::log(const std::string &str)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(str);
+    }
+    _queued.notify_one();
+}
+
+void AsynchronousLogCallback::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _written.wait(lock, [this] { return _queue.empty() && !_writing; });
+}
+
+void AsynchronousLogCallback::writeMessages()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(true) {
+        _queued.wait(lock, [this] { return _done || !_queue.empty(); });
+        if(_queue.empty()) break; // done, and everything has been written
+
+        // Write everything queued so far without holding the lock.
+        std::deque<std::string> messages;
+        messages.swap(_queue);
+        _writing = true;
+        lock.unlock();
+        for(const std::string& message : messages) *_out << message;
+        _out->flush();
+        lock.lock();
+        _writing = false;
+        _written.notify_all();
+    }
+}
+
 //=============================================================================
 // LogBuffer
 //=============================================================================
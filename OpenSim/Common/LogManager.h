@@ -25,8 +25,12 @@
 #include "osimCommonDLL.h"
 #include "Array.h"
 #include "LogCallback.h"
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 namespace OpenSim {
 
@@ -46,6 +50,45 @@ public:
     void log(const std::string &aStr) override;
 };
 
+/// @endcond
+
+/** A LogCallback that writes to a file on a background thread, so that the
+thread logging a message does not wait for the file to be written. Messages
+are written in the order they are logged; all of them have been written when
+flush() returns or the callback is destroyed. Add it to LogManager::out or
+LogManager::err, e.g.
+
+@code
+    LogManager::out.addLogCallback(new AsynchronousLogCallback("cmc.log"));
+@endcode
+
+On Windows, remove and delete the callback before main() returns, since
+a thread cannot be joined while the library is being unloaded. */
+class OSIMCOMMON_API AsynchronousLogCallback : public LogCallback
+{
+private:
+    std::ostream *_out;
+    std::deque<std::string> _queue;
+    bool _writing;
+    bool _done;
+    std::mutex _mutex;
+    std::condition_variable _queued;
+    std::condition_variable _written;
+    std::thread _thread;
+
+public:
+    AsynchronousLogCallback(const std::string &aFilename);
+    ~AsynchronousLogCallback();
+    void log(const std::string &aStr) override;
+    /** Wait until all logged messages have been written to the file. */
+    void flush();
+
+private:
+    void writeMessages();
+};
+
+// Excluding this from Doxygen until it has better documentation! -Sam Hamner
+/// @cond
 
 class OSIMCOMMON_API LogBuffer : public std::stringbuf
 {
@@ -0,0 +1,113 @@
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  Logger.cpp                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "Logger.h"
+#include "Exception.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+
+using namespace OpenSim;
+
+// The initial level, from the OPENSIM_LOG_LEVEL environment variable if set.
+static int getInitialLevel()
+{
+    const char* levelName = std::getenv("OPENSIM_LOG_LEVEL");
+    if (levelName != nullptr) {
+        std::string name(levelName);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        for (int i = 0; i <= static_cast<int>(Logger::Level::Trace); ++i) {
+            if (name == Logger::getLevelName(static_cast<Logger::Level>(i)))
+                return i;
+        }
+    }
+    return static_cast<int>(Logger::Level::Info);
+}
+
+std::atomic<int> Logger::_level(getInitialLevel());
+
+// Serializes writing messages so that lines from different threads are not
+// interleaved.
+static std::mutex& getLogMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+//=============================================================================
+// LEVEL
+//=============================================================================
+void Logger::setLevel(Level level)
+{
+    _level.store(static_cast<int>(level));
+}
+
+Logger::Level Logger::getLevel()
+{
+    return static_cast<Level>(_level.load());
+}
+
+void Logger::setLevel(const std::string& levelName)
+{
+    std::string name(levelName);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    for (int i = 0; i <= static_cast<int>(Level::Trace); ++i) {
+        if (name == getLevelName(static_cast<Level>(i))) {
+            setLevel(static_cast<Level>(i));
+            return;
+        }
+    }
+    throw Exception("Logger::setLevel: unknown log level '" + levelName +
+                    "'.", __FILE__, __LINE__);
+}
+
+const char* Logger::getLevelName(Level level)
+{
+    switch (level) {
+    case Level::Off:   return "off";
+    case Level::Error: return "error";
+    case Level::Warn:  return "warn";
+    case Level::Info:  return "info";
+    case Level::Debug: return "debug";
+    case Level::Trace: return "trace";
+    }
+    return "unknown";
+}
+
+//=============================================================================
+// LOGGING
+//=============================================================================
+void Logger::log(Level level, const std::string& message)
+{
+    if (level == Level::Off || !shouldLog(level))
+        return;
+
+    std::lock_guard<std::mutex> lock(getLogMutex());
+    std::ostream& out = level == Level::Error ? std::cerr : std::cout;
+    out << message << std::endl;
+}
@@ -0,0 +1,105 @@
+#ifndef OPENSIM_LOGGER_H_
+#define OPENSIM_LOGGER_H_
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  Logger.h                              *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <atomic>
+#include <sstream>
+#include <string>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Leveled logging for diagnostics that are printed from inside loops over
+ * frames, integration steps or optimizer iterations. Use the OPENSIM_LOG_*
+ * macros rather than Logger::log(): a macro tests the level before it
+ * evaluates or formats any of its message, so a disabled message costs a
+ * single atomic load.
+ *
+ * @code
+ *     OPENSIM_LOG_INFO("Frame " << i << " (t=" << t << "): RMS=" << rms);
+ * @endcode
+ *
+ * Messages are written to std::cout (Error messages to std::cerr), followed
+ * by a newline, so they reach the callbacks of LogManager, including any
+ * AsynchronousLogCallback writing them to a file. The level is initially
+ * Info, or the value of the OPENSIM_LOG_LEVEL environment variable (off,
+ * error, warn, info, debug or trace).
+ */
+class OSIMCOMMON_API Logger {
+public:
+    enum class Level {
+        Off   = 0,
+        Error = 1,
+        Warn  = 2,
+        Info  = 3,
+        Debug = 4,
+        Trace = 5
+    };
+
+    /** Messages less severe than the given level are discarded. */
+    static void setLevel(Level level);
+    static Level getLevel();
+
+    /** %Set the level from its name (case insensitive). Throws an Exception
+    if the name is not that of a level. */
+    static void setLevel(const std::string& levelName);
+    static const char* getLevelName(Level level);
+
+    /** Whether messages of the given level are written. */
+    static bool shouldLog(Level level) {
+        return static_cast<int>(level) <= _level.load(std::memory_order_relaxed);
+    }
+
+    /** Write a message, if its level is enabled. Messages logged from
+    different threads are not interleaved. */
+    static void log(Level level, const std::string& message);
+
+private:
+    static std::atomic<int> _level;
+};
+
+} // end of namespace OpenSim
+
+/** Log a message at the given Logger::Level (Error, Warn, Info, Debug or
+Trace). The message is a sequence of << operands and is only evaluated if the
+level is enabled. */
+#define OPENSIM_LOG(level, message)                                          \
+    do {                                                                     \
+        if (OpenSim::Logger::shouldLog(OpenSim::Logger::Level::level)) {     \
+            std::ostringstream openSimLogMessage;                            \
+            openSimLogMessage << message;                                    \
+            OpenSim::Logger::log(OpenSim::Logger::Level::level,              \
+                                 openSimLogMessage.str());                   \
+        }                                                                    \
+    } while (false)
+
+#define OPENSIM_LOG_ERROR(message) OPENSIM_LOG(Error, message)
+#define OPENSIM_LOG_WARN(message)  OPENSIM_LOG(Warn, message)
+#define OPENSIM_LOG_INFO(message)  OPENSIM_LOG(Info, message)
+#define OPENSIM_LOG_DEBUG(message) OPENSIM_LOG(Debug, message)
+#define OPENSIM_LOG_TRACE(message) OPENSIM_LOG(Trace, message)
+
+#endif // OPENSIM_LOGGER_H_
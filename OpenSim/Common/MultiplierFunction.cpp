@@ -182,6 +182,21 @@ double MultiplierFunction::calcValue(const SimTK::Vector& x) const
     }
 }
 
+void MultiplierFunction::calcValueAndDerivatives(double x, double& rValue,
+    double& rFirstDerivative, double& rSecondDerivative) const
+{
+    if (_osFunction) {
+        _osFunction->calcValueAndDerivatives(x, rValue, rFirstDerivative,
+                                             rSecondDerivative);
+        rValue *= _scale;
+        rFirstDerivative *= _scale;
+        rSecondDerivative *= _scale;
+    }
+    else {
+        throw Exception("MultiplierFunction::calcValueAndDerivatives(): _osFunction is NULL.");
+    }
+}
+
 int MultiplierFunction::getArgumentSize() const
 {
     if (_osFunction)
@@ -54,7 +54,10 @@ const double OptimizationTarget::SMALLDX = 1.0e-14;
  * @param aNX The number of controls.
  */
 OptimizationTarget::
-OptimizationTarget(int aNX)
+OptimizationTarget(int aNX) :
+    _differenceScheme(FiniteDifferences::CentralDifference),
+    _numObjectiveEvaluations(0),
+    _numGradientEvaluations(0)
 {
     if(aNX>0) setNumParameters(aNX); // OptimizerSystem
 }
@@ -130,6 +133,46 @@ getDXArray()
     return &_dx[0];
 }
 
+//------------------------------------------------------------------------------
+// DIFFERENCE SCHEME
+//------------------------------------------------------------------------------
+//______________________________________________________________________________
+/**
+ * Set the finite-difference scheme used by targets that compute their
+ * derivatives with FiniteDifferences.
+ */
+void OptimizationTarget::
+setDifferenceScheme(FiniteDifferences::Scheme aScheme)
+{
+    _differenceScheme = aScheme;
+}
+//______________________________________________________________________________
+/**
+ * Get the finite-difference scheme.
+ */
+FiniteDifferences::Scheme OptimizationTarget::
+getDifferenceScheme() const
+{
+    return _differenceScheme;
+}
+
+//==============================================================================
+// EVALUATION COUNTS
+//==============================================================================
+//______________________________________________________________________________
+/**
+ * Reset the numbers of objective and gradient evaluations to zero, e.g.,
+ * before each optimization, so that the counts measure the work of a single
+ * optimization. For gradient-based optimizers the number of gradient
+ * evaluations approximates the number of iterations.
+ */
+void OptimizationTarget::
+resetEvaluationCounts()
+{
+    _numObjectiveEvaluations = 0;
+    _numGradientEvaluations = 0;
+}
+
 //==============================================================================
 // UTILITY
 //==============================================================================
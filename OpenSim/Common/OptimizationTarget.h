@@ -33,6 +33,7 @@
 //=============================================================================
 #include "osimCommonDLL.h"
 #include "Array.h"
+#include "FiniteDifferences.h"
 #include <simmath/Optimizer.h>
 
 
@@ -58,6 +59,14 @@ public:
 protected:
     /** Perturbation size for computing numerical derivatives. */
     Array<double> _dx;
+    /** Scheme used by targets that differentiate with FiniteDifferences. */
+    FiniteDifferences::Scheme _differenceScheme;
+    /** Number of evaluations of the objective function since the counts
+    were last reset. Derived classes increment it in objectiveFunc(). */
+    mutable int _numObjectiveEvaluations;
+    /** Number of evaluations of the gradient since the counts were last
+    reset. Derived classes increment it in gradientFunc(). */
+    mutable int _numGradientEvaluations;
 
 //=============================================================================
 // METHODS
@@ -71,6 +80,13 @@ public:
     void setDX(int aIndex,double aVal);
     double getDX(int aIndex);
     double* getDXArray();
+    void setDifferenceScheme(FiniteDifferences::Scheme aScheme);
+    FiniteDifferences::Scheme getDifferenceScheme() const;
+
+    // EVALUATION COUNTS
+    void resetEvaluationCounts();
+    int getNumObjectiveEvaluations() const { return _numObjectiveEvaluations; }
+    int getNumGradientEvaluations() const { return _numGradientEvaluations; }
 
     // UTILITY
     void validatePerturbationSize(double &aSize);
@@ -58,7 +58,8 @@ PiecewiseLinearFunction::~PiecewiseLinearFunction()
  */
 PiecewiseLinearFunction::PiecewiseLinearFunction() :
     _x(_propX.getValueDblArray()),
-    _y(_propY.getValueDblArray())
+    _y(_propY.getValueDblArray()),
+    _lastSegment(0)
 {
     setNull();
 }
@@ -69,7 +70,8 @@ PiecewiseLinearFunction::PiecewiseLinearFunction(int aN,const double *aX,const d
     const string &aName) :
     _x(_propX.getValueDblArray()),
     _y(_propY.getValueDblArray()),
-   _b(0.0)
+   _b(0.0),
+   _lastSegment(0)
 {
     setNull();
 
@@ -111,7 +113,8 @@ PiecewiseLinearFunction::PiecewiseLinearFunction(const PiecewiseLinearFunction &
     Function(aFunction),
     _x(_propX.getValueDblArray()),
     _y(_propY.getValueDblArray()),
-   _b(0.0)
+   _b(0.0),
+   _lastSegment(0)
 {
     setEqual(aFunction);
 }
@@ -445,19 +448,7 @@ double PiecewiseLinearFunction::calcValue(const Vector& x) const
     else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
         return _y[n-1];
 
-    // Do a binary search to find which two points the abscissa is between.
-    int k, i = 0;
-    int j = n;
-    while (1)
-    {
-        k = (i+j)/2;
-        if (aX < _x[k])
-            j = k;
-        else if (aX > _x[k+1])
-            i = k;
-        else
-            break;
-    }
+    int k = findSegment(aX);
 
     return _y[k] + (aX - _x[k]) * _b[k];
 }
@@ -488,8 +479,56 @@ double PiecewiseLinearFunction::calcDerivative(const std::vector<int>& derivComp
         return _b[n-1];
     }
 
+    int k = findSegment(aX);
+
+    return _b[k];
+}
+
+void PiecewiseLinearFunction::calcValueAndDerivatives(double aX,
+    double& rValue, double& rFirstDerivative, double& rSecondDerivative) const
+{
+    int n = _x.getSize();
+
+    // The same cases as calcValue() and calcDerivative(), with the abscissa
+    // located once.
+    if (aX < _x[0]) {
+        rValue = _y[0] + (aX - _x[0]) * _b[0];
+        rFirstDerivative = _b[0];
+    } else if (aX > _x[n-1]) {
+        rValue = _y[n-1] + (aX - _x[n-1]) * _b[n-1];
+        rFirstDerivative = _b[n-1];
+    } else if (EQUAL_WITHIN_ERROR(aX, _x[0])) {
+        rValue = _y[0];
+        rFirstDerivative = _b[0];
+    } else if (EQUAL_WITHIN_ERROR(aX,_x[n-1])) {
+        rValue = _y[n-1];
+        rFirstDerivative = _b[n-1];
+    } else {
+        int k = findSegment(aX);
+        rValue = _y[k] + (aX - _x[k]) * _b[k];
+        rFirstDerivative = _b[k];
+    }
+    rSecondDerivative = 0.0;
+}
+
+//_____________________________________________________________________________
+/**
+ * Find the segment [x[k], x[k+1]] of the knot sequence that contains aX,
+ * which must lie strictly between the end points. The segment found by the
+ * previous call is tried before searching.
+ */
+int PiecewiseLinearFunction::findSegment(double aX) const
+{
+    int n = _x.getSize();
+    int k = _lastSegment.load(std::memory_order_relaxed);
+    // Only an abscissa strictly inside the previous segment reuses it; one
+    // at a knot is searched for so that the segment chosen for it, and so
+    // the derivatives at it, do not depend on earlier calls.
+    if (k < n-1 && aX > _x[k] && aX < _x[k+1])
+        return k;
+
     // Do a binary search to find which two points the abscissa is between.
-    int k, i = 0;
+    int i = 0;
     int j = n;
     while (1)
     {
@@ -501,8 +540,8 @@ double PiecewiseLinearFunction::calcDerivative(const std::vector<int>& derivComp
         else
             break;
     }
-
-    return _b[k];
+    _lastSegment.store(k, std::memory_order_relaxed);
+    return k;
 }
 
 int PiecewiseLinearFunction::getArgumentSize() const
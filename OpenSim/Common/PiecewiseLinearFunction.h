@@ -26,6 +26,7 @@
 
 // INCLUDES
 #include "osimCommonDLL.h"
+#include <atomic>
 #include <string>
 #include "Array.h"
 #include "PropertyInt.h"
@@ -67,6 +68,9 @@ protected:
 
 private:
     Array<double> _b;
+    /** The segment in which the previous evaluation found its argument,
+    which is tried first by the next evaluation. */
+    mutable std::atomic<int> _lastSegment;
 
 //=============================================================================
 // METHODS
@@ -119,6 +123,8 @@ public:
     //--------------------------------------------------------------------------
     double calcValue(const SimTK::Vector& x) const override;
     double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const override;
+    void calcValueAndDerivatives(double x, double& rValue,
+        double& rFirstDerivative, double& rSecondDerivative) const override;
     int getArgumentSize() const override;
     int getMaxDerivativeOrder() const override;
     SimTK::Function* createSimTKFunction() const override;
@@ -127,6 +133,7 @@ public:
 
 private:
    void calcCoefficients();
+   int findSegment(double aX) const;
 
 //=============================================================================
 };  // END class PiecewiseLinearFunction
@@ -0,0 +1,409 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ResultCache.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ResultCache.h"
+#include "Exception.h"
+#include "IO.h"
+#include "Object.h"
+#include "PropertySet.h"
+#include "XMLDocument.h"
+#include "OpenSimBuildId.h"
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace OpenSim {
+
+namespace {
+
+// Written at the start of each table.
+const uint32_t TableMagic = 0x4F524331; // "ORC1"
+
+// The version of the format of the tables and of the results in them, which
+// is part of each table's key; change it when either changes.
+const int CacheFormatVersion = 2;
+
+const char* IndexFileName = "index.txt";
+
+#define RESULT_CACHE_STR(var) #var
+#define RESULT_CACHE_MAKE_STRING(a) RESULT_CACHE_STR(a)
+
+// The version of OpenSim (as in OpenSim/version.h) and the sources the
+// libraries were built from, as identified by the build (see
+// cmake/OpenSimBuildId.cmake), so that results are not reused by a build of
+// other sources, e.g. after changing the code of a muscle.
+const char* BuildIdentity =
+    RESULT_CACHE_MAKE_STRING(OSIM_VERSION) " " OSIM_BUILD_ID;
+
+// Size of a table's header, and of a result with no values.
+const uint64_t HeaderBytes = sizeof(uint32_t) + 2*sizeof(uint64_t);
+const uint64_t EntryBytes = sizeof(uint64_t) + sizeof(uint32_t);
+
+// Serializes saving the tables and index of all caches in this process.
+mutex saveMutex;
+
+struct IndexEntry {
+    long long bytes;
+    long long lastUsed;
+};
+
+long long fileSize(const string& fileName)
+{
+    ifstream file(fileName.c_str(), ios::binary | ios::ate);
+    return file ? (long long)file.tellg() : -1;
+}
+
+// Replace fileName with tempFileName, which has been written in full.
+bool replaceFile(const string& tempFileName, const string& fileName)
+{
+    // rename() does not replace an existing file on all platforms.
+    std::remove(fileName.c_str());
+    return std::rename(tempFileName.c_str(), fileName.c_str()) == 0;
+}
+
+std::string hexString(unsigned long long value)
+{
+    char text[17];
+    snprintf(text, sizeof(text), "%016llx", value);
+    return text;
+}
+
+// A suffix for temporary files that no other thread or process writing to the
+// same directory uses.
+std::string tempSuffix()
+{
+    stringstream suffix;
+    suffix << "." << getpid() << "." << this_thread::get_id() << ".tmp";
+    return suffix.str();
+}
+
+} // end of anonymous namespace
+
+//=============================================================================
+// HASH
+//=============================================================================
+ResultCache::Hash::Hash() : _value(14695981039346656037ULL) {}
+
+ResultCache::Hash& ResultCache::Hash::add(const void* data, size_t numBytes)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < numBytes; ++i) {
+        _value ^= bytes[i];
+        _value *= 1099511628211ULL;
+    }
+    return *this;
+}
+
+ResultCache::Hash& ResultCache::Hash::add(const std::string& value)
+{
+    // Include the length, so that consecutive strings hash as a sequence.
+    add((int)value.size());
+    return add(value.data(), value.size());
+}
+
+ResultCache::Hash& ResultCache::Hash::add(int value)
+{
+    const int32_t v = value;
+    return add(&v, sizeof(v));
+}
+
+ResultCache::Hash& ResultCache::Hash::add(double value)
+{
+    // -0 and 0 are the same input.
+    if (value == 0) value = 0;
+    return add(&value, sizeof(value));
+}
+
+ResultCache::Hash& ResultCache::Hash::add(const SimTK::Vector& values)
+{
+    add(values.size());
+    for (int i = 0; i < values.size(); ++i)
+        add(values[i]);
+    return *this;
+}
+
+ResultCache::Hash& ResultCache::Hash::add(const Object& object)
+{
+    XMLDocument doc;
+    SimTK::Xml::Element root = doc.getRootElement();
+    object.updateXMLNode(root);
+    SimTK::String xml;
+    doc.getRootElement().node_begin()->writeToString(xml);
+    return add(std::string(xml));
+}
+
+ResultCache::Hash& ResultCache::Hash::addFile(const std::string& fileName)
+{
+    ifstream file(fileName.c_str(), ios::binary);
+    if (!file)
+        throw Exception("ResultCache: could not read " + fileName + ".",
+                        __FILE__, __LINE__);
+    stringstream contents;
+    contents << file.rdbuf();
+    return add(contents.str());
+}
+
+std::string ResultCache::Hash::toString() const
+{
+    return hexString(_value);
+}
+
+//=============================================================================
+// TABLE
+//=============================================================================
+ResultCache::ResultCache(const std::string& directory, const Hash& key,
+                         double maxMegabytes) :
+    _directory(directory),
+    _key(Hash(key).add(CacheFormatVersion)
+                  .add(XMLDocument::getLatestVersion())
+                  .add(BuildIdentity).getValue()),
+    _maxBytes(maxMegabytes*1024*1024), _modified(false),
+    _numHits(0), _numMisses(0)
+{
+    read();
+}
+
+std::string ResultCache::getFileName() const
+{
+    return _directory + "/" + hexString(_key) + ".orc";
+}
+
+void ResultCache::read()
+{
+    ifstream file(getFileName().c_str(), ios::binary | ios::ate);
+    if (!file) return;
+    const long long fileBytes = (long long)file.tellg();
+    file.seekg(0);
+
+    uint32_t magic = 0;
+    uint64_t key = 0, numResults = 0;
+    file.read((char*)&magic, sizeof(magic));
+    file.read((char*)&key, sizeof(key));
+    file.read((char*)&numResults, sizeof(numResults));
+    if (!file || magic != TableMagic || key != _key) return;
+
+    // Sizes are checked against what is left of the file before anything is
+    // allocated, so that a corrupt table is read as empty.
+    uint64_t bytesLeft = (uint64_t)fileBytes - HeaderBytes;
+    if (numResults > bytesLeft/EntryBytes) file.setstate(ios::failbit);
+    for (uint64_t i = 0; file && i < numResults; ++i) {
+        uint64_t frame = 0;
+        uint32_t size = 0;
+        file.read((char*)&frame, sizeof(frame));
+        file.read((char*)&size, sizeof(size));
+        if (!file) break;
+        bytesLeft -= EntryBytes;
+        if (size > bytesLeft/sizeof(double)) {
+            file.setstate(ios::failbit);
+            break;
+        }
+        bytesLeft -= size*sizeof(double);
+        std::vector<double> values(size);
+        if (size > 0) file.read((char*)&values[0], size*sizeof(double));
+        if (!file) break;
+        _results[frame].swap(values);
+    }
+    if (!file) {
+        cout << "WARNING- ResultCache: " << getFileName()
+             << " is incomplete and will be rewritten." << endl;
+        _results.clear();
+    }
+}
+
+bool ResultCache::find(const Hash& frame, std::vector<double>& values)
+{
+    auto result = _results.find(frame.getValue());
+    if (result == _results.end()) {
+        ++_numMisses;
+        return false;
+    }
+    values = result->second;
+    ++_numHits;
+    return true;
+}
+
+void ResultCache::insert(const Hash& frame, const std::vector<double>& values)
+{
+    _results[frame.getValue()] = values;
+    _modified = true;
+}
+
+void ResultCache::save()
+{
+    if (_results.empty() && !_modified) return;
+    lock_guard<mutex> lock(saveMutex);
+    // Create the directory and any of its parents that do not exist.
+    for (size_t sep = _directory.find_first_of("/\\", 1);
+         sep != string::npos; sep = _directory.find_first_of("/\\", sep + 1))
+        IO::makeDir(_directory.substr(0, sep));
+    IO::makeDir(_directory);
+    const string fileName = getFileName();
+    const string suffix = tempSuffix();
+
+    if (_modified) {
+        const string tempFileName = fileName + suffix;
+        {
+            ofstream file(tempFileName.c_str(), ios::binary);
+            const uint64_t key = _key, numResults = _results.size();
+            file.write((const char*)&TableMagic, sizeof(TableMagic));
+            file.write((const char*)&key, sizeof(key));
+            file.write((const char*)&numResults, sizeof(numResults));
+            for (const auto& result : _results) {
+                const uint64_t frame = result.first;
+                const uint32_t size = (uint32_t)result.second.size();
+                file.write((const char*)&frame, sizeof(frame));
+                file.write((const char*)&size, sizeof(size));
+                if (size > 0)
+                    file.write((const char*)&result.second[0],
+                               size*sizeof(double));
+            }
+            if (!file) {
+                cout << "WARNING- ResultCache: could not write " << fileName
+                     << "; results will not be reused." << endl;
+                file.close();
+                std::remove(tempFileName.c_str());
+                return;
+            }
+        }
+        if (!replaceFile(tempFileName, fileName)) {
+            cout << "WARNING- ResultCache: could not write " << fileName
+                 << "; results will not be reused." << endl;
+            return;
+        }
+        _modified = false;
+    }
+
+    // Merge this table into the index written by other caches, dropping
+    // tables whose files have been removed.
+    const string indexFileName = _directory + "/" + IndexFileName;
+    map<string, IndexEntry> index;
+    {
+        ifstream file(indexFileName.c_str());
+        string name;
+        IndexEntry entry;
+        while (file >> name >> entry.bytes >> entry.lastUsed)
+            index[name] = entry;
+    }
+    const string name = hexString(_key) + ".orc";
+    index[name].lastUsed = (long long)std::time(NULL);
+    long long totalBytes = 0;
+    for (auto entry = index.begin(); entry != index.end();) {
+        entry->second.bytes = fileSize(_directory + "/" + entry->first);
+        if (entry->second.bytes < 0) {
+            entry = index.erase(entry);
+            continue;
+        }
+        totalBytes += entry->second.bytes;
+        ++entry;
+    }
+
+    // Remove the least recently used tables, other than this one, until the
+    // directory is within its limit.
+    while (totalBytes > _maxBytes) {
+        auto oldest = index.end();
+        for (auto entry = index.begin(); entry != index.end(); ++entry)
+            if (entry->first != name && (oldest == index.end() ||
+                    entry->second.lastUsed < oldest->second.lastUsed))
+                oldest = entry;
+        if (oldest == index.end()) break;
+        std::remove((_directory + "/" + oldest->first).c_str());
+        totalBytes -= oldest->second.bytes;
+        index.erase(oldest);
+    }
+    // A table over the limit on its own is not kept.
+    if (totalBytes > _maxBytes) {
+        std::remove(fileName.c_str());
+        index.erase(name);
+        _modified = true;
+    }
+
+    const string tempIndexFileName = indexFileName + suffix;
+    {
+        ofstream file(tempIndexFileName.c_str());
+        for (const auto& entry : index)
+            file << entry.first << " " << entry.second.bytes << " "
+                 << entry.second.lastUsed << "\n";
+    }
+    replaceFile(tempIndexFileName, indexFileName);
+}
+
+void ResultCache::clear(const std::string& directory)
+{
+    lock_guard<mutex> lock(saveMutex);
+    const string indexFileName = directory + "/" + IndexFileName;
+    {
+        ifstream file(indexFileName.c_str());
+        string name;
+        IndexEntry entry;
+        while (file >> name >> entry.bytes >> entry.lastUsed)
+            std::remove((directory + "/" + name).c_str());
+    }
+    std::remove(indexFileName.c_str());
+    IO::removeDir(directory);
+}
+
+//=============================================================================
+// SETTINGS
+//=============================================================================
+ResultCacheSettings::ResultCacheSettings() :
+    _useProp("use_result_cache", true),
+    _directoryProp("result_cache_directory", ""),
+    _sizeLimitProp("result_cache_size_limit", 256.0)
+{
+    _useProp.setComment("Whether to reuse results kept from earlier runs of "
+        "the tool on the same model, data and settings, and keep new results "
+        "for later runs. Set to false to always recompute.");
+    _directoryProp.setComment("Directory in which results are kept between "
+        "runs. If empty, result_cache in the results directory is used.");
+    _sizeLimitProp.setComment("Size, in megabytes, to which the result cache "
+        "directory is limited. The least recently used results are removed "
+        "first.");
+}
+
+void ResultCacheSettings::appendTo(PropertySet& aPropertySet)
+{
+    aPropertySet.append(&_useProp);
+    aPropertySet.append(&_directoryProp);
+    aPropertySet.append(&_sizeLimitProp);
+}
+
+std::string ResultCacheSettings::getPath(const std::string& aResultsDir) const
+{
+    return getDirectory().empty() ? aResultsDir + "/result_cache"
+                                  : getDirectory();
+}
+
+} // end of namespace OpenSim
@@ -0,0 +1,172 @@
+#ifndef OPENSIM_RESULT_CACHE_H_
+#define OPENSIM_RESULT_CACHE_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ResultCache.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "PropertyBool.h"
+#include "PropertyDbl.h"
+#include "PropertyStr.h"
+#include "SimTKcommon.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenSim {
+
+class Object;
+class PropertySet;
+
+//=============================================================================
+//=============================================================================
+/**
+ * A table of per-frame results kept on disk, so that a tool run again on the
+ * same inputs can reuse the results of earlier runs instead of recomputing
+ * them.
+ *
+ * Results are addressed by content. A table is identified by a hash of
+ * everything its results depend on other than the frame (e.g., the model and
+ * the tool's settings), and each result in it by a hash of the frame's own
+ * inputs (e.g., its time and the data read for it). Changing the model or a
+ * setting therefore selects another table, and changing the data of some
+ * frames only misses the results of those frames. Tables are also keyed on
+ * the version of the cache's format, the version of OpenSim and the sources
+ * it was built from (the git commit and any uncommitted changes, identified
+ * on every build), so results are not reused by another build, which may
+ * compute them differently.
+ *
+ * Each table is one file in the cache directory, named by its hash. The
+ * directory also holds an index of the tables' sizes and when each was last
+ * used; save() removes the least recently used tables until the directory
+ * is within its size limit. A table that cannot be read (e.g., written by an
+ * incompatible version) is treated as empty.
+ *
+ * Tables may be saved by several threads or processes at once; each table
+ * and the index are written to a temporary file, unique to the process, and
+ * then renamed.
+ */
+class OSIMCOMMON_API ResultCache {
+public:
+    /** A 64-bit FNV-1a hash of a sequence of values, used to address tables
+    and results. */
+    class OSIMCOMMON_API Hash {
+    public:
+        Hash();
+        Hash& add(const void* data, size_t numBytes);
+        Hash& add(const std::string& value);
+        Hash& add(const char* value) { return add(std::string(value)); }
+        Hash& add(int value);
+        Hash& add(double value);
+        Hash& add(const SimTK::Vector& values);
+        /** Add the XML serialization of an object, e.g., a model. */
+        Hash& add(const Object& object);
+        /** Add the contents of a file. Throws an Exception if the file cannot
+        be read. */
+        Hash& addFile(const std::string& fileName);
+
+        unsigned long long getValue() const { return _value; }
+        /** The value as 16 hexadecimal digits. */
+        std::string toString() const;
+    private:
+        unsigned long long _value;
+    };
+
+    /**
+     * Open the table identified by key in directory, reading the results
+     * saved in it by earlier runs, if any. The directory is created when the
+     * table is saved. Tables are removed from the directory, least recently
+     * used first, to keep their total size under maxMegabytes.
+     */
+    ResultCache(const std::string& directory, const Hash& key,
+                double maxMegabytes);
+
+    /** Get the result of a frame into values, and return whether there was
+    one. */
+    bool find(const Hash& frame, std::vector<double>& values);
+    /** Add or replace the result of a frame. */
+    void insert(const Hash& frame, const std::vector<double>& values);
+    /** Write the table, if it has changed, record its use in the index, and
+    remove other tables if the directory is over its size limit. */
+    void save();
+
+    int getNumResults() const { return (int)_results.size(); }
+    /** Number of calls to find() that found a result. */
+    int getNumHits() const { return _numHits; }
+    /** Number of calls to find() that did not. */
+    int getNumMisses() const { return _numMisses; }
+    /** The file in which the table is kept. */
+    std::string getFileName() const;
+
+    /** Remove the tables listed in the index of directory, the index and,
+    if it is then empty, the directory. */
+    static void clear(const std::string& directory);
+
+private:
+    void read();
+
+    std::string _directory;
+    unsigned long long _key;
+    double _maxBytes;
+    std::unordered_map<unsigned long long, std::vector<double> > _results;
+    bool _modified;
+    int _numHits;
+    int _numMisses;
+};
+
+//=============================================================================
+//=============================================================================
+/**
+ * The properties with which a tool uses a ResultCache: whether it reuses
+ * results, the directory in which they are kept and the size to which that
+ * directory is limited. A tool keeps the settings as a member and appends
+ * them to its property set when setting up its properties.
+ */
+class OSIMCOMMON_API ResultCacheSettings {
+public:
+    ResultCacheSettings();
+
+    /** Append the properties to the property set of a tool. */
+    void appendTo(PropertySet& aPropertySet);
+
+    /** Get/set whether results are kept between runs. */
+    bool getUse() const { return _useProp.getValueBool(); }
+    void setUse(bool aTrueFalse) { _useProp.setValue(aTrueFalse); }
+    /** Get/set the directory in which results are kept; empty for the
+    default. */
+    const std::string& getDirectory() const { return _directoryProp.getValueStr(); }
+    void setDirectory(const std::string& aDirectory) { _directoryProp.setValue(aDirectory); }
+    /** Get/set the size, in megabytes, to which the directory is limited. */
+    double getSizeLimit() const { return _sizeLimitProp.getValueDbl(); }
+    void setSizeLimit(double aMegabytes) { _sizeLimitProp.setValue(aMegabytes); }
+    /** The directory in which results are kept: the directory property or,
+    if it is empty, result_cache in aResultsDir. */
+    std::string getPath(const std::string& aResultsDir) const;
+
+private:
+    PropertyBool _useProp;
+    PropertyStr _directoryProp;
+    PropertyDbl _sizeLimitProp;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_RESULT_CACHE_H_
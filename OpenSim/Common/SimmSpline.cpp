@@ -60,7 +60,8 @@ SimmSpline::~SimmSpline()
 SimmSpline::SimmSpline() :
     _x(_propX.getValueDblArray()),
     _y(_propY.getValueDblArray()),
-    _b(0.0), _c(0.0), _d(0.0)
+    _b(0.0), _c(0.0), _d(0.0),
+    _lastSegment(0)
 {
     setNull();
 }
@@ -71,7 +72,8 @@ SimmSpline::SimmSpline(int aN,const double *aX,const double *aY,
     const string &aName) :
     _x(_propX.getValueDblArray()),
     _y(_propY.getValueDblArray()),
-    _b(0.0), _c(0.0), _d(0.0)
+    _b(0.0), _c(0.0), _d(0.0),
+    _lastSegment(0)
 {
     setNull();
 
@@ -113,7 +115,8 @@ SimmSpline::SimmSpline(const SimmSpline &aSpline) :
     Function(aSpline),
     _x(_propX.getValueDblArray()),
     _y(_propY.getValueDblArray()),
-    _b(0.0), _c(0.0), _d(0.0)
+    _b(0.0), _c(0.0), _d(0.0),
+    _lastSegment(0)
 {
     setEqual(aSpline);
 }
@@ -519,7 +522,7 @@ double SimmSpline::calcValue(const Vector& x) const
     if(!_c.getSize()) return(SimTK::NaN);
     if(!_d.getSize()) return(SimTK::NaN);
 
-    int i, j, k;
+    int k;
     double dx;
 
     int n = _x.getSize();
@@ -549,30 +552,7 @@ double SimmSpline::calcValue(const Vector& x) const
    else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
        return _y[n-1];
 
-    if (n < 3)
-    {
-        /* If there are only 2 function points, then set k to zero
-         * (you've already checked to see if the abscissa is out of
-         * range or equal to one of the endpoints).
-         */
-        k = 0;
-    }
-    else
-    {
-        /* Do a binary search to find which two points the abscissa is between. */
-        i = 0;
-        j = n;
-        while (1)
-        {
-            k = (i+j)/2;
-            if (aX < _x[k])
-                j = k;
-            else if (aX > _x[k+1])
-                i = k;
-            else
-                break;
-        }
-    }
+    k = findSegment(aX);
 
    dx = aX - _x[k];
    return _y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k]));
@@ -586,7 +566,7 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
     if(!_c.getSize()) return(SimTK::NaN);
     if(!_d.getSize()) return(SimTK::NaN);
 
-    int i, j, k;
+    int k;
     double dx;
 
     int n = _x.getSize();
@@ -639,30 +619,7 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
          return 2.0*_c[n-1];
    }
 
-    if (n < 3)
-    {
-        /* If there are only 2 function points, then set k to zero
-         * (you've already checked to see if the abscissa is out of
-         * range or equal to one of the endpoints).
-         */
-        k = 0;
-    }
-    else
-    {
-        /* Do a binary search to find which two points the abscissa is between. */
-        i = 0;
-        j = n;
-        while (1)
-        {
-            k = (i+j)/2;
-            if (aX < _x[k])
-                j = k;
-            else if (aX > _x[k+1])
-                i = k;
-            else
-                break;
-        }
-    }
+    k = findSegment(aX);
 
    dx = aX - _x[k];
 
@@ -673,6 +630,87 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
       return (2.0*_c[k] + 6.0*dx*_d[k]);
 }
 
+void SimmSpline::calcValueAndDerivatives(double aX, double& rValue,
+    double& rFirstDerivative, double& rSecondDerivative) const
+{
+    // NOT A NUMBER
+    if(!_y.getSize() || !_b.getSize() || !_c.getSize() || !_d.getSize()) {
+        rValue = rFirstDerivative = rSecondDerivative = SimTK::NaN;
+        return;
+    }
+
+    int n = _x.getSize();
+
+    // The same cases as calcValue() and calcDerivative(), with the abscissa
+    // located once.
+    if (aX < _x[0]) {
+        rValue = _y[0] + (aX - _x[0])*_b[0];
+        rFirstDerivative = _b[0];
+        rSecondDerivative = 0;
+    } else if (aX > _x[n-1]) {
+        rValue = _y[n-1] + (aX - _x[n-1])*_b[n-1];
+        rFirstDerivative = _b[n-1];
+        rSecondDerivative = 0;
+    } else if (EQUAL_WITHIN_ERROR(aX,_x[0])) {
+        rValue = _y[0];
+        rFirstDerivative = _b[0];
+        rSecondDerivative = 2.0*_c[0];
+    } else if (EQUAL_WITHIN_ERROR(aX,_x[n-1])) {
+        rValue = _y[n-1];
+        rFirstDerivative = _b[n-1];
+        rSecondDerivative = 2.0*_c[n-1];
+    } else {
+        int k = findSegment(aX);
+        double dx = aX - _x[k];
+        rValue = _y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k]));
+        rFirstDerivative = (_b[k] + dx*(2.0*_c[k] + 3.0*dx*_d[k]));
+        rSecondDerivative = (2.0*_c[k] + 6.0*dx*_d[k]);
+    }
+}
+
+//_____________________________________________________________________________
+/**
+ * Find the segment [x[k], x[k+1]] of the knot sequence that contains aX,
+ * which must lie strictly between the end points. The segment found by the
+ * previous call is tried before searching, so that the value and derivatives
+ * at one abscissa, or at the abscissae of consecutive integration steps,
+ * are found without repeating the binary search.
+ */
+int SimmSpline::findSegment(double aX) const
+{
+    int n = _x.getSize();
+
+    /* If there are only 2 function points, then the abscissa is between
+     * them (you've already checked to see if the abscissa is out of
+     * range or equal to one of the endpoints).
+     */
+    if (n < 3)
+        return 0;
+
+    int k = _lastSegment.load(std::memory_order_relaxed);
+    // Only an abscissa strictly inside the previous segment reuses it; one
+    // at a knot is searched for so that the segment chosen for it, and so
+    // the derivatives at it, do not depend on earlier calls.
+    if (k < n-1 && aX > _x[k] && aX < _x[k+1])
+        return k;
+
+    /* Do a binary search to find which two points the abscissa is between. */
+    int i = 0;
+    int j = n;
+    while (1)
+    {
+        k = (i+j)/2;
+        if (aX < _x[k])
+            j = k;
+        else if (aX > _x[k+1])
+            i = k;
+        else
+            break;
+    }
+    _lastSegment.store(k, std::memory_order_relaxed);
+    return k;
+}
+
 int SimmSpline::getArgumentSize() const
 {
     return 1;
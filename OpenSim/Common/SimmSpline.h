@@ -26,6 +26,7 @@
 
 // INCLUDES
 #include "osimCommonDLL.h"
+#include <atomic>
 #include <string>
 #include "Array.h"
 #include "PropertyInt.h"
@@ -70,6 +71,9 @@ private:
     Array<double> _b;
     Array<double> _c;
     Array<double> _d;
+    /** The segment in which the previous evaluation found its argument,
+    which is tried first by the next evaluation. */
+    mutable std::atomic<int> _lastSegment;
 
 //=============================================================================
 // METHODS
@@ -122,6 +126,8 @@ public:
     //--------------------------------------------------------------------------
     double calcValue(const SimTK::Vector& x) const override;
     double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const override;
+    void calcValueAndDerivatives(double x, double& rValue,
+        double& rFirstDerivative, double& rSecondDerivative) const override;
     int getArgumentSize() const override;
     int getMaxDerivativeOrder() const override;
     SimTK::Function* createSimTKFunction() const override;
@@ -130,6 +136,7 @@ public:
 
 private:
     void calcCoefficients();
+    int findSegment(double aX) const;
 //=============================================================================
 };  // END class SimmSpline
 
@@ -24,6 +24,8 @@
 // INCLUDES
 //=============================================================================
 #include "SmoothSegmentedFunction.h"
+#include <map>
+#include <mutex>
 
 //=============================================================================
 // STATICS
@@ -95,10 +97,72 @@ SmoothSegmentedFunction::
 _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
      _computeIntegral(computeIntegral),_intx0x1(intx0x1),_name(name)
 {
-    
-
     _numBezierSections = mX.ncol();
 
+    _splineFits = findOrFitSplines(mX, mY, x0, x1, y0, y1, dydx0, dydx1,
+                                   computeIntegral, intx0x1, name);
+
+    _mXVec.resize(_numBezierSections);
+    _mYVec.resize(_numBezierSections);
+    for(int s=0; s < _numBezierSections; s++){
+        _mXVec[s] = mX(s); 
+        _mYVec[s] = mY(s); 
+    }
+}
+
+/*The spline fits of every curve that is in use, keyed on the bit patterns of
+  the arguments they were fitted from. Entries expire with the last curve
+  that uses them.*/
+static std::mutex splineFitsCacheMutex;
+static std::map<std::string, 
+    std::weak_ptr<const void> > splineFitsCache;
+
+static void appendToKey(std::string& key, double value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::shared_ptr<const SmoothSegmentedFunction::SplineFits> 
+    SmoothSegmentedFunction::findOrFitSplines(
+        const SimTK::Matrix& mX, const SimTK::Matrix& mY,
+        double x0, double x1, double y0, double y1,
+        double dydx0, double dydx1,
+        bool computeIntegral, bool intx0x1, const std::string& name)
+{
+    std::string key;
+    key.reserve(sizeof(double)*(2*mX.nelt() + 9));
+    appendToKey(key, mX.nrow());
+    appendToKey(key, mX.ncol());
+    for(int c=0; c < mX.ncol(); c++){
+        for(int r=0; r < mX.nrow(); r++){
+            appendToKey(key, mX(r,c));
+            appendToKey(key, mY(r,c));
+        }
+    }
+    appendToKey(key, x0);
+    appendToKey(key, x1);
+    appendToKey(key, y0);
+    appendToKey(key, y1);
+    appendToKey(key, dydx0);
+    appendToKey(key, dydx1);
+    key.push_back(computeIntegral ? 'i' : '-');
+    key.push_back(intx0x1 ? 'r' : 'l');
+
+    {
+        std::lock_guard<std::mutex> lock(splineFitsCacheMutex);
+        auto it = splineFitsCache.find(key);
+        if(it != splineFitsCache.end()){
+            std::shared_ptr<const void> cached = it->second.lock();
+            if(cached)
+                return std::static_pointer_cast<const SplineFits>(cached);
+        }
+    }
+
+    // Fit outside of the lock; if two threads fit the same curve at once,
+    // the fit that is cached last is the one that later curves share.
+    std::shared_ptr<SplineFits> fits = std::make_shared<SplineFits>();
+    int numBezierSections = mX.ncol();
+
     //////////////////////////////////////////////////
     //Generate the set of splines that approximate u(x)
     //////////////////////////////////////////////////
@@ -106,21 +170,21 @@ _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
     SimTK::Vector x(NUM_SAMPLE_PTS); //Used for the approximate inverse
 
     //Used to generate the set of knot points of the integral of y(x)    
-   SimTK::Vector xALL(NUM_SAMPLE_PTS*_numBezierSections-(_numBezierSections-1));
-    _arraySplineUX.resize(_numBezierSections);
+   SimTK::Vector xALL(NUM_SAMPLE_PTS*numBezierSections-(numBezierSections-1));
+    fits->arraySplineUX.resize(numBezierSections);
     int xidx = 0;
 
-    for(int s=0; s < _numBezierSections; s++){
+    for(int s=0; s < numBezierSections; s++){
         //Sample the local set for u and x
         for(int i=0;i<NUM_SAMPLE_PTS;i++){
             u(i) = ( (double)i )/( (double)(NUM_SAMPLE_PTS-1) );
             x(i) = SegmentedQuinticBezierToolkit::
                 calcQuinticBezierCurveVal(u(i),mX(s));            
-            if(_numBezierSections > 1){
+            if(numBezierSections > 1){
                 //Skip the last point of a set that has another set of points
                 //after it. Why? The last point and the starting point of the
                 //next set are identical in value.
-                if(i<(NUM_SAMPLE_PTS-1) || s == (_numBezierSections-1)){
+                if(i<(NUM_SAMPLE_PTS-1) || s == (numBezierSections-1)){
                     xALL(xidx) = x(i);
                     xidx++;
                 }
@@ -130,18 +194,18 @@ _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
             }
         }
         //Create the array of approximate inverses for u(x)    
-        _arraySplineUX[s] = SimTK::SplineFitter<Real>::
+        fits->arraySplineUX[s] = SimTK::SplineFitter<Real>::
             fitForSmoothingParameter(3,x,u,0).getSpline();
     }
 
-    if(_computeIntegral){
+    if(computeIntegral){
         //////////////////////////////////////////////////
         //Compute the integral of y(x) and spline the result    
         //////////////////////////////////////////////////
 
         SimTK::Matrix yInt =  SegmentedQuinticBezierToolkit::
             calcNumIntBezierYfcnX(xALL,0,INTTOL, UTOL, MAXITER,mX, mY,
-            _arraySplineUX,_intx0x1,_name);
+            fits->arraySplineUX,intx0x1,name);
 
         //not correct
         //if(_intx0x1==false){
@@ -149,16 +213,20 @@ _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
         //    yInt = yInt - yInt(yInt.nelt()-1);
         //}
 
-        _splineYintX = SimTK::SplineFitter<Real>::
+        fits->splineYintX = SimTK::SplineFitter<Real>::
                 fitForSmoothingParameter(3,yInt(0),yInt(1),0).getSpline();
     }
-    
-    _mXVec.resize(_numBezierSections);
-    _mYVec.resize(_numBezierSections);
-    for(int s=0; s < _numBezierSections; s++){
-        _mXVec[s] = mX(s); 
-        _mYVec[s] = mY(s); 
+
+    std::lock_guard<std::mutex> lock(splineFitsCacheMutex);
+    // Drop the entries of curves that no longer exist.
+    for(auto it = splineFitsCache.begin(); it != splineFitsCache.end(); ){
+        if(it->second.expired())
+            it = splineFitsCache.erase(it);
+        else
+            ++it;
     }
+    splineFitsCache[key] = fits;
+    return fits;
 }
 
  SmoothSegmentedFunction::SmoothSegmentedFunction():
@@ -166,10 +234,9 @@ _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
      ,_y1(SimTK::NaN),_dydx0(SimTK::NaN),_dydx1(SimTK::NaN),
      _computeIntegral(false),_intx0x1(false),_name("NOT_YET_SET")
  {
-        _arraySplineUX.resize(0);        
+        _splineFits = std::make_shared<SplineFits>();
         _mXVec.resize(0);
         _mYVec.resize(0);
-        _splineYintX = SimTK::Spline();
         _numBezierSections = (int)SimTK::NaN;
        
  }
@@ -202,7 +269,7 @@ double SmoothSegmentedFunction::calcValue(double x) const
     {
         int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
         double u = SegmentedQuinticBezierToolkit::
-                 calcU(x,_mXVec[idx], _arraySplineUX[idx], UTOL,MAXITER);
+                 calcU(x,_mXVec[idx], _splineFits->arraySplineUX[idx], UTOL,MAXITER);
         yVal = SegmentedQuinticBezierToolkit::
                  calcQuinticBezierCurveVal(u,_mYVec[idx]);
     }else{
@@ -270,7 +337,7 @@ double SmoothSegmentedFunction::calcDerivative(double x, int order) const
             if(x >= _x0 && x <= _x1){        
                 int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
                 double u = SegmentedQuinticBezierToolkit::
-                                calcU(x,_mXVec[idx], _arraySplineUX[idx], 
+                                calcU(x,_mXVec[idx], _splineFits->arraySplineUX[idx], 
                                 UTOL,MAXITER);
                 yVal = SegmentedQuinticBezierToolkit::
                             calcQuinticBezierCurveDerivDYDX(u, _mXVec[idx], 
@@ -351,13 +418,13 @@ double SmoothSegmentedFunction::calcIntegral(double x) const
 
     double yVal = 0;    
     if(x >= _x0 && x <= _x1){
-        yVal = _splineYintX.calcValue(SimTK::Vector(1,x));
+        yVal = _splineFits->splineYintX.calcValue(SimTK::Vector(1,x));
     }else{
         //LINEAR EXTRAPOLATION         
         if(x < _x0){
             SimTK::Vector tmp(1);
             tmp(0) = _x0;
-            double ic = _splineYintX.calcValue(tmp);
+            double ic = _splineFits->splineYintX.calcValue(tmp);
             if(_intx0x1){//Integrating left to right
                 yVal = _y0*(x-_x0) 
                     + _dydx0*(x-_x0)*(x-_x0)*0.5 
@@ -370,7 +437,7 @@ double SmoothSegmentedFunction::calcIntegral(double x) const
         }else{
             SimTK::Vector tmp(1);
             tmp(0) = _x1;
-            double ic = _splineYintX.calcValue(tmp);
+            double ic = _splineFits->splineYintX.calcValue(tmp);
             if(_intx0x1){
                 yVal = _y1*(x-_x1) 
                     + _dydx1*(x-_x1)*(x-_x1)*0.5 
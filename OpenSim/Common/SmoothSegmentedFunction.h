@@ -26,6 +26,7 @@
 
 //#include "SmoothSegmentedFunctionFactory.h"
 #include "SegmentedQuinticBezierToolkit.h"
+#include <memory>
 
 namespace OpenSim { 
 
@@ -302,10 +303,28 @@ namespace OpenSim {
 
     private:
        
-        /**Array of spline fit functions X(u) for each Bezier elbow*/
-        SimTK::Array_<SimTK::Spline> _arraySplineUX;        
-        /**Spline fit of the integral of the curve y(x)*/
-        SimTK::Spline _splineYintX;
+        /**The spline fits of a curve, which depend only on its control points
+        and end conditions and never change once computed*/
+        struct SplineFits {
+            /**Array of spline fit functions X(u) for each Bezier elbow*/
+            SimTK::Array_<SimTK::Spline> arraySplineUX;
+            /**Spline fit of the integral of the curve y(x)*/
+            SimTK::Spline splineYintX;
+        };
+
+        /**Fitting is the expensive part of constructing a curve, so the fits
+        are shared by every curve constructed from the same control points and
+        end conditions (e.g. the curves of muscles in copies of a Model), and
+        by copies of this curve*/
+        std::shared_ptr<const SplineFits> _splineFits;
+
+        /**Returns the spline fits for the given control points and end
+        conditions, computing them only if no existing curve already has*/
+        static std::shared_ptr<const SplineFits> findOrFitSplines(
+            const SimTK::Matrix& mX, const SimTK::Matrix& mY,
+            double x0, double x1, double y0, double y1,
+            double dydx0, double dydx1,
+            bool computeIntegral, bool intx0x1, const std::string& name);
         
         /**Bezier X1,...,Xn control point locations. Control points are 
         stored in 6x1 vectors in the order above*/
@@ -30,6 +30,7 @@
 #include "IO.h"
 #include "StateVector.h"
 #include "SimTKcommon.h"
+#include <string>
 
 
 
@@ -541,6 +542,16 @@ divide(StateVector *aStateVector)
  */
 int StateVector::
 print(FILE *fp) const
+{
+    return(print(fp,IO::GetNumberFormat()));
+}
+//_____________________________________________________________________________
+/**
+ * Print the contents of this StateVector to file with a number output format
+ * captured before (see IO::GetNumberFormat()), rather than the current one.
+ */
+int StateVector::
+print(FILE *fp,const IO::NumberFormat &aFormat) const
 {
     // CHECK FILE POINTER
     if(fp==NULL) {
@@ -548,35 +559,39 @@ print(FILE *fp) const
         return(-1);
     }
 
+    // FORMAT THE ROW
+    // The whole row is formatted before it is written so that the file is
+    // written once per row rather than once per number.
+    std::string row;
+    row.reserve(24*(_data.getSize()+1));
+    char number[IO_STRLEN];
+
     // TIME
-    char format[IO_STRLEN];
-    sprintf(format,"%s",IO::GetDoubleOutputFormat());
-    int n=0,nTotal=0;
-    n = fprintf(fp,format,_t);
+    int n = IO::FormatDouble(_t,number,IO_STRLEN,aFormat);
     if(n<0) {
-        printf("StateVector.print(FILE*): error writing to file.\n");
+        printf("StateVector.print(FILE*): error formatting time.\n");
         return(n);
     }
-    nTotal += n;
+    row.append(number,n);
 
     // STATES
-    sprintf(format,"\t%s",IO::GetDoubleOutputFormat());
     for(int i=0;i<_data.getSize();i++) {
-        n = fprintf(fp,format,_data[i]);
+        n = IO::FormatDouble(_data[i],number,IO_STRLEN,aFormat);
         if(n<0) {
-            printf("StateVector.print(FILE*): error writing to file.\n");
+            printf("StateVector.print(FILE*): error formatting data.\n");
             return(n);
         }
-        nTotal += n;
+        row += '\t';
+        row.append(number,n);
     }
 
     // CARRIAGE RETURN
-    n = fprintf(fp,"\n");
-    if(n<0) {
+    row += '\n';
+
+    if(fwrite(row.data(),1,row.size(),fp)!=row.size()) {
         printf("StateVector.print(FILE*): error writing to file.\n");
-        return(n);
+        return(-1);
     }
-    nTotal += n;
 
-    return(nTotal);
+    return((int)row.size());
 }
@@ -30,6 +30,7 @@
 
 #include "osimCommonDLL.h"
 #include "Array.h"
+#include "IO.h"
 
 
 //template class OSIMCOMMON_API Array<double>;
@@ -132,6 +133,7 @@ public:
     //--------------------------------------------------------------------------
 #ifndef SWIG
     int print(FILE *fp) const;
+    int print(FILE *fp,const IO::NumberFormat &aFormat) const;
 #endif
 
 //=============================================================================
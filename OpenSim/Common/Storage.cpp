@@ -28,11 +28,14 @@
 
 // INCLUDES
 #include "osimCommonDLL.h"
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 #include <iostream>
 #include "IO.h"
 #include "Signal.h"
 #include "Storage.h"
+#include "AsynchronousFileWriter.h"
 #include "GCVSplineSet.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
@@ -82,6 +85,7 @@ const int Storage::LatestVersion = 1;
  */
 Storage::~Storage()
 {
+    closeOutputFile();
 }
 
 //=============================================================================
@@ -314,6 +318,14 @@ setNull()
     _stepInterval = 1;
     _lastI = 0;
     _fp = 0;
+    _numRowsWritten = 0;
+    _lastRowPending = false;
+    _lastRowFormat = IO::GetNumberFormat();
+    _countsPosition = -1;
+    _memoryWindow = 0;
+    _asynchronousOutput = false;
+    _resultFileName = "";
+    _resultSize = 0;
     _inDegrees = false;
 }
 //_____________________________________________________________________________
@@ -1354,12 +1366,20 @@ append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
     // TODO: use some tolerance when checking for duplicate time?
     if(aCheckForDuplicateTime && _storage.getSize() && _storage.getLast().getTime()==aStateVector.getTime())
         _storage.updLast() = aStateVector;
-    else
+    else {
+        // The last row is complete once a row with another time follows it.
+        if (_fp!=0)
+            writeLastRow();
         _storage.append(aStateVector);
+    }
 
     if (_fp!=0){
-        aStateVector.print(_fp);
-        fflush(_fp);
+        _lastRowPending = true;
+        _lastRowFormat = IO::GetNumberFormat();
+        if (_memoryWindow > 0)
+            discardRowsOutsideMemoryWindow();
+        else if (!_asynchronousOutput)
+            fflush(_fp);
     }
     return(_storage.getSize());
 }
@@ -1377,7 +1397,7 @@ int Storage::
 append(const Array<StateVector> &aStorage)
 {
     for(int i=0; i<aStorage.getSize(); i++)
-        _storage.append(aStorage[i]);
+        append(aStorage[i], false);
     return(_storage.getSize());
 }
 //_____________________________________________________________________________
@@ -2615,11 +2635,124 @@ setOutputFileName(const std::string& aFileName)
     _fp = IO::OpenFile(aFileName,"w");
     if(_fp==NULL) throw(Exception("Could not open file "+aFileName));
     // WRITE THE HEADER
-    int n=0,nTotal=0;
-    n = writeHeader(_fp);
-    n = writeDescription(_fp);
+    // The counts are not known until the file is closed, so leave room to
+    // rewrite them in place.
+    int nc = (_storage.getSize()>0) ? getSmallestNumberOfStates()+1 :
+                                      _columnLabels.getSize();
+    writeHeader(_fp,_storage.getSize(),nc,&_countsPosition);
+    writeDescription(_fp);
     // WRITE THE COLUMN LABELS
-    n = writeColumnLabels(_fp);
+    writeColumnLabels(_fp);
+
+    // WRITE THE ROWS HELD SO FAR
+    // The last one may still be replaced by a row with the same time.
+    int nComplete = (_storage.getSize()>0) ? _storage.getSize()-1 : 0;
+    for(int i=0;i<nComplete;i++)
+        _storage[i].print(_fp);
+    _numRowsWritten = nComplete;
+    _lastRowPending = _storage.getSize()>0;
+    _lastRowFormat = IO::GetNumberFormat();
+    fflush(_fp);
+}
+//_____________________________________________________________________________
+/**
+ * Write the last row in memory to the output file if it has been held back
+ * (see append()).
+ */
+void Storage::
+writeLastRow() const
+{
+    if(!_lastRowPending) return;
+    _lastRowPending = false;
+    if(_storage.getSize()==0) return;
+
+    if(_asynchronousOutput) {
+        if(!_writer) _writer = AsynchronousFileWriter::acquire();
+        _writer->writeRow(_fp,_storage.getLast(),_lastRowFormat);
+    } else
+        _storage.getLast().print(_fp,_lastRowFormat);
+    _numRowsWritten++;
+}
+//_____________________________________________________________________________
+/**
+ * Get the number of rows written, or held back to be written, to the output
+ * file.
+ */
+int Storage::
+getNumRowsStreamed() const
+{
+    return(_numRowsWritten + (_lastRowPending ? 1 : 0));
+}
+//_____________________________________________________________________________
+/**
+ * Complete the row and column counts in the header of the output file and
+ * close it.
+ */
+void Storage::
+closeOutputFile() const
+{
+    if(_fp==NULL) return;
+
+    writeLastRow();
+    if(_writer) {
+        _writer->flush(_fp);
+        _writer.reset();
+    }
+    if(_countsPosition>=0 && fseek(_fp,_countsPosition,SEEK_SET)==0) {
+        int nc = (_storage.getSize()>0) ? getSmallestNumberOfStates()+1 :
+                                          _columnLabels.getSize();
+        fprintf(_fp,"nRows=%-10d\n",_numRowsWritten);
+        fprintf(_fp,"nColumns=%-10d\n",nc);
+    }
+    fclose(_fp);
+    _fp = NULL;
+    _fileName = "";
+    _countsPosition = -1;
+}
+//_____________________________________________________________________________
+/**
+ * Set whether rows are written to the output file on a background thread.
+ */
+void Storage::
+setAsynchronousOutput(bool aTrueFalse)
+{
+    // Rows already handed to the writer must be written before rows are
+    // written directly again.
+    if(!aTrueFalse && _writer) {
+        _writer->flush(_fp);
+        _writer.reset();
+    }
+    _asynchronousOutput = aTrueFalse;
+}
+//_____________________________________________________________________________
+/**
+ * Set the maximum number of rows held in memory while rows are written to an
+ * output file.
+ */
+void Storage::
+setMemoryWindow(int aNumRows)
+{
+    _memoryWindow = (aNumRows<0) ? 0 : aNumRows;
+    if(_fp!=NULL && _memoryWindow>0) discardRowsOutsideMemoryWindow();
+}
+//_____________________________________________________________________________
+/**
+ * Discard the oldest rows, which have already been written to the output
+ * file, once twice the memory window is held, so that each row is moved at
+ * most once.
+ */
+void Storage::
+discardRowsOutsideMemoryWindow()
+{
+    int size = _storage.getSize();
+    if(size < 2*_memoryWindow) return;
+
+    if(!_asynchronousOutput) fflush(_fp);
+    int nDiscard = size - _memoryWindow;
+    for(int i=0;i<_memoryWindow;i++)
+        _storage[i] = _storage[i+nDiscard];
+    _storage.setSize(_memoryWindow);
+    _lastI = 0;
 }
 //_____________________________________________________________________________
 /**
@@ -2641,6 +2774,15 @@ setOutputFileName(const std::string& aFileName)
 bool Storage::
 print(const string &aFileName,const string &aMode, const string& aComment) const
 {
+    // If the rows are already being written to this file, complete it. If
+    // rows have been discarded from memory, the file is the only complete
+    // record of them and must not be overwritten.
+    if(_fp!=NULL && aFileName==_fileName) {
+        bool rowsDiscarded = getNumRowsStreamed() > _storage.getSize();
+        closeOutputFile();
+        if(rowsDiscarded) return(true);
+    }
+
     // OPEN THE FILE
     FILE *fp = IO::OpenFile(aFileName,aMode);
     if(fp==NULL) return(false);
@@ -2718,7 +2860,7 @@ print(const string &aFileName,double aDT,const string &aMode) const
     // CHECK FOR VALID DT
     if(aDT<=0) return(0);
 
-    if (_fp!= NULL) fclose(_fp);
+    closeOutputFile();
     // OPEN THE FILE
     FILE *fp = IO::OpenFile(aFileName,aMode);
     if(fp==NULL) return(-1);
@@ -2798,6 +2940,42 @@ printResult(const Storage *aStorage,const std::string &aName,
     if(!aStorage) return;
     std::string path = (aDir=="") ? "." : aDir;
     std::string name = (aName.rfind(aExtension)==string::npos)? (path + "/" + aName + aExtension) :  (path + "/" + aName);
+    // The rows of a storage that has been writing to its own output file
+    // are all in that file, whereas older rows may have been discarded from
+    // memory, so the file itself becomes the result.
+    std::string outputFileName = aStorage->getOutputFileName();
+    if(outputFileName!="" && outputFileName!=name) {
+        bool rowsDiscarded =
+            aStorage->getNumRowsStreamed() > aStorage->getSize();
+        aStorage->closeOutputFile();
+        std::remove(name.c_str());
+        if(std::rename(outputFileName.c_str(),name.c_str())!=0) {
+            cout << "Storage.printResult: failed to move " << outputFileName
+                 << " to " << name << "." << endl;
+            return;
+        }
+        if(rowsDiscarded) {
+            aStorage->_resultFileName = name;
+            aStorage->_resultSize = aStorage->getSize();
+        }
+        return;
+    }
+    // Printing the rows left in memory would overwrite the complete result
+    // with its last rows, so the result file is copied instead.
+    if(aStorage->_resultFileName!="") {
+        if(aStorage->getSize()!=aStorage->_resultSize)
+            cout << "Storage.printResult: rows recorded after "
+                 << aStorage->_resultFileName << " was completed are not "
+                 << "included in " << name << "." << endl;
+        if(name==aStorage->_resultFileName) return;
+        ifstream source(aStorage->_resultFileName.c_str(), ios::binary);
+        ofstream copy(name.c_str(), ios::binary);
+        copy << source.rdbuf();
+        if(!source || !copy)
+            cout << "Storage.printResult: failed to copy "
+                 << aStorage->_resultFileName << " to " << name << "." << endl;
+        return;
+    }
     if(aDT<=0.0) aStorage->print(name);
     else aStorage->print(name,aDT);
 }
@@ -2822,11 +3000,31 @@ writeHeader(FILE *rFP,double aDT) const
     }
     nc = getSmallestNumberOfStates()+1;
 
+    return(writeHeader(rFP,nr,nc,NULL));
+}
+//_____________________________________________________________________________
+/**
+ * Write the header with the given row and column counts. If
+ * rCountsPosition is not NULL, the position of the counts in the file is
+ * returned in it and the counts are padded so they can be rewritten in place
+ * (see closeOutputFile()).
+ */
+int Storage::
+writeHeader(FILE *rFP,int aNumRows,int aNumColumns,long *rCountsPosition) const
+{
+    if(rFP==NULL) return(-1);
+
     // ATTRIBUTES
     fprintf(rFP,"%s\n",getName().c_str());
     fprintf(rFP,"version=%d\n",LatestVersion);
-    fprintf(rFP,"nRows=%d\n",nr);
-    fprintf(rFP,"nColumns=%d\n",nc);
+    if(rCountsPosition) {
+        *rCountsPosition = ftell(rFP);
+        fprintf(rFP,"nRows=%-10d\n",aNumRows);
+        fprintf(rFP,"nColumns=%-10d\n",aNumColumns);
+    } else {
+        fprintf(rFP,"nRows=%d\n",aNumRows);
+        fprintf(rFP,"nColumns=%d\n",aNumColumns);
+    }
     fprintf(rFP,"inDegrees=%s\n",(_inDegrees?"yes":"no"));
 
     return(0);
@@ -33,6 +33,7 @@
 #include "Units.h"
 #include "SimTKcommon.h"
 #include "StorageInterface.h"
+#include <memory>
 
 const int Storage_DEFAULT_CAPACITY = 256;
 //=============================================================================
@@ -41,6 +42,8 @@ namespace OpenSim {
 
 typedef std::map<std::string, std::string, std::less<std::string> > MapKeysToValues;
 
+class AsynchronousFileWriter;
+
 //static std::string[] simmReservedKeys;
  
 /**
@@ -98,8 +101,36 @@ protected:
     /** Map between keys in file header and values */
     MapKeysToValues _keyValueMap;
     /** Cache for fileName and file pointer when the file is opened so we can flush and write intermediate files if needed */
-    std::string _fileName;
-    FILE *_fp;
+    mutable std::string _fileName;
+    mutable FILE *_fp;
+    /** Number of rows written to the output file (see setOutputFileName()). */
+    mutable int _numRowsWritten;
+#ifndef SWIG
+    /** Whether the last row in memory is still to be written to the output
+    file. It is held back until a row with another time is appended or the
+    file is closed, since a row appended with the same time replaces it.
+    It is written with the number format in effect when it was appended. */
+    mutable bool _lastRowPending;
+    IO::NumberFormat _lastRowFormat;
+#endif
+    /** Position of the row and column counts in the output file's header. */
+    mutable long _countsPosition;
+    /** Maximum number of rows to keep in memory while rows are being
+    written to an output file; 0 keeps all rows. */
+    int _memoryWindow;
+    /** Whether rows are written to the output file on a background
+    thread. */
+    bool _asynchronousOutput;
+#ifndef SWIG
+    /** The writer that rows are queued to, held from the first queued row
+    until the output file is flushed. */
+    mutable std::shared_ptr<AsynchronousFileWriter> _writer;
+#endif
+    /** The result file to which printResult() moved the output file, if rows
+    had been discarded from memory, so that the file is the only complete
+    record of them, and the number of rows in memory at that time. */
+    mutable std::string _resultFileName;
+    mutable int _resultSize;
     /** Name and Description */
     std::string _name;
     std::string _description;
@@ -298,13 +329,48 @@ public:
     //--------------------------------------------------------------------------
     bool print(const std::string &aFileName,const std::string &aMode="w", const std::string& aComment="") const;
     int print(const std::string &aFileName,double aDT,const std::string &aMode="w") const;
+    /** Write this storage to a file as rows are appended to it. The header,
+    the column labels and any rows already held are written immediately, so
+    the column labels should be set beforehand. The last row is written once
+    the next row with another time is appended, so that the file holds the
+    same rows as print() would. The row and column counts in the header are
+    completed, and the last row written, by closeOutputFile(). */
     void setOutputFileName(const std::string& aFileName) override ;
-    // convenience function for Analyses and DerivCallbacks
+    /** The file rows are being written to, or an empty string. */
+    const std::string& getOutputFileName() const { return _fileName; }
+    /** Complete the header of the output file with the number of rows
+    written to it and close it. The storage no longer writes to a file
+    afterwards. Does nothing if there is no output file. */
+    void closeOutputFile() const;
+    /** While rows are being written to an output file, keep at most
+    aNumRows of the most recent rows in memory and discard older ones,
+    which are already on disk, so that memory use stays bounded during long
+    simulations. Functions that need the full history (e.g. print() or
+    resample()) only see the rows still held in memory. The default, 0, 
+    keeps all rows. */
+    void setMemoryWindow(int aNumRows);
+    int getMemoryWindow() const { return _memoryWindow; }
+    /** %Set whether rows appended to this storage are formatted and written
+    to the output file on a background thread (see AsynchronousFileWriter),
+    so that writing overlaps with computing the rows. The output file is
+    complete once closeOutputFile() returns. Off by default. */
+    void setAsynchronousOutput(bool aTrueFalse);
+    bool getAsynchronousOutput() const { return _asynchronousOutput; }
+    // convenience function for Analyses and DerivCallbacks. If aStorage has
+    // been writing its rows to an output file, that file is completed and
+    // moved to the result file's name instead of printing aStorage's rows.
+    // If rows had been discarded from memory, later calls copy that file
+    // rather than printing the rows that are left.
     static void printResult(const Storage *aStorage,const std::string &aName,
         const std::string &aDir,double aDT,const std::string &aExtension);
     void interpolateAt(const Array<double> &targetTimes);
 private:
     int writeHeader(FILE *rFP,double aDT=-1) const;
+    int writeHeader(FILE *rFP,int aNumRows,int aNumColumns,
+                    long *rCountsPosition) const;
+    void discardRowsOutsideMemoryWindow();
+    void writeLastRow() const;
+    int getNumRowsStreamed() const;
     int writeSIMMHeader(FILE *rFP,double aDT=-1, const char*aComment=0) const;
     int writeDescription(FILE *rFP) const;
     int writeColumnLabels(FILE *rFP) const;
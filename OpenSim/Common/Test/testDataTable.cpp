@@ -23,6 +23,8 @@
 
 #include <OpenSim/Common/TimeSeriesTable.h>
 
+#include <cmath>
+
 int main() {
     using namespace SimTK;
     using namespace OpenSim;
@@ -130,5 +132,90 @@ int main() {
                 "(\"Filename\").getValue<std::string>() != std::string"
                 "{\"/path/to/file\"}"};
 
+    // Reserve storage, append rows in bulk and look up rows by time.
+    {
+        TimeSeriesTable bulk{};
+        bulk.setDependentsMetaData(dep_metadata);
+        bulk.reserve(1000);
+        if(bulk.getCapacity() < 1000)
+            throw Exception{"Test failed: bulk.getCapacity() < 1000"};
+
+        // Append a million rows, one at a time, after the reserved rows.
+        const size_t num_rows = 1000000;
+        for(size_t i = 0; i < num_rows; ++i)
+            bulk.appendRow(0.01 * i, row + static_cast<double>(i));
+        if(bulk.getNumRows() != num_rows)
+            throw Exception{"Test failed: bulk.getNumRows() != num_rows"};
+        if(bulk.getDependentColumnAtIndex(0).size() != num_rows)
+            throw Exception{"Test failed: bulk.getDependentColumnAtIndex(0)"
+                    ".size() != num_rows"};
+
+        std::vector<double> times{};
+        SimTK::Matrix_<double> rows{10, 5};
+        for(int i = 0; i < 10; ++i) {
+            times.push_back(0.01 * (num_rows + i));
+            rows.updRow(i) = row + static_cast<double>(num_rows + i);
+        }
+        bulk.appendRows(times, rows);
+        if(bulk.getNumRows() != num_rows + 10)
+            throw Exception{"Test failed: bulk.getNumRows() != num_rows + 10"};
+
+        // The matrix excludes reserved rows and refers to the table.
+        if(bulk.getMatrix().nrow() != static_cast<int>(num_rows + 10) ||
+           bulk.getMatrix().ncol() != 5)
+            throw Exception{"Test failed: bulk.getMatrix() has the wrong "
+                    "size."};
+        const double saved = bulk.getMatrix()(3, 2);
+        bulk.updMatrix()(3, 2) = -1;
+        if(bulk.getRowAtIndex(3)[2] != -1)
+            throw Exception{"Test failed: bulk.updMatrix() is not a view."};
+        bulk.updMatrix()(3, 2) = saved;
+
+        try {
+            bulk.appendRows(std::vector<double>{1e9}, rows);
+            throw Exception{"Test failed: appendRows() accepted mismatched "
+                    "number of rows."};
+        } catch(IncorrectNumRows&) {}
+
+        // A time that is not increasing rejects the whole block.
+        try {
+            bulk.appendRows(times, rows);
+            throw Exception{"Test failed: appendRows() accepted decreasing "
+                    "time."};
+        } catch(InvalidRow&) {}
+        if(bulk.getNumRows() != num_rows + 10)
+            throw Exception{"Test failed: rejected rows were appended."};
+
+        bulk.shrink_to_fit();
+        if(bulk.getRowAtIndex(num_rows + 9)[0] != num_rows + 9)
+            throw Exception{"Test failed: shrink_to_fit() lost rows."};
+
+        for(size_t i = 0; i < num_rows + 10; i += 9973)
+            if(bulk.getRow(bulk.getIndependentColumn()[i])[0] != i)
+                throw Exception{"Test failed: bulk.getRow(time)[0] != i"};
+        try {
+            bulk.getRow(0.005);
+            throw Exception{"Test failed: getRow() found a missing time."};
+        } catch(KeyNotFound&) {}
+
+        if(bulk.getNearestRowIndexForTime(0.504) != 50 ||
+           bulk.getNearestRowIndexForTime(0.506) != 51 ||
+           bulk.getNearestRowIndexForTime(-1) != 0 ||
+           bulk.getNearestRowIndexForTime(1e9) != num_rows + 9)
+            throw Exception{"Test failed: getNearestRowIndexForTime()"};
+        if(bulk.getNearestRow(0.506)[0] != 51)
+            throw Exception{"Test failed: bulk.getNearestRow(0.506)[0] != 51"};
+
+        const auto interpolated = bulk.getInterpolatedRow(0.0125);
+        for(int j = 0; j < 5; ++j)
+            if(std::abs(interpolated[j] - 1.25) > 1e-10)
+                throw Exception{"Test failed: bulk.getInterpolatedRow(0.0125)"
+                        "[j] != 1.25"};
+        try {
+            bulk.getInterpolatedRow(-0.5);
+            throw Exception{"Test failed: getInterpolatedRow() extrapolated."};
+        } catch(TimeOutOfRange&) {}
+    }
+
     return 0;
 }
@@ -0,0 +1,147 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  testFiniteDifferences.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <OpenSim/Common/FiniteDifferences.h>
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <cmath>
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Vector;
+using SimTK::Matrix;
+
+const int nx = 12;
+
+// f_j = x_j^2 + sin(x_{j+1}): a banded function of the parameters.
+int bandedFunction(SimTK::State&, const Vector& x, Vector& f)
+{
+    for (int j = 0; j < nx; ++j)
+        f[j] = x[j]*x[j] + (j+1 < nx ? sin(x[j+1]) : 0.0);
+    return 0;
+}
+
+Matrix analyticJacobian(const Vector& x)
+{
+    Matrix jac(nx, nx, 0.0);
+    for (int j = 0; j < nx; ++j) {
+        jac(j, j) = 2.0*x[j];
+        if (j+1 < nx) jac(j, j+1) = cos(x[j+1]);
+    }
+    return jac;
+}
+
+void assertJacobian(const Matrix& jac, const Matrix& expected, double tol)
+{
+    for (int j = 0; j < expected.nrow(); ++j)
+        for (int p = 0; p < expected.ncol(); ++p)
+            ASSERT_EQUAL(expected(j, p), jac(j, p), tol);
+}
+
+void testJacobian()
+{
+    SimTK::State s;
+    Vector x(nx);
+    for (int p = 0; p < nx; ++p) x[p] = 0.1*(p+1);
+    vector<double> dx(nx, 1e-6);
+    Matrix expected = analyticJacobian(x);
+
+    // Central differences take two evaluations per parameter.
+    int numEvaluations = 0;
+    FiniteDifferences::Function counted =
+        [&numEvaluations](SimTK::State& s, const Vector& x, Vector& f) {
+            ++numEvaluations;
+            return bandedFunction(s, x, f);
+        };
+    Matrix jacCentral(nx, nx);
+    ASSERT(FiniteDifferences::calcJacobian(s, counted,
+        FiniteDifferences::CentralDifference, x, &dx[0], jacCentral) == 0);
+    ASSERT(numEvaluations == 2*nx);
+    assertJacobian(jacCentral, expected, 1e-8);
+
+    // Forward differences take one, plus one unperturbed evaluation that is
+    // also returned.
+    numEvaluations = 0;
+    Matrix jacForward(nx, nx);
+    Vector f0(nx), fx(nx);
+    FiniteDifferences::calcJacobian(s, counted,
+        FiniteDifferences::ForwardDifference, x, &dx[0], jacForward, &f0);
+    ASSERT(numEvaluations == nx+1);
+    bandedFunction(s, x, fx);
+    assertJacobian(jacForward, expected, 1e-5);
+    for (int j = 0; j < nx; ++j) ASSERT_EQUAL(fx[j], f0[j], 0.0);
+
+    // Gradient of a scalar function.
+    FiniteDifferences::ScalarFunction sumOfSquares =
+        [](SimTK::State&, const Vector& x, double& f) {
+            f = ~x*x;
+            return 0;
+        };
+    Vector gradient(nx);
+    FiniteDifferences::calcGradient(s, sumOfSquares,
+        FiniteDifferences::CentralDifference, x, &dx[0], gradient);
+    for (int p = 0; p < nx; ++p) ASSERT_EQUAL(2.0*x[p], gradient[p], 1e-8);
+
+    // The Jacobian must have a column per parameter.
+    Matrix wrongSize(nx, nx-1);
+    ASSERT_THROW(Exception, FiniteDifferences::calcJacobian(s, counted,
+        FiniteDifferences::CentralDifference, x, &dx[0], wrongSize));
+}
+
+void testErrors()
+{
+    SimTK::State s;
+    Vector x(nx, 1.0);
+    vector<double> dx(nx, 1e-6);
+    Matrix jac(nx, nx);
+
+    // A negative status is returned.
+    FiniteDifferences::Function failing =
+        [](SimTK::State& s, const Vector& x, Vector& f) {
+            bandedFunction(s, x, f);
+            return x[5] > 1.0 ? -2 : 0;
+        };
+    ASSERT(FiniteDifferences::calcJacobian(s, failing,
+        FiniteDifferences::CentralDifference, x, &dx[0], jac) == -2);
+
+    // An exception reaches the caller.
+    FiniteDifferences::Function throwing =
+        [](SimTK::State& s, const Vector& x, Vector& f) {
+            if (x[7] != 1.0) throw Exception("perturbed", __FILE__, __LINE__);
+            return bandedFunction(s, x, f);
+        };
+    ASSERT_THROW(Exception, FiniteDifferences::calcJacobian(s, throwing,
+        FiniteDifferences::CentralDifference, x, &dx[0], jac));
+}
+
+int main()
+{
+    try {
+        testJacobian();
+        testErrors();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -20,7 +20,10 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/MultiplierFunction.h>
 #include <OpenSim/Common/PiecewiseLinearFunction.h>
+#include <OpenSim/Common/SimmSpline.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -43,6 +46,74 @@ int main() {
             ASSERT_EQUAL(f1.calcDerivative(deriv,xvec), f2.calcDerivative(deriv,xvec), 1e-10, __FILE__, __LINE__);
         }
         ASSERT(adapter.getArgumentSize() == 1, __FILE__, __LINE__);
+
+        // Fused evaluation and the adapter's derivatives match the separate
+        // evaluations exactly, at abscissae visited in any order.
+        SimmSpline spline(6, x, y);
+        const SimTK::Function& adapted = *spline.createSimTKFunction();
+        vector<int> deriv2(2, 0);
+        SimTK::Array_<int> simtkDeriv(1, 0), simtkDeriv2(2, 0);
+        for (int i = 0; i < 200; ++i) {
+            xvec[0] = -1.0 + ((i*37) % 200)*0.06;
+            const double value = spline.calcValue(xvec);
+            const double first = spline.calcDerivative(deriv, xvec);
+            const double second = spline.calcDerivative(deriv2, xvec);
+            double fusedValue, fusedFirst, fusedSecond;
+            spline.calcValueAndDerivatives(xvec[0], fusedValue, fusedFirst,
+                                           fusedSecond);
+            ASSERT_EQUAL(value, fusedValue, 0.0, __FILE__, __LINE__);
+            ASSERT_EQUAL(first, fusedFirst, 0.0, __FILE__, __LINE__);
+            ASSERT_EQUAL(second, fusedSecond, 0.0, __FILE__, __LINE__);
+            ASSERT_EQUAL(first, adapted.calcDerivative(simtkDeriv, xvec),
+                         0.0, __FILE__, __LINE__);
+            ASSERT_EQUAL(second, adapted.calcDerivative(simtkDeriv2, xvec),
+                         0.0, __FILE__, __LINE__);
+
+            f1.calcValueAndDerivatives(xvec[0], fusedValue, fusedFirst,
+                                       fusedSecond);
+            ASSERT_EQUAL(f1.calcValue(xvec), fusedValue, 0.0,
+                         __FILE__, __LINE__);
+            ASSERT_EQUAL(f1.calcDerivative(deriv, xvec), fusedFirst, 0.0,
+                         __FILE__, __LINE__);
+        }
+        delete &adapted;
+
+        // At an interior knot the segment, and so the second derivative of
+        // the spline, do not depend on which segment was evaluated before.
+        double value, first, second, afterValue, afterFirst, afterSecond;
+        spline.calcValueAndDerivatives(1.5, value, first, second);
+        spline.calcValueAndDerivatives(2.0, value, first, second);
+        spline.calcValueAndDerivatives(2.25, afterValue, afterFirst,
+                                       afterSecond);
+        spline.calcValueAndDerivatives(2.0, afterValue, afterFirst,
+                                       afterSecond);
+        ASSERT_EQUAL(value, afterValue, 0.0, __FILE__, __LINE__);
+        ASSERT_EQUAL(first, afterFirst, 0.0, __FILE__, __LINE__);
+        ASSERT_EQUAL(second, afterSecond, 0.0, __FILE__, __LINE__);
+        f1.calcValueAndDerivatives(0.5, value, first, second);
+        f1.calcValueAndDerivatives(1.0, value, first, second);
+        f1.calcValueAndDerivatives(1.5, afterValue, afterFirst, afterSecond);
+        f1.calcValueAndDerivatives(1.0, afterValue, afterFirst, afterSecond);
+        ASSERT_EQUAL(first, afterFirst, 0.0, __FILE__, __LINE__);
+
+        // Functions that wrap or replace splines in models (e.g., in
+        // MovingPathPoints) give the same results when evaluated fused.
+        MultiplierFunction scaled(spline.clone(), 1.5);
+        Constant constant(0.25);
+        for (int i = 0; i < 20; ++i) {
+            xvec[0] = -1.0 + i*0.6;
+            scaled.calcValueAndDerivatives(xvec[0], value, first, second);
+            ASSERT_EQUAL(scaled.calcValue(xvec), value, 0.0,
+                         __FILE__, __LINE__);
+            ASSERT_EQUAL(scaled.calcDerivative(deriv, xvec), first, 0.0,
+                         __FILE__, __LINE__);
+            ASSERT_EQUAL(scaled.calcDerivative(deriv2, xvec), second, 0.0,
+                         __FILE__, __LINE__);
+            constant.calcValueAndDerivatives(xvec[0], value, first, second);
+            ASSERT_EQUAL(constant.calcValue(xvec), value, 0.0,
+                         __FILE__, __LINE__);
+            ASSERT_EQUAL(0.0, first, 0.0, __FILE__, __LINE__);
+        }
     }
     catch (const Exception& e) {
         e.print(cerr);
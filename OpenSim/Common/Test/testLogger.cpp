@@ -0,0 +1,99 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  testLogger.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/LogManager.h>
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <fstream>
+
+using namespace OpenSim;
+using namespace std;
+
+// Count the evaluations of a log message's operands.
+static int numEvaluations = 0;
+static int evaluate(int value) { ++numEvaluations; return value; }
+
+void testLevels()
+{
+    Logger::setLevel(Logger::Level::Warn);
+    ASSERT(Logger::getLevel() == Logger::Level::Warn);
+    ASSERT(Logger::shouldLog(Logger::Level::Error));
+    ASSERT(Logger::shouldLog(Logger::Level::Warn));
+    ASSERT(!Logger::shouldLog(Logger::Level::Info));
+
+    // Messages of disabled levels are never evaluated.
+    numEvaluations = 0;
+    OPENSIM_LOG_INFO("not printed " << evaluate(1));
+    OPENSIM_LOG_DEBUG("not printed " << evaluate(2));
+    ASSERT(numEvaluations == 0);
+    OPENSIM_LOG_WARN("testLogger: printed " << evaluate(3));
+    ASSERT(numEvaluations == 1);
+
+    Logger::setLevel("Off");
+    OPENSIM_LOG_ERROR("not printed " << evaluate(4));
+    ASSERT(numEvaluations == 1);
+
+    Logger::setLevel("trace");
+    ASSERT(Logger::shouldLog(Logger::Level::Trace));
+    ASSERT_THROW(Exception, Logger::setLevel("verbose"));
+
+    Logger::setLevel(Logger::Level::Info);
+}
+
+void testAsynchronousLogCallback()
+{
+    const int numMessages = 1000;
+    AsynchronousLogCallback* callback =
+        new AsynchronousLogCallback("testLogger_async.log");
+    LogManager::out.addLogCallback(callback);
+    for (int i = 0; i < numMessages; ++i)
+        OPENSIM_LOG_INFO("message " << i);
+    callback->flush();
+    LogManager::out.removeLogCallback(callback);
+    delete callback;
+
+    // All messages were written, in order.
+    ifstream file("testLogger_async.log");
+    string line;
+    int i = 0;
+    while (getline(file, line)) {
+        if (line.empty()) continue;
+        ASSERT(line == "message " + to_string(i), __FILE__, __LINE__,
+            "Expected 'message " + to_string(i) + "' but read '" + line + "'.");
+        ++i;
+    }
+    ASSERT(i == numMessages);
+}
+
+int main()
+{
+    try {
+        testLevels();
+        testAsynchronousLogCallback();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -0,0 +1,174 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testResultCache.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <OpenSim/Common/ResultCache.h>
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+using namespace OpenSim;
+using namespace std;
+
+const string cacheDir = "testResultCache_results/cache";
+
+ResultCache::Hash frameHash(double time)
+{
+    ResultCache::Hash frame;
+    frame.add(time).add(2*time);
+    return frame;
+}
+
+// Results of about 8 kB per table.
+void fillTable(ResultCache& cache)
+{
+    for (int i = 0; i < 10; ++i)
+        cache.insert(frameHash(0.01*i), vector<double>(100, 0.5*i));
+}
+
+void testHash()
+{
+    ResultCache::Hash a, b, c;
+    a.add("model").add(1.5).add(2);
+    b.add("model").add(1.5).add(2);
+    c.add(1.5).add("model").add(2);
+    ASSERT(a.getValue() == b.getValue());
+    ASSERT(a.getValue() != c.getValue());
+    ASSERT(a.toString().size() == 16);
+
+    // Strings are hashed with their lengths.
+    ResultCache::Hash ab, a_b;
+    ab.add("ab").add("");
+    a_b.add("a").add("b");
+    ASSERT(ab.getValue() != a_b.getValue());
+
+    // -0 and 0 are the same input.
+    ASSERT(ResultCache::Hash().add(0.0).getValue() ==
+           ResultCache::Hash().add(-0.0).getValue());
+
+    ASSERT_THROW(OpenSim::Exception,
+                 ResultCache::Hash().addFile("testResultCache_missing.txt"));
+}
+
+void testReuse()
+{
+    ResultCache::Hash key;
+    key.add("testReuse");
+    {
+        ResultCache cache(cacheDir, key, 1.0);
+        ASSERT(cache.getNumResults() == 0);
+        fillTable(cache);
+        cache.save();
+    }
+
+    // Results are found by the hash of their frame in a new cache.
+    ResultCache cache(cacheDir, key, 1.0);
+    ASSERT(cache.getNumResults() == 10);
+    vector<double> values;
+    ASSERT(cache.find(frameHash(0.03), values));
+    ASSERT(values.size() == 100);
+    ASSERT_EQUAL(1.5, values[99], 0.0);
+    ASSERT(!cache.find(frameHash(0.035), values));
+    ASSERT(cache.getNumHits() == 1 && cache.getNumMisses() == 1);
+
+    // Another key is another table.
+    ResultCache other(cacheDir, ResultCache::Hash().add("testReuse2"), 1.0);
+    ASSERT(other.getNumResults() == 0);
+    ASSERT(other.getFileName() != cache.getFileName());
+
+    // A table whose sizes exceed its file is empty, rather than allocated.
+    // The count of results follows the 4-byte magic number and 8-byte key,
+    // and the size of the first result follows its 8-byte frame hash.
+    {
+        fstream file(cache.getFileName().c_str(),
+                     ios::binary | ios::in | ios::out);
+        const uint32_t size = 0xFFFFFFFF;
+        file.seekp(28);
+        file.write((const char*)&size, sizeof(size));
+    }
+    ASSERT(ResultCache(cacheDir, key, 1.0).getNumResults() == 0);
+    {
+        fstream file(cache.getFileName().c_str(),
+                     ios::binary | ios::in | ios::out);
+        const uint64_t numResults = 1ULL << 60;
+        file.seekp(12);
+        file.write((const char*)&numResults, sizeof(numResults));
+    }
+    ASSERT(ResultCache(cacheDir, key, 1.0).getNumResults() == 0);
+
+    // A table that cannot be read is empty.
+    {
+        ofstream file(cache.getFileName().c_str(), ios::binary | ios::trunc);
+        file << "not a table";
+    }
+    ResultCache corrupt(cacheDir, key, 1.0);
+    ASSERT(corrupt.getNumResults() == 0);
+}
+
+void testSizeLimit()
+{
+    const double limit = 12.0/1024; // 12 kB
+    ResultCache first(cacheDir + "_limited",
+                      ResultCache::Hash().add("first"), limit);
+    fillTable(first);
+    first.save();
+    ASSERT(ResultCache(cacheDir + "_limited",
+                       ResultCache::Hash().add("first"), limit)
+               .getNumResults() == 10);
+
+    // Saving a second table removes the first, least recently used.
+    ResultCache second(cacheDir + "_limited",
+                       ResultCache::Hash().add("second"), limit);
+    fillTable(second);
+    second.save();
+    ASSERT(ResultCache(cacheDir + "_limited",
+                       ResultCache::Hash().add("first"), limit)
+               .getNumResults() == 0);
+    ASSERT(ResultCache(cacheDir + "_limited",
+                       ResultCache::Hash().add("second"), limit)
+               .getNumResults() == 10);
+
+    // A table over the limit on its own is not kept.
+    ResultCache tooLarge(cacheDir + "_limited",
+                         ResultCache::Hash().add("tooLarge"), limit);
+    for (int i = 0; i < 3; ++i)
+        tooLarge.insert(frameHash(i), vector<double>(1000, 1.0));
+    tooLarge.save();
+    ASSERT(ResultCache(cacheDir + "_limited",
+                       ResultCache::Hash().add("tooLarge"), limit)
+               .getNumResults() == 0);
+}
+
+int main()
+{
+    try {
+        testHash();
+        testReuse();
+        testSizeLimit();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -22,6 +22,10 @@
 
 #include <fstream>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/AsynchronousFileWriter.h>
+#include <cmath>
+#include <thread>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -72,6 +76,180 @@ int main() {
         ASSERT(fabs(diff) < 1E-7);
 
         delete st;
+
+        // Stream rows to a file while keeping only the most recent in memory.
+        {
+            Array<std::string> labels;
+            labels.append("time"); labels.append("v1"); labels.append("v2");
+            Storage streamed(10, "streamed");
+            streamed.setColumnLabels(labels);
+            streamed.setOutputFileName("testStorage_streamed.sto");
+            streamed.setMemoryWindow(5);
+            const int nRows = 1000;
+            for (int r = 0; r < nRows; ++r) {
+                double y[] = { 10.0*r, 20.0*r };
+                streamed.append(double(r), 2, y);
+            }
+            ASSERT(streamed.getSize() < 10);
+            ASSERT(streamed.getLastTime() == nRows - 1);
+            streamed.closeOutputFile();
+
+            Storage reread("testStorage_streamed.sto");
+            ASSERT(reread.getSize() == nRows);
+            ASSERT(reread.getSmallestNumberOfStates() == 2);
+            for (int r = 0; r < nRows; r += 99) {
+                const StateVector& row = *reread.getStateVector(r);
+                ASSERT(row.getTime() == r);
+                ASSERT(row.getData()[1] == 20.0*r);
+            }
+
+            // The streamed file becomes the result, and printing the result
+            // again keeps or copies it rather than printing the rows left in
+            // memory.
+            Storage result(10, "result");
+            result.setColumnLabels(labels);
+            result.setOutputFileName("testStorage_streamed_result_tmp.sto");
+            result.setMemoryWindow(5);
+            for (int r = 0; r < nRows; ++r) {
+                double y[] = { 10.0*r, 20.0*r };
+                result.append(double(r), 2, y);
+            }
+            for (int i = 0; i < 2; ++i) {
+                Storage::printResult(&result, "testStorage_streamed_result",
+                                     ".", -1, ".sto");
+                Storage::printResult(&result, "testStorage_streamed_copy",
+                                     ".", -1, ".sto");
+                ASSERT(Storage("testStorage_streamed_result.sto").getSize()
+                       == nRows);
+                ASSERT(Storage("testStorage_streamed_copy.sto").getSize()
+                       == nRows);
+            }
+
+            // A row appended with the time of the last row replaces it, in
+            // the streamed file as in memory, so that the file has the rows
+            // print() writes.
+            for (int window = 0; window <= 2; window += 2) {
+                Storage repeated(10, "repeated");
+                repeated.setColumnLabels(labels);
+                repeated.setOutputFileName("testStorage_repeated.sto");
+                repeated.setMemoryWindow(window);
+                Storage inMemory(10, "inMemory");
+                inMemory.setColumnLabels(labels);
+                for (int r = 0; r < 20; ++r) {
+                    // Times 0, 1, 2, 2, 3, 4, 4, ...
+                    const double t = r - r/3;
+                    double y[] = { double(r), -double(r) };
+                    repeated.append(StateVector(t, 2, y));
+                    inMemory.append(StateVector(t, 2, y));
+                }
+                repeated.closeOutputFile();
+                inMemory.print("testStorage_repeated_print.sto");
+                Storage streamedRows("testStorage_repeated.sto");
+                Storage printedRows("testStorage_repeated_print.sto");
+                ASSERT(streamedRows.getSize() == printedRows.getSize());
+                ASSERT(streamedRows.getSize() < 20);
+                for (int r = 0; r < printedRows.getSize(); ++r) {
+                    const StateVector& a = *streamedRows.getStateVector(r);
+                    const StateVector& b = *printedRows.getStateVector(r);
+                    ASSERT(a.getTime() == b.getTime());
+                    ASSERT(a.getData()[0] == b.getData()[0]);
+                    ASSERT(a.getData()[1] == b.getData()[1]);
+                }
+            }
+
+            // The same rows written on the background thread. The storage
+            // owns the shared writer only while it has rows to write.
+            std::shared_ptr<AsynchronousFileWriter> writer =
+                AsynchronousFileWriter::acquire();
+            Storage async(10, "async");
+            async.setColumnLabels(labels);
+            async.setOutputFileName("testStorage_async.sto");
+            async.setAsynchronousOutput(true);
+            for (int r = 0; r < nRows; ++r) {
+                double y[] = { 10.0*r, 20.0*r };
+                async.append(double(r), 2, y);
+            }
+            ASSERT(writer.use_count() == 2);
+            async.closeOutputFile();
+            ASSERT(writer.use_count() == 1);
+            writer.reset();
+            Storage rereadAsync("testStorage_async.sto");
+            ASSERT(rereadAsync.getSize() == nRows);
+            for (int r = 0; r < nRows; r += 99)
+                ASSERT(rereadAsync.getStateVector(r)->getData()[0] == 10.0*r);
+
+            // Rows are formatted as when they were appended, even if the
+            // output precision changes before they are written.
+            IO::SetPrecision(3);
+            Storage precise(10, "precise");
+            precise.setColumnLabels(labels);
+            precise.setOutputFileName("testStorage_async_precision.sto");
+            precise.setAsynchronousOutput(true);
+            for (int r = 0; r < nRows; ++r) {
+                double y[] = { 1.0/3, 2.0/3 };
+                precise.append(double(r), 2, y);
+            }
+            IO::SetPrecision(8);
+            precise.closeOutputFile();
+            Storage rereadPrecise("testStorage_async_precision.sto");
+            ASSERT(rereadPrecise.getSize() == nRows);
+            for (int r = 0; r < nRows; r += 99)
+                ASSERT_EQUAL(0.333,
+                    rereadPrecise.getStateVector(r)->getData()[0], 1e-12);
+        }
+
+        // Numbers are formatted as sprintf() would format them.
+        {
+            char fast[IO_STRLEN], reference[IO_STRLEN];
+            const double values[] = { 0.0, -0.0, 1.0, -1.0, 0.5, 1e-9,
+                -1e-12, 0.123456785, 2.675, 1234567.891, -98765.4321e3,
+                1e12, 3.0e15, 1e300, SimTK::NaN, SimTK::Infinity };
+            const int precisions[] = { 0, 3, 8, 15 };
+            for (int p : precisions) {
+                IO::SetPrecision(p);
+                for (double x : values) {
+                    IO::FormatDouble(x, fast, IO_STRLEN);
+                    sprintf(reference, IO::GetDoubleOutputFormat(), x);
+                    ASSERT(string(fast) == string(reference), __FILE__,
+                        __LINE__, string(fast) + " != " + reference);
+                }
+                SimTK::Random::Uniform random(-1e6, 1e6);
+                for (int i = 0; i < 10000; ++i) {
+                    double x = random.getValue()/std::pow(10.0, i%12);
+                    IO::FormatDouble(x, fast, IO_STRLEN);
+                    sprintf(reference, IO::GetDoubleOutputFormat(), x);
+                    ASSERT(string(fast) == string(reference), __FILE__,
+                        __LINE__, string(fast) + " != " + reference);
+                }
+            }
+            IO::SetPrecision(8);
+
+            // A captured format is used after the current one changes.
+            IO::SetPrecision(3);
+            const IO::NumberFormat captured = IO::GetNumberFormat();
+            IO::SetPrecision(8);
+            for (double x : values) {
+                IO::FormatDouble(x, fast, IO_STRLEN, captured);
+                sprintf(reference, captured.doubleFormat, x);
+                ASSERT(string(fast) == string(reference), __FILE__,
+                    __LINE__, string(fast) + " != " + reference);
+            }
+
+            // A thread's precision applies to that thread only, and until
+            // it is destroyed.
+            {
+                IO::ThreadPrecision threadPrecision(3);
+                ASSERT(IO::GetPrecision() == 3);
+                IO::FormatDouble(1.0/3, fast, IO_STRLEN);
+                ASSERT(string(fast) == string("      0.333"));
+                int otherPrecision = -1;
+                std::thread other([&otherPrecision]() {
+                    otherPrecision = IO::GetPrecision(); });
+                other.join();
+                ASSERT(otherPrecision == 8);
+            }
+            ASSERT(IO::GetPrecision() == 8);
+        }
     }
     catch (const Exception& e) {
         e.print(cerr);
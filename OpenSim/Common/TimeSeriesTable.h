@@ -93,12 +93,43 @@ public:
     }
 };
 
+class EmptyTable : public InvalidTable {
+public:
+    EmptyTable(const std::string& file,
+               size_t line,
+               const std::string& func) :
+        InvalidTable(file, line, func) {
+        std::string msg = "Table has no rows.";
+
+        addMessage(msg);
+    }
+};
+
+class TimeOutOfRange : public Exception {
+public:
+    TimeOutOfRange(const std::string& file,
+                   size_t line,
+                   const std::string& func,
+                   double time,
+                   double min,
+                   double max) :
+        Exception(file, line, func) {
+        std::string msg = "Time " + std::to_string(time);
+        msg += " is outside the time column [" + std::to_string(min);
+        msg += ", " + std::to_string(max) + "].";
+
+        addMessage(msg);
+    }
+};
+
 /** TimeSeriesTable_ is a DataTable_ where the independent column is time of 
-type double. The time column is enforced to be strictly increasing.           */
+type double. The time column is enforced to be strictly increasing, so rows 
+are looked up by time with a binary search.                                   */
 template<typename ETY = SimTK::Real>
 class TimeSeriesTable_ : public DataTable_<double, ETY> {
 public:
-    using RowVector = SimTK::RowVector_<ETY>;
+    using RowVector     = SimTK::RowVector_<ETY>;
+    using RowVectorView = SimTK::RowVectorView_<ETY>;
 
     TimeSeriesTable_()                                   = default;
     TimeSeriesTable_(const TimeSeriesTable_&)            = default;
@@ -123,7 +154,93 @@ public:
                          TimeColumnNotIncreasing);
     }
 
+    /** Get row corresponding to the given time. This hides 
+    DataTable_::getRow(), which searches linearly.
+
+    \throws KeyNotFound If the time column has no entry with given value.    */
+    RowVectorView getRow(double time) const {
+        return DT::_depData.row(static_cast<int>(getRowIndex(time)));
+    }
+
+    /** Update row corresponding to the given time. This hides 
+    DataTable_::updRow(), which searches linearly.
+
+    \throws KeyNotFound If the time column has no entry with given value.    */
+    RowVectorView updRow(double time) {
+        return DT::_depData.updRow(static_cast<int>(getRowIndex(time)));
+    }
+
+    /** Get the index of the row whose time is closest to the given time. Ties
+    go to the earlier row.
+
+    \throws EmptyTable If the table has no rows.                             */
+    size_t getNearestRowIndexForTime(double time) const {
+        OPENSIM_THROW_IF(DT::_indData.empty(), EmptyTable);
+
+        const auto& times = DT::_indData;
+        auto iter = std::lower_bound(times.cbegin(), times.cend(), time);
+        if(iter == times.cbegin())
+            return 0;
+        if(iter == times.cend())
+            return times.size() - 1;
+        auto prev = iter - 1;
+        return static_cast<size_t>(
+            ((time - *prev) <= (*iter - time) ? prev : iter) - times.cbegin());
+    }
+
+    /** Get the row whose time is closest to the given time.
+
+    \throws EmptyTable If the table has no rows.                             */
+    RowVectorView getNearestRow(double time) const {
+        return DT::_depData.row(
+            static_cast<int>(getNearestRowIndexForTime(time)));
+    }
+
+    /** Get the row at the given time, linearly interpolated between the rows
+    before and after it.
+
+    \throws EmptyTable If the table has no rows.
+    \throws TimeOutOfRange If the time is before the first or after the last
+                           row.                                              */
+    RowVector getInterpolatedRow(double time) const {
+        OPENSIM_THROW_IF(DT::_indData.empty(), EmptyTable);
+
+        const auto& times = DT::_indData;
+        OPENSIM_THROW_IF(time < times.front() || time > times.back(),
+                         TimeOutOfRange, time, times.front(), times.back());
+
+        auto iter = std::lower_bound(times.cbegin(), times.cend(), time);
+        const int after = static_cast<int>(iter - times.cbegin());
+        if(*iter == time)
+            return DT::_depData.row(after);
+
+        const int before = after - 1;
+        const double weight = (time - times[before]) / 
+                              (times[after] - times[before]);
+        const auto rowBefore = DT::_depData.row(before);
+        const auto rowAfter  = DT::_depData.row(after);
+        RowVector row{rowBefore.ncol()};
+        for(int j = 0; j < row.ncol(); ++j)
+            row[j] = (1 - weight) * rowBefore[j] + weight * rowAfter[j];
+        return row;
+    }
+
 protected:
+    using DT = DataTable_<double, ETY>;
+
+    /** Get index of the row corresponding to the given time.
+
+    \throws KeyNotFound If the time column has no entry with given value.    */
+    size_t getRowIndex(double time) const {
+        const auto& times = DT::_indData;
+        auto iter = std::lower_bound(times.cbegin(), times.cend(), time);
+
+        OPENSIM_THROW_IF(iter == times.cend() || *iter != time,
+                         KeyNotFound, std::to_string(time));
+
+        return static_cast<size_t>(iter - times.cbegin());
+    }
+
     /** Validate the given row. 
 
     \throws InvalidRow If the timestamp for the row breaks strictly increasing
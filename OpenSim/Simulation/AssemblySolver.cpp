@@ -24,6 +24,7 @@
 #include "AssemblySolver.h"
 #include "Model/Model.h"
 #include <OpenSim/Common/Constant.h>
+#include <algorithm>
 
 using namespace std;
 using namespace SimTK;
@@ -43,6 +44,8 @@ AssemblySolver::AssemblySolver
 {
     setAuthors("Ajay Seth");
     _assembler = NULL;
+    _predictorOrder = 0;
+    _numIterations = 0;
     
     _constraintWeight = constraintWeight;
 
@@ -77,6 +80,60 @@ AssemblySolver::~AssemblySolver()
     delete _assembler;
 }
 
+void AssemblySolver::setPredictorOrder(int order)
+{
+    if(order < 0 || order > 2)
+        throw Exception("AssemblySolver::setPredictorOrder(): order must be "
+                        "0, 1 or 2.", __FILE__, __LINE__);
+    _predictorOrder = order;
+}
+
+/* Extrapolate the free q's of the previous solutions with the Lagrange 
+   polynomial through the last (order+1) of them, and start the assembler
+   there if that lowers the assembly cost without increasing the error in
+   the constraints. */
+void AssemblySolver::predictSolution(double time)
+{
+    int n = std::min(int(_solutionHistory.size()), _predictorOrder+1);
+    if(n < 2 || time <= _solutionHistory.back().first)
+        return;
+
+    const int first = int(_solutionHistory.size()) - n;
+    SimTK::Vector predicted(_solutionHistory.back().second.size(), 0.0);
+    for(int i = first; i < int(_solutionHistory.size()); ++i){
+        double ti = _solutionHistory[i].first;
+        double li = 1.0;
+        for(int j = first; j < int(_solutionHistory.size()); ++j){
+            if(j == i) continue;
+            double tj = _solutionHistory[j].first;
+            li *= (time - tj)/(ti - tj);
+        }
+        predicted += li*_solutionHistory[i].second;
+    }
+
+    SimTK::Vector previous = _assembler->getFreeQsFromInternalState();
+    if(predicted.size() != previous.size())
+        return;
+    SimTK::Real previousCost = _assembler->calcCurrentGoal();
+    SimTK::Real previousError = _assembler->calcCurrentErrorNorm();
+    _assembler->setInternalStateFromFreeQs(predicted);
+    // Strictly enforced constraints are not part of the goal; a prediction
+    // must not violate them more than the previous solution (or tolerance).
+    if(!(_assembler->calcCurrentGoal() < previousCost) ||
+       _assembler->calcCurrentErrorNorm() > std::max(previousError, _accuracy))
+        _assembler->setInternalStateFromFreeQs(previous);
+}
+
+void AssemblySolver::recordSolution(double time)
+{
+    if(!_solutionHistory.empty() && time <= _solutionHistory.back().first)
+        _solutionHistory.clear();
+    _solutionHistory.push_back(
+        std::make_pair(time, _assembler->getFreeQsFromInternalState()));
+    while(int(_solutionHistory.size()) > _predictorOrder+1)
+        _solutionHistory.pop_front();
+}
+
 /* Internal method to convert the CoordinateReferences into goals of the 
    assembly solver. Subclasses, override and call base to include other goals  
    such as point of interest matching (Marker tracking). This method is
@@ -206,7 +263,11 @@ void AssemblySolver::assemble(SimTK::State &state)
     */
     try{
         // Now do the assembly and return the updated state.
+        _assembler->resetStats();
         _assembler->assemble();
+        _numIterations = _assembler->getNumAssemblySteps();
+        _solutionHistory.clear();
+        recordSolution(s.getTime());
         // Update the q's in the state passed in
         _assembler->updateFromInternalState(s);
         state.updQ() = s.getQ();
@@ -270,8 +331,15 @@ void AssemblySolver::track(SimTK::State &s)
     */
 
     try{
+        // Start from the extrapolation of the previous solutions.
+        if(_predictorOrder > 0)
+            predictSolution(s.getTime());
+
         // Now do the assembly and return the updated state.
+        _assembler->resetStats();
         _assembler->track(s.getTime());
+        _numIterations = _assembler->getNumAssemblySteps();
+        recordSolution(s.getTime());
 
         // update the state from the result of the assembler 
         _assembler->updateFromInternalState(s);
@@ -291,4 +359,30 @@ void AssemblySolver::track(SimTK::State &s)
     }
 }
 
+SimTK::Vector AssemblySolver::getSolution() const
+{
+    if(!(_assembler && _assembler->isInitialized()))
+        throw Exception("AssemblySolver::getSolution() failed: "
+                        "assemble() must be called first.", __FILE__, __LINE__);
+    return _assembler->getFreeQsFromInternalState();
+}
+
+void AssemblySolver::trackSolution(SimTK::State &s,
+                                   const SimTK::Vector &solution)
+{
+    if(!(_assembler && _assembler->isInitialized()))
+        throw Exception("AssemblySolver::trackSolution() failed: "
+                        "assemble() must be called first.", __FILE__, __LINE__);
+    if(solution.size() != _assembler->getNumFreeQs())
+        throw Exception("AssemblySolver::trackSolution() failed: the "
+                        "solution does not match the free coordinates.",
+                        __FILE__, __LINE__);
+
+    updateGoals(s);
+    _assembler->setInternalStateFromFreeQs(solution);
+    _numIterations = 0;
+    recordSolution(s.getTime());
+    _assembler->updateFromInternalState(s);
+}
+
 } // end of namespace OpenSim
@@ -26,6 +26,8 @@
 #include "Solver.h"
 #include "OpenSim/Simulation/CoordinateReference.h"
 #include <OpenSim/Common/Set.h>
+#include <deque>
+#include <utility>
 
 namespace OpenSim {
 
@@ -48,7 +50,10 @@ class Model;
  * When the model (and the number of goals) is guaranteed not to change and the 
  * the initial state is close to the assembly solution (from initial assembly(),
  * then track() is a efficient method for updating the configuration to track
- * the small change to the desired coordinate value.
+ * the small change to the desired coordinate value. track() can seed the
+ * solver with an extrapolation of the previous solutions (see
+ * setPredictorOrder()), which saves iterations when tracking smooth motions
+ * sampled at high rates.
  *
  * See SimTK::Assembler for more algorithmic details of the underlying solver.
  *
@@ -77,6 +82,16 @@ protected:
 
     SimTK::Array_<SimTK::QValue*> _coordinateAssemblyConditions;
 
+    // Order of the polynomial through the previous solutions that predicts
+    // the starting point of track(); 0 starts from the previous solution
+    int _predictorOrder;
+
+    // Times and free q's of the most recent solutions, oldest first
+    std::deque<std::pair<double, SimTK::Vector> > _solutionHistory;
+
+    // Number of assembly iterations taken by the last assemble() or track()
+    int _numIterations;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -113,6 +128,19 @@ public:
     void updateCoordinateReference(const std::string &coordName, double value, 
                                    double weight=1.0);
 
+    /** %Set the order of the extrapolation used by track() to predict the
+        solution from the previous solutions: 0 (the default) starts from
+        the previous solution, 1 assumes constant velocity and 2 constant
+        acceleration. A prediction that increases the assembly cost, or the
+        error in the constraints beyond the accuracy, over that of the
+        previous solution is discarded. */
+    void setPredictorOrder(int order);
+    int getPredictorOrder() const { return _predictorOrder; }
+
+    /** The number of iterations (assembly steps) taken by the most recent
+        call to assemble() or track(). */
+    int getNumIterations() const { return _numIterations; }
+
     /** Assemble a model configuration that meets the assembly conditions  
         (desired values and constraints) starting from an initial state that  
         does not have to satisfy the constraints. */
@@ -126,6 +154,16 @@ public:
         to track a desired trajectory of coordinate values. */
     virtual void track(SimTK::State &s);
 
+    /** The values of the free coordinates of the most recent solution, e.g.,
+        to be saved and passed to trackSolution() later. */
+    SimTK::Vector getSolution() const;
+
+    /** Take a solution found before (see getSolution()) as the solution at
+        the time of the state s, in place of calling track(): the goals are
+        updated to that time and s and the history used to predict the next
+        solution are updated as by track(), without solving. */
+    void trackSolution(SimTK::State &s, const SimTK::Vector &solution);
+
 protected:
     /** Internal method to convert the CoordinateReferences into goals of the 
         assembly solver. Subclasses, can add and override to include other goals  
@@ -137,6 +175,12 @@ protected:
         is called at the end of setupGoals() and beginning of track()*/
     virtual void updateGoals(const SimTK::State &s);
 
+private:
+    // Seed the assembler with the extrapolation of the previous solutions.
+    void predictSolution(double time);
+    // Add the assembler's solution at the given time to the history.
+    void recordSolution(double time);
+
 //=============================================================================
 };  // END of class AssemblySolver
 //=============================================================================
@@ -26,6 +26,7 @@
  */
 #include <cstdio>
 #include "Manager.h"
+#include "SimulationCheckpoint.h"
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/AnalysisSet.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
@@ -33,6 +34,7 @@
 #include <OpenSim/Simulation/Control/Controller.h>
 #include <OpenSim/Simulation/Model/ControllerSet.h>
 #include <OpenSim/Common/Array.h>
+#include <OpenSim/Common/Logger.h>
 
 
 
@@ -133,11 +135,16 @@ setNull()
     _specifiedDT = false;
     _constantDT = false;
     _dt = 1.0e-4;
+    _useDenseOutput = false;
+    _integratorStepFixed = false;
     _performAnalyses=true;
     _writeToStorage=true;
     _tArray.setSize(0);
     _system = 0;
     _dtArray.setSize(0);
+    _checkpointInterval = 0.0;
+    _checkpointFileName = "";
+    _resumeCheckpoint = NULL;
 }
 //_____________________________________________________________________________
 /**
@@ -306,6 +313,42 @@ getUseConstantDT() const
 {
     return(_constantDT);
 }
+
+//-----------------------------------------------------------------------------
+// DENSE OUTPUT
+//-----------------------------------------------------------------------------
+//_____________________________________________________________________________
+/**
+ * Set whether constant or specified time steps are used only as report
+ * times. When true, the integrator is not forced to take fixed steps;
+ * it takes its own error-controlled steps and the states at the report
+ * times are interpolated from its steps. Analyses and storage see the
+ * same times as with fixed steps, usually at a fraction of the cost.
+ * This flag has no effect on variable-step integrations. The integrator's
+ * settings are not changed, so its step sizes should not have been fixed.
+ *
+ * @param aTrueFalse If true, report times are reached by interpolation.
+ *
+ * @see setUseConstantDT()
+ * @see setUseSpecifiedDT()
+ */
+void Manager::
+setUseDenseOutput(bool aTrueFalse)
+{
+    _useDenseOutput = aTrueFalse;
+}
+//_____________________________________________________________________________
+/**
+ * Get whether constant or specified time steps are used only as report
+ * times.
+ *
+ * @see setUseDenseOutput()
+ */
+bool Manager::
+getUseDenseOutput() const
+{
+    return(_useDenseOutput);
+}
 //-----------------------------------------------------------------------------
 // DT ARRAY
 //-----------------------------------------------------------------------------
@@ -365,7 +408,7 @@ double Manager::
 getDTArrayDT(int aStep)
 {
     if((aStep<0) || (aStep>=_dtArray.getSize())) {
-        printf("Manager.getDTArrayDT: ERR- invalid step.\n");
+        OPENSIM_LOG_ERROR("Manager.getDTArrayDT: ERR- invalid step.");
         return(SimTK::NaN);
     }
 
@@ -385,8 +428,8 @@ printDTArray(const char *aFileName)
     } else {
         fp = fopen(aFileName,"w");
         if(fp==NULL) {
-            printf("Manager.printDTArray: unable to print to file %s.\n",
-                aFileName);
+            OPENSIM_LOG_ERROR("Manager.printDTArray: unable to print to file "
+                << aFileName << ".");
             fp = stdout;
         }
     }
@@ -456,7 +499,7 @@ double Manager::
 getTimeArrayTime(int aStep)
 {
     if((aStep<0) || (aStep>=_tArray.getSize())) {
-        printf("Manager.getTimeArrayTime: ERR- invalid step.\n");
+        OPENSIM_LOG_ERROR("Manager.getTimeArrayTime: ERR- invalid step.");
         return(SimTK::NaN);
     }
 
@@ -480,8 +523,8 @@ printTimeArray(const char *aFileName)
     } else {
         fp = fopen(aFileName,"w");
         if(fp==NULL) {
-            printf("Manager.printTimeArray: unable to print to file %s.\n",
-                aFileName);
+            OPENSIM_LOG_ERROR("Manager.printTimeArray: unable to print to file "
+                << aFileName << ".");
             fp = stdout;
         }
     }
@@ -559,6 +602,7 @@ void Manager::
 setIntegrator(SimTK::Integrator& integrator) 
 {   
     _integ = &integrator;
+    _integratorStepFixed = false;
 }
 
 
@@ -675,6 +719,169 @@ hasStateStorage() const
     return (_stateStore != NULL);
 }
 
+//-----------------------------------------------------------------------------
+// CHECKPOINTS
+//-----------------------------------------------------------------------------
+//_____________________________________________________________________________
+/**
+ * Set the simulation time between checkpoints written during an
+ * integration. A checkpoint is written after the first reported step at or
+ * past each multiple of the interval from the initial time. Each checkpoint
+ * writes all rows of the state, control and analysis storages recorded so
+ * far, so short intervals are costly in long simulations. Analyses that
+ * stream their results keep only their most recent rows, so integrating
+ * with checkpoints throws an Exception if any analysis streams results.
+ *
+ * @param aInterval Time between checkpoints. If 0, no checkpoints are
+ * written.
+ *
+ * @see setCheckpointFileName()
+ * @see resume()
+ */
+void Manager::
+setCheckpointInterval(double aInterval)
+{
+    if(aInterval < 0.0)
+        throw Exception("Manager::setCheckpointInterval: the interval must "
+                        "be non-negative.", __FILE__, __LINE__);
+    _checkpointInterval = aInterval;
+}
+double Manager::
+getCheckpointInterval() const
+{
+    return(_checkpointInterval);
+}
+//_____________________________________________________________________________
+/**
+ * Set the file to which checkpoints are written. Each checkpoint replaces
+ * the previous one. If no file name is set, checkpoints are written to
+ * "<session name>_checkpoint.ockpt".
+ */
+void Manager::
+setCheckpointFileName(const std::string& aFileName)
+{
+    _checkpointFileName = aFileName;
+}
+const std::string& Manager::
+getCheckpointFileName() const
+{
+    return(_checkpointFileName);
+}
+//_____________________________________________________________________________
+/**
+ * Set a function that adds to each checkpoint the state of objects the
+ * Manager does not know about, such as the internal state of a controller.
+ * It is called by captureCheckpoint().
+ */
+void Manager::
+setCheckpointCallback(
+    const std::function<void(SimulationCheckpoint&)>& aCallback)
+{
+    _checkpointCallback = aCallback;
+}
+//_____________________________________________________________________________
+/**
+ * Record the progress of an integration: the state, the step counter, the
+ * state and control storages, the storages of the model's analyses and
+ * whatever the checkpoint callback adds.
+ *
+ * @param s State reached by the integration.
+ * @param step Number of steps reported so far.
+ * @param rCheckpoint Checkpoint to fill in.
+ */
+void Manager::
+captureCheckpoint(const SimTK::State& s, int step,
+                  SimulationCheckpoint& rCheckpoint) const
+{
+    rCheckpoint.captureState(s);
+    rCheckpoint.setStep(step);
+
+    if(hasStateStorage())
+        rCheckpoint.setStorage("states", getStateStorage());
+    if(_model->isControlled() && _controllerSet->getControlStorage())
+        rCheckpoint.setStorage("controls",
+                               *_controllerSet->getControlStorage());
+
+    AnalysisSet& analysisSet = _model->updAnalysisSet();
+    for(int i=0; i<analysisSet.getSize(); ++i) {
+        Analysis& analysis = analysisSet.get(i);
+        ArrayPtrs<Storage>& storages = analysis.getStorageList();
+        for(int j=0; j<storages.getSize(); ++j) {
+            rCheckpoint.setStorage("analysis." + analysis.getName() + "." +
+                                   std::to_string(j), *storages[j]);
+        }
+    }
+
+    if(_checkpointCallback) _checkpointCallback(rCheckpoint);
+}
+//_____________________________________________________________________________
+/**
+ * Restore the storages recorded by captureCheckpoint(), after the analyses
+ * have begun.
+ */
+void Manager::
+restoreCheckpointStorages(const SimulationCheckpoint& aCheckpoint)
+{
+    if(hasStateStorage() && aCheckpoint.hasStorage("states"))
+        aCheckpoint.restoreStorage("states", getStateStorage());
+    if(_model->isControlled() && _controllerSet->getControlStorage() &&
+            aCheckpoint.hasStorage("controls"))
+        aCheckpoint.restoreStorage("controls",
+                                   *_controllerSet->getControlStorage());
+
+    AnalysisSet& analysisSet = _model->updAnalysisSet();
+    for(int i=0; i<analysisSet.getSize(); ++i) {
+        Analysis& analysis = analysisSet.get(i);
+        ArrayPtrs<Storage>& storages = analysis.getStorageList();
+        for(int j=0; j<storages.getSize(); ++j) {
+            const string key = "analysis." + analysis.getName() + "." +
+                               std::to_string(j);
+            if(aCheckpoint.hasStorage(key))
+                aCheckpoint.restoreStorage(key, *storages[j]);
+        }
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Continue an integration from a checkpoint to the final time. The state,
+ * step counter and storages are restored from the checkpoint, and the
+ * integration starts at the checkpoint's time with the step size the
+ * integrator would have taken next. With constant or specified time steps,
+ * or with a Runge-Kutta integrator, whose steps depend only on the state and
+ * the step size, the continuation is the same as an uninterrupted
+ * integration. Objects that were added to the checkpoint by the checkpoint
+ * callback must be restored by the caller before calling resume().
+ *
+ * @param s State of the model; it must have the same variables as the
+ * checkpointed State, e.g. as returned by Model::initSystem().
+ * @param aCheckpoint Checkpoint to continue from; it is not modified.
+ * @param dtFirst First step size if the checkpoint does not have one.
+ */
+bool Manager::
+resume(SimTK::State& s, const SimulationCheckpoint& aCheckpoint,
+       double dtFirst)
+{
+    aCheckpoint.restoreState(s);
+    _ti = aCheckpoint.getTime();
+
+    bool fixedStep = _constantDT || _specifiedDT;
+    if(!fixedStep && aCheckpoint.getStepSize() > 0.0) {
+        _integ->setInitialStepSize(aCheckpoint.getStepSize());
+        dtFirst = aCheckpoint.getStepSize();
+    }
+
+    _resumeCheckpoint = &aCheckpoint;
+    bool status;
+    try {
+        status = doIntegration(s, aCheckpoint.getStep(), dtFirst);
+    } catch(...) {
+        _resumeCheckpoint = NULL;
+        throw;
+    }
+    _resumeCheckpoint = NULL;
+    return status;
+}
+
 //-----------------------------------------------------------------------------
 // INTEGRATION
 //-----------------------------------------------------------------------------
@@ -746,8 +953,19 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
                                        : _model->getMultibodySystem();
     SimTK::TimeStepper ts(sys, *_integ);
 
+    // With dense output the fixed steps are only report times: the
+    // integrator keeps its error control and the TimeStepper interpolates
+    // the states at the report times. The integrator's own settings (final
+    // time, step sizes, returning every internal step) are left as they
+    // are, since they cannot be read back to restore them afterwards.
+    bool denseOutput = fixedStep && _useDenseOutput;
+    if( denseOutput && _integratorStepFixed )
+        OPENSIM_LOG_WARN("Manager: the integrator still has the fixed step "
+            "size of an earlier integration; reset its step sizes for dense "
+            "output to use error-controlled steps.");
+
     ts.initialize(s);
-    ts.setReportAllSignificantStates(true);
+    ts.setReportAllSignificantStates(!denseOutput);
     SimTK::Integrator::SuccessfulStepStatus status;
 
     if( fixedStep ) {
@@ -764,8 +982,10 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
     if(_system == NULL)
         sys.realize(s, SimTK::Stage::Velocity); // this is multibody system 
     initialize(s, dt);  
+    if( _resumeCheckpoint ) restoreCheckpointStorages(*_resumeCheckpoint);
 
-    if( fixedStep){
+    // The initial state of a resumed integration is already recorded.
+    if( fixedStep && !_resumeCheckpoint ){
         s.updTime() = time;
         sys.realize(s, SimTK::Stage::Acceleration);
 
@@ -783,12 +1003,41 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
 
     double stepToTime = _tf;
 
+    // CHECKPOINTS
+    // Streamed analyses keep only their most recent rows in memory, so a
+    // checkpoint could not record their results; fail before integrating.
+    if( _checkpointInterval > 0.0 && _performAnalyses ) {
+        const AnalysisSet& analysisSet = _model->getAnalysisSet();
+        for(int i=0; i<analysisSet.getSize(); ++i) {
+            const Analysis& analysis = analysisSet.get(i);
+            if( analysis.getOn() && analysis.getStreamResults() )
+                throw Exception("Manager: analysis " + analysis.getName() +
+                    " streams its results, which cannot be checkpointed. "
+                    "Turn off stream_results to write checkpoints.",
+                    __FILE__, __LINE__);
+        }
+    }
+    double nextCheckpointTime = time + _checkpointInterval;
+    const std::string checkpointFileName = _checkpointFileName.empty() ?
+        _sessionName + "_checkpoint.ockpt" : _checkpointFileName;
+
     // LOOP
     while( time  < _tf ) {
-        if( fixedStep ){
+        if( denseOutput ) {
+            // Next report time; the constant grid is computed from _ti so
+            // that interpolated times do not accumulate round-off.
+            if( _constantDT ) {
+                double n = floor((time - _ti)/_dt + 1.0e-9);
+                stepToTime = _ti + (n + 1.0)*_dt;
+            } else {
+                stepToTime = getNextTimeArrayTime( time );
+            }
+            if( !(stepToTime < _tf) ) stepToTime = _tf;
+        } else if( fixedStep ){
               fixedStepSize = getNextTimeArrayTime( time ) - time;
              if( fixedStepSize + time  >= _tf )  fixedStepSize = _tf - time;
              _integ->setFixedStepSize( fixedStepSize );
+             _integratorStepFixed = true;
              stepToTime = time + fixedStepSize; 
         }
 
@@ -798,10 +1047,23 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
         // need to record it again.
         status = ts.stepTo(stepToTime);
 
+        // An integrator that returns every internal step may return before
+        // the report time; only report times are recorded.
+        if( denseOutput && status == SimTK::Integrator::TimeHasAdvanced
+            && _integ->getState().getTime() < stepToTime ) {
+            time = _integ->getState().getTime();
+            if(checkHalt()) break;
+            continue;
+        }
+
         if( status != SimTK::Integrator::EndOfSimulation ) {
             const SimTK::State& s =  _integ->getState();
+            // An interpolated state is only realized through Velocity.
+            if( denseOutput ) sys.realize(s, SimTK::Stage::Acceleration);
             if(_performAnalyses)_model->updAnalysisSet().step(s,step);
             tReal = s.getTime();
+            OPENSIM_LOG_TRACE("Manager: step " << step << ", t = " << tReal
+                << ", step size = " << _integ->getPreviousStepSizeTaken());
             if( _writeToStorage) {
                 SimTK::Vector stateValues = _model->getStateVariableValues(s);
                 StateVector vec;
@@ -811,6 +1073,17 @@ bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
                     _controllerSet->storeControls(s, step);
             }
             step++;
+
+            if( _checkpointInterval > 0.0 && tReal >= nextCheckpointTime ) {
+                SimulationCheckpoint checkpoint;
+                captureCheckpoint(s, step, checkpoint);
+                checkpoint.setStepSize(_integ->getPredictedNextStepSize());
+                checkpoint.write(checkpointFileName);
+                OPENSIM_LOG_DEBUG("Manager: wrote checkpoint at t = " << tReal
+                    << " to " << checkpointFileName);
+                while( nextCheckpointTime <= tReal )
+                    nextCheckpointTime += _checkpointInterval;
+            }
         }
         else
             halt();
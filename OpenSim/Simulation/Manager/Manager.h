@@ -32,6 +32,7 @@
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Simulation/osimSimulationDLL.h>
 #include "SimTKsimbody.h"
+#include <functional>
 
 
 namespace OpenSim { 
@@ -39,6 +40,7 @@ namespace OpenSim {
 class Model;
 class Storage;
 class ControllerSet;
+class SimulationCheckpoint;
 
 //=============================================================================
 //=============================================================================
@@ -92,6 +94,12 @@ private:
    bool _constantDT;
    /** Constant integration time step. */
    double _dt;
+   /** Flag to indicate whether the constant or specified time steps are
+   only report times: the integrator keeps its own error-controlled step
+   sizes and states at the report times are interpolated. */
+   bool _useDenseOutput;
+   /** Whether an integration has fixed the integrator's step size. */
+   bool _integratorStepFixed;
    /** Vector of integration time steps. */
    Array<double> _tArray;
    /** Vector of integration time step deltas. */
@@ -112,6 +120,15 @@ private:
     /** system of equations to be integrated */
     const SimTK::System* _system;
 
+    /** Simulation time between checkpoints; 0 if none are written. */
+    double _checkpointInterval;
+    /** File to which checkpoints are written. */
+    std::string _checkpointFileName;
+    /** Adds the state of other objects (e.g., controllers) to checkpoints. */
+    std::function<void(SimulationCheckpoint&)> _checkpointCallback;
+    /** Checkpoint the integration in progress continues from, if any. */
+    const SimulationCheckpoint* _resumeCheckpoint;
+
 
 //=============================================================================
 // METHODS
@@ -128,6 +145,7 @@ private:
     void setNull();
     bool constructStates();
     bool constructStorage();
+    void restoreCheckpointStorages(const SimulationCheckpoint& aCheckpoint);
     //--------------------------------------------------------------------------
     // GET AND SET
     //--------------------------------------------------------------------------
@@ -157,6 +175,9 @@ public:
    // CONSTANT TIME STEP
    void setUseConstantDT(bool aTrueFalse);
    bool getUseConstantDT() const;
+   // DENSE OUTPUT
+   void setUseDenseOutput(bool aTrueFalse);
+   bool getUseDenseOutput() const;
    // DT VECTOR
    const Array<double>& getDTArray();
    void setDTArray(int aN,const double aDT[],double aTI=0.0);
@@ -186,6 +207,18 @@ public:
     void finalize( SimTK::State& s);
     double getFixedStepSize(int tArrayStep) const;
 
+    // CHECKPOINTS
+    void setCheckpointInterval(double aInterval);
+    double getCheckpointInterval() const;
+    void setCheckpointFileName(const std::string& aFileName);
+    const std::string& getCheckpointFileName() const;
+    void setCheckpointCallback(
+        const std::function<void(SimulationCheckpoint&)>& aCallback);
+    void captureCheckpoint(const SimTK::State& s, int step,
+                           SimulationCheckpoint& rCheckpoint) const;
+    bool resume(SimTK::State& s, const SimulationCheckpoint& aCheckpoint,
+                double dtFirst=1.0e-6);
+
     // STATE STORAGE
     bool hasStateStorage() const;
     void setStateStorage(Storage& aStorage);
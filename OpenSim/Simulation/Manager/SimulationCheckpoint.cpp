@@ -0,0 +1,485 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  SimulationCheckpoint.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "SimulationCheckpoint.h"
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Common/Storage.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+using namespace std;
+using namespace OpenSim;
+
+// Identifies a checkpoint file and the layout of its contents.
+static const char CheckpointMagic[8] = { 'O','S','I','M','C','K','P','T' };
+static const int32_t CheckpointFormatVersion = 1;
+
+// Types of the discrete variables that are recorded.
+enum DiscreteType { DiscreteReal, DiscreteInt, DiscreteBool, DiscreteVec3,
+                    DiscreteVector };
+
+//=============================================================================
+// BINARY STREAM HELPERS
+//=============================================================================
+static void checkStream(istream& in)
+{
+    if (!in)
+        throw Exception("SimulationCheckpoint: unexpected end of checkpoint.",
+                        __FILE__, __LINE__);
+}
+
+static void writeInt(ostream& out, int32_t value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static int32_t readInt(istream& in)
+{
+    int32_t value = 0;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    checkStream(in);
+    return value;
+}
+
+static int32_t readSize(istream& in)
+{
+    const int32_t size = readInt(in);
+    if (size < 0)
+        throw Exception("SimulationCheckpoint: corrupt checkpoint.",
+                        __FILE__, __LINE__);
+    return size;
+}
+
+static void writeDouble(ostream& out, double value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static double readDouble(istream& in)
+{
+    double value = 0;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    checkStream(in);
+    return value;
+}
+
+static void writeDoubles(ostream& out, const double* values, int size)
+{
+    writeInt(out, size);
+    if (size > 0)
+        out.write(reinterpret_cast<const char*>(values),
+                  size*sizeof(double));
+}
+
+static void readDoubles(istream& in, vector<double>& values)
+{
+    values.resize(readSize(in));
+    if (!values.empty())
+        in.read(reinterpret_cast<char*>(&values[0]),
+                values.size()*sizeof(double));
+    checkStream(in);
+}
+
+static void writeVector(ostream& out, const SimTK::Vector& vector)
+{
+    // Copy in case the Vector is a view with a stride.
+    std::vector<double> values(vector.size());
+    for (int i = 0; i < vector.size(); ++i)
+        values[i] = vector[i];
+    writeDoubles(out, values.empty() ? nullptr : &values[0],
+                 (int)values.size());
+}
+
+static void readVector(istream& in, SimTK::Vector& vector)
+{
+    std::vector<double> values;
+    readDoubles(in, values);
+    vector.resize((int)values.size());
+    for (int i = 0; i < vector.size(); ++i)
+        vector[i] = values[i];
+}
+
+static void writeString(ostream& out, const string& str)
+{
+    writeInt(out, (int32_t)str.size());
+    out.write(str.data(), str.size());
+}
+
+static string readString(istream& in)
+{
+    string str(readSize(in), '\0');
+    if (!str.empty())
+        in.read(&str[0], str.size());
+    checkStream(in);
+    return str;
+}
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+SimulationCheckpoint::SimulationCheckpoint() :
+    _time(0.0),
+    _step(0),
+    _stepSize(0.0)
+{
+}
+
+SimulationCheckpoint::SimulationCheckpoint(const string& fileName) :
+    SimulationCheckpoint()
+{
+    ifstream in(fileName.c_str(), ios_base::in | ios_base::binary);
+    if (!in.good())
+        throw Exception("SimulationCheckpoint: could not open file '" +
+                        fileName + "'.", __FILE__, __LINE__);
+    readFromStream(in);
+}
+
+//=============================================================================
+// STATE
+//=============================================================================
+void SimulationCheckpoint::captureState(const SimTK::State& s)
+{
+    _time = s.getTime();
+    _y = s.getY();
+
+    _numDiscreteVariables.clear();
+    _discreteValues.clear();
+    for (SimTK::SubsystemIndex ss(0); ss < s.getNumSubsystems(); ++ss) {
+        const int nd = s.getNDiscreteVariables(ss);
+        _numDiscreteVariables.push_back(nd);
+        for (SimTK::DiscreteVariableIndex dv(0); dv < nd; ++dv) {
+            const SimTK::AbstractValue& value = s.getDiscreteVariable(ss, dv);
+            DiscreteValue recorded;
+            recorded.subsystem = ss;
+            recorded.index = dv;
+            if (SimTK::Value<double>::isA(value)) {
+                recorded.type = DiscreteReal;
+                recorded.values.push_back(
+                    SimTK::Value<double>::downcast(value).get());
+            } else if (SimTK::Value<int>::isA(value)) {
+                recorded.type = DiscreteInt;
+                recorded.values.push_back(
+                    SimTK::Value<int>::downcast(value).get());
+            } else if (SimTK::Value<bool>::isA(value)) {
+                recorded.type = DiscreteBool;
+                recorded.values.push_back(
+                    SimTK::Value<bool>::downcast(value).get() ? 1.0 : 0.0);
+            } else if (SimTK::Value<SimTK::Vec3>::isA(value)) {
+                recorded.type = DiscreteVec3;
+                const SimTK::Vec3& v =
+                    SimTK::Value<SimTK::Vec3>::downcast(value).get();
+                recorded.values.assign(&v[0], &v[0] + 3);
+            } else if (SimTK::Value<SimTK::Vector>::isA(value)) {
+                recorded.type = DiscreteVector;
+                const SimTK::Vector& v =
+                    SimTK::Value<SimTK::Vector>::downcast(value).get();
+                for (int i = 0; i < v.size(); ++i)
+                    recorded.values.push_back(v[i]);
+            } else {
+                // Other types are topology or instance settings that the
+                // Model gives every State it creates.
+                continue;
+            }
+            _discreteValues.push_back(recorded);
+        }
+    }
+}
+
+void SimulationCheckpoint::restoreState(SimTK::State& s) const
+{
+    if (s.getNY() != _y.size())
+        throw Exception("SimulationCheckpoint: the State has " +
+            to_string(s.getNY()) + " continuous state variables but the "
+            "checkpoint has " + to_string(_y.size()) + ".",
+            __FILE__, __LINE__);
+    bool sameDiscreteVariables =
+        s.getNumSubsystems() == (int)_numDiscreteVariables.size();
+    for (int ss = 0; sameDiscreteVariables && ss < s.getNumSubsystems(); ++ss)
+        sameDiscreteVariables = s.getNDiscreteVariables(
+            SimTK::SubsystemIndex(ss)) == _numDiscreteVariables[ss];
+    if (!sameDiscreteVariables)
+        throw Exception("SimulationCheckpoint: the State's discrete "
+            "variables do not match those of the checkpoint.",
+            __FILE__, __LINE__);
+
+    s.setTime(_time);
+    s.updY() = _y;
+
+    for (const DiscreteValue& recorded : _discreteValues) {
+        SimTK::AbstractValue& value = s.updDiscreteVariable(
+            SimTK::SubsystemIndex(recorded.subsystem),
+            SimTK::DiscreteVariableIndex(recorded.index));
+        bool typeMatches = false;
+        switch (recorded.type) {
+        case DiscreteReal:
+            if ((typeMatches = SimTK::Value<double>::isA(value)))
+                SimTK::Value<double>::updDowncast(value).upd() =
+                    recorded.values[0];
+            break;
+        case DiscreteInt:
+            if ((typeMatches = SimTK::Value<int>::isA(value)))
+                SimTK::Value<int>::updDowncast(value).upd() =
+                    (int)recorded.values[0];
+            break;
+        case DiscreteBool:
+            if ((typeMatches = SimTK::Value<bool>::isA(value)))
+                SimTK::Value<bool>::updDowncast(value).upd() =
+                    recorded.values[0] != 0.0;
+            break;
+        case DiscreteVec3:
+            if ((typeMatches = SimTK::Value<SimTK::Vec3>::isA(value))) {
+                SimTK::Vec3& v =
+                    SimTK::Value<SimTK::Vec3>::updDowncast(value).upd();
+                std::copy(recorded.values.begin(), recorded.values.end(),
+                          &v[0]);
+            }
+            break;
+        case DiscreteVector:
+            if ((typeMatches = SimTK::Value<SimTK::Vector>::isA(value))) {
+                SimTK::Vector& v =
+                    SimTK::Value<SimTK::Vector>::updDowncast(value).upd();
+                v.resize((int)recorded.values.size());
+                for (int i = 0; i < v.size(); ++i)
+                    v[i] = recorded.values[i];
+            }
+            break;
+        }
+        if (!typeMatches)
+            throw Exception("SimulationCheckpoint: discrete variable " +
+                to_string(recorded.index) + " of subsystem " +
+                to_string(recorded.subsystem) + " has a different type "
+                "than in the checkpoint.", __FILE__, __LINE__);
+    }
+}
+
+//=============================================================================
+// STORAGES AND DATA
+//=============================================================================
+void SimulationCheckpoint::setStorage(const string& key,
+                                      const Storage& aStorage)
+{
+    // Rows discarded from memory while streaming to a file cannot be
+    // recorded, and a resumed run would be missing them.
+    if (aStorage.getOutputFileName() != "" && aStorage.getMemoryWindow() > 0)
+        throw Exception("SimulationCheckpoint: storage '" + key + "' keeps "
+            "only its most recent rows in memory and cannot be recorded. "
+            "Turn off streaming of results to write checkpoints.",
+            __FILE__, __LINE__);
+    StorageData& data = _storages[key];
+    const Array<string>& labels = aStorage.getColumnLabels();
+    data.labels.clear();
+    for (int i = 0; i < labels.getSize(); ++i)
+        data.labels.push_back(labels[i]);
+    data.times.resize(aStorage.getSize());
+    data.rows.resize(aStorage.getSize());
+    for (int i = 0; i < aStorage.getSize(); ++i) {
+        const StateVector* row = aStorage.getStateVector(i);
+        const Array<double>& values = row->getData();
+        data.times[i] = row->getTime();
+        data.rows[i].assign(values.get(), values.get() + values.getSize());
+    }
+}
+
+void SimulationCheckpoint::restoreStorage(const string& key,
+                                          Storage& rStorage) const
+{
+    auto found = _storages.find(key);
+    if (found == _storages.end())
+        throw Exception("SimulationCheckpoint: no storage '" + key + "'.",
+                        __FILE__, __LINE__);
+    const StorageData& data = found->second;
+    if (rStorage.getColumnLabels().getSize() == 0) {
+        Array<string> labels;
+        for (const string& label : data.labels)
+            labels.append(label);
+        rStorage.setColumnLabels(labels);
+    }
+    // Rows already written to the storage's output file, e.g. by the
+    // analyses at the start of the resumed integration, are replaced by the
+    // recorded rows: the file is started again once they are restored.
+    const string outputFileName = rStorage.getOutputFileName();
+    if (outputFileName != "")
+        rStorage.closeOutputFile();
+    rStorage.purge();
+    for (size_t i = 0; i < data.rows.size(); ++i)
+        rStorage.append(data.times[i], (int)data.rows[i].size(),
+                        data.rows[i].empty() ? nullptr : &data.rows[i][0],
+                        false);
+    if (outputFileName != "")
+        rStorage.setOutputFileName(outputFileName);
+}
+
+const SimTK::Vector& SimulationCheckpoint::getData(const string& key) const
+{
+    auto found = _data.find(key);
+    if (found == _data.end())
+        throw Exception("SimulationCheckpoint: no data '" + key + "'.",
+                        __FILE__, __LINE__);
+    return found->second;
+}
+
+//=============================================================================
+// READ AND WRITE
+//=============================================================================
+void SimulationCheckpoint::write(const string& fileName) const
+{
+    const string tempFileName = fileName + ".tmp";
+    {
+        ofstream out(tempFileName.c_str(), ios_base::out | ios_base::binary);
+        if (!out.good())
+            throw Exception("SimulationCheckpoint: could not open file '" +
+                            tempFileName + "' for writing.",
+                            __FILE__, __LINE__);
+        writeToStream(out);
+        out.flush();
+        if (!out.good())
+            throw Exception("SimulationCheckpoint: failed to write file '" +
+                            tempFileName + "'.", __FILE__, __LINE__);
+    }
+    // rename() does not replace an existing file on all platforms.
+    std::remove(fileName.c_str());
+    if (std::rename(tempFileName.c_str(), fileName.c_str()) != 0)
+        throw Exception("SimulationCheckpoint: could not rename '" +
+                        tempFileName + "' to '" + fileName + "'.",
+                        __FILE__, __LINE__);
+}
+
+void SimulationCheckpoint::writeToStream(ostream& out) const
+{
+    out.write(CheckpointMagic, sizeof(CheckpointMagic));
+    writeInt(out, CheckpointFormatVersion);
+
+    writeDouble(out, _time);
+    writeInt(out, _step);
+    writeDouble(out, _stepSize);
+    writeVector(out, _y);
+
+    writeInt(out, (int32_t)_numDiscreteVariables.size());
+    for (int nd : _numDiscreteVariables)
+        writeInt(out, nd);
+    writeInt(out, (int32_t)_discreteValues.size());
+    for (const DiscreteValue& recorded : _discreteValues) {
+        writeInt(out, recorded.subsystem);
+        writeInt(out, recorded.index);
+        writeInt(out, recorded.type);
+        writeDoubles(out, recorded.values.empty() ? nullptr :
+                     &recorded.values[0], (int)recorded.values.size());
+    }
+
+    writeInt(out, (int32_t)_storages.size());
+    for (const auto& entry : _storages) {
+        const StorageData& data = entry.second;
+        writeString(out, entry.first);
+        writeInt(out, (int32_t)data.labels.size());
+        for (const string& label : data.labels)
+            writeString(out, label);
+        writeInt(out, (int32_t)data.rows.size());
+        for (size_t i = 0; i < data.rows.size(); ++i) {
+            writeDouble(out, data.times[i]);
+            writeDoubles(out, data.rows[i].empty() ? nullptr :
+                         &data.rows[i][0], (int)data.rows[i].size());
+        }
+    }
+
+    writeInt(out, (int32_t)_data.size());
+    for (const auto& entry : _data) {
+        writeString(out, entry.first);
+        writeVector(out, entry.second);
+    }
+}
+
+void SimulationCheckpoint::readFromStream(istream& in)
+{
+    char magic[sizeof(CheckpointMagic)];
+    in.read(magic, sizeof(magic));
+    if (!in || !std::equal(magic, magic + sizeof(magic), CheckpointMagic))
+        throw Exception("SimulationCheckpoint: not a simulation checkpoint.",
+                        __FILE__, __LINE__);
+    if (readInt(in) != CheckpointFormatVersion)
+        throw Exception("SimulationCheckpoint: unsupported checkpoint format "
+                        "version.", __FILE__, __LINE__);
+
+    _time = readDouble(in);
+    _step = readInt(in);
+    _stepSize = readDouble(in);
+    readVector(in, _y);
+
+    _numDiscreteVariables.resize(readSize(in));
+    for (int& nd : _numDiscreteVariables)
+        nd = readSize(in);
+    _discreteValues.resize(readSize(in));
+    for (DiscreteValue& recorded : _discreteValues) {
+        recorded.subsystem = readSize(in);
+        recorded.index = readSize(in);
+        recorded.type = readInt(in);
+        readDoubles(in, recorded.values);
+        // restoreState() indexes the State and reads the values by these.
+        bool valid =
+            recorded.subsystem < (int)_numDiscreteVariables.size() &&
+            recorded.index < _numDiscreteVariables[recorded.subsystem];
+        switch (recorded.type) {
+        case DiscreteReal:
+        case DiscreteInt:
+        case DiscreteBool:
+            valid = valid && recorded.values.size() == 1;
+            break;
+        case DiscreteVec3:
+            valid = valid && recorded.values.size() == 3;
+            break;
+        case DiscreteVector:
+            break;
+        default:
+            valid = false;
+        }
+        if (!valid)
+            throw Exception("SimulationCheckpoint: corrupt checkpoint.",
+                            __FILE__, __LINE__);
+    }
+
+    _storages.clear();
+    const int32_t nStorages = readSize(in);
+    for (int32_t k = 0; k < nStorages; ++k) {
+        StorageData& data = _storages[readString(in)];
+        data.labels.resize(readSize(in));
+        for (string& label : data.labels)
+            label = readString(in);
+        const int32_t nRows = readSize(in);
+        data.times.resize(nRows);
+        data.rows.resize(nRows);
+        for (int32_t i = 0; i < nRows; ++i) {
+            data.times[i] = readDouble(in);
+            readDoubles(in, data.rows[i]);
+        }
+    }
+
+    _data.clear();
+    const int32_t nData = readSize(in);
+    for (int32_t k = 0; k < nData; ++k) {
+        const string key = readString(in);
+        readVector(in, _data[key]);
+    }
+}
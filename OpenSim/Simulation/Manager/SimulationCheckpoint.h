@@ -0,0 +1,181 @@
+#ifndef OPENSIM_SIMULATION_CHECKPOINT_H_
+#define OPENSIM_SIMULATION_CHECKPOINT_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  SimulationCheckpoint.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include "SimTKcommon.h"
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+class Storage;
+
+//==============================================================================
+//                            SIMULATION CHECKPOINT
+//==============================================================================
+/** The saved progress of a simulation, from which the simulation can be
+continued as if it had not been interrupted. A checkpoint holds
+
+- the time and continuous state variables (Y, which includes the auxiliary
+  states of muscles and controllers) of a SimTK::State,
+- the values of the State's discrete variables that hold numbers (double,
+  int and bool scalars, Vec3 and Vector), which include the discrete
+  variables of all OpenSim Components,
+- the step counter of the Manager and the integrator's predicted next step
+  size,
+- copies of any number of named Storages (the Manager adds its states,
+  controls and analysis storages), and
+- named vectors of numbers in which other objects, such as a CMC controller,
+  save their internal state.
+
+Manager writes checkpoints periodically during an integration (see
+Manager::setCheckpointInterval()) and continues from one with
+Manager::resume(). Resuming does not modify the checkpoint, so the same
+checkpoint can be used to fan out many continuations of a common prefix,
+e.g. with different controls or final times:
+
+@code
+    SimulationCheckpoint checkpoint("walk_checkpoint.ockpt");
+    for (double tf : {1.5, 2.0, 2.5}) {
+        SimTK::State s = model.initializeState();
+        Manager manager(model, integrator);
+        manager.setFinalTime(tf);
+        manager.resume(s, checkpoint);
+    }
+@endcode
+
+A checkpoint can only be restored into a State of the same Model, i.e., one
+with the same numbers of state and discrete variables. Checkpoint files store
+numbers in the byte order of the machine that wrote them.
+
+Each checkpoint holds complete copies of its Storages, so writing one takes
+time in proportion to the rows recorded so far, and writing checkpoints at a
+fixed interval takes time quadratic in the length of the simulation. For long
+simulations with large storages, choose an interval that keeps the time
+spent writing checkpoints small compared with integrating. **/
+class OSIMSIMULATION_API SimulationCheckpoint {
+public:
+    /** An empty checkpoint at time 0. **/
+    SimulationCheckpoint();
+
+    /** Read a checkpoint that was written by write(). Throws an Exception if
+    the file cannot be read or is not a checkpoint. **/
+    explicit SimulationCheckpoint(const std::string& fileName);
+
+    /** Write this checkpoint to a binary file. The checkpoint is written to a
+    temporary file that then replaces fileName, so that a failure while
+    writing leaves the previous checkpoint intact. **/
+    void write(const std::string& fileName) const;
+
+    //--------------------------------------------------------------------------
+    // STATE
+    //--------------------------------------------------------------------------
+    /** Record the time, continuous state variables and numeric discrete
+    variables of s. **/
+    void captureState(const SimTK::State& s);
+
+    /** Set the time, continuous state variables and numeric discrete
+    variables of s to the recorded values. Throws an Exception if s does not
+    have the same variables as the captured State. **/
+    void restoreState(SimTK::State& s) const;
+
+    double getTime() const { return _time; }
+
+    //--------------------------------------------------------------------------
+    // COUNTERS
+    //--------------------------------------------------------------------------
+    /** The number of integration steps reported before the checkpoint. **/
+    void setStep(int aStep) { _step = aStep; }
+    int getStep() const { return _step; }
+
+    /** The size of the step the integrator would have taken next, or 0 if
+    unknown. **/
+    void setStepSize(double aStepSize) { _stepSize = aStepSize; }
+    double getStepSize() const { return _stepSize; }
+
+    //--------------------------------------------------------------------------
+    // STORAGES
+    //--------------------------------------------------------------------------
+    /** Record the column labels and rows of a Storage under a key. Throws
+    an Exception if the Storage is writing to an output file and discarding
+    older rows from memory (see Storage::setMemoryWindow()). **/
+    void setStorage(const std::string& key, const Storage& aStorage);
+    bool hasStorage(const std::string& key) const
+    {   return _storages.count(key) > 0; }
+    /** Replace the rows of rStorage with the rows recorded under key. The
+    name and output settings of rStorage are kept, as are its column labels
+    unless it has none. If rStorage is writing to an output file, the file
+    is written again with the recorded rows. Throws an Exception if no
+    Storage was recorded under key. **/
+    void restoreStorage(const std::string& key, Storage& rStorage) const;
+
+    //--------------------------------------------------------------------------
+    // DATA
+    //--------------------------------------------------------------------------
+    /** Record a vector of numbers under a key. **/
+    void setData(const std::string& key, const SimTK::Vector& aData)
+    {   _data[key] = aData; }
+    bool hasData(const std::string& key) const
+    {   return _data.count(key) > 0; }
+    /** The vector recorded under key. Throws an Exception if there is
+    none. **/
+    const SimTK::Vector& getData(const std::string& key) const;
+
+private:
+    // A numeric discrete variable of a State.
+    struct DiscreteValue {
+        int subsystem;
+        int index;
+        int type;
+        std::vector<double> values;
+    };
+
+    // The column labels and rows of a Storage.
+    struct StorageData {
+        std::vector<std::string> labels;
+        std::vector<double> times;
+        std::vector<std::vector<double>> rows;
+    };
+
+    void readFromStream(std::istream& in);
+    void writeToStream(std::ostream& out) const;
+
+    double                  _time;
+    int                     _step;
+    double                  _stepSize;
+    SimTK::Vector           _y;
+    std::vector<int>        _numDiscreteVariables;
+    std::vector<DiscreteValue> _discreteValues;
+    std::map<std::string, StorageData>   _storages;
+    std::map<std::string, SimTK::Vector> _data;
+
+//==============================================================================
+};  // END of class SimulationCheckpoint
+//==============================================================================
+} // end of namespace OpenSim
+
+#endif // OPENSIM_SIMULATION_CHECKPOINT_H_
@@ -68,6 +68,9 @@ AbstractTool::AbstractTool():
     _maxDT(_maxDTProp.getValueDbl()),
     _minDT(_minDTProp.getValueDbl()),
     _errorTolerance(_errorToleranceProp.getValueDbl()),
+    _checkpointInterval(_checkpointIntervalProp.getValueDbl()),
+    _checkpointFile(_checkpointFileProp.getValueStr()),
+    _resumeFromCheckpoint(_resumeFromCheckpointProp.getValueBool()),
     _analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
     _analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -100,6 +103,9 @@ AbstractTool::AbstractTool(const string &aFileName, bool aUpdateFromXMLNode):
     _maxDT(_maxDTProp.getValueDbl()),
     _minDT(_minDTProp.getValueDbl()),
     _errorTolerance(_errorToleranceProp.getValueDbl()),
+    _checkpointInterval(_checkpointIntervalProp.getValueDbl()),
+    _checkpointFile(_checkpointFileProp.getValueStr()),
+    _resumeFromCheckpoint(_resumeFromCheckpointProp.getValueBool()),
     _analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
     _analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -162,6 +168,9 @@ AbstractTool::AbstractTool(const AbstractTool &aTool):
     _maxDT(_maxDTProp.getValueDbl()),
     _minDT(_minDTProp.getValueDbl()),
     _errorTolerance(_errorToleranceProp.getValueDbl()),
+    _checkpointInterval(_checkpointIntervalProp.getValueDbl()),
+    _checkpointFile(_checkpointFileProp.getValueStr()),
+    _resumeFromCheckpoint(_resumeFromCheckpointProp.getValueBool()),
     _analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
     _analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -195,6 +204,9 @@ setNull()
     _maxDT = 1.0;
     _minDT = 1.0e-8;
     _errorTolerance = 1.0e-5;
+    _checkpointInterval = 0.0;
+    _checkpointFile = "";
+    _resumeFromCheckpoint = false;
     _toolOwnsModel=true;
     _externalLoadsFileName = "";
 }
@@ -269,6 +281,24 @@ void AbstractTool::setupProperties()
     _errorToleranceProp.setName("integrator_error_tolerance");
     _propertySet.append( &_errorToleranceProp );
 
+    comment = "Simulation time between checkpoints of the integration, from which an "
+              "interrupted integration can be resumed. If 0, no checkpoints are written.";
+    _checkpointIntervalProp.setComment(comment);
+    _checkpointIntervalProp.setName("checkpoint_interval");
+    _propertySet.append( &_checkpointIntervalProp );
+
+    comment = "File to which checkpoints are written and from which the integration is resumed. "
+              "If empty, <name>_checkpoint.ockpt in the results directory is used.";
+    _checkpointFileProp.setComment(comment);
+    _checkpointFileProp.setName("checkpoint_file");
+    _propertySet.append( &_checkpointFileProp );
+
+    comment = "Flag (true or false) indicating whether to resume the integration from the "
+              "checkpoint file rather than start it at the initial time.";
+    _resumeFromCheckpointProp.setComment(comment);
+    _resumeFromCheckpointProp.setName("resume_from_checkpoint");
+    _propertySet.append( &_resumeFromCheckpointProp );
+
     comment = "Set of analyses to be run during the investigation.";
     _analysisSetProp.setComment(comment);
     _analysisSetProp.setName("Analyses");
@@ -316,6 +346,9 @@ operator=(const AbstractTool &aTool)
     _maxDT = aTool._maxDT;
     _minDT = aTool._minDT;
     _errorTolerance = aTool._errorTolerance;
+    _checkpointInterval = aTool._checkpointInterval;
+    _checkpointFile = aTool._checkpointFile;
+    _resumeFromCheckpoint = aTool._resumeFromCheckpoint;
     _analysisSet = aTool._analysisSet;
     _toolOwnsModel = aTool._toolOwnsModel;
 
@@ -372,6 +405,21 @@ getAnalysisSet() const
 {
     return(_analysisSet);
 }
+//-----------------------------------------------------------------------------
+// CHECKPOINTS
+//-----------------------------------------------------------------------------
+//_____________________________________________________________________________
+/**
+ * Get the file that checkpoints are written to and resumed from: the
+ * checkpoint file if one is set, or <name>_checkpoint.ockpt in the results
+ * directory otherwise.
+ */
+std::string AbstractTool::
+getCheckpointFilePath() const
+{
+    if(!_checkpointFile.empty()) return(_checkpointFile);
+    return(_resultsDir + "/" + getName() + "_checkpoint.ockpt");
+}
 
 //=============================================================================
 // LOAD MODEL
@@ -465,6 +513,7 @@ addAnalysisSetToModel()
     for(int i=0;i<size;i++) {
         if(!&_analysisSet.get(i)) continue;
         Analysis *analysis = _analysisSet.get(i).clone();
+        analysis->setResultsDirectory(getResultsDir());
         _model->addAnalysis(analysis);
         _analysisCopies.adoptAndAppend(analysis);
     }
@@ -562,10 +611,9 @@ bool AbstractTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         return false;
     }
 
-    // This is required so that the references to other files inside ExternalLoads file are interpreted 
-    // as relative paths
-    std::string savedCwd = IO::getCwd();
-    IO::chDir(IO::getParentDirectory(aExternalLoadsFileName));
+    // The files named inside the ExternalLoads file are relative to its
+    // directory; resolve them without changing the working directory.
+    const std::string loadsDirectory = IO::getParentDirectory(aExternalLoadsFileName);
     // Create external forces
     try {
         _externalLoads = ExternalLoads(aModel, aExternalLoadsFileName);
@@ -576,10 +624,12 @@ bool AbstractTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         cout << "Error: failed to construct ExternalLoads from file " << aExternalLoadsFileName;
         cout << ". Please make sure the file exists and that it contains an ExternalLoads";
         cout << "object or create a fresh one." << endl;
-        if(getDocument()) IO::chDir(savedCwd);
         throw(ex);
     }
     _externalLoads.setMemoryOwner(false);
+    string dataFileName = _externalLoads.getDataFileName();
+    IO::TrimWhitespace(dataFileName);
+    _externalLoads.setDataFileName(IO::resolvePath(dataFileName, loadsDirectory));
     _externalLoads.invokeConnectToModel(aModel);
 
     string loadKinematicsFileName = _externalLoads.getExternalLoadsModelKinematicsFileName();
@@ -595,9 +645,8 @@ bool AbstractTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         Storage *temp = NULL;
         // fine if there are no kinematics as long as it was not assigned
         if(!(loadKinematicsFileName == "") && !(loadKinematicsFileName == "Unassigned")){
-            temp = new Storage(loadKinematicsFileName);
+            temp = new Storage(IO::resolvePath(loadKinematicsFileName, loadsDirectory));
             if(!temp){
-                IO::chDir(savedCwd);
                 throw Exception("DynamicsTool: could not find external loads kinematics file '"+loadKinematicsFileName+"'."); 
             }
         }
@@ -638,7 +687,6 @@ bool AbstractTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
     if(!loadKinematics)
         delete loadKinematics;
 
-    IO::chDir(savedCwd);
     return(true);
 }
 
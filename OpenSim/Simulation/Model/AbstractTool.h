@@ -117,6 +117,22 @@ protected:
     integrator step size is decreased. */
     PropertyDbl _errorToleranceProp;
     double &_errorTolerance;
+
+    /** Simulation time between checkpoints of the integration, from which
+    the integration can be resumed. If 0, no checkpoints are written. */
+    PropertyDbl _checkpointIntervalProp;
+    double &_checkpointInterval;
+
+    /** File to which checkpoints are written and from which the integration
+    is resumed. If empty, <name>_checkpoint.ockpt in the results directory is
+    used. */
+    PropertyStr _checkpointFileProp;
+    std::string &_checkpointFile;
+
+    /** Whether to resume the integration from the checkpoint file rather
+    than start it at the initial time. */
+    PropertyBool _resumeFromCheckpointProp;
+    bool &_resumeFromCheckpoint;
     
     /** Set of analyses to be run during the study. */
     PropertyObj _analysisSetProp;
@@ -304,6 +320,17 @@ public:
     double getErrorTolerance() const { return _errorTolerance; }
     void setErrorTolerance(double aErrorTolerance) { _errorTolerance = aErrorTolerance; }
 
+    // Checkpoints
+    double getCheckpointInterval() const { return _checkpointInterval; }
+    void setCheckpointInterval(double aInterval) { _checkpointInterval = aInterval; }
+    /** The checkpoint file name as set, which may be empty. */
+    const std::string& getCheckpointFileName() const { return _checkpointFile; }
+    void setCheckpointFileName(const std::string& aFileName) { _checkpointFile = aFileName; }
+    bool getResumeFromCheckpoint() const { return _resumeFromCheckpoint; }
+    void setResumeFromCheckpoint(bool aTrueFalse) { _resumeFromCheckpoint = aTrueFalse; }
+    /** The file that checkpoints are written to and resumed from. */
+    std::string getCheckpointFilePath() const;
+
     // Model xml file
     const std::string& getModelFilename() const { return _modelFile; }
     void setModelFilename(const std::string& aModelFile) { _modelFile = aModelFile; }
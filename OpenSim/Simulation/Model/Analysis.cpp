@@ -31,6 +31,7 @@
 //=============================================================================
 #include "Analysis.h"
 #include "Model.h"
+#include <OpenSim/Common/IO.h>
 
 
 
@@ -51,6 +52,8 @@ Analysis::Analysis(Model *aModel):
     _endTime(_endTimeProp.getValueDbl()),
     _stepInterval(_stepIntervalProp.getValueInt()),
     _inDegrees(_inDegreesProp.getValueBool()),
+    _streamResults(_streamResultsProp.getValueBool()),
+    _streamWindow(_streamWindowProp.getValueInt()),
     _statesStore(NULL)
 {
     
@@ -91,6 +94,8 @@ Analysis::Analysis(const string &aFileName, bool aUpdateFromXMLNode):
     Object(aFileName, false),
     _stepInterval(_stepIntervalProp.getValueInt()),
     _inDegrees(_inDegreesProp.getValueBool()),
+    _streamResults(_streamResultsProp.getValueBool()),
+    _streamWindow(_streamWindowProp.getValueInt()),
     _on(_onProp.getValueBool()),
     _startTime(_startTimeProp.getValueDbl()),
     _endTime(_endTimeProp.getValueDbl()),
@@ -143,6 +148,8 @@ Analysis::Analysis(const Analysis &aAnalysis):
    _endTime(_endTimeProp.getValueDbl()),
    _stepInterval(_stepIntervalProp.getValueInt()),
    _inDegrees(_inDegreesProp.getValueBool()),
+    _streamResults(_streamResultsProp.getValueBool()),
+    _streamWindow(_streamWindowProp.getValueInt()),
    _statesStore(NULL)
 {
     setNull();
@@ -163,6 +170,9 @@ setNull()
     _startTime = -SimTK::Infinity;
     _endTime = SimTK::Infinity;
     _inDegrees=true;
+    _streamResults = false;
+    _streamWindow = 100;
+    _resultsDir = "";
     _storageList.setMemoryOwner(false);
     _printResultFiles=true;
 }
@@ -195,6 +205,18 @@ void Analysis::setupProperties()
         "results are in degrees or not.");
     _inDegreesProp.setName("in_degrees");
     _propertySet.append( &_inDegreesProp );
+
+    _streamResultsProp.setComment("Flag (true or false) indicating whether "
+        "results are written to files as they are recorded, keeping only the "
+        "most recent rows in memory. Use for long simulations. False by "
+        "default.");
+    _streamResultsProp.setName("stream_results");
+    _propertySet.append( &_streamResultsProp );
+
+    _streamWindowProp.setComment("Number of recorded rows of each result kept "
+        "in memory when stream_results is true.");
+    _streamWindowProp.setName("stream_window");
+    _propertySet.append( &_streamWindowProp );
 }
 
 
@@ -222,6 +244,9 @@ operator=(const Analysis &aAnalysis)
 
     _inDegrees = aAnalysis._inDegrees;
     _printResultFiles = aAnalysis._printResultFiles;
+    _streamResults = aAnalysis._streamResults;
+    _streamWindow = aAnalysis._streamWindow;
+    _resultsDir = aAnalysis._resultsDir;
 
     // Class Members
     setStepInterval(aAnalysis.getStepInterval());
@@ -352,6 +377,49 @@ ArrayPtrs<Storage>& Analysis::getStorageList()
     return _storageList;
 }
 
+//-----------------------------------------------------------------------------
+// STREAMING
+//-----------------------------------------------------------------------------
+//_____________________________________________________________________________
+/**
+ * Set the number of recorded rows of each storage kept in memory while
+ * streaming results.
+ *
+ * @param aNumRows Number of rows. Should be 1 or greater.
+ */
+void Analysis::
+setStreamWindow(int aNumRows)
+{
+    _streamWindow = aNumRows;
+    if(_streamWindow<1) _streamWindow = 1;
+}
+//_____________________________________________________________________________
+/**
+ * Start writing the storages of this analysis to files as rows are recorded.
+ * The files are named after the analysis and the storage and are moved to
+ * their final names by printResults() (see Storage::printResult()). Rows are
+ * written on a background thread while the simulation proceeds.
+ */
+void Analysis::
+startStreamingResults()
+{
+    if(!getOn() || !_streamResults) return;
+
+    string dir = (_resultsDir=="") ? "." : _resultsDir;
+    IO::makeDir(dir);
+
+    int window = (_streamWindow<1) ? 1 : _streamWindow;
+    ArrayPtrs<Storage>& storageList = getStorageList();
+    for(int i=0;i<storageList.getSize();i++) {
+        Storage* store = storageList[i];
+        if(store==NULL || store->getOutputFileName()!="") continue;
+        store->setOutputFileName(dir + "/" + getName() + "_" +
+            store->getName() + "_streaming.sto");
+        store->setMemoryWindow(window);
+        store->setAsynchronousOutput(true);
+    }
+}
+
 // GET AND SET
 //=============================================================================
 //_____________________________________________________________________________
@@ -67,6 +67,17 @@ private:
     PropertyBool _inDegreesProp;
     bool &_inDegrees;
 
+    /** Whether or not to write results to files as they are recorded. */
+    PropertyBool _streamResultsProp;
+    bool &_streamResults;
+
+    /** Number of recorded rows kept in memory when streaming results. */
+    PropertyInt _streamWindowProp;
+    int &_streamWindow;
+
+    /** Directory to which streamed results are written. */
+    std::string _resultsDir;
+
     // WORK ARRAYS
     /** Column labels. */
     Array<std::string> _labels;
@@ -213,6 +224,39 @@ public:
     void setPrintResultFiles(bool aToWrite) { _printResultFiles = aToWrite; }
     bool getPrintResultFiles() const { return _printResultFiles; }
 
+    // STREAMING
+    /**
+     * %Set whether results are written to files as they are recorded rather
+     * than only when printResults() is called. While streaming, only the
+     * most recent rows (see setStreamWindow()) of the storages in
+     * getStorageList() are kept in memory, so memory use does not grow with
+     * the length of a simulation. printResults() then completes the streamed
+     * files and moves them to the usual result file names; the time
+     * interval passed to it is ignored, since every recorded row has already
+     * been written.
+     */
+    void setStreamResults(bool aTrueFalse) { _streamResults = aTrueFalse; }
+    bool getStreamResults() const { return _streamResults; }
+    /**
+     * %Set the number of recorded rows of each storage kept in memory while
+     * streaming results.
+     */
+    void setStreamWindow(int aNumRows);
+    int getStreamWindow() const { return _streamWindow; }
+    /**
+     * %Set the directory to which results are streamed. Tools set this to
+     * their results directory; the current directory is used otherwise.
+     */
+    void setResultsDirectory(const std::string& aDir) { _resultsDir = aDir; }
+    const std::string& getResultsDirectory() const { return _resultsDir; }
+    /**
+     * Start writing each storage in getStorageList() to a file in the results
+     * directory, if streaming is on. AnalysisSet::begin() calls this after
+     * begin(), once the storages have been set up for the simulation.
+     * Storages that are already being written are left as they are.
+     */
+    void startStreamingResults();
+
     //--------------------------------------------------------------------------
     // RESULTS
     //--------------------------------------------------------------------------
@@ -203,7 +203,10 @@ begin(SimTK::State& s )
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
-        if (analysis.getOn()) analysis.begin(s);
+        if (analysis.getOn()) {
+            analysis.begin(s);
+            analysis.startStreamingResults();
+        }
     }
 }
 //_____________________________________________________________________________
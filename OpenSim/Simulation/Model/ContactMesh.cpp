@@ -31,7 +31,7 @@ namespace OpenSim {
 ContactMesh::ContactMesh() :
     ContactGeometry(),
     _filename(_filenameProp.getValueStr()),
-    _geometry(NULL)
+    _geometry()
 {
     setNull();
     setupProperties();
@@ -40,7 +40,7 @@ ContactMesh::ContactMesh() :
 ContactMesh::ContactMesh(const std::string& filename, const SimTK::Vec3& location, const SimTK::Vec3& orientation, Body& body) :
     ContactGeometry(location, orientation, body),
     _filename(_filenameProp.getValueStr()),
-    _geometry(NULL)
+    _geometry()
 {
     setNull();
     setupProperties();
@@ -53,14 +53,16 @@ ContactMesh::ContactMesh(const std::string& filename, const SimTK::Vec3& locatio
         file.close();
         SimTK::PolygonalMesh mesh;
         mesh.loadFile(filename);
-        _geometry = new SimTK::ContactGeometry::TriangleMesh(mesh);
+        _geometry = std::make_shared<const SimTK::ContactGeometry::TriangleMesh>(mesh);
+        _bvh = std::make_shared<const TriangleMeshBVH>(*_geometry);
+        _geometryFilename = filename;
     }
 }
 
 ContactMesh::ContactMesh(const std::string& filename, const SimTK::Vec3& location, const SimTK::Vec3& orientation, Body& body, const std::string& name) :
     ContactGeometry(location, orientation, body),
     _filename(_filenameProp.getValueStr()),
-    _geometry(NULL)
+    _geometry()
 {
     setNull();
     setupProperties();
@@ -78,7 +80,9 @@ ContactMesh::ContactMesh(const std::string& filename, const SimTK::Vec3& locatio
 ContactMesh::ContactMesh(const ContactMesh& geom) :
     ContactGeometry(geom),
     _filename(_filenameProp.getValueStr()),
-    _geometry(NULL)
+    _geometry(geom._geometry),
+    _bvh(geom._bvh),
+    _geometryFilename(geom._geometryFilename)
 {
     setNull();
     setupProperties();
@@ -106,40 +110,61 @@ void ContactMesh::setFilename(const std::string& filename)
 {
     _filename = filename;
     _filenameProp.setValueIsDefault(false);
-    if (_geometry != NULL)
-        delete _geometry;
-    _geometry = NULL;
+    // Copies that share the old mesh keep it.
+    _geometry.reset();
+    _bvh.reset();
+}
+
+const SimTK::ContactGeometry::TriangleMesh& ContactMesh::getTriangleMesh() const
+{
+    if (!_geometry)
+        throw Exception("ContactMesh " + getName() + ": the mesh has not "
+            "been loaded; connect the ContactMesh to a model first.",
+            __FILE__, __LINE__);
+    return *_geometry;
+}
+
+const TriangleMeshBVH& ContactMesh::getBVH() const
+{
+    getTriangleMesh();
+    return *_bvh;
+}
+
+void ContactMesh::extendConnectToModel(Model& aModel)
+{
+    Super::extendConnectToModel(aModel);
+    if (_filename != "" && (!_geometry || _geometryFilename != _filename))
+        loadMesh(_filename);
 }
 
 void ContactMesh::loadMesh(const std::string& filename)
 {
-    if (_geometry==NULL){
+    if (!_geometry || _geometryFilename != filename){
         SimTK::PolygonalMesh mesh;
         std::ifstream file;
         assert (_model);
-        const std::string& savedCwd = IO::getCwd();
-        bool restoreDirectory = false;
-        if ((_model->getInputFileName()!="") && (_model->getInputFileName()!="Unassigned")) {
-            std::string parentDirectory = IO::getParentDirectory(_model->getInputFileName());
-            IO::chDir(parentDirectory);
-            restoreDirectory=true;
-        }
-        file.open(filename.c_str());
+        // The file is named relative to the model file.
+        std::string path = filename;
+        if ((_model->getInputFileName()!="") && (_model->getInputFileName()!="Unassigned"))
+            path = IO::resolvePath(filename, IO::getParentDirectory(_model->getInputFileName()));
+        file.open(path.c_str());
         if (file.fail()){
-            if (restoreDirectory) IO::chDir(savedCwd);
             throw Exception("Error loading mesh file: "+filename+". The file should exist in same folder with model.\n Loading is aborted.");
         }
         file.close();
-        mesh.loadFile(filename);
-        if (restoreDirectory) IO::chDir(savedCwd);
-        _geometry = new SimTK::ContactGeometry::TriangleMesh(mesh);
+        mesh.loadFile(path);
+        _geometry = std::make_shared<const SimTK::ContactGeometry::TriangleMesh>(mesh);
+        _bvh = std::make_shared<const TriangleMeshBVH>(*_geometry);
+        _geometryFilename = filename;
     }
 
 }
 
 SimTK::ContactGeometry ContactMesh::createSimTKContactGeometry()
 {
-    if (_geometry == NULL)
+    // The filename may have been changed by deserialization since the mesh
+    // was loaded.
+    if (!_geometry || _geometryFilename != _filename)
         loadMesh(_filename);
     return *_geometry;
 }
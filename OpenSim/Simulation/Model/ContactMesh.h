@@ -24,6 +24,8 @@
  * -------------------------------------------------------------------------- */
 // INCLUDE
 #include "ContactGeometry.h"
+#include "TriangleMeshBVH.h"
+#include <memory>
 
 namespace OpenSim {
 
@@ -39,7 +41,14 @@ OpenSim_DECLARE_CONCRETE_OBJECT(ContactMesh, ContactGeometry);
 // DATA
 //=============================================================================
 private:
-    SimTK::ContactGeometry::TriangleMesh* _geometry;
+    // The mesh is loaded once and then shared, read-only, by copies of this
+    // ContactMesh until their filename is changed.
+    std::shared_ptr<const SimTK::ContactGeometry::TriangleMesh> _geometry;
+    // The bounding volume hierarchy over the faces of _geometry, shared
+    // in the same way.
+    std::shared_ptr<const TriangleMeshBVH> _bvh;
+    // The filename _geometry was loaded from.
+    std::string _geometryFilename;
     PropertyStr _filenameProp;
     std::string& _filename;
 public:
@@ -84,6 +93,8 @@ public:
 
     void copyData(const ContactMesh& source) {
         _geometry = source._geometry;
+        _bvh = source._bvh;
+        _geometryFilename = source._geometryFilename;
         _filename = source._filename;
     }
     SimTK::ContactGeometry createSimTKContactGeometry() override;
@@ -97,6 +108,20 @@ public:
      * %Set the name of the file to load the mesh from.
      */
     void setFilename(const std::string& filename);
+    /**
+     * Get the mesh, which is loaded when the ContactMesh is connected to a
+     * model.
+     */
+    const SimTK::ContactGeometry::TriangleMesh& getTriangleMesh() const;
+    /**
+     * Get the bounding volume hierarchy over the faces of the mesh, which is
+     * built when the mesh is loaded.
+     */
+    const TriangleMeshBVH& getBVH() const;
+
+protected:
+    // ModelComponent interface
+    void extendConnectToModel(Model& aModel) override;
 private:
     // INITIALIZATION
     void setNull();
@@ -250,7 +250,10 @@ void ControllerSet::printInfo() const
 void ControllerSet::computeControls(const SimTK::State& s, SimTK::Vector &controls) const
 {
     for(int i=0;i<getSize(); i++ ) {
-        if(!get(i).isDisabled() )
+        if(!get(i).isDisabled() ) {
+            ComponentProfiler::Scope scope(get(i),
+                                           ComponentProfiler::ComputeControls);
             get(i).computeControls(s, controls);
+        }
     }
 }
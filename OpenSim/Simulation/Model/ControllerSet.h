@@ -83,6 +83,9 @@ public:
     void constructStorage();
     void storeControls( const SimTK::State& s, int step );
     void printControlStorage( const std::string& fileName) const;
+    /** The controls recorded by storeControls(), or NULL if
+    constructStorage() has not been called. */
+    Storage* getControlStorage() const { return _controlStore.get(); }
     void setActuators(Set<Actuator>& actuators);
 
     void setDesiredStates( Storage* yStore); 
@@ -24,12 +24,48 @@
 #include "ElasticFoundationForce.h"
 #include "ContactGeometry.h"
 #include "ContactGeometrySet.h"
+#include "ContactHalfSpace.h"
 #include "ContactMesh.h"
+#include "ContactSphere.h"
 #include "Model.h"
 #include <OpenSim/Simulation/Model/BodySet.h>
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using SimTK::Vec3;
+using SimTK::SpatialVec;
+using SimTK::Transform;
+using SimTK::UnitVec3;
 
 namespace OpenSim {
 
+namespace {
+// The faces of each mesh of a pair of surfaces that may be in contact with
+// the other surface, and the pose of the second surface in the first's frame
+// when they were found.
+struct MeshProximity {
+    MeshProximity() : valid(false) {}
+    bool valid;
+    Transform X_12;
+    std::vector<int> faces1, faces2;
+};
+
+struct MeshProximityCache {
+    std::vector<MeshProximity> pairs;
+};
+
+std::ostream& operator<<(std::ostream& out, const MeshProximityCache& cache)
+{
+    return out << "MeshProximityCache(" << cache.pairs.size() << " pairs)";
+}
+
+// Springs are evaluated on up to num_threads threads when there are at least
+// twice this many candidate faces.
+const int MinFacesPerThread = 2000;
+}
+
 //==============================================================================
 //                         ELASTIC FOUNDATION FORCE
 //==============================================================================
@@ -55,6 +91,62 @@ void ElasticFoundationForce::extendAddToSystem(SimTK::MultibodySystem& system) c
         get_contact_parameters();
     const double& transitionVelocity = get_transition_velocity();
 
+    if (get_accelerate_mesh_contact()) {
+        // The ForceAdapter created by Force::extendAddToSystem() calls
+        // computeForce(); find the surfaces and the pairs it acts on.
+        ElasticFoundationForce* mutableThis =
+            const_cast<ElasticFoundationForce *>(this);
+        mutableThis->_surfaces.clear();
+        mutableThis->_pairs.clear();
+        for (int i = 0; i < contactParametersSet.getSize(); ++i)
+        {
+            ContactParameters& params = contactParametersSet.get(i);
+            for (int j = 0; j < params.getGeometry().size(); ++j)
+            {
+                if (!_model->updContactGeometrySet().contains(params.getGeometry()[j]))
+                {
+                    std::string errorMessage = "Invalid ContactGeometry (" + params.getGeometry()[j] + ") specified in ElasticFoundationForce" + getName();
+                    throw (Exception(errorMessage.c_str()));
+                }
+                ContactGeometry& geom = _model->updContactGeometrySet().get(params.getGeometry()[j]);
+                Surface surface;
+                surface.mesh = dynamic_cast<const ContactMesh*>(&geom);
+                surface.radius = 0;
+                if (surface.mesh != NULL)
+                    surface.type = Surface::Mesh;
+                else if (ContactSphere* sphere = dynamic_cast<ContactSphere*>(&geom)) {
+                    surface.type = Surface::Sphere;
+                    surface.radius = sphere->getRadius();
+                }
+                else if (dynamic_cast<ContactHalfSpace*>(&geom) != NULL)
+                    surface.type = Surface::HalfSpace;
+                else
+                    throw Exception("ElasticFoundationForce " + getName() +
+                        ": accelerate_mesh_contact supports ContactMesh, "
+                        "ContactSphere and ContactHalfSpace geometry, but " +
+                        geom.getName() + " is a " +
+                        geom.getConcreteClassName() + ".", __FILE__, __LINE__);
+                surface.parameters = i;
+                surface.body = geom.getBody().getMobilizedBodyIndex();
+                surface.X_BS = geom.getBody().findTransformInBaseFrame() *
+                               geom.getTransform();
+                mutableThis->_surfaces.push_back(surface);
+            }
+        }
+        for (int a = 0; a < (int)_surfaces.size(); ++a)
+            for (int b = a + 1; b < (int)_surfaces.size(); ++b)
+                if (_surfaces[a].body != _surfaces[b].body &&
+                    (_surfaces[a].type == Surface::Mesh ||
+                     _surfaces[b].type == Surface::Mesh))
+                    mutableThis->_pairs.push_back(std::make_pair(a, b));
+
+        MeshProximityCache cache;
+        cache.pairs.resize(_pairs.size());
+        addCacheVariable<MeshProximityCache>("mesh_proximity", cache,
+                                             SimTK::Stage::Topology);
+        return;
+    }
+
     SimTK::GeneralContactSubsystem& contacts = system.updContactSubsystem();
     SimTK::SimbodyMatterSubsystem& matter = system.updMatterSubsystem();
     SimTK::ContactSetIndex set = contacts.createContactSet();
@@ -88,6 +180,243 @@ void ElasticFoundationForce::constructProperties()
 {
     constructProperty_contact_parameters(ContactParametersSet());
     constructProperty_transition_velocity(0.01);
+    constructProperty_accelerate_mesh_contact(false);
+    constructProperty_proximity_margin(0.005);
+    constructProperty_num_threads(1);
+}
+
+//=============================================================================
+// ACCELERATED MESH CONTACT
+//=============================================================================
+ElasticFoundationForce::SurfaceMotion ElasticFoundationForce::
+calcSurfaceMotion(const SimTK::State& s, const Surface& surface) const
+{
+    const SimTK::MobilizedBody& body =
+        _model->getMatterSubsystem().getMobilizedBody(surface.body);
+    const SpatialVec& V_GB = body.getBodyVelocity(s);
+    SurfaceMotion motion;
+    motion.X_GS = body.getBodyTransform(s)*surface.X_BS;
+    motion.origin = body.getBodyOriginLocation(s);
+    motion.angularVelocity = V_GB[0];
+    motion.originVelocity = V_GB[1];
+    return motion;
+}
+
+// Find the faces of a mesh that may be within margin of another surface,
+// whose frame is X_MO in the mesh's frame.
+void ElasticFoundationForce::findCandidateFaces(const Surface& mesh,
+        const Surface& other, const Transform& X_MO, double margin,
+        std::vector<int>& faces)
+{
+    const TriangleMeshBVH& bvh = mesh.mesh->getBVH();
+    switch (other.type) {
+    case Surface::Mesh:
+        bvh.findFacesNearMesh(other.mesh->getBVH(), X_MO, margin, faces);
+        break;
+    case Surface::Sphere:
+        bvh.findFacesNearPoint(X_MO.p(), other.radius + margin, faces);
+        break;
+    case Surface::HalfSpace:
+        // The inside of a ContactHalfSpace is x > 0 in its frame.
+        bvh.findFacesInHalfSpace(X_MO.R().x(),
+                                 ~X_MO.R().x()*X_MO.p() - margin, faces);
+        break;
+    }
+}
+
+// Find the depth of a point (in the surface's frame) inside a surface, and
+// the surface's outward normal at the nearest point on it.
+bool ElasticFoundationForce::calcDepth(const Surface& surface,
+        const Vec3& point, double& depth, UnitVec3& normal)
+{
+    switch (surface.type) {
+    case Surface::Mesh: {
+        bool inside;
+        const Vec3 nearest = surface.mesh->getTriangleMesh().
+            findNearestPoint(point, inside, normal);
+        if (!inside)
+            return false;
+        depth = (nearest - point).norm();
+        break;
+    }
+    case Surface::Sphere: {
+        const double r = point.norm();
+        depth = surface.radius - r;
+        normal = r > 0 ? UnitVec3(point) : UnitVec3(SimTK::XAxis);
+        break;
+    }
+    case Surface::HalfSpace:
+        depth = point[0];
+        normal = UnitVec3(-1, 0, 0);
+        break;
+    }
+    return depth > 0;
+}
+
+void ElasticFoundationForce::addSpringsInRange(const Surface& foundation,
+        const SurfaceMotion& motionF, const Surface& other,
+        const SurfaceMotion& motionO, const std::vector<int>& faces,
+        int begin, int end, SpatialVec& onFoundation, SpatialVec& onOther) const
+{
+    const SimTK::ContactGeometry::TriangleMesh& mesh =
+        foundation.mesh->getTriangleMesh();
+    const ContactParameters& params =
+        get_contact_parameters().get(foundation.parameters);
+    const double stiffness = params.getStiffness();
+    const double dissipation = params.getDissipation();
+    const double us = params.getStaticFriction();
+    const double ud = params.getDynamicFriction();
+    const double uv = params.getViscousFriction();
+    const double vtrans = get_transition_velocity();
+
+    // The foundation's frame in the other surface's frame.
+    const Transform X_OF = ~motionO.X_GS*motionF.X_GS;
+    for (int k = begin; k < end; ++k) {
+        const int face = faces[k];
+        const Vec3 spring = X_OF*mesh.getFaceCentroid(face);
+        double depth;
+        UnitVec3 normalO;
+        if (!calcDepth(other, spring, depth, normalO))
+            continue;
+
+        // The contact point is halfway between the spring and the surface;
+        // find the velocity of the foundation relative to the other surface
+        // there.
+        const Vec3 point = motionO.X_GS*(spring + 0.5*depth*normalO);
+        const Vec3 normal = motionO.X_GS.R()*normalO;
+        const Vec3 velocity =
+            (motionF.originVelocity +
+             motionF.angularVelocity % (point - motionF.origin)) -
+            (motionO.originVelocity +
+             motionO.angularVelocity % (point - motionO.origin));
+        const double vnormal = ~velocity*normal;
+
+        // Hunt-Crossley dissipation of the spring force, with the friction
+        // model of HuntCrossleyForce.
+        const double fH = stiffness*mesh.getFaceArea(face)*depth;
+        const double fNormal = fH*(1 - 1.5*dissipation*vnormal);
+        if (fNormal <= 0)
+            continue;
+        Vec3 force = fNormal*normal;
+        const Vec3 vslip = velocity - vnormal*normal;
+        const double slip = vslip.norm();
+        if (slip > 0) {
+            const double vrel = slip/vtrans;
+            const double mu = std::min(vrel, 1.0)*
+                (ud + 2*(us - ud)/(1 + vrel*vrel)) + uv*slip;
+            force -= (fNormal*mu/slip)*vslip;
+        }
+        onFoundation += SpatialVec((point - motionF.origin) % force, force);
+        onOther -= SpatialVec((point - motionO.origin) % force, force);
+    }
+}
+
+void ElasticFoundationForce::addSprings(const Surface& foundation,
+        const SurfaceMotion& motionF, const Surface& other,
+        const SurfaceMotion& motionO, const std::vector<int>& faces,
+        SpatialVec& onFoundation, SpatialVec& onOther) const
+{
+    const int numFaces = (int)faces.size();
+    int maxThreads = get_num_threads();
+    if (maxThreads <= 0)
+        maxThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    const int numThreads = std::min(maxThreads, numFaces/MinFacesPerThread);
+    if (numThreads < 2) {
+        addSpringsInRange(foundation, motionF, other, motionO, faces,
+                          0, numFaces, onFoundation, onOther);
+        return;
+    }
+
+    // Each thread sums the forces of a contiguous range of faces; the sums
+    // are added in order, so the result does not depend on timing.
+    const int chunk = (numFaces + numThreads - 1)/numThreads;
+    std::vector<SpatialVec> sums(2*numThreads, SpatialVec(Vec3(0), Vec3(0)));
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto evaluate = [&](int t) {
+        try {
+            addSpringsInRange(foundation, motionF, other, motionO, faces,
+                t*chunk, std::min(numFaces, (t + 1)*chunk),
+                sums[2*t], sums[2*t + 1]);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t)
+        threads.push_back(std::thread(evaluate, t));
+    evaluate(0);
+    for (auto& thread : threads)
+        thread.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    for (int t = 0; t < numThreads; ++t) {
+        onFoundation += sums[2*t];
+        onOther += sums[2*t + 1];
+    }
+}
+
+void ElasticFoundationForce::computeForce(const SimTK::State& s,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector& generalizedForces) const
+{
+    if (!get_accelerate_mesh_contact())
+        return;
+
+    MeshProximityCache& cache =
+        updCacheVariableValue<MeshProximityCache>(s, "mesh_proximity");
+    const double margin = get_proximity_margin();
+    for (int p = 0; p < (int)_pairs.size(); ++p) {
+        const Surface& surface1 = _surfaces[_pairs[p].first];
+        const Surface& surface2 = _surfaces[_pairs[p].second];
+        const SurfaceMotion motion1 = calcSurfaceMotion(s, surface1);
+        const SurfaceMotion motion2 = calcSurfaceMotion(s, surface2);
+        const Transform X_12 = ~motion1.X_GS*motion2.X_GS;
+
+        // Reuse the candidate faces unless a point of either mesh may have
+        // moved by more than the margin relative to the other surface since
+        // they were found, with twice the margin.
+        MeshProximity& proximity = cache.pairs[p];
+        bool update = !proximity.valid;
+        if (!update) {
+            const double angle = (~proximity.X_12.R()*X_12.R()).
+                convertRotationToAngleAxis()[0];
+            const double radius1 = surface1.type == Surface::Mesh ?
+                surface1.mesh->getBVH().getBoundingRadius() : 0;
+            const double radius2 = surface2.type == Surface::Mesh ?
+                surface2.mesh->getBVH().getBoundingRadius() : 0;
+            const Vec3 p21 = (~X_12).p(), p21Before = (~proximity.X_12).p();
+            update =
+                (p21 - p21Before).norm() + angle*radius1 > margin ||
+                (X_12.p() - proximity.X_12.p()).norm() + angle*radius2 > margin;
+        }
+        if (update) {
+            proximity.faces1.clear();
+            proximity.faces2.clear();
+            if (surface1.type == Surface::Mesh)
+                findCandidateFaces(surface1, surface2, X_12, 2*margin,
+                                   proximity.faces1);
+            if (surface2.type == Surface::Mesh)
+                findCandidateFaces(surface2, surface1, ~X_12, 2*margin,
+                                   proximity.faces2);
+            proximity.X_12 = X_12;
+            proximity.valid = true;
+        }
+
+        SpatialVec on1(Vec3(0), Vec3(0)), on2(Vec3(0), Vec3(0));
+        if (surface1.type == Surface::Mesh)
+            addSprings(surface1, motion1, surface2, motion2,
+                       proximity.faces1, on1, on2);
+        if (surface2.type == Surface::Mesh)
+            addSprings(surface2, motion2, surface1, motion1,
+                       proximity.faces2, on2, on1);
+        bodyForces[surface1.body] += on1;
+        bodyForces[surface2.body] += on2;
+    }
 }
 
 
@@ -329,8 +658,9 @@ OpenSim::Array<double> ElasticFoundationForce::getRecordValues(const SimTK::Stat
     const ContactParametersSet& contactParametersSet = 
         get_contact_parameters();
 
-    const SimTK::ElasticFoundationForce& simtkForce = 
-        (SimTK::ElasticFoundationForce &)(_model->getForceSubsystem().getForce(_index));
+    // Either a SimTK::ElasticFoundationForce or, if accelerate_mesh_contact
+    // is true, the ForceAdapter that calls computeForce().
+    const SimTK::Force& simtkForce = _model->getForceSubsystem().getForce(_index);
 
     SimTK::Vector_<SimTK::SpatialVec> bodyForces(0);
     SimTK::Vector_<SimTK::Vec3> particleForces(0);
@@ -31,6 +31,7 @@
 namespace OpenSim {
 
 class Model;
+class ContactMesh;
 //==============================================================================
 //                       ELASTIC FOUNDATION FORCE
 //==============================================================================
@@ -39,6 +40,17 @@ places a spring at the center of each face of each ContactMesh it acts on.
 Those springs interact with all objects (both meshes and other objects) the 
 mesh comes in contact with.
 
+By default the force is computed by Simbody's GeneralContactSubsystem. If
+accelerate_mesh_contact is true, it is instead computed by this class for
+contact between ContactMeshes and ContactMeshes, ContactSpheres or
+ContactHalfSpaces. Each ContactMesh then uses a bounding volume hierarchy,
+built when the mesh is loaded, to find the faces that may be in contact with
+the other geometry. Those faces are kept in the state and reused until the
+two bodies have moved relative to each other by more than proximity_margin,
+and the springs on them are evaluated on multiple threads when there are
+many. Springs deeper than proximity_margin inside another mesh may be
+missed, so the margin should exceed the largest penetration expected.
+
 @author Peter Eastman **/
 class OSIMSIMULATION_API ElasticFoundationForce : public Force {
 OpenSim_DECLARE_CONCRETE_OBJECT(ElasticFoundationForce, Force);
@@ -53,6 +65,17 @@ public:
         "Material properties.");
     OpenSim_DECLARE_PROPERTY(transition_velocity, double,
         "Slip velocity (creep) at which peak static friction occurs.");
+    OpenSim_DECLARE_PROPERTY(accelerate_mesh_contact, bool,
+        "Compute contact of meshes using bounding volume hierarchies and "
+        "cached candidate faces, rather than Simbody's contact subsystem.");
+    OpenSim_DECLARE_PROPERTY(proximity_margin, double,
+        "Relative motion (m) of two surfaces before the faces that may be in "
+        "contact are found again, when accelerate_mesh_contact is true.");
+    OpenSim_DECLARE_PROPERTY(num_threads, int,
+        "Maximum number of threads that evaluate the springs of a pair of "
+        "meshes with many candidate faces, when accelerate_mesh_contact is "
+        "true. Threads are started at every evaluation. 0 uses one per "
+        "processor core.");
 
 
 //==============================================================================
@@ -105,10 +128,62 @@ public:
     *  Provide the value(s) to be reported that correspond to the labels
     */
     OpenSim::Array<double> getRecordValues(const SimTK::State& state) const override ;
+
+protected:
+    /**
+     * Compute the contact forces of meshes if accelerate_mesh_contact is
+     * true; otherwise they are computed by Simbody.
+     */
+    void computeForce(const SimTK::State& state,
+                      SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                      SimTK::Vector& generalizedForces) const override;
+
 private:
     // INITIALIZATION
     void constructProperties();
 
+    // A piece of contact geometry, and where it is on its mobilized body.
+    struct Surface {
+        enum Type { Mesh, Sphere, HalfSpace };
+        Type type;
+        const ContactMesh* mesh;
+        double radius;
+        int parameters;             // index in contact_parameters
+        SimTK::MobilizedBodyIndex body;
+        SimTK::Transform X_BS;
+    };
+    // The surface's frame, its body's origin, and its body's angular and
+    // linear velocities, in ground.
+    struct SurfaceMotion {
+        SimTK::Transform X_GS;
+        SimTK::Vec3 origin;
+        SimTK::Vec3 angularVelocity;
+        SimTK::Vec3 originVelocity;
+    };
+    SurfaceMotion calcSurfaceMotion(const SimTK::State& state,
+                                    const Surface& surface) const;
+    static void findCandidateFaces(const Surface& mesh, const Surface& other,
+                                   const SimTK::Transform& X_MO, double margin,
+                                   std::vector<int>& faces);
+    static bool calcDepth(const Surface& surface, const SimTK::Vec3& point,
+                          double& depth, SimTK::UnitVec3& normal);
+    void addSprings(const Surface& foundation, const SurfaceMotion& motionF,
+                    const Surface& other, const SurfaceMotion& motionO,
+                    const std::vector<int>& faces,
+                    SimTK::SpatialVec& onFoundation,
+                    SimTK::SpatialVec& onOther) const;
+    void addSpringsInRange(const Surface& foundation,
+                           const SurfaceMotion& motionF,
+                           const Surface& other, const SurfaceMotion& motionO,
+                           const std::vector<int>& faces, int begin, int end,
+                           SimTK::SpatialVec& onFoundation,
+                           SimTK::SpatialVec& onOther) const;
+
+    // The surfaces, and the pairs of them on different bodies that include a
+    // mesh, when accelerate_mesh_contact is true.
+    std::vector<Surface> _surfaces;
+    std::vector<std::pair<int, int> > _pairs;
+
 //==============================================================================
 };  // END of class ElasticFoundationForce
 //==============================================================================
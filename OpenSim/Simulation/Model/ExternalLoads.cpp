@@ -406,32 +406,26 @@ void ExternalLoads::updateFromXMLNode(SimTK::Xml::Element& aNode, int versionNum
         if (kinFilterNode != aNode.element_end()){
             _lowpassCutoffFrequencyForLoadKinematics = kinFilterNode->getValueAs<double>();
             }
-            bool changeWorkingDir = false;
-            std::string savedCwd;
-            // Change to directory of Document
-            if(!ifstream(_dataFileName.c_str(), ios_base::in).good()) {
+            // Look for the data file in the directory of the document if it
+            // is not in the working directory.
+            string dataFileName = _dataFileName;
+            if(!ifstream(dataFileName.c_str(), ios_base::in).good()) {
             string msg =
                     "Object: ERR- Could not open file " + _dataFileName+ "IO. It may not exist or you don't have permission to read it.";
                 cout << msg;
-                // Try switching to directory of setup file before aborting
-                if(getDocument()) {
-                    savedCwd = IO::getCwd();
-                    IO::chDir(IO::getParentDirectory(getDocument()->getFileName()));
-                    changeWorkingDir=true;
-                }
-                if(!ifstream(_dataFileName.c_str(), ios_base::in).good()) {
-                    if(changeWorkingDir) IO::chDir(savedCwd);
+                if(getDocument())
+                    dataFileName = IO::resolvePath(_dataFileName,
+                        IO::getParentDirectory(getDocument()->getFileName()));
+                if(!ifstream(dataFileName.c_str(), ios_base::in).good())
             throw Exception(msg,__FILE__,__LINE__);
-                }
             }
-            Storage* dataSource = new Storage(_dataFileName, true);
+            Storage* dataSource = new Storage(dataFileName, true);
             if (!dataSource->makeStorageLabelsUnique()){
-                cout << "Making labels unique in storage file "<< _dataFileName << endl;
-                dataSource = new Storage(_dataFileName);
+                cout << "Making labels unique in storage file "<< dataFileName << endl;
+                dataSource = new Storage(dataFileName);
                 dataSource->makeStorageLabelsUnique();
-                dataSource->print(_dataFileName);
+                dataSource->print(dataFileName);
             }
-            if(changeWorkingDir) IO::chDir(savedCwd);
             
             const Array<string> &labels = dataSource->getColumnLabels();
             // Populate data file and other things that haven't changed
@@ -48,6 +48,27 @@ using SimTK::Vec3;
 
 static const Vec3 DefaultDefaultColor(.5,.5,.5); // boring gray 
 
+// Room reserved for the points of one wrap; wrap objects that trace a
+// longer path grow the arrays once, after which they are reused.
+static const int DefaultNumWrapPoints = 100;
+
+namespace {
+// Scratch storage used by applyWrapObjects(). It lives in the cache of each
+// State so that computing a path reuses the same arrays instead of
+// allocating new ones for every path segment that is checked for wrapping.
+struct WrapWorkspace {
+    WrapResult best;       // the best wrap found so far for a wrap object
+    WrapResult candidate;  // the wrap of the path segment being checked
+    Array<int> result;     // the result of wrapping each wrap object
+    Array<int> order;      // the order in which the wrap objects are applied
+};
+
+std::ostream& operator<<(std::ostream& o, const WrapWorkspace& w)
+{
+    return o << "WrapWorkspace(" << w.order.getSize() << " wrap objects)";
+}
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -104,8 +125,12 @@ void GeometryPath::extendConnectToModel(Model& aModel)
     // after Position stage, speed requires u's also so valid at Velocity stage.
     addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
     addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
-    // Cache the set of points currently defining this path.
-    Array<PathPoint *> pathPrototype;
+    // Cache the set of points currently defining this path, with room for
+    // every path point and the two tangent points of every wrap object so
+    // that computing the path does not need to grow the array.
+    const int numWraps = get_PathWrapSet().getSize();
+    Array<PathPoint *> pathPrototype(NULL, 0,
+        get_PathPointSet().getSize() + 2*numWraps + 1);
     addCacheVariable<Array<PathPoint *> >
         ("current_path", pathPrototype, SimTK::Stage::Position);
     // When displaying, cache the set of points to be used to draw the path.
@@ -116,6 +141,21 @@ void GeometryPath::extendConnectToModel(Model& aModel)
     // and first marked valid, and we won't ever invalidate it.
     addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
                                   SimTK::Stage::Topology);
+
+    // Scratch storage for applying the wrap objects. Its contents never
+    // outlive a single path computation, so like "color" it is valid from
+    // Topology stage on and only ever updated in place.
+    if (numWraps > 0) {
+        WrapWorkspace workspace;
+        workspace.result.setSize(numWraps);
+        workspace.order.setSize(numWraps);
+        workspace.best.wrap_pts.setSize(DefaultNumWrapPoints);
+        workspace.best.wrap_pts.setSize(0);
+        workspace.candidate.wrap_pts.setSize(DefaultNumWrapPoints);
+        workspace.candidate.wrap_pts.setSize(0);
+        addCacheVariable<WrapWorkspace>("wrap_workspace", workspace,
+                                        SimTK::Stage::Topology);
+    }
 }
 
  void GeometryPath::extendInitStateFromProperties(SimTK::State& s) const
@@ -858,6 +898,7 @@ void GeometryPath::computePath(const SimTK::State& s) const
     if (isCacheVariableValid(s, "current_path"))  {
         return;
     }
+    ComponentProfiler::Scope scope(*this, ComponentProfiler::ComputePath);
 
     // Clear the current path.
     Array<PathPoint*>& currentPath = 
@@ -895,6 +936,8 @@ void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
 {
     if (isCacheVariableValid(s, "speed"))
         return;
+    ComponentProfiler::Scope scope(*this,
+                                   ComponentProfiler::ComputeLengtheningSpeed);
 
     SimTK::Vec3 posRelative, velRelative;
     SimTK::Vec3 posStartInertial, posEndInertial, 
@@ -963,12 +1006,16 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
 {
     if (get_PathWrapSet().getSize() < 1)
         return;
+    ComponentProfiler::Scope scope(*this, ComponentProfiler::ApplyWrapObjects);
 
-    WrapResult best_wrap;
-    Array<int> result, order;
-
-    result.setSize(get_PathWrapSet().getSize());
-    order.setSize(get_PathWrapSet().getSize());
+    // Reuse the arrays held in the State's cache rather than allocating new
+    // ones every time the path is computed.
+    WrapWorkspace& workspace = 
+        updCacheVariableValue<WrapWorkspace>(s, "wrap_workspace");
+    WrapResult& best_wrap = workspace.best;
+    WrapResult& wr = workspace.candidate;
+    Array<int>& result = workspace.result;
+    Array<int>& order = workspace.order;
 
     // Set the initial order to be the order they are listed in the path.
     for (int i = 0; i < get_PathWrapSet().getSize(); i++)
@@ -1069,9 +1116,9 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                         || (   path.get(pt1)->getWrapObject() 
                             != path.get(pt2)->getWrapObject()))
                     {
-                        WrapResult wr;
                         wr.startPoint = pt1;
                         wr.endPoint   = pt2;
+                        wr.wrap_pts.setSize(0);
 
                         result[i] = wo->wrapPathSegment(s, *path.get(pt1), 
                                                         *path.get(pt2), ws, wr);
@@ -1125,7 +1172,9 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                     ws.getWrapPoint(0).getWrapPath().setSize(0);
 
                     Array<SimTK::Vec3>& wrapPath = ws.getWrapPoint(1).getWrapPath();
-                    wrapPath = best_wrap.wrap_pts;
+                    wrapPath.setSize(best_wrap.wrap_pts.getSize());
+                    for (int j = 0; j < wrapPath.getSize(); j++)
+                        wrapPath[j] = best_wrap.wrap_pts[j];
 
                     // In OpenSim, all conversion to/from the wrap object's 
                     // reference frame will be performed inside 
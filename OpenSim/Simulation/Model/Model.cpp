@@ -67,6 +67,9 @@
 #include <iostream>
 #include <string>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 using namespace OpenSim;
@@ -102,6 +105,12 @@ Model::Model() :
  * Constructor from an XML file
  */
 Model::Model(const string &aFileName, const bool finalize) :
+    Model(aFileName, finalize, SimTK::realTime())
+{
+}
+
+Model::Model(const string &aFileName, const bool finalize,
+             double loadStartTime) :
     ModelComponent(aFileName, false),
     _fileName("Unassigned"),
     _analysisSet(AnalysisSet()),
@@ -110,12 +119,20 @@ Model::Model(const string &aFileName, const bool finalize) :
     _allControllersEnabled(true),
     _workingState()
 {   
+    // The base class constructor has parsed the XML document.
+    double t = SimTK::realTime();
+    _loadProfile.parseXML += t - loadStartTime;
+
     constructInfrastructure();
     setNull();
     updateFromXMLDocument();
 
+    _loadProfile.constructObjects += SimTK::realTime() - t;
+
     if (finalize) {
+        t = SimTK::realTime();
         finalizeFromProperties();
+        _loadProfile.finalize += SimTK::realTime() - t;
     }
 
     _fileName = aFileName;
@@ -288,8 +305,10 @@ SimTK::State& Model::initializeState() {
         throw Exception("Model::initializeState(): call buildSystem() first.");
 
     // This tells Simbody to finalize the System.
+    const double t = SimTK::realTime();
     getMultibodySystem().invalidateSystemTopologyCache();
     getMultibodySystem().realizeTopology();
+    _loadProfile.realizeTopology += SimTK::realTime() - t;
 
     // Set the model's operating state (internal member variable) to the 
     // default state that is stored inside the System.
@@ -464,7 +483,9 @@ void Model::createMultibodySystem()
     _gravityForce.reset(new SimTK::Force::Gravity(*_forceSubsystem, *_matter,
                 direction, magnitude));
 
+    const double t = SimTK::realTime();
     addToSystem(*_system);
+    _loadProfile.addToSystem += SimTK::realTime() - t;
 }
 
 
@@ -773,6 +794,9 @@ void Model::extendConnectToModel(Model &model)
 
     // Create iterator here to include newly added components
     initComponentTreeTraversal(*this);
+    // and re-index them so that they can be found when connecting.
+    if (!hasParent())
+        buildComponentIndex();
 
     // Reorder coordinates in order of the underlying mobilities
     updCoordinateSet().populate(*this);
@@ -942,6 +966,21 @@ void Model::addController(Controller *aController)
     }
 }
 //_____________________________________________________________________________
+/**
+ * Copy this model without finalizing each component as it is copied, then
+ * finalize the copy once, from the top.
+ */
+Model* Model::fork() const
+{
+    Model* forked = nullptr;
+    {
+        Component::DeferFinalizeOnCopy deferFinalize;
+        forked = clone();
+    }
+    forked->finalizeFromProperties();
+    return forked;
+}
+//_____________________________________________________________________________
 /**
  * Perform some setup functions that happen after the
  * object has been deserialized. This method is
@@ -950,10 +989,14 @@ void Model::addController(Controller *aController)
  */
 void Model::setup()
 {
+    double t = SimTK::realTime();
     finalizeFromProperties();
+    _loadProfile.finalize += SimTK::realTime() - t;
     
     //now connect the Model and all its subcomponents all up
+    t = SimTK::realTime();
     connect(*this);
+    _loadProfile.connect += SimTK::realTime() - t;
 
     populatePathName("");
 }
@@ -1041,6 +1084,85 @@ void Model::equilibrateMuscles(SimTK::State& state)
         throw Exception("Model::equilibrateMuscles() "+errorMsg, __FILE__, __LINE__);
 }
 
+int Model::equilibrateMuscles(SimTK::State& state, bool warmStart,
+                              int numThreads)
+{
+    getMultibodySystem().realize(state, Stage::Velocity);
+
+    bool failed = false;
+    string errorMsg = "";
+
+    // Compute everything the solvers read from the state before solving, so
+    // that they only read from it while running concurrently.
+    std::vector<const Muscle*> muscles;
+    std::vector<double> initialFiberLengths;
+    for (int i = 0; i < get_ForceSet().getSize(); i++)
+    {
+        const Muscle* muscle = dynamic_cast<const Muscle*>(&get_ForceSet().get(i));
+        if (muscle == NULL || muscle->isDisabled(state))
+            continue;
+        try{
+            muscle->getLength(state);
+            muscle->getLengtheningSpeed(state);
+            muscle->getActivation(state);
+            muscles.push_back(muscle);
+            initialFiberLengths.push_back(warmStart ?
+                muscle->getFiberLength(state) : SimTK::NaN);
+        }
+        catch (const std::exception& e) {
+            if(!failed){
+                errorMsg = e.what();
+                failed = true;
+            }
+        }
+    }
+
+    const int numMuscles = (int)muscles.size();
+    std::vector<Muscle::FiberEquilibrium> equilibria(numMuscles);
+    std::atomic<int> next(0);
+    auto solve = [&]() {
+        // solveFiberEquilibrium() reports solver failures in its result.
+        for (int k = next++; k < numMuscles; k = next++)
+            equilibria[k] = muscles[k]->solveFiberEquilibrium(state,
+                                                    initialFiberLengths[k]);
+    };
+
+    if (numThreads <= 0)
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, numMuscles);
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t)
+        threads.push_back(std::thread(solve));
+    solve();
+    for (auto& thread : threads)
+        thread.join();
+
+    // Set the solutions in the state, and equilibrate the muscles that
+    // cannot be solved concurrently one at a time.
+    int iterations = 0;
+    for (int k = 0; k < numMuscles; ++k)
+    {
+        try{
+            if (equilibria[k].solved) {
+                muscles[k]->applyFiberEquilibrium(state, equilibria[k]);
+                iterations += equilibria[k].iterations;
+            }
+            else
+                muscles[k]->equilibrate(state);
+        }
+        catch (const std::exception& e) {
+            if(!failed){
+                errorMsg = e.what();
+                failed = true;
+            }
+        }
+    }
+
+    if(failed) // Notify the caller of the failure to equilibrate 
+        throw Exception("Model::equilibrateMuscles() "+errorMsg, __FILE__, __LINE__);
+    return iterations;
+}
+
 //=============================================================================
 // GRAVITY
 //=============================================================================
@@ -1435,6 +1557,71 @@ void Model::printBasicInfo(std::ostream &aOStream) const
 
 }
 //_____________________________________________________________________________
+/**
+ * Print the time spent in each phase of loading and initializing the model.
+ *
+ * @param aOStream Output stream.
+ */
+void Model::printLoadProfile(std::ostream &aOStream) const
+{
+    aOStream<<"          MODEL LOAD: "<<getName()<<std::endl;
+    aOStream<<"           parse XML: "<<_loadProfile.parseXML<<" s"<<std::endl;
+    aOStream<<"   construct objects: "<<_loadProfile.constructObjects<<" s"<<std::endl;
+    aOStream<<"            finalize: "<<_loadProfile.finalize<<" s"<<std::endl;
+    aOStream<<"             connect: "<<_loadProfile.connect<<" s"<<std::endl;
+    aOStream<<"         addToSystem: "<<_loadProfile.addToSystem<<" s"<<std::endl;
+    aOStream<<"    realize topology: "<<_loadProfile.realizeTopology<<" s"<<std::endl;
+    aOStream<<"               total: "<<_loadProfile.getTotal()<<" s"<<std::endl;
+}
+
+//_____________________________________________________________________________
+/**
+ * Turn on or off timing of the computations of the model's components.
+ */
+void Model::setProfiling(bool aTrueFalse)
+{
+    if (!_componentProfiler) {
+        if (!aTrueFalse)
+            return;
+        _componentProfiler.reset(new ComponentProfiler());
+    }
+    _componentProfiler->setEnabled(aTrueFalse);
+    setProfiler(aTrueFalse ? _componentProfiler.get() : nullptr);
+}
+
+bool Model::getProfiling() const
+{
+    return _componentProfiler && _componentProfiler->isEnabled();
+}
+
+const ComponentProfiler& Model::getProfiler() const
+{
+    if (!_componentProfiler)
+        throw Exception("Model::getProfiler(): profiling was never turned "
+                        "on; call setProfiling(true) first.",
+                        __FILE__, __LINE__);
+    return *_componentProfiler;
+}
+
+void Model::resetProfiler()
+{
+    if (_componentProfiler)
+        _componentProfiler->reset();
+}
+
+/**
+ * Print the components' computations with the largest self times.
+ */
+void Model::printProfile(std::ostream &aOStream, int aMaxRows) const
+{
+    aOStream<<"       MODEL PROFILE: "<<getName()<<std::endl;
+    if (!_componentProfiler) {
+        aOStream<<"Profiling is off; see Model::setProfiling()."<<std::endl;
+        return;
+    }
+    _componentProfiler->printReport(aOStream, aMaxRows);
+}
+//_____________________________________________________________________________
 /**
  * Print detailed information about the model.
  *
@@ -2122,6 +2309,32 @@ SimTK::Vec3 Model::calcMassCenterAcceleration(const SimTK::State &s) const
     return getMatterSubsystem().calcSystemMassCenterAccelerationInGround(s);    
 }
 
+void Model::calcJointReactions(const SimTK::State &s,
+                               SimTK::Vector_<SimTK::SpatialVec>& reactions) const
+{
+    SimTK::Vector_<SimTK::SpatialVec> mobilizerReactions;
+    calcJointReactions(s, reactions, mobilizerReactions);
+}
+
+void Model::calcJointReactions(const SimTK::State &s,
+                    SimTK::Vector_<SimTK::SpatialVec>& reactions,
+                    SimTK::Vector_<SimTK::SpatialVec>& mobilizerReactions) const
+{
+    getMultibodySystem().realize(s, Stage::Acceleration);
+
+    // Simbody computes the reactions of all mobilizers, indexed by
+    // mobilized body; there may be more mobilized bodies than joints.
+    getMatterSubsystem().calcMobilizerReactionForces(s, mobilizerReactions);
+
+    const JointSet& joints = getJointSet();
+    const int nj = joints.getSize();
+    if (reactions.size() != nj)
+        reactions.resize(nj);
+    for (int i = 0; i < nj; ++i)
+        reactions[i] = mobilizerReactions[
+            joints[i].getChildFrame().getMobilizedBodyIndex()];
+}
+
 /**
 * Construct outputs
 *
@@ -86,6 +86,35 @@ class FrameSet;
 #endif
 
 
+//==============================================================================
+//                            MODEL LOAD PROFILE
+//==============================================================================
+/** Wall clock time (in seconds) that a Model has spent in each phase of being
+loaded from a file and having its computational System created. Times
+accumulate over repeated calls (e.g. to initSystem()) until
+Model::resetLoadProfile() is called.
+@see Model::getLoadProfile() **/
+struct OSIMSIMULATION_API ModelLoadProfile {
+    /** Parsing the XML document of the model file. */
+    double parseXML = 0;
+    /** Constructing objects and their properties from the XML document. */
+    double constructObjects = 0;
+    /** Model::finalizeFromProperties(). */
+    double finalize = 0;
+    /** Connecting all Components (resolving their Connectors). */
+    double connect = 0;
+    /** Creating the MultibodySystem and invoking addToSystem(). */
+    double addToSystem = 0;
+    /** Realizing the System's topology in Model::initializeState(). */
+    double realizeTopology = 0;
+
+    /** Sum of the times spent in all phases. */
+    double getTotal() const {
+        return parseXML + constructObjects + finalize + connect +
+               addToSystem + realizeTopology;
+    }
+};
+
 //==============================================================================
 //                                  MODEL
 //==============================================================================
@@ -198,6 +227,26 @@ public:
     **/
     explicit Model(const std::string& filename, bool finalize=true) SWIG_DECLARE_EXCEPTION;
 
+private:
+    // Delegated to by the file constructor so that the time spent parsing the
+    // XML document (in the base class constructor) can be measured.
+    Model(const std::string& filename, bool finalize, double loadStartTime);
+public:
+
+    /**
+     * Create a new Model that is an independent copy of this one and has
+     * been finalized from its properties, ready for initSystem(). Unlike
+     * clone(), the copied components are not individually finalized while
+     * they are being copied, so forking a model that is used as a prototype
+     * (e.g. by each worker of a batch process) is considerably faster.
+     * Data that does not change once it has been computed, such as the
+     * spline fits of muscle curves and loaded contact meshes, is shared by
+     * the copies rather than duplicated.
+     * The caller takes ownership of the returned Model.
+     * @see ModelSnapshot
+     */
+    Model* fork() const;
+
     /**
      * Perform some set up functions that happen after the
      * object has been deserialized. TODO: this method is
@@ -366,6 +415,26 @@ public:
      */
     void equilibrateMuscles(SimTK::State& state);
 
+    /**
+     * Update the state of all Muscles so they are in equilibrium, solving
+     * for the equilibria of different muscles concurrently. The model is
+     * realized once, and muscles that implement
+     * Muscle::solveFiberEquilibrium() are solved on numThreads threads (the
+     * number of hardware threads if numThreads is 0); the others are
+     * equilibrated one at a time as by equilibrateMuscles(state).
+     * If warmStart is true, each muscle's solver starts from the fiber
+     * length already in the state, as when replaying a trajectory in which
+     * the state still holds the equilibrium of the previous frame.
+     * Threads are started and joined on every call; warm-started solves
+     * are usually too short to pay for that, so pass numThreads = 1 when
+     * equilibrating frame after frame.
+     *
+     * @return the total number of solver iterations taken by the muscles
+     *         that were solved concurrently
+     */
+    int equilibrateMuscles(SimTK::State& state, bool warmStart,
+                           int numThreads = 0);
+
     //--------------------------------------------------------------------------
     /**@name       Access to the Simbody System and components
 
@@ -749,6 +818,26 @@ public:
     SimTK::Vec3 calcMassCenterPosition(const SimTK::State &s) const;
     SimTK::Vec3 calcMassCenterVelocity(const SimTK::State &s) const;
     SimTK::Vec3 calcMassCenterAcceleration(const SimTK::State &s) const;
+    /**
+     * Compute the reaction loads of all the joints in the model in one pass
+     * over the multibody tree. reactions[i] is the load, as a SpatialVec of
+     * [moment, force], that joint i of the JointSet applies to its child
+     * body at the origin of the joint's child frame, expressed in ground.
+     * The state is realized to Stage::Acceleration if it is not already;
+     * reactions is resized only if it does not have getNumJoints() elements,
+     * so that callers evaluating many states can reuse it.
+     */
+    void calcJointReactions(const SimTK::State &s,
+                    SimTK::Vector_<SimTK::SpatialVec>& reactions) const;
+    /**
+     * As calcJointReactions(s, reactions), with the reactions of all the
+     * mobilizers, indexed by mobilized body, computed into
+     * mobilizerReactions, which callers evaluating many states can reuse so
+     * that it is not allocated for every state.
+     */
+    void calcJointReactions(const SimTK::State &s,
+                    SimTK::Vector_<SimTK::SpatialVec>& reactions,
+                    SimTK::Vector_<SimTK::SpatialVec>& mobilizerReactions) const;
 
     //--------------------------------------------------------------------------
     // STATES
@@ -874,6 +963,56 @@ public:
      */
     void printDetailedInfo(const SimTK::State& s, std::ostream &aOStream) const;
 
+    /**
+     * Get the wall clock times spent loading this model from file and
+     * creating its computational system, broken down by phase. Use this to
+     * track regressions in model load time.
+     */
+    const ModelLoadProfile& getLoadProfile() const { return _loadProfile; }
+
+    /** Zero all the phase times of the load profile. */
+    void resetLoadProfile() { _loadProfile = ModelLoadProfile(); }
+
+    /**
+     * Print the time spent in each phase of loading and initializing the
+     * model.
+     *
+     * @param aOStream Output stream.
+     */
+    void printLoadProfile(std::ostream &aOStream) const;
+
+    /**
+     * Turn on or off timing of the computations of each component of the
+     * model: realize stages, forces, state variable derivatives, controls,
+     * and path and wrapping computations. Timings accumulate across
+     * simulations until resetProfiler() is called and are kept when
+     * profiling is turned off. Profiling is off by default and is not
+     * copied with the model.
+     *
+     * @see ComponentProfiler
+     */
+    void setProfiling(bool aTrueFalse);
+    /** Whether the computations of the model's components are being timed. */
+    bool getProfiling() const;
+
+    /**
+     * Get the timings of the computations of the model's components. Throws
+     * an Exception if profiling was never turned on.
+     */
+    const ComponentProfiler& getProfiler() const;
+
+    /** Discard the timings accumulated by the profiler, if any. */
+    void resetProfiler();
+
+    /**
+     * Print the components' computations with the largest self times (time
+     * not spent in nested computations of other components).
+     *
+     * @param aOStream Output stream.
+     * @param aMaxRows Maximum number of rows to print; < 0 prints all.
+     */
+    void printProfile(std::ostream &aOStream, int aMaxRows=30) const;
+
     /**
      * Model relinquishes ownership of all components such as: Bodies, Constraints, Forces, 
      * ContactGeometry and so on. That means the freeing of the memory of these objects is up
@@ -1030,6 +1169,9 @@ private:
     // Global flag used to disable all Controllers.
     bool _allControllersEnabled;
 
+    // Time spent in each phase of loading and initializing this model.
+    ModelLoadProfile _loadProfile;
+
 
     //                      SIMBODY MULTIBODY SYSTEM
     // We dynamically allocate these because they are not available at
@@ -1073,6 +1215,10 @@ private:
     // copied.
     SimTK::ResetOnCopy<std::unique_ptr<ModelVisualizer>> _modelViz;
 
+    // Times the computations of the model's components when profiling is
+    // on. Created the first time profiling is turned on; not copied.
+    SimTK::ResetOnCopy<std::unique_ptr<ComponentProfiler>> _componentProfiler;
+
 //==============================================================================
 };  // END of class Model
 //==============================================================================
@@ -0,0 +1,308 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ModelSnapshot.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ModelSnapshot.h"
+#include "Model.h"
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/XMLDocument.h>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+using namespace std;
+using namespace OpenSim;
+
+// Identifies a snapshot file and the layout of its contents.
+static const char SnapshotMagic[8] = { 'O','S','I','M','S','N','A','P' };
+static const int32_t SnapshotFormatVersion = 1;
+
+//=============================================================================
+// BINARY STREAM HELPERS
+//=============================================================================
+static void writeInt(ostream& out, int32_t value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static int32_t readInt(istream& in)
+{
+    int32_t value = 0;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    if (!in)
+        throw Exception("ModelSnapshot: unexpected end of snapshot.",
+                        __FILE__, __LINE__);
+    return value;
+}
+
+static void writeString(ostream& out, const string& str)
+{
+    writeInt(out, (int32_t)str.size());
+    out.write(str.data(), str.size());
+}
+
+static string readString(istream& in)
+{
+    const int32_t size = readInt(in);
+    if (size < 0)
+        throw Exception("ModelSnapshot: corrupt snapshot.",
+                        __FILE__, __LINE__);
+    string str(size, '\0');
+    if (size > 0)
+        in.read(&str[0], size);
+    if (!in)
+        throw Exception("ModelSnapshot: unexpected end of snapshot.",
+                        __FILE__, __LINE__);
+    return str;
+}
+
+// Read an index into the string table, or -1 if allowNone.
+static int32_t readStringIndex(istream& in, size_t nStrings,
+                               bool allowNone = false)
+{
+    const int32_t index = readInt(in);
+    if (index < (allowNone ? -1 : 0) || index >= (int64_t)nStrings)
+        throw Exception("ModelSnapshot: corrupt snapshot.",
+                        __FILE__, __LINE__);
+    return index;
+}
+
+// Read the number of items that follow.
+static int32_t readCount(istream& in)
+{
+    const int32_t count = readInt(in);
+    if (count < 0)
+        throw Exception("ModelSnapshot: corrupt snapshot.",
+                        __FILE__, __LINE__);
+    return count;
+}
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+ModelSnapshot::ModelSnapshot(const Model& model) :
+    _modelFileName(model.getInputFileName()),
+    _documentVersion(XMLDocument::getLatestVersion())
+{
+    // Serialize the model into an in-memory document, as Object::dump() does,
+    // then record the document's elements against a table of unique strings.
+    XMLDocument doc;
+    SimTK::Xml::Element root = doc.getRootElement();
+    model.updateXMLNode(root);
+
+    SimTK::Xml::element_iterator modelElement = root.element_begin();
+    if (modelElement == root.element_end())
+        throw Exception("ModelSnapshot: failed to serialize model '" +
+                        model.getName() + "'.", __FILE__, __LINE__);
+
+    // Objects read from other files are named relative to the model file.
+    // Record their absolute paths so that createModel() need not change the
+    // working directory.
+    string modelDirectory = IO::getParentDirectory(_modelFileName);
+    if (_modelFileName == "Unassigned")
+        modelDirectory = "";
+    modelDirectory = IO::resolvePath(modelDirectory, IO::getCwd() + "/");
+
+    unordered_map<string, int> stringIndex;
+    captureElement(*modelElement, _root, stringIndex, modelDirectory);
+}
+
+ModelSnapshot::ModelSnapshot(const string& fileName) :
+    _documentVersion(XMLDocument::getLatestVersion())
+{
+    ifstream in(fileName.c_str(), ios_base::in | ios_base::binary);
+    if (!in.good())
+        throw Exception("ModelSnapshot: could not open file '" + fileName +
+                        "'.", __FILE__, __LINE__);
+    readFromStream(in);
+}
+
+void ModelSnapshot::captureElement(SimTK::Xml::Element& xml, Element& element,
+                                   unordered_map<string, int>& stringIndex,
+                                   const string& modelDirectory)
+{
+    auto intern = [&](const string& str) {
+        auto it = stringIndex.find(str);
+        if (it != stringIndex.end())
+            return it->second;
+        const int index = (int)_strings.size();
+        _strings.push_back(str);
+        stringIndex[str] = index;
+        return index;
+    };
+
+    element.tag = intern(xml.getElementTag());
+    for (SimTK::Xml::attribute_iterator att = xml.attribute_begin();
+         att != xml.attribute_end(); ++att) {
+        // See Object::readObjectFromXMLNodeOrFile().
+        const string value = att->getName() == "file" ?
+            IO::resolvePath(att->getValue(), modelDirectory) : att->getValue();
+        element.attributes.push_back(
+            std::make_pair(intern(att->getName()), intern(value)));
+    }
+
+    element.isValue = xml.isValueElement();
+    element.value = element.isValue ? intern(xml.getValue()) : -1;
+    if (element.isValue)
+        return;
+
+    for (SimTK::Xml::element_iterator child = xml.element_begin();
+         child != xml.element_end(); ++child) {
+        element.children.push_back(Element());
+        captureElement(*child, element.children.back(), stringIndex,
+                       modelDirectory);
+    }
+}
+
+//=============================================================================
+// READ AND WRITE
+//=============================================================================
+void ModelSnapshot::write(const string& fileName) const
+{
+    ofstream out(fileName.c_str(), ios_base::out | ios_base::binary);
+    if (!out.good())
+        throw Exception("ModelSnapshot: could not open file '" + fileName +
+                        "' for writing.", __FILE__, __LINE__);
+    writeToStream(out);
+    if (!out.good())
+        throw Exception("ModelSnapshot: failed to write file '" + fileName +
+                        "'.", __FILE__, __LINE__);
+}
+
+void ModelSnapshot::writeToStream(ostream& out) const
+{
+    out.write(SnapshotMagic, sizeof(SnapshotMagic));
+    writeInt(out, SnapshotFormatVersion);
+    writeInt(out, _documentVersion);
+    writeString(out, _modelFileName);
+
+    writeInt(out, (int32_t)_strings.size());
+    for (const string& str : _strings)
+        writeString(out, str);
+
+    writeElement(out, _root);
+}
+
+void ModelSnapshot::readFromStream(istream& in)
+{
+    char magic[sizeof(SnapshotMagic)];
+    in.read(magic, sizeof(magic));
+    if (!in || !std::equal(magic, magic + sizeof(magic), SnapshotMagic))
+        throw Exception("ModelSnapshot: not a model snapshot.",
+                        __FILE__, __LINE__);
+
+    const int32_t formatVersion = readInt(in);
+    if (formatVersion != SnapshotFormatVersion)
+        throw Exception("ModelSnapshot: unsupported snapshot format version.",
+                        __FILE__, __LINE__);
+    _documentVersion = readInt(in);
+    _modelFileName = readString(in);
+
+    const int32_t nStrings = readCount(in);
+    _strings.clear();
+    for (int32_t i = 0; i < nStrings; ++i)
+        _strings.push_back(readString(in));
+
+    readElement(in, _root);
+}
+
+void ModelSnapshot::writeElement(ostream& out, const Element& element)
+{
+    writeInt(out, element.tag);
+    writeInt(out, (int32_t)element.attributes.size());
+    for (const auto& att : element.attributes) {
+        writeInt(out, att.first);
+        writeInt(out, att.second);
+    }
+    writeInt(out, element.value);
+    if (element.isValue)
+        return;
+
+    writeInt(out, (int32_t)element.children.size());
+    for (const Element& child : element.children)
+        writeElement(out, child);
+}
+
+void ModelSnapshot::readElement(istream& in, Element& element) const
+{
+    const size_t nStrings = _strings.size();
+    element.tag = readStringIndex(in, nStrings);
+    const int32_t nAttributes = readCount(in);
+    for (int32_t i = 0; i < nAttributes; ++i) {
+        const int32_t name = readStringIndex(in, nStrings);
+        element.attributes.push_back(
+            std::make_pair(name, readStringIndex(in, nStrings)));
+    }
+    element.value = readStringIndex(in, nStrings, true);
+    element.isValue = element.value >= 0;
+    if (element.isValue)
+        return;
+
+    const int32_t nChildren = readCount(in);
+    for (int32_t i = 0; i < nChildren; ++i) {
+        element.children.push_back(Element());
+        readElement(in, element.children.back());
+    }
+}
+
+//=============================================================================
+// MODEL CREATION
+//=============================================================================
+SimTK::Xml::Element ModelSnapshot::createXmlElement(const Element& element)
+    const
+{
+    // The indices were checked when the snapshot was captured or read.
+    SimTK::Xml::Element xml(_strings[element.tag],
+        element.isValue ? _strings[element.value] : string());
+    for (const auto& att : element.attributes)
+        xml.setAttributeValue(_strings[att.first], _strings[att.second]);
+
+    for (const Element& child : element.children)
+        xml.insertNodeAfter(xml.node_end(), createXmlElement(child));
+
+    return xml;
+}
+
+Model* ModelSnapshot::createModel() const
+{
+    SimTK::Xml::Element modelElement = createXmlElement(_root);
+
+    std::unique_ptr<Model> model(new Model());
+
+    // Objects read from other files have absolute paths in the snapshot, so
+    // unlike Model(fileName) this need not change the working directory.
+    try {
+        model->updateFromXMLNode(modelElement, _documentVersion);
+    } catch (...) {
+        modelElement.clearOrphan();
+        throw; // re-issue the exception
+    }
+    // The element was never put in a document so it must be freed here.
+    modelElement.clearOrphan();
+
+    model->setInputFileName(_modelFileName);
+    model->finalizeFromProperties();
+    return model.release();
+}
@@ -0,0 +1,126 @@
+#ifndef OPENSIM_MODEL_SNAPSHOT_H_
+#define OPENSIM_MODEL_SNAPSHOT_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ModelSnapshot.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include "SimTKcommon.h"
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenSim {
+
+class Model;
+
+//==============================================================================
+//                              MODEL SNAPSHOT
+//==============================================================================
+/** A compact, binary representation of the properties of a Model, including
+the names of the components its Connectors are connected to, from which new
+Models can be created without reading and parsing an XML (.osim) file.
+
+A snapshot holds the Model's document as a tree of string-table indices, so
+the text of a model file is never read or tokenized when a Model is created
+from it. createModel() still rebuilds the document's elements in memory and
+deserializes the Model from them as Model(fileName) does, so it saves only
+the cost of reading and parsing the file; testInitState reports both times.
+A snapshot can be kept in memory and used repeatedly, or written to a file
+and read back by other processes:
+
+@code
+    Model model("subject01.osim");
+    model.initSystem();
+    ModelSnapshot(model).write("subject01.osnap");
+
+    // in a worker process
+    ModelSnapshot snapshot("subject01.osnap");
+    std::unique_ptr<Model> copy(snapshot.createModel());
+    copy->initSystem();
+@endcode
+
+Snapshot files store numbers in the byte order of the machine that wrote
+them and are meant as a cache rather than an archive format; use the .osim
+file as the source of truth.
+
+@see Model::fork() to copy a Model that is already in memory. **/
+class OSIMSIMULATION_API ModelSnapshot {
+public:
+    /** Capture the current properties of the model. Capture the Model after
+    it has been connected (e.g. after initSystem()) to record the resolved
+    names of its Connectors' connectees. **/
+    explicit ModelSnapshot(const Model& model);
+
+    /** Read a snapshot that was written by write(). Throws an Exception if
+    the file cannot be read, is not a snapshot or is corrupt. **/
+    explicit ModelSnapshot(const std::string& fileName);
+
+    /** Write this snapshot to a binary file. **/
+    void write(const std::string& fileName) const;
+
+    /** Create a new Model from this snapshot, finalized from its properties
+    and ready for initSystem(). Objects the model reads from other files
+    are found relative to the directory of the snapshotted model file, and
+    the working directory is not changed, so Models can be created from
+    snapshots on several threads at once. The caller takes ownership of the
+    Model. **/
+    Model* createModel() const;
+
+    /** The name of the file the snapshotted Model was read from, if any. **/
+    const std::string& getModelFileName() const { return _modelFileName; }
+
+private:
+    // An element of the model's XML document whose tag, attributes and text
+    // are stored as indices into the string table.
+    struct Element {
+        int tag;
+        std::vector<std::pair<int,int>> attributes;
+        bool isValue;
+        int value;
+        std::vector<Element> children;
+    };
+
+    void captureElement(SimTK::Xml::Element& xml, Element& element,
+                        std::unordered_map<std::string, int>& stringIndex,
+                        const std::string& modelDirectory);
+
+    void readFromStream(std::istream& in);
+    void writeToStream(std::ostream& out) const;
+
+    static void writeElement(std::ostream& out, const Element& element);
+    void readElement(std::istream& in, Element& element) const;
+
+    SimTK::Xml::Element createXmlElement(const Element& element) const;
+
+    std::string          _modelFileName;
+    int                  _documentVersion;
+    std::vector<std::string> _strings;
+    Element              _root;
+
+//==============================================================================
+};  // END of class ModelSnapshot
+//==============================================================================
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MODEL_SNAPSHOT_H_
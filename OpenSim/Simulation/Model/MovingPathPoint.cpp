@@ -43,6 +43,25 @@ using namespace std;
 using namespace OpenSim;
 using SimTK::Vec3;
 
+// Path points are updated every time a path is computed, so the functions
+// are evaluated at the coordinate value directly rather than through a
+// Vector, which allocates.
+static double calcValueAt(const Function& aFunction, double aX)
+{
+    double value, firstDerivative, secondDerivative;
+    aFunction.calcValueAndDerivatives(aX, value, firstDerivative,
+                                      secondDerivative);
+    return value;
+}
+
+static double calcFirstDerivativeAt(const Function& aFunction, double aX)
+{
+    double value, firstDerivative, secondDerivative;
+    aFunction.calcValueAndDerivatives(aX, value, firstDerivative,
+                                      secondDerivative);
+    return firstDerivative;
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -375,25 +394,25 @@ void MovingPathPoint::update(const SimTK::State& s)
         const double xval = SimTK::clamp(_xCoordinate->getRangeMin(),
                                          _xCoordinate->getValue(s),
                                          _xCoordinate->getRangeMax());
-        _location[0] = _xLocation->calcValue(SimTK::Vector(1, xval));
+        _location[0] = calcValueAt(*_xLocation, xval);
     } else // type == Constant
-        _location[0] = _xLocation->calcValue(SimTK::Vector(1, 0.0));
+        _location[0] = calcValueAt(*_xLocation, 0.0);
 
     if (_yCoordinate) {
         const double yval = SimTK::clamp(_yCoordinate->getRangeMin(),
                                          _yCoordinate->getValue(s),
                                          _yCoordinate->getRangeMax());
-        _location[1] = _yLocation->calcValue(SimTK::Vector(1, yval));
+        _location[1] = calcValueAt(*_yLocation, yval);
     } else // type == Constant
-        _location[1] = _yLocation->calcValue(SimTK::Vector(1, 0.0));
+        _location[1] = calcValueAt(*_yLocation, 0.0);
 
     if (_zCoordinate) {
         const double zval = SimTK::clamp(_zCoordinate->getRangeMin(),
                                          _zCoordinate->getValue(s),
                                          _zCoordinate->getRangeMax());
-        _location[2] = _zLocation->calcValue(SimTK::Vector(1, zval));
+        _location[2] = calcValueAt(*_zLocation, zval);
     } else // type == Constant
-        _location[2] = _zLocation->calcValue(SimTK::Vector(1, 0.0));
+        _location[2] = calcValueAt(*_zLocation, 0.0);
 }
 
 //_____________________________________________________________________________
@@ -405,12 +424,10 @@ void MovingPathPoint::update(const SimTK::State& s)
 
 void MovingPathPoint::getVelocity(const SimTK::State& s, SimTK::Vec3& aVelocity)
 {
-    std::vector<int> derivComponents;
-    derivComponents.push_back(0);
-
     if (_xCoordinate){
         //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        aVelocity[0] = _xLocation->calcDerivative(derivComponents, SimTK::Vector(1, _xCoordinate->getValue(s)))*
+        aVelocity[0] = calcFirstDerivativeAt(*_xLocation,
+            _xCoordinate->getValue(s)) *
             _xCoordinate->getSpeedValue(s);
     }
     else
@@ -418,7 +435,8 @@ void MovingPathPoint::getVelocity(const SimTK::State& s, SimTK::Vec3& aVelocity)
 
     if (_yCoordinate){
         //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        aVelocity[1] = _yLocation->calcDerivative(derivComponents, SimTK::Vector(1, _yCoordinate->getValue(s)))*
+        aVelocity[1] = calcFirstDerivativeAt(*_yLocation,
+            _yCoordinate->getValue(s)) *
             _yCoordinate->getSpeedValue(s);
     }
     else
@@ -426,7 +444,8 @@ void MovingPathPoint::getVelocity(const SimTK::State& s, SimTK::Vec3& aVelocity)
 
     if (_zCoordinate){
         //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        aVelocity[2] = _zLocation->calcDerivative(derivComponents, SimTK::Vector(1, _zCoordinate->getValue(s)))*
+        aVelocity[2] = calcFirstDerivativeAt(*_zLocation,
+            _zCoordinate->getValue(s)) *
             _zCoordinate->getSpeedValue(s);
     }
     else
@@ -444,23 +463,20 @@ SimTK::Vec3 MovingPathPoint::getdPointdQ(const SimTK::State& s) const
 {
     SimTK::Vec3 dPdq_B(0);
 
-    std::vector<int> derivComponents;
-    derivComponents.push_back(0);
-
     if (_xCoordinate){
         //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        dPdq_B[0] = _xLocation->calcDerivative(derivComponents, 
-            SimTK::Vector(1, _xCoordinate->getValue(s)));
+        dPdq_B[0] = calcFirstDerivativeAt(*_xLocation,
+            _xCoordinate->getValue(s));
     }
     if (_yCoordinate){
         //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        dPdq_B[1] = _yLocation->calcDerivative(derivComponents, 
-            SimTK::Vector(1, _yCoordinate->getValue(s)));
+        dPdq_B[1] = calcFirstDerivativeAt(*_yLocation,
+            _yCoordinate->getValue(s));
     }
     if (_zCoordinate){
         //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        dPdq_B[2] = _zLocation->calcDerivative(derivComponents, 
-            SimTK::Vector(1, _zCoordinate->getValue(s)));
+        dPdq_B[2] = calcFirstDerivativeAt(*_zLocation,
+            _zCoordinate->getValue(s));
     }
 
     return dPdq_B;
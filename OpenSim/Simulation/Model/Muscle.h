@@ -248,6 +248,44 @@ public:
     //@{
     /** Find and set the equilibrium state of the muscle (if any) */
     void equilibrate(SimTK::State& s) const { return computeFiberEquilibriumAtZeroVelocity(s); }
+
+    /** The result of solveFiberEquilibrium(). */
+    struct FiberEquilibrium {
+        FiberEquilibrium() : solved(false), status(-1), iterations(0),
+            error(SimTK::NaN), fiberLength(SimTK::NaN),
+            tendonForce(SimTK::NaN) {}
+        /** false if the muscle does not implement solveFiberEquilibrium(). */
+        bool solved;
+        /** The solver's status: 0 if it converged, 1 if the fiber reached
+        its minimum length, 2 if it ran out of iterations, or -1 if it threw
+        an exception (see message). */
+        int status;
+        /** The number of Newton iterations taken. */
+        int iterations;
+        /** The force error of the solution (N). */
+        double error;
+        double fiberLength;
+        double tendonForce;
+        std::string message;
+    };
+
+    /** Solve for the state that equilibrate() would find, without modifying
+    the State. The State must have been realized to Stage::Velocity and this
+    muscle's path length and lengthening speed computed, after which this
+    method only reads from the State, so it may be called for different
+    muscles concurrently. If initialFiberLength is not NaN, the solver starts
+    from that fiber length rather than from its default guess, and falls back
+    to the default guess if it does not converge. Muscles that do not
+    implement this method return an unsolved FiberEquilibrium, and
+    Model::equilibrateMuscles() equilibrates them with equilibrate(). */
+    virtual FiberEquilibrium solveFiberEquilibrium(const SimTK::State& s,
+        double initialFiberLength = SimTK::NaN) const
+    {   return FiberEquilibrium(); }
+
+    /** Set the state of the muscle to a solution found by
+    solveFiberEquilibrium(), reporting failures as equilibrate() does. */
+    virtual void applyFiberEquilibrium(SimTK::State& s,
+        const FiberEquilibrium& equilibrium) const {}
     // End of Muscle's State Dependent Accessors.
     //@} 
 
@@ -0,0 +1,287 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  SmoothSphereHalfSpaceForce.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SmoothSphereHalfSpaceForce.h"
+#include "ContactGeometrySet.h"
+#include "ContactHalfSpace.h"
+#include "ContactSphere.h"
+#include "Model.h"
+
+using namespace SimTK;
+
+namespace OpenSim {
+
+//==============================================================================
+//                      SMOOTH SPHERE HALF SPACE FORCE
+//==============================================================================
+// Uses default (compiler-generated) destructor, copy constructor, copy
+// assignment operator.
+
+// Default constructor.
+SmoothSphereHalfSpaceForce::SmoothSphereHalfSpaceForce()
+{
+    constructProperties();
+}
+
+SmoothSphereHalfSpaceForce::SmoothSphereHalfSpaceForce(
+        const std::string& name, const std::string& halfSpaceName)
+{
+    constructProperties();
+    setName(name);
+    set_contact_half_space(halfSpaceName);
+}
+
+void SmoothSphereHalfSpaceForce::constructProperties()
+{
+    constructProperty_contact_sphere(); // a list of strings
+    constructProperty_contact_half_space("");
+    constructProperty_stiffness(1e6);
+    constructProperty_dissipation(1.0);
+    constructProperty_static_friction(0.9);
+    constructProperty_dynamic_friction(0.8);
+    constructProperty_viscous_friction(0.0);
+    constructProperty_transition_velocity(0.1);
+    constructProperty_hertz_smoothing(1e4);
+    constructProperty_hunt_crossley_smoothing(50.0);
+}
+
+void SmoothSphereHalfSpaceForce::addContactSphere(const std::string& name)
+{
+    updProperty_contact_sphere().appendValue(name);
+}
+
+int SmoothSphereHalfSpaceForce::getNumContactSpheres() const
+{
+    return getProperty_contact_sphere().size();
+}
+
+double SmoothSphereHalfSpaceForce::getStiffness() const
+{   return get_stiffness(); }
+void SmoothSphereHalfSpaceForce::setStiffness(double stiffness)
+{   set_stiffness(stiffness); }
+double SmoothSphereHalfSpaceForce::getDissipation() const
+{   return get_dissipation(); }
+void SmoothSphereHalfSpaceForce::setDissipation(double dissipation)
+{   set_dissipation(dissipation); }
+double SmoothSphereHalfSpaceForce::getStaticFriction() const
+{   return get_static_friction(); }
+void SmoothSphereHalfSpaceForce::setStaticFriction(double friction)
+{   set_static_friction(friction); }
+double SmoothSphereHalfSpaceForce::getDynamicFriction() const
+{   return get_dynamic_friction(); }
+void SmoothSphereHalfSpaceForce::setDynamicFriction(double friction)
+{   set_dynamic_friction(friction); }
+double SmoothSphereHalfSpaceForce::getViscousFriction() const
+{   return get_viscous_friction(); }
+void SmoothSphereHalfSpaceForce::setViscousFriction(double friction)
+{   set_viscous_friction(friction); }
+double SmoothSphereHalfSpaceForce::getTransitionVelocity() const
+{   return get_transition_velocity(); }
+void SmoothSphereHalfSpaceForce::setTransitionVelocity(double velocity)
+{   set_transition_velocity(velocity); }
+
+void SmoothSphereHalfSpaceForce::extendConnectToModel(Model& aModel)
+{
+    Super::extendConnectToModel(aModel);
+
+    const ContactGeometrySet& geometry = aModel.getContactGeometrySet();
+    const std::string& halfSpaceName = get_contact_half_space();
+    _halfSpace = geometry.contains(halfSpaceName) ?
+        dynamic_cast<const ContactHalfSpace*>(&geometry.get(halfSpaceName)) :
+        NULL;
+    if (_halfSpace.empty())
+        throw Exception("SmoothSphereHalfSpaceForce " + getName() +
+            ": there is no ContactHalfSpace named '" + halfSpaceName + "'.",
+            __FILE__, __LINE__);
+
+    _spheres.clear();
+    for (int i = 0; i < getProperty_contact_sphere().size(); ++i) {
+        const std::string& sphereName = get_contact_sphere(i);
+        const ContactSphere* sphere = geometry.contains(sphereName) ?
+            dynamic_cast<const ContactSphere*>(&geometry.get(sphereName)) :
+            NULL;
+        if (sphere == NULL)
+            throw Exception("SmoothSphereHalfSpaceForce " + getName() +
+                ": there is no ContactSphere named '" + sphereName + "'.",
+                __FILE__, __LINE__);
+        _spheres.push_back(SimTK::ReferencePtr<const ContactSphere>(sphere));
+    }
+}
+
+void SmoothSphereHalfSpaceForce::
+    extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+
+    // The bodies have been added to the system, so the geometry can be
+    // located in the mobilized bodies it moves with.
+    SmoothSphereHalfSpaceForce* mutableThis =
+        const_cast<SmoothSphereHalfSpaceForce *>(this);
+
+    const PhysicalFrame& planeFrame = _halfSpace->getBody();
+    const Vec3& orientation = _halfSpace->getOrientation();
+    mutableThis->_halfSpaceBody = planeFrame.getMobilizedBodyIndex();
+    mutableThis->_halfSpaceInBody = planeFrame.findTransformInBaseFrame() *
+        Transform(Rotation(BodyRotationSequence,
+                           orientation[0], XAxis,
+                           orientation[1], YAxis,
+                           orientation[2], ZAxis),
+                  _halfSpace->getLocation());
+
+    const int n = (int)_spheres.size();
+    mutableThis->_sphereBodies.resize(n);
+    mutableThis->_sphereCenters.resize(n);
+    mutableThis->_sphereRadii.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const PhysicalFrame& frame = _spheres[i]->getBody();
+        mutableThis->_sphereBodies[i] = frame.getMobilizedBodyIndex();
+        mutableThis->_sphereCenters[i] =
+            frame.findTransformInBaseFrame() * _spheres[i]->getLocation();
+        mutableThis->_sphereRadii[i] = _spheres[i]->getRadius();
+    }
+}
+
+//=============================================================================
+// COMPUTATION
+//=============================================================================
+SmoothSphereHalfSpaceForce::Plane
+SmoothSphereHalfSpaceForce::calcPlane(const SimTK::State& s) const
+{
+    const MobilizedBody& body =
+        _model->getMatterSubsystem().getMobilizedBody(_halfSpaceBody);
+    const Transform X_GH = body.getBodyTransform(s) * _halfSpaceInBody;
+    const SpatialVec& V_GB = body.getBodyVelocity(s);
+
+    Plane plane;
+    // Points with x > 0 in the half space's frame are inside it.
+    plane.normal = -X_GH.R().x();
+    plane.offset = ~plane.normal * X_GH.p();
+    plane.bodyOrigin = body.getBodyOriginLocation(s);
+    plane.angularVelocity = V_GB[0];
+    plane.originVelocity = V_GB[1];
+    return plane;
+}
+
+void SmoothSphereHalfSpaceForce::calcSphereContact(const SimTK::State& s,
+        const Plane& plane, int i, Vec3& force, Vec3& point) const
+{
+    const MobilizedBody& body =
+        _model->getMatterSubsystem().getMobilizedBody(_sphereBodies[i]);
+    const Transform& X_GB = body.getBodyTransform(s);
+    const SpatialVec& V_GB = body.getBodyVelocity(s);
+    const double R = _sphereRadii[i];
+    const Vec3& n = plane.normal;
+
+    // Depth of the sphere below the plane, and the contact point halfway
+    // through the overlap.
+    const Vec3 center = X_GB * _sphereCenters[i];
+    const double depth = R - (~n*center - plane.offset);
+    point = center - (R - 0.5*depth)*n;
+
+    // Velocity of the contact point on the sphere relative to the same
+    // point moving with the half space.
+    const Vec3 velocity =
+        (V_GB[1] + V_GB[0] % (point - X_GB.p())) -
+        (plane.originVelocity + plane.angularVelocity % (point - plane.bodyOrigin));
+    const double approachSpeed = -(~n*velocity);
+    const Vec3 slip = velocity + approachSpeed*n;
+
+    // Smooth Hertz force with Hunt-Crossley dissipation; x+ approximates
+    // max(x, 0) within a width w of 0.
+    const double wd = 1.0/get_hertz_smoothing();
+    const double d = 0.5*(depth + std::sqrt(depth*depth + wd*wd));
+    const double wv = 1.0/get_hunt_crossley_smoothing();
+    const double g = 1 + 1.5*get_dissipation()*approachSpeed;
+    const double damping = 0.5*(g + std::sqrt(g*g + wv*wv));
+    const double normalForce =
+        4.0/3.0*get_stiffness()*std::sqrt(R)*d*std::sqrt(d)*damping;
+
+    // Friction, mu*normalForce opposite the slip velocity, written in terms
+    // of mu/|slip| so that it is smooth at zero slip.
+    const double vt = get_transition_velocity();
+    const double x2 = (~slip*slip)/(vt*vt);
+    const double muOverSpeed =
+        (get_dynamic_friction()/std::sqrt(1 + x2) +
+         2*(get_static_friction() - get_dynamic_friction())/(1 + x2))/vt +
+        get_viscous_friction();
+
+    force = normalForce*(n - muOverSpeed*slip);
+}
+
+void SmoothSphereHalfSpaceForce::calcContactForce(const SimTK::State& s,
+        int sphereIndex, Vec3& force, Vec3& point) const
+{
+    calcSphereContact(s, calcPlane(s), sphereIndex, force, point);
+}
+
+void SmoothSphereHalfSpaceForce::computeForce(const SimTK::State& s,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector& generalizedForces) const
+{
+    const SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    const Plane plane = calcPlane(s);
+
+    Vec3 force, point;
+    for (int i = 0; i < (int)_sphereBodies.size(); ++i) {
+        calcSphereContact(s, plane, i, force, point);
+        const Vec3 sphereOrigin =
+            matter.getMobilizedBody(_sphereBodies[i]).getBodyOriginLocation(s);
+        bodyForces[_sphereBodies[i]] +=
+            SpatialVec((point - sphereOrigin) % force, force);
+        bodyForces[_halfSpaceBody] -=
+            SpatialVec((point - plane.bodyOrigin) % force, force);
+    }
+}
+
+//=============================================================================
+// Reporting
+//=============================================================================
+OpenSim::Array<std::string> SmoothSphereHalfSpaceForce::getRecordLabels() const
+{
+    OpenSim::Array<std::string> labels("");
+    for (int i = 0; i < getProperty_contact_sphere().size(); ++i) {
+        const std::string prefix = getName() + "." + get_contact_sphere(i);
+        labels.append(prefix + ".force.X");
+        labels.append(prefix + ".force.Y");
+        labels.append(prefix + ".force.Z");
+        labels.append(prefix + ".point.X");
+        labels.append(prefix + ".point.Y");
+        labels.append(prefix + ".point.Z");
+    }
+    return labels;
+}
+
+OpenSim::Array<double> SmoothSphereHalfSpaceForce::
+getRecordValues(const SimTK::State& state) const
+{
+    OpenSim::Array<double> values(1);
+    const Plane plane = calcPlane(state);
+    Vec3 force, point;
+    for (int i = 0; i < (int)_sphereBodies.size(); ++i) {
+        calcSphereContact(state, plane, i, force, point);
+        values.append(3, &force[0]);
+        values.append(3, &point[0]);
+    }
+    return values;
+}
+
+}// end of namespace OpenSim
@@ -0,0 +1,194 @@
+#ifndef OPENSIM_SMOOTH_SPHERE_HALF_SPACE_FORCE_H_
+#define OPENSIM_SMOOTH_SPHERE_HALF_SPACE_FORCE_H_
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  SmoothSphereHalfSpaceForce.h                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+// INCLUDE
+#include "Force.h"
+
+namespace OpenSim {
+
+class ContactSphere;
+class ContactHalfSpace;
+
+//==============================================================================
+//                      SMOOTH SPHERE HALF SPACE FORCE
+//==============================================================================
+/** This force subclass implements a smooth Hunt-Crossley contact model between
+a set of ContactSpheres and a single ContactHalfSpace, which may be attached to
+ground or to any other body (e.g., a treadmill belt or a foot plate).
+
+Unlike HuntCrossleyForce, it does not use Simbody's GeneralContactSubsystem:
+there is no broad phase or contact tracking, and the force on each sphere is a
+closed-form expression of the sphere's depth below the half space and of its
+velocity relative to it. The expression is smooth everywhere, including at
+the onset of contact and at zero slip velocity, so that variable-step
+integrators need not take small steps to resolve discontinuities. This makes
+it well suited to gait models with 10-20 spheres per foot.
+
+For a sphere of radius R whose depth below the plane is d, approaching the
+plane at speed v, the normal force is
+
+    f = 4/3 E sqrt(R) d+^(3/2) (1 + 3/2 c v)+
+
+where E is the stiffness, c the dissipation, and x+ = (x + sqrt(x^2 + w^2))/2
+is a smooth approximation of max(x, 0), with w = 1/hertz_smoothing for the
+depth and w = 1/hunt_crossley_smoothing for the damping term. The stiffness
+is the effective (combined) stiffness of the sphere and the half space. The
+friction force opposes the slip velocity u at the contact point and has
+magnitude mu f, with
+
+    mu = mu_d x/sqrt(1 + x^2) + 2 (mu_s - mu_d) x/(1 + x^2) + mu_v |u|,
+
+where x = |u|/transition_velocity. The static friction coefficient mu_s
+governs the peak friction around the transition velocity, and mu approaches
+mu_d (plus the viscous term) at large slip velocities.
+
+The half space is the side of the ContactHalfSpace's plane where x > 0 in its
+local frame, as for HuntCrossleyForce. **/
+class OSIMSIMULATION_API SmoothSphereHalfSpaceForce : public Force {
+OpenSim_DECLARE_CONCRETE_OBJECT(SmoothSphereHalfSpaceForce, Force);
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(contact_sphere, std::string,
+        "Names of the ContactSpheres in contact with the half space.");
+    OpenSim_DECLARE_PROPERTY(contact_half_space, std::string,
+        "Name of the ContactHalfSpace.");
+    OpenSim_DECLARE_PROPERTY(stiffness, double,
+        "Effective stiffness of the sphere and half space (N/m^2).");
+    OpenSim_DECLARE_PROPERTY(dissipation, double,
+        "Hunt-Crossley dissipation coefficient (s/m).");
+    OpenSim_DECLARE_PROPERTY(static_friction, double,
+        "Static (peak) coefficient of friction.");
+    OpenSim_DECLARE_PROPERTY(dynamic_friction, double,
+        "Dynamic coefficient of friction.");
+    OpenSim_DECLARE_PROPERTY(viscous_friction, double,
+        "Viscous coefficient of friction (s/m).");
+    OpenSim_DECLARE_PROPERTY(transition_velocity, double,
+        "Slip velocity at which peak static friction occurs (m/s).");
+    OpenSim_DECLARE_PROPERTY(hertz_smoothing, double,
+        "Inverse of the depth (1/m) over which the onset of contact is "
+        "smoothed.");
+    OpenSim_DECLARE_PROPERTY(hunt_crossley_smoothing, double,
+        "Sharpness of the smoothing of the dissipation term as the sphere "
+        "leaves the half space.");
+
+//==============================================================================
+// PUBLIC METHODS
+//==============================================================================
+    SmoothSphereHalfSpaceForce();
+    /** Create a force between the named ContactHalfSpace and the spheres that
+    are added with addContactSphere(). */
+    SmoothSphereHalfSpaceForce(const std::string& name,
+                               const std::string& halfSpaceName);
+
+    /** Add the named ContactSphere to the spheres in contact with the half
+    space. */
+    void addContactSphere(const std::string& sphereName);
+    int getNumContactSpheres() const;
+
+    double getStiffness() const;
+    void setStiffness(double stiffness);
+    double getDissipation() const;
+    void setDissipation(double dissipation);
+    double getStaticFriction() const;
+    void setStaticFriction(double friction);
+    double getDynamicFriction() const;
+    void setDynamicFriction(double friction);
+    double getViscousFriction() const;
+    void setViscousFriction(double friction);
+    double getTransitionVelocity() const;
+    void setTransitionVelocity(double velocity);
+
+    /**
+     * Compute the force applied by the half space to the sphere with the
+     * given index, expressed in ground, and the point (in ground) at which
+     * it is applied. The opposite force is applied to the half space at the
+     * same point. The state must be realized to Stage::Velocity.
+     */
+    void calcContactForce(const SimTK::State& state, int sphereIndex,
+                          SimTK::Vec3& force, SimTK::Vec3& point) const;
+
+    //-----------------------------------------------------------------------------
+    // Reporting
+    //-----------------------------------------------------------------------------
+    /**
+     * Provide name(s) of the quantities (column labels) of the force value(s)
+     * to be reported: the force on each sphere and the point at which it is
+     * applied, in ground.
+     */
+    OpenSim::Array<std::string> getRecordLabels() const override ;
+    /**
+    *  Provide the value(s) to be reported that correspond to the labels
+    */
+    OpenSim::Array<double> getRecordValues(const SimTK::State& state) const override ;
+
+protected:
+    // ModelComponent interface
+    void extendConnectToModel(Model& aModel) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+    // Force interface
+    void computeForce(const SimTK::State& state,
+                      SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                      SimTK::Vector& generalizedForces) const override;
+
+private:
+    // The half space's plane and its body's velocity in ground.
+    struct Plane {
+        SimTK::Vec3 normal;     // outward (toward the spheres)
+        double offset;          // normal . (any point on the plane)
+        SimTK::Vec3 bodyOrigin;
+        SimTK::Vec3 angularVelocity;
+        SimTK::Vec3 originVelocity;
+    };
+    Plane calcPlane(const SimTK::State& state) const;
+    void calcSphereContact(const SimTK::State& state, const Plane& plane,
+                           int sphereIndex,
+                           SimTK::Vec3& force, SimTK::Vec3& point) const;
+
+    // INITIALIZATION
+    void constructProperties();
+
+    // The contact geometry named by the properties.
+    SimTK::ReferencePtr<const ContactHalfSpace> _halfSpace;
+    std::vector<SimTK::ReferencePtr<const ContactSphere> > _spheres;
+
+    // Per-sphere data, laid out contiguously and computed in
+    // extendAddToSystem(), so that computeForce() does not have to look up
+    // the geometry: each sphere's mobilized body, center in that body and
+    // radius.
+    std::vector<SimTK::MobilizedBodyIndex> _sphereBodies;
+    std::vector<SimTK::Vec3> _sphereCenters;
+    std::vector<double> _sphereRadii;
+    SimTK::MobilizedBodyIndex _halfSpaceBody;
+    SimTK::Transform _halfSpaceInBody;
+
+//==============================================================================
+};  // END of class SmoothSphereHalfSpaceForce
+//==============================================================================
+//==============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_SMOOTH_SPHERE_HALF_SPACE_FORCE_H_
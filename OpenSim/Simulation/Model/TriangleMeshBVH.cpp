@@ -0,0 +1,233 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  TriangleMeshBVH.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "TriangleMeshBVH.h"
+#include <algorithm>
+
+using SimTK::Vec3;
+
+namespace OpenSim {
+
+// Leaves hold at most this many faces.
+static const int MaxFacesPerLeaf = 4;
+
+TriangleMeshBVH::TriangleMeshBVH() : _radius(0) {}
+
+TriangleMeshBVH::TriangleMeshBVH(
+        const SimTK::ContactGeometry::TriangleMesh& mesh) : _radius(0)
+{
+    const int numFaces = mesh.getNumFaces();
+    if (numFaces == 0)
+        return;
+
+    std::vector<Vec3> lowers(numFaces), uppers(numFaces), centers(numFaces);
+    for (int f = 0; f < numFaces; ++f) {
+        lowers[f] = uppers[f] = mesh.getVertexPosition(mesh.getFaceVertex(f, 0));
+        for (int k = 1; k < 3; ++k) {
+            const Vec3& v = mesh.getVertexPosition(mesh.getFaceVertex(f, k));
+            for (int i = 0; i < 3; ++i) {
+                lowers[f][i] = std::min(lowers[f][i], v[i]);
+                uppers[f][i] = std::max(uppers[f][i], v[i]);
+            }
+        }
+        centers[f] = 0.5*(lowers[f] + uppers[f]);
+    }
+    for (int v = 0; v < mesh.getNumVertices(); ++v)
+        _radius = std::max(_radius, mesh.getVertexPosition(v).norm());
+
+    _faces.resize(numFaces);
+    for (int f = 0; f < numFaces; ++f)
+        _faces[f] = f;
+    _nodes.reserve(2*(numFaces/MaxFacesPerLeaf + 1));
+    Node root;
+    root.first = 0;
+    root.count = numFaces;
+    _nodes.push_back(root);
+    build(lowers, uppers, centers, 0);
+}
+
+// Bound the faces of a node and split them, at the median of their centers
+// along the longest axis of the centers' bounds, between two children.
+void TriangleMeshBVH::build(std::vector<Vec3>& lowers,
+                            std::vector<Vec3>& uppers,
+                            std::vector<Vec3>& centers, int node)
+{
+    const int first = _nodes[node].first, count = _nodes[node].count;
+    Vec3 lower = lowers[_faces[first]], upper = uppers[_faces[first]];
+    Vec3 centerLower = centers[_faces[first]], centerUpper = centerLower;
+    for (int k = first + 1; k < first + count; ++k) {
+        const int f = _faces[k];
+        for (int i = 0; i < 3; ++i) {
+            lower[i] = std::min(lower[i], lowers[f][i]);
+            upper[i] = std::max(upper[i], uppers[f][i]);
+            centerLower[i] = std::min(centerLower[i], centers[f][i]);
+            centerUpper[i] = std::max(centerUpper[i], centers[f][i]);
+        }
+    }
+    _nodes[node].lower = lower;
+    _nodes[node].upper = upper;
+    _nodes[node].left = -1;
+    if (count <= MaxFacesPerLeaf)
+        return;
+
+    const Vec3 extent = centerUpper - centerLower;
+    const int axis = extent[0] > extent[1] ?
+        (extent[0] > extent[2] ? 0 : 2) : (extent[1] > extent[2] ? 1 : 2);
+    const int half = count/2;
+    std::nth_element(_faces.begin() + first, _faces.begin() + first + half,
+                     _faces.begin() + first + count,
+                     [&centers, axis](int a, int b)
+                     { return centers[a][axis] < centers[b][axis]; });
+
+    const int left = (int)_nodes.size();
+    Node child;
+    child.first = first;
+    child.count = half;
+    _nodes.push_back(child);
+    child.first = first + half;
+    child.count = count - half;
+    _nodes.push_back(child);
+    _nodes[node].left = left;
+    build(lowers, uppers, centers, left);
+    build(lowers, uppers, centers, left + 1);
+}
+
+void TriangleMeshBVH::finish(std::vector<int>& faces, size_t begin)
+{
+    std::sort(faces.begin() + begin, faces.end());
+    faces.erase(std::unique(faces.begin() + begin, faces.end()), faces.end());
+}
+
+void TriangleMeshBVH::findFacesNearMesh(const TriangleMeshBVH& other,
+        const SimTK::Transform& X_AB, double margin,
+        std::vector<int>& faces) const
+{
+    const size_t begin = faces.size();
+    if (_nodes.empty() || other._nodes.empty())
+        return;
+
+    SimTK::Mat33 absR;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            absR(i, j) = std::abs(X_AB.R()(i, j));
+
+    // Leaves of this hierarchy whose faces have been found.
+    std::vector<char> found(_nodes.size(), 0);
+    std::vector<std::pair<int, int> > stack(1, std::make_pair(0, 0));
+    while (!stack.empty()) {
+        const int a = stack.back().first, b = stack.back().second;
+        stack.pop_back();
+        const Node& nodeA = _nodes[a];
+        const Node& nodeB = other._nodes[b];
+        if (found[a])
+            continue;
+
+        // Bound nodeB's box in this mesh's frame, and test it against
+        // nodeA's box, separated by at most margin.
+        const Vec3 halfB = 0.5*(nodeB.upper - nodeB.lower);
+        const Vec3 centerB = X_AB*(0.5*(nodeB.upper + nodeB.lower));
+        const Vec3 halfBinA = absR*halfB;
+        bool overlap = true;
+        for (int i = 0; i < 3 && overlap; ++i)
+            overlap = std::abs(centerB[i] - 0.5*(nodeA.upper[i] + nodeA.lower[i]))
+                <= halfBinA[i] + 0.5*(nodeA.upper[i] - nodeA.lower[i]) + margin;
+        if (!overlap)
+            continue;
+
+        const bool leafA = nodeA.left < 0, leafB = nodeB.left < 0;
+        if (leafA && leafB) {
+            found[a] = 1;
+            for (int k = nodeA.first; k < nodeA.first + nodeA.count; ++k)
+                faces.push_back(_faces[k]);
+        }
+        else if (leafB || (!leafA && nodeA.count >= nodeB.count)) {
+            stack.push_back(std::make_pair(nodeA.left, b));
+            stack.push_back(std::make_pair(nodeA.left + 1, b));
+        }
+        else {
+            stack.push_back(std::make_pair(a, nodeB.left));
+            stack.push_back(std::make_pair(a, nodeB.left + 1));
+        }
+    }
+    finish(faces, begin);
+}
+
+void TriangleMeshBVH::findFacesNearPoint(const Vec3& point, double radius,
+                                         std::vector<int>& faces) const
+{
+    const size_t begin = faces.size();
+    if (_nodes.empty())
+        return;
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        const Node& node = _nodes[stack.back()];
+        stack.pop_back();
+        // Squared distance from the point to the box.
+        double distance2 = 0;
+        for (int i = 0; i < 3; ++i) {
+            const double d = std::max(std::max(node.lower[i] - point[i],
+                                               point[i] - node.upper[i]), 0.0);
+            distance2 += d*d;
+        }
+        if (distance2 > radius*radius)
+            continue;
+        if (node.left < 0) {
+            for (int k = node.first; k < node.first + node.count; ++k)
+                faces.push_back(_faces[k]);
+        }
+        else {
+            stack.push_back(node.left);
+            stack.push_back(node.left + 1);
+        }
+    }
+    finish(faces, begin);
+}
+
+void TriangleMeshBVH::findFacesInHalfSpace(const SimTK::UnitVec3& normal,
+        double offset, std::vector<int>& faces) const
+{
+    const size_t begin = faces.size();
+    if (_nodes.empty())
+        return;
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        const Node& node = _nodes[stack.back()];
+        stack.pop_back();
+        // The corner of the box farthest along the normal.
+        double farthest = 0;
+        for (int i = 0; i < 3; ++i)
+            farthest += normal[i]*(normal[i] > 0 ? node.upper[i] : node.lower[i]);
+        if (farthest <= offset)
+            continue;
+        if (node.left < 0) {
+            for (int k = node.first; k < node.first + node.count; ++k)
+                faces.push_back(_faces[k]);
+        }
+        else {
+            stack.push_back(node.left);
+            stack.push_back(node.left + 1);
+        }
+    }
+    finish(faces, begin);
+}
+
+} // end of namespace OpenSim
@@ -0,0 +1,89 @@
+#ifndef OPENSIM_TRIANGLE_MESH_BVH_H_
+#define OPENSIM_TRIANGLE_MESH_BVH_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  TriangleMeshBVH.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+// INCLUDE
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include <SimTKsimbody.h>
+#include <vector>
+
+namespace OpenSim {
+
+/**
+ * A bounding volume hierarchy of axis-aligned boxes over the faces of a
+ * triangle mesh, in the mesh's frame. It is used to find the faces of a
+ * ContactMesh that may be in contact with another piece of contact geometry,
+ * so that only those faces need to be considered by ElasticFoundationForce.
+ * All queries are conservative: they may return faces that are not in
+ * contact, but return every face whose bounding box is within the given
+ * distance of the other geometry.
+ */
+class OSIMSIMULATION_API TriangleMeshBVH {
+public:
+    /** Create an empty hierarchy, with no faces. */
+    TriangleMeshBVH();
+    /** Build the hierarchy over the faces of a mesh. */
+    explicit TriangleMeshBVH(const SimTK::ContactGeometry::TriangleMesh& mesh);
+
+    int getNumFaces() const { return (int)_faces.size(); }
+    /** The largest distance of a vertex from the origin of the mesh. */
+    double getBoundingRadius() const { return _radius; }
+
+    /**
+     * Find the faces whose bounding boxes are within a distance margin of
+     * the bounding boxes of the faces of another mesh. X_AB is the
+     * transform of the other mesh's frame in this mesh's frame. The faces
+     * are appended to faces, in increasing order.
+     */
+    void findFacesNearMesh(const TriangleMeshBVH& other,
+                           const SimTK::Transform& X_AB, double margin,
+                           std::vector<int>& faces) const;
+    /** Find the faces whose bounding boxes are within a distance radius of
+    a point, in increasing order. */
+    void findFacesNearPoint(const SimTK::Vec3& point, double radius,
+                            std::vector<int>& faces) const;
+    /** Find the faces whose bounding boxes extend into the half space of
+    points x for which ~normal*x > offset, in increasing order. */
+    void findFacesInHalfSpace(const SimTK::UnitVec3& normal, double offset,
+                              std::vector<int>& faces) const;
+
+private:
+    // A node's box bounds the faces _faces[first, first+count). Leaves have
+    // no children (left < 0); otherwise the children are left and left+1.
+    struct Node {
+        SimTK::Vec3 lower, upper;
+        int first, count;
+        int left;
+    };
+    void build(std::vector<SimTK::Vec3>& lowers,
+               std::vector<SimTK::Vec3>& uppers,
+               std::vector<SimTK::Vec3>& centers, int node);
+    static void finish(std::vector<int>& faces, size_t begin);
+
+    std::vector<Node> _nodes;
+    std::vector<int> _faces;
+    double _radius;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_TRIANGLE_MESH_BVH_H_
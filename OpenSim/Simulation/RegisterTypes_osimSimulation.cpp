@@ -49,6 +49,7 @@
 #include "Model/CoordinateSet.h"
 #include "Model/ElasticFoundationForce.h"
 #include "Model/HuntCrossleyForce.h"
+#include "Model/SmoothSphereHalfSpaceForce.h"
 #include "Model/Ligament.h"
 #include "Model/JointSet.h"
 #include "Model/Marker.h"
@@ -229,6 +230,7 @@ OSIMSIMULATION_API void RegisterTypes_osimSimulation()
     Object::registerType( CoordinateLimitForce() );
     Object::registerType( HuntCrossleyForce() );
     Object::registerType( ElasticFoundationForce() );
+    Object::registerType( SmoothSphereHalfSpaceForce() );
     Object::registerType( HuntCrossleyForce::ContactParameters() );
     Object::registerType( HuntCrossleyForce::ContactParametersSet() );
     Object::registerType( ElasticFoundationForce::ContactParameters() );
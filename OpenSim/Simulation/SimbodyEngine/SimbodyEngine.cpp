@@ -345,38 +345,19 @@ SimTK::Transform SimbodyEngine::getTransform(const SimTK::State& s,
  */
 void SimbodyEngine::computeReactions(const SimTK::State& s, Vector_<Vec3>& rForces, Vector_<Vec3>& rTorques) const
 {
-    // get the number of mobilized bodies in the underlying SimbodyMatterSubsystem
-    int nmb = _model->getMatterSubsystem().getNumBodies();
-    
-    // get the number of bodies in the OpenSim model
     int nj = _model->getNumJoints();
+    assert(nj == rForces.size());
+    assert(nj == rTorques.size());
 
-    int nf = rForces.size();
-    int ntorq = rTorques.size();
-
-    // there may be more mobilized bodies than joint exposed in the OpenSim model
-    // since joints and other components may use (massless) bodies internally
-    assert(nmb >= nj);
-    assert(nj == nf);
-    assert(nf == ntorq);
-
+    // Systems are realized to acceleration stage by the model.
     SimTK::Vector_<SpatialVec> reactionForces(nj);
-
-    // Systems must be realized to acceleration stage
-    _model->getMultibodySystem().realize(s, Stage::Acceleration);
-    _model->getMatterSubsystem().calcMobilizerReactionForces(s, reactionForces);
-
-
-    const JointSet &joints = _model->getJointSet();
+    _model->calcJointReactions(s, reactionForces);
 
     //Separate SimTK SpatialVecs to Forces and Torques  
     // SpatialVec = Vec2<Vec3 torque, Vec3 force>
     for(int i=0; i<nj; i++){
-        const SimTK::MobilizedBodyIndex& ix = 
-            joints[i].getChildFrame().getMobilizedBodyIndex();
-         
-        rTorques[i] = reactionForces[ix](0);
-        rForces[i] = reactionForces[ix](1);
+        rTorques[i] = reactionForces[i](0);
+        rForces[i] = reactionForces[i](1);
     }
 }
 
@@ -29,12 +29,16 @@
 #include <OpenSim/Simulation/osimSimulation.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Common/Sine.h>
+#include <OpenSim/Common/LinearFunction.h>
 
 using namespace OpenSim;
 using namespace std;
 
 void testAssembleModelWithConstraints(string modelFile);
 void testAssemblySatisfiesConstraints(string modelFile);
+void testTrackWithPredictor(string modelFile);
+void testTrackWithPredictorSatisfiesConstraints(string modelFile);
 double calcLigamentLengthError(const SimTK::State &s, const Model &model);
 
 int main()
@@ -42,6 +46,8 @@ int main()
     try {
         LoadOpenSimLibrary("osimActuators");
         testAssemblySatisfiesConstraints("knee_patella_ligament.osim");
+        testTrackWithPredictor("double_pendulum.osim");
+        testTrackWithPredictorSatisfiesConstraints("knee_patella_ligament.osim");
         testAssembleModelWithConstraints("PushUpToesOnGroundExactConstraints.osim");
         testAssembleModelWithConstraints("PushUpToesOnGroundLessPreciseConstraints.osim");
         testAssembleModelWithConstraints("PushUpToesOnGroundWithMuscles.osim");
@@ -305,6 +311,103 @@ void testAssemblySatisfiesConstraints(string modelFile)
     }
 }
 
+void testTrackWithPredictor(string modelFile)
+{
+    cout << "****************************************************************************" << endl;
+    cout << " testTrackWithPredictor :: " << modelFile << endl;
+    cout << "****************************************************************************\n" << endl;
+
+    Model model(modelFile);
+    SimTK::State& state = model.initSystem();
+    const CoordinateSet& coords = model.getCoordinateSet();
+
+    // Smooth reference trajectories sampled at a high rate.
+    Sine q1Trajectory(0.5, 2*SimTK::Pi, 0.0), q2Trajectory(0.8, 3*SimTK::Pi, 0.3);
+    SimTK::Array_<CoordinateReference> references;
+    references.push_back(CoordinateReference(coords[0].getName(), q1Trajectory));
+    references.push_back(CoordinateReference(coords[1].getName(), q2Trajectory));
+
+    const double accuracy = 1e-8;
+    const int N = 200;
+    const double dt = 1.0/600;
+    ASSERT_THROW(OpenSim::Exception,
+        AssemblySolver(model, references).setPredictorOrder(3));
+
+    SimTK::Matrix solutions[3];
+    int numIterations[3] = {0, 0, 0};
+    for(int order = 0; order <= 2; ++order){
+        SimTK::State s = state;
+        AssemblySolver solver(model, references);
+        solver.setAccuracy(accuracy);
+        solver.setPredictorOrder(order);
+        s.updTime() = 0;
+        solver.assemble(s);
+
+        solutions[order].resize(N, s.getNQ());
+        for(int i = 0; i < N; ++i){
+            s.updTime() = i*dt;
+            solver.track(s);
+            numIterations[order] += solver.getNumIterations();
+            solutions[order][i] = ~s.getQ();
+        }
+        cout << "Predictor order " << order << ": " << numIterations[order]
+             << " iterations over " << N << " frames." << endl;
+    }
+
+    // Predicting the starting point must save iterations without changing
+    // the solution.
+    for(int order = 1; order <= 2; ++order){
+        ASSERT(numIterations[order] < numIterations[0], __FILE__, __LINE__,
+            "Predictor did not reduce the number of iterations.");
+        for(int i = 0; i < N; ++i)
+            for(int j = 0; j < solutions[0].ncol(); ++j)
+                ASSERT_EQUAL(solutions[0](i,j), solutions[order](i,j),
+                    10*accuracy, __FILE__, __LINE__,
+                    "Solution changed with the predictor.");
+    }
+}
+
+void testTrackWithPredictorSatisfiesConstraints(string modelFile)
+{
+    cout << "****************************************************************************" << endl;
+    cout << " testTrackWithPredictorSatisfiesConstraints :: " << modelFile << endl;
+    cout << "****************************************************************************\n" << endl;
+
+    Model model(modelFile);
+    model.set_assembly_accuracy(1e-8);
+    SimTK::State& state = model.initSystem();
+    const CoordinateSet& coords = model.getCoordinateSet();
+
+    // Track the knee angle only; the strictly enforced ligament constraint
+    // is not part of the assembly goal, so predictions must not be accepted
+    // at its expense.
+    // Flex the knee from 0.2 to 1.7 radians.
+    LinearFunction kneeTrajectory(-1.5, -0.2);
+    SimTK::Array_<CoordinateReference> references;
+    references.push_back(CoordinateReference(coords[0].getName(), kneeTrajectory));
+
+    const double accuracy = 1e-8;
+    const int N = 200;
+    const double dt = 1.0/200;
+    for(int order = 0; order <= 2; ++order){
+        SimTK::State s = state;
+        AssemblySolver solver(model, references);
+        solver.setAccuracy(accuracy);
+        solver.setPredictorOrder(order);
+        s.updTime() = 0;
+        solver.assemble(s);
+
+        for(int i = 0; i < N; ++i){
+            s.updTime() = i*dt;
+            solver.track(s);
+            model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+            ASSERT_EQUAL(0.0, calcLigamentLengthError(s, model),
+                model.get_assembly_accuracy(), __FILE__, __LINE__,
+                "Constraint NOT satisfied when tracking with the predictor.");
+        }
+    }
+}
+
 double calcLigamentLengthError(const SimTK::State &s, const Model &model)
 {
     using namespace SimTK;
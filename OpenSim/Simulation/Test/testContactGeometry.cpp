@@ -30,7 +30,8 @@
 //  Tests Include:
 //      1. Analytical contact sphere-plane geometry 
 //      2. Mesh-based sphere on analytical plane geometry
-//      3. 
+//      3. Smooth sphere to half space contact on a foot with many spheres
+//      4. Accelerated elastic foundation contact of two dense meshes
 //
 //==========================================================================================================
 #include <iostream>
@@ -49,9 +50,13 @@
 #include <OpenSim/Simulation/Model/ElasticFoundationForce.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/HuntCrossleyForce.h>
+#include <OpenSim/Simulation/Model/SmoothSphereHalfSpaceForce.h>
 #include <OpenSim/Simulation/SimbodyEngine/FreeJoint.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include "SimTKsimbody.h"
+#include <ctime>  // clock(), clock_t, CLOCKS_PER_SEC
+#include <chrono>
+#include <fstream>
 
 using namespace OpenSim;
 using namespace SimTK;
@@ -74,6 +79,8 @@ const static string mesh_files[] = {"sphere_10cm_radius.obj", "sphere_10cm_radiu
 int testBouncingBall(bool useMesh, const std::string mesh_filename="");
 int testBallToBallContact(bool useElasticFoundation, bool useMesh1, bool useMesh2);
 void compareHertzAndMeshContactResults();
+void testSmoothSphereHalfSpaceForce();
+void testAcceleratedMeshContact();
 
 int main()
 {
@@ -91,6 +98,8 @@ int main()
         testBallToBallContact(true, false, true);
         testBallToBallContact(true, true, true); 
         compareHertzAndMeshContactResults();
+        testSmoothSphereHalfSpaceForce();
+        testAcceleratedMeshContact();
     }
     catch (const OpenSim::Exception& e) {
         e.print(cerr);
@@ -354,3 +363,307 @@ void compareHertzAndMeshContactResults()
     CHECK_STORAGE_AGAINST_STANDARD(noMeshToMesh, meshToNoMesh, rms_tols_3, __FILE__, __LINE__, "ElasticFoundation noMesh-Mesh FAILED to match Mesh-noMesh Case ");
 
 }
+
+// A box-shaped foot on a free joint, with a 4x4 grid of contact spheres on
+// its sole, in contact with the ground through either a
+// SmoothSphereHalfSpaceForce or a HuntCrossleyForce of equivalent stiffness.
+const static double foot_sphere_radius = 0.02;
+const static double foot_stiffness = 1.0e6;
+const static double foot_dissipation = 1.0;
+
+Model* createFootModel(bool smooth)
+{
+    Model* osimModel = new Model;
+    osimModel->setName(smooth ? "SmoothContactFoot" : "HuntCrossleyFoot");
+    osimModel->setGravity(gravity_vec);
+
+    OpenSim::Body& ground = *new OpenSim::Body("ground", SimTK::Infinity,
+        Vec3(0), Inertia());
+    osimModel->addBody(&ground);
+    OpenSim::Body* foot = new OpenSim::Body("foot", mass, Vec3(0),
+        mass*Inertia::brick(0.1, 0.03, 0.05));
+    osimModel->addBody(foot);
+    osimModel->addJoint(new FreeJoint("free", ground, Vec3(0), Vec3(0),
+                                      *foot, Vec3(0), Vec3(0)));
+
+    osimModel->addContactGeometry(new ContactHalfSpace(Vec3(0),
+        Vec3(0, 0, -0.5*SimTK_PI), ground, "floor"));
+
+    SmoothSphereHalfSpaceForce* smoothForce =
+        new SmoothSphereHalfSpaceForce("foot_contact", "floor");
+    smoothForce->setStiffness(foot_stiffness);
+    smoothForce->setDissipation(foot_dissipation);
+    // Simbody combines the stiffnesses k of two surfaces as
+    // (k^(-2/3) + k^(-2/3))^(-3/2) = k/2^(3/2).
+    HuntCrossleyForce::ContactParameters* params =
+        new HuntCrossleyForce::ContactParameters(
+            pow(2.0, 1.5)*foot_stiffness, foot_dissipation,
+            smoothForce->getStaticFriction(),
+            smoothForce->getDynamicFriction(),
+            smoothForce->getViscousFriction());
+    params->addGeometry("floor");
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            const std::string name = "sphere_" + std::to_string(4*i + j);
+            osimModel->addContactGeometry(new ContactSphere(foot_sphere_radius,
+                Vec3(-0.09 + 0.06*i, -0.015, -0.045 + 0.03*j), *foot, name));
+            smoothForce->addContactSphere(name);
+            params->addGeometry(name);
+        }
+    }
+
+    if (smooth) {
+        osimModel->addForce(smoothForce);
+        delete params;
+    }
+    else {
+        HuntCrossleyForce* force = new HuntCrossleyForce(params);
+        force->setTransitionVelocity(smoothForce->getTransitionVelocity());
+        osimModel->addForce(force);
+        delete smoothForce;
+    }
+    return osimModel;
+}
+
+void testSmoothSphereHalfSpaceForce()
+{
+    // Compare the force on each sphere with Hertz's law, at rest and sliding.
+    Model* osimModel = createFootModel(true);
+    SimTK::State& state = osimModel->initSystem();
+    const SmoothSphereHalfSpaceForce& force =
+        dynamic_cast<const SmoothSphereHalfSpaceForce&>(
+            osimModel->getForceSet().get("foot_contact"));
+    ASSERT(force.getNumContactSpheres() == 16);
+
+    const double depth = 0.001;
+    const double hertz = 4.0/3.0*foot_stiffness*
+        sqrt(foot_sphere_radius)*pow(depth, 1.5);
+    state.updQ()[4] = 0.015 + foot_sphere_radius - depth;
+    osimModel->getMultibodySystem().realize(state, Stage::Velocity);
+    Vec3 f, p;
+    for (int i = 0; i < force.getNumContactSpheres(); ++i) {
+        force.calcContactForce(state, i, f, p);
+        ASSERT_EQUAL(hertz, f[1], 1e-2*hertz, __FILE__, __LINE__,
+            "SmoothSphereHalfSpaceForce does not follow Hertz's law.");
+        ASSERT_EQUAL(0.0, f[0], SimTK::Eps);
+        ASSERT_EQUAL(0.0, f[2], SimTK::Eps);
+        ASSERT_EQUAL(-0.5*depth, p[1], SimTK::Eps);
+    }
+    ASSERT(force.getRecordValues(state).getSize() ==
+           force.getRecordLabels().getSize());
+
+    // Sliding along X at 10 times the transition velocity.
+    state.updU()[3] = 10*force.getTransitionVelocity();
+    osimModel->getMultibodySystem().realize(state, Stage::Velocity);
+    const double mu_d = force.getDynamicFriction();
+    const double mu_s = force.getStaticFriction();
+    const double mu = mu_d*10/sqrt(101.0) + 2*(mu_s - mu_d)*10/101.0;
+    force.calcContactForce(state, 0, f, p);
+    ASSERT_EQUAL(-mu*f[1], f[0], 1e-10*hertz, __FILE__, __LINE__,
+        "SmoothSphereHalfSpaceForce friction is incorrect.");
+    ASSERT_EQUAL(0.0, f[2], SimTK::Eps);
+    delete osimModel;
+
+    // Drop the foot onto the ground with each contact model and compare
+    // the steps taken and time spent by the integrator, and where the foot
+    // comes to rest.
+    double restHeight[2];
+    for (int smooth = 0; smooth < 2; ++smooth) {
+        osimModel = createFootModel(smooth == 1);
+        SimTK::State& s = osimModel->initSystem();
+        s.updQ()[4] = 0.1;
+        s.updU()[3] = 0.2;
+
+        RungeKuttaMersonIntegrator integrator(osimModel->getMultibodySystem());
+        integrator.setAccuracy(integ_accuracy);
+        Manager manager(*osimModel, integrator);
+        manager.setInitialTime(0.0);
+        manager.setFinalTime(duration);
+
+        clock_t startTime = clock();
+        manager.integrate(s);
+        const double ms = 1.e3*(clock() - startTime)/CLOCKS_PER_SEC;
+
+        cout << (smooth ? "SmoothSphereHalfSpaceForce" : "HuntCrossleyForce")
+             << " foot drop: " << integrator.getNumStepsTaken() << " steps, "
+             << osimModel->getMultibodySystem().getNumRealizationsOfThisStage(
+                    Stage::Acceleration) << " realizations, "
+             << ms << " ms" << endl;
+
+        osimModel->getMultibodySystem().realize(s, Stage::Velocity);
+        restHeight[smooth] = s.getQ()[4];
+        ASSERT(restHeight[smooth] > 0 && restHeight[smooth] < 0.015 +
+               foot_sphere_radius, __FILE__, __LINE__,
+               "Foot did not come to rest on the ground.");
+        ASSERT_EQUAL(0.0, s.getU()[4], 1e-2);
+        delete osimModel;
+    }
+    // The weight is shared by 16 spheres, so the equilibrium depth is small.
+    ASSERT_EQUAL(restHeight[0], restHeight[1], 1e-4, __FILE__, __LINE__,
+        "SmoothSphereHalfSpaceForce and HuntCrossleyForce feet came to rest "
+        "at different heights.");
+}
+
+// Write a closed, outward-facing sphere mesh with 2*nLon*(nLat-1) triangles.
+void writeSphereMesh(const std::string& filename, double r, int nLat, int nLon)
+{
+    std::ofstream out(filename.c_str());
+    out << "v 0 " << r << " 0" << endl;
+    for (int i = 1; i < nLat; ++i) {
+        const double theta = SimTK::Pi*i/nLat;
+        for (int j = 0; j < nLon; ++j) {
+            const double phi = 2*SimTK::Pi*j/nLon;
+            out << "v " << r*sin(theta)*cos(phi) << " " << r*cos(theta)
+                << " " << r*sin(theta)*sin(phi) << endl;
+        }
+    }
+    out << "v 0 " << -r << " 0" << endl;
+
+    // 1-based index of vertex j of ring i, and of the south pole.
+    auto ring = [nLon](int i, int j) { return 2 + (i - 1)*nLon + j%nLon; };
+    const int south = 2 + (nLat - 1)*nLon;
+    for (int j = 0; j < nLon; ++j) {
+        out << "f 1 " << ring(1, j + 1) << " " << ring(1, j) << endl;
+        for (int i = 1; i < nLat - 1; ++i) {
+            out << "f " << ring(i, j) << " " << ring(i, j + 1) << " "
+                << ring(i + 1, j) << endl;
+            out << "f " << ring(i, j + 1) << " " << ring(i + 1, j + 1) << " "
+                << ring(i + 1, j) << endl;
+        }
+        out << "f " << ring(nLat - 1, j) << " " << ring(nLat - 1, j + 1)
+            << " " << south << endl;
+    }
+}
+
+const static double dense_mesh_radius = 0.03;
+const static double dense_mesh_overlap = 0.002;
+
+// Two dense sphere meshes, one fixed to ground and one on a free body,
+// overlapping by dense_mesh_overlap.
+Model* createMeshContactModel(bool accelerate, double margin,
+                              int numThreads = 1)
+{
+    Model* osimModel = new Model;
+    osimModel->setName("DenseMeshContact");
+    OpenSim::Body& ground = *new OpenSim::Body("ground", SimTK::Infinity,
+        Vec3(0), Inertia());
+    osimModel->addBody(&ground);
+    OpenSim::Body* femur = new OpenSim::Body("femur", mass, Vec3(0),
+        Inertia(1.0));
+    osimModel->addBody(femur);
+    osimModel->addJoint(new FreeJoint("free", ground, Vec3(0), Vec3(0),
+                                      *femur, Vec3(0), Vec3(0)));
+
+    osimModel->addContactGeometry(new ContactMesh("dense_sphere.obj",
+        Vec3(0), Vec3(0), ground, "tibia"));
+    osimModel->addContactGeometry(new ContactMesh("dense_sphere.obj",
+        Vec3(0), Vec3(0.3, 0.2, 0.1), *femur, "femur"));
+
+    ElasticFoundationForce::ContactParameters* params =
+        new ElasticFoundationForce::ContactParameters(
+            1.0e6/(2*dense_mesh_radius), 0.1, 0.8, 0.6, 0.0);
+    params->addGeometry("tibia");
+    params->addGeometry("femur");
+    ElasticFoundationForce* force = new ElasticFoundationForce(params);
+    force->setName("contact");
+    force->set_accelerate_mesh_contact(accelerate);
+    force->set_proximity_margin(margin);
+    force->set_num_threads(numThreads);
+    osimModel->addForce(force);
+    return osimModel;
+}
+
+// Set the femur's position and velocity; the spheres overlap by
+// dense_mesh_overlap when offset is 0.
+void setFemurMotion(SimTK::State& s, const Vec3& offset)
+{
+    s.updQ()[3] = offset[0];
+    s.updQ()[4] = 2*dense_mesh_radius - dense_mesh_overlap + offset[1];
+    s.updQ()[5] = offset[2];
+    s.updU()[3] = 0.05;
+    s.updU()[4] = -0.01;
+}
+
+// The force on the femur, in ground.
+Vec3 calcFemurForce(const Model& model, const SimTK::State& s)
+{
+    model.getMultibodySystem().realize(s, Stage::Velocity);
+    const OpenSim::Force& force = model.getForceSet().get("contact");
+    Array<double> values = force.getRecordValues(s);
+    // The values of the tibia, then of the femur, each force then torque.
+    return Vec3(values[6], values[7], values[8]);
+}
+
+void testAcceleratedMeshContact()
+{
+    writeSphereMesh("dense_sphere.obj", dense_mesh_radius, 71, 72);
+
+    Model* simbody = createMeshContactModel(false, 0.005);
+    Model* accelerated = createMeshContactModel(true, 0.005);
+    // With a large margin, every face is a candidate for contact.
+    Model* bruteForce = createMeshContactModel(true, 1.0);
+    // Enough faces that their springs are split among threads.
+    Model* threaded = createMeshContactModel(true, 1.0, 4);
+    SimTK::State& s1 = simbody->initSystem();
+    SimTK::State& s2 = accelerated->initSystem();
+    SimTK::State& s3 = bruteForce->initSystem();
+    SimTK::State& s4 = threaded->initSystem();
+
+    // Move the femur by less than the margin, so that the candidate faces
+    // are reused, and then by more, so that they are found again; the
+    // forces must match those found by considering every face. They must
+    // also match Simbody's, which evaluates the same springs in another
+    // order, to within a relative tolerance of 1e-6.
+    const Vec3 offsets[] = { Vec3(0), Vec3(0.001, 0, 0.0005),
+                             Vec3(0.002, -0.0005, 0.001), Vec3(0.008, 0, 0) };
+    for (const Vec3& offset : offsets) {
+        setFemurMotion(s1, offset);
+        setFemurMotion(s2, offset);
+        setFemurMotion(s3, offset);
+        setFemurMotion(s4, offset);
+        const Vec3 fSimbody = calcFemurForce(*simbody, s1);
+        const Vec3 fAccelerated = calcFemurForce(*accelerated, s2);
+        const Vec3 fBruteForce = calcFemurForce(*bruteForce, s3);
+        const Vec3 fThreaded = calcFemurForce(*threaded, s4);
+        cout << "Mesh contact force on femur: Simbody " << fSimbody
+             << ", accelerated " << fAccelerated << endl;
+        ASSERT(fAccelerated[1] > 0, __FILE__, __LINE__,
+            "Accelerated mesh contact found no contact.");
+        ASSERT_EQUAL(0.0, (fAccelerated - fBruteForce).norm(),
+            1e-10*fBruteForce.norm(), __FILE__, __LINE__,
+            "Accelerated mesh contact missed faces in contact.");
+        ASSERT_EQUAL(0.0, (fThreaded - fBruteForce).norm(),
+            1e-10*fBruteForce.norm(), __FILE__, __LINE__,
+            "Mesh contact on several threads differs from one thread.");
+        ASSERT_EQUAL(0.0, (fAccelerated - fSimbody).norm(),
+            1e-6*fSimbody.norm(), __FILE__, __LINE__,
+            "Accelerated mesh contact differs from Simbody's.");
+    }
+
+    // Time evaluations of the contact force of the 20k-triangle pair, each
+    // at a slightly different pose, as during a simulation.
+    const int n = 50;
+    Model* models[] = { simbody, accelerated, bruteForce, threaded };
+    SimTK::State* states[] = { &s1, &s2, &s3, &s4 };
+    const char* names[] = { "Simbody", "accelerated", "all faces",
+                            "all faces, 4 threads" };
+    for (int m = 0; m < 4; ++m) {
+        const auto startTime = std::chrono::steady_clock::now();
+        for (int k = 0; k < n; ++k) {
+            setFemurMotion(*states[m], Vec3(1e-5*k, 0, 0));
+            models[m]->getMultibodySystem().realize(*states[m],
+                                                    Stage::Dynamics);
+        }
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - startTime;
+        cout << "Elastic foundation contact of two " << 2*72*70
+             << "-triangle meshes (" << names[m] << "): "
+             << elapsed.count()/n << " ms per evaluation" << endl;
+    }
+
+    delete simbody;
+    delete accelerated;
+    delete bruteForce;
+    delete threaded;
+}
@@ -0,0 +1,178 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testGeometryPath.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testGeometryPath counts the heap allocations made while computing the
+// lengths and lengthening speeds of muscle paths: the wrapping paths of the
+// arm26 model, and a knee extensor whose path has a MovingPathPoint and a
+// ConditionalPathPoint that is only active over part of the knee's range.
+// Once every path has been computed over the range of motion, doing so
+// again must not allocate. The allocations made by a complete evaluation of
+// the model's dynamics are reported for reference.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <new>
+
+using namespace OpenSim;
+using namespace std;
+
+// Count the allocations made by the program while counting is enabled.
+static atomic<bool> countAllocations(false);
+static atomic<long> numAllocations(0);
+
+void* operator new(size_t size)
+{
+    if (countAllocations)
+        ++numAllocations;
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+// Set the model's configuration at fraction f of a sweep through its range
+// of motion, in which alternate coordinates move in opposite directions,
+// realized to Velocity stage.
+void setConfiguration(const Model& model, SimTK::State& s, double f)
+{
+    const CoordinateSet& coordinates = model.getCoordinateSet();
+    for (int j = 0; j < coordinates.getSize(); ++j) {
+        const Coordinate& coord = coordinates.get(j);
+        const double range = coord.getRangeMax() - coord.getRangeMin();
+        if (j % 2 == 0) {
+            coord.setValue(s, coord.getRangeMin() + f*range, false);
+            coord.setSpeedValue(s, 0.5);
+        } else {
+            coord.setValue(s, coord.getRangeMax() - f*range, false);
+            coord.setSpeedValue(s, -1.0);
+        }
+    }
+    model.realizeVelocity(s);
+}
+
+void testPathComputationDoesNotAllocate(const string& modelFile)
+{
+    Model model(modelFile);
+    SimTK::State& s = model.initSystem();
+    const Set<Muscle>& muscles = model.getMuscles();
+
+    // Compute every path over the range of motion, so that each wrap has
+    // been found and each conditional point activated at least once and the
+    // arrays have grown to their final sizes.
+    const int n = 50;
+    int minPathPoints = INT_MAX, maxPathPoints = 0;
+    for (int k = 0; k < n; ++k) {
+        setConfiguration(model, s, double(k)/(n - 1));
+        for (int i = 0; i < muscles.getSize(); ++i) {
+            const GeometryPath& path = muscles.get(i).getGeometryPath();
+            path.getLengtheningSpeed(s);
+            const int numPathPoints = path.getCurrentPath(s).getSize();
+            minPathPoints = min(minPathPoints, numPathPoints);
+            maxPathPoints = max(maxPathPoints, numPathPoints);
+        }
+    }
+
+    // Compute the paths again, at configurations that were not visited, and
+    // count only the allocations made by the path computations.
+    long maxPathAllocations = 0, maxRHSAllocations = 0;
+    double sumLength = 0;
+    for (int k = 0; k < n - 1; ++k) {
+        setConfiguration(model, s, (k + 0.5)/(n - 1));
+
+        numAllocations = 0;
+        countAllocations = true;
+        for (int i = 0; i < muscles.getSize(); ++i) {
+            const GeometryPath& path = muscles.get(i).getGeometryPath();
+            sumLength += path.getLength(s);
+            path.getLengtheningSpeed(s);
+        }
+        countAllocations = false;
+        maxPathAllocations = max(maxPathAllocations, long(numAllocations));
+
+        // The rest of the dynamics (muscle equilibrium, forces and
+        // accelerations) are not held to the same requirement.
+        numAllocations = 0;
+        countAllocations = true;
+        model.realizeAcceleration(s);
+        countAllocations = false;
+        maxRHSAllocations = max(maxRHSAllocations, long(numAllocations));
+    }
+
+    cout << modelFile << ": allocations per computation of all "
+         << muscles.getSize() << " muscle paths: " << maxPathAllocations
+         << " (" << minPathPoints << " to " << maxPathPoints
+         << " points per path)" << endl;
+    cout << "Allocations per dynamics evaluation (after paths): "
+         << maxRHSAllocations << endl;
+    ASSERT(sumLength > 0);
+    ASSERT(maxPathAllocations == 0, __FILE__, __LINE__,
+        "Computing muscle paths allocated memory in steady state.");
+}
+
+// The knee extensor's path ends at a MovingPathPoint, and its
+// ConditionalPathPoint must be active over only part of the sweep.
+void testMovingAndConditionalPathPoints()
+{
+    Model model("MovingPathPointMomentArmTest.osim");
+    SimTK::State& s = model.initSystem();
+    const GeometryPath& path = model.getMuscles().get(0).getGeometryPath();
+
+    const int n = 50;
+    int minPathPoints = INT_MAX, maxPathPoints = 0;
+    for (int k = 0; k < n; ++k) {
+        setConfiguration(model, s, double(k)/(n - 1));
+        const int numPathPoints = path.getCurrentPath(s).getSize();
+        minPathPoints = min(minPathPoints, numPathPoints);
+        maxPathPoints = max(maxPathPoints, numPathPoints);
+    }
+    ASSERT(minPathPoints < maxPathPoints, __FILE__, __LINE__,
+        "The ConditionalPathPoint was not activated and deactivated.");
+    ASSERT(dynamic_cast<const MovingPathPoint*>(
+               &path.getPathPointSet().get(path.getPathPointSet().getSize()-1))
+           != NULL, __FILE__, __LINE__,
+        "Expected the last path point to be a MovingPathPoint.");
+}
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testPathComputationDoesNotAllocate("arm26.osim");
+        testMovingAndConditionalPathPoints();
+        testPathComputationDoesNotAllocate("MovingPathPointMomentArmTest.osim");
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -21,9 +21,11 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 #include <stdint.h>
+#include <fstream>
 #include <OpenSim/Simulation/Manager/Manager.h>
 #include <OpenSim/Simulation/Control/ControlSetController.h>
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ModelSnapshot.h>
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
@@ -42,6 +44,22 @@ void testStates(const string& modelFile);
 // cause the memory footprint of the process to increase significantly.
 //==============================================================================
 void testMemoryUsage(const string& modelFile);
+//==============================================================================
+// testLoadProfile tests that the time spent in each phase of loading a model
+// is recorded and that connectors resolved by the model's component index
+// find the components they name.
+//==============================================================================
+void testLoadProfile(const string& modelFile);
+//==============================================================================
+// testForkAndSnapshot tests that models forked from a prototype or created
+// from a binary snapshot have the same default state as the original.
+//==============================================================================
+void testForkAndSnapshot(const string& modelFile);
+//==============================================================================
+// testComponentProfile tests that the computations of a model's components
+// are timed only while profiling is on.
+//==============================================================================
+void testComponentProfile(const string& modelFile);
 
 static const int MAX_N_TRIES = 100;
 
@@ -52,6 +70,10 @@ int main()
         testStates("arm26.osim");
         testMemoryUsage("arm26.osim");
         testMemoryUsage("PushUpToesOnGroundWithMuscles.osim");
+        testLoadProfile("gait2354_simbody.osim");
+        testForkAndSnapshot("arm26.osim");
+        testForkAndSnapshot("gait2354_simbody.osim");
+        testComponentProfile("arm26.osim");
     }
     catch (const Exception& e) {
         cout << "testInitState failed: ";
@@ -224,3 +246,168 @@ void testMemoryUsage(const string& modelFile)
     ASSERT( delta < 1e8, __FILE__, __LINE__, 
         "testMemoryUsage: total estimated memory leaked > 100MB.");
 }
+
+void testLoadProfile(const string& modelFile)
+{
+    Model model(modelFile);
+    model.initSystem();
+
+    const ModelLoadProfile& profile = model.getLoadProfile();
+    model.printLoadProfile(cout);
+
+    ASSERT(profile.parseXML > 0, __FILE__, __LINE__,
+        "testLoadProfile: time to parse XML was not recorded.");
+    ASSERT(profile.constructObjects > 0, __FILE__, __LINE__,
+        "testLoadProfile: time to construct objects was not recorded.");
+    ASSERT(profile.finalize > 0 && profile.connect > 0, __FILE__, __LINE__,
+        "testLoadProfile: time to finalize and connect was not recorded.");
+    ASSERT(profile.addToSystem > 0 && profile.realizeTopology > 0,
+        __FILE__, __LINE__,
+        "testLoadProfile: time to create the System was not recorded.");
+
+    // Every joint must be connected to the frames that it names.
+    for (int i = 0; i < model.getJointSet().getSize(); ++i) {
+        const Joint& joint = model.getJointSet()[i];
+        ASSERT(joint.getParentFrame().getName() == joint.getParentFrameName(),
+            __FILE__, __LINE__, "testLoadProfile: parent frame mismatch.");
+        ASSERT(joint.getChildFrame().getName() == joint.getChildFrameName(),
+            __FILE__, __LINE__, "testLoadProfile: child frame mismatch.");
+    }
+
+    // Reinitializing accumulates and reset clears the profile.
+    const double total = profile.getTotal();
+    model.initSystem();
+    ASSERT(model.getLoadProfile().getTotal() > total);
+    model.resetLoadProfile();
+    ASSERT(model.getLoadProfile().getTotal() == 0);
+}
+
+void testForkAndSnapshot(const string& modelFile)
+{
+    using namespace SimTK;
+
+    Model model(modelFile);
+    const Vector y0 = model.initSystem().getY();
+
+    clock_t startTime = clock();
+    std::unique_ptr<Model> cloned(model.clone());
+    double cloneTime = (double)(clock() - startTime) / CLOCKS_PER_SEC;
+
+    startTime = clock();
+    std::unique_ptr<Model> forked(model.fork());
+    double forkTime = (double)(clock() - startTime) / CLOCKS_PER_SEC;
+    cout << modelFile << ": clone " << cloneTime << "s, fork " << forkTime
+         << "s" << endl;
+
+    const Vector yFork = forked->initSystem().getY();
+    ASSERT(yFork.size() == y0.size(), __FILE__, __LINE__,
+        "testForkAndSnapshot: forked model has a different number of states.");
+    for (int i = 0; i < y0.size(); ++i) {
+        ASSERT_EQUAL(y0[i], yFork[i], 1e-9, __FILE__, __LINE__,
+            "testForkAndSnapshot: forked model has a different default state.");
+    }
+
+    ModelSnapshot(model).write("testForkAndSnapshot.osnap");
+    ModelSnapshot snapshot("testForkAndSnapshot.osnap");
+
+    startTime = clock();
+    { Model loaded(modelFile); }
+    double loadTime = (double)(clock() - startTime) / CLOCKS_PER_SEC;
+
+    startTime = clock();
+    std::unique_ptr<Model> restored(snapshot.createModel());
+    double snapshotTime = (double)(clock() - startTime) / CLOCKS_PER_SEC;
+    cout << modelFile << ": read model file " << loadTime
+         << "s, create from snapshot " << snapshotTime << "s" << endl;
+    ASSERT(restored->getName() == model.getName());
+    ASSERT(restored->getNumCoordinates() == model.getNumCoordinates());
+
+    const Vector ySnap = restored->initSystem().getY();
+    ASSERT(ySnap.size() == y0.size(), __FILE__, __LINE__,
+        "testForkAndSnapshot: restored model has a different number of states.");
+    for (int i = 0; i < y0.size(); ++i) {
+        ASSERT_EQUAL(y0[i], ySnap[i], 1e-9, __FILE__, __LINE__,
+            "testForkAndSnapshot: restored model has a different default state.");
+    }
+
+    // Anything else must be rejected.
+    ASSERT_THROW(Exception, ModelSnapshot snapshot2(modelFile));
+
+    // So must snapshots with negative counts or out-of-range string indices.
+    auto writeCorrupt = [](const std::vector<int32_t>& element) {
+        std::ofstream out("testForkAndSnapshotCorrupt.osnap",
+                          std::ios_base::out | std::ios_base::binary);
+        const int32_t header[] = { 1, 30000, 0, 1, 5 };
+        out.write("OSIMSNAP", 8);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write("Model", 5);
+        out.write(reinterpret_cast<const char*>(element.data()),
+                  element.size()*sizeof(int32_t));
+    };
+    writeCorrupt({ 0, 0, -1, 0 });
+    ModelSnapshot empty("testForkAndSnapshotCorrupt.osnap");
+    writeCorrupt({ 1, 0, -1, 0 });
+    ASSERT_THROW(Exception,
+                 ModelSnapshot bad("testForkAndSnapshotCorrupt.osnap"));
+    writeCorrupt({ 0, 1, 0, 3, -1, 0 });
+    ASSERT_THROW(Exception,
+                 ModelSnapshot bad("testForkAndSnapshotCorrupt.osnap"));
+    writeCorrupt({ 0, -1, -1, 0 });
+    ASSERT_THROW(Exception,
+                 ModelSnapshot bad("testForkAndSnapshotCorrupt.osnap"));
+    writeCorrupt({ 0, 0, -1, -2 });
+    ASSERT_THROW(Exception,
+                 ModelSnapshot bad("testForkAndSnapshotCorrupt.osnap"));
+    writeCorrupt({ 0, 0, -2 });
+    ASSERT_THROW(Exception,
+                 ModelSnapshot bad("testForkAndSnapshotCorrupt.osnap"));
+}
+
+void testComponentProfile(const string& modelFile)
+{
+    Model model(modelFile);
+    SimTK::State& state = model.initSystem();
+    model.setProfiling(true);
+    ASSERT(model.getProfiling());
+
+    const int nRealizations = 20;
+    for (int i = 0; i < nRealizations; ++i) {
+        state.updTime() = 0.01*i;
+        model.realizeAcceleration(state);
+    }
+    model.printProfile(cout);
+    model.getProfiler().printCSV("testComponentProfile.csv");
+
+    const vector<ComponentProfiler::Record> records =
+        model.getProfiler().getRecords();
+    ASSERT(!records.empty(), __FILE__, __LINE__,
+        "testComponentProfile: no computations were timed.");
+    bool foundForce = false, foundPath = false;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (i > 0)
+            ASSERT(records[i-1].selfTime >= records[i].selfTime);
+        ASSERT(records[i].selfTime <= records[i].totalTime + 1e-12);
+        if (records[i].category == ComponentProfiler::ComputeForce &&
+                records[i].concreteClassName.find("Muscle") != string::npos) {
+            foundForce = true;
+            ASSERT(records[i].numCalls == nRealizations, __FILE__, __LINE__,
+                "testComponentProfile: muscle force was not timed each time.");
+        }
+        if (records[i].category == ComponentProfiler::ComputePath)
+            foundPath = true;
+    }
+    ASSERT(foundForce && foundPath, __FILE__, __LINE__,
+        "testComponentProfile: muscle forces and paths were not timed.");
+
+    // Copies are not profiled, and turning profiling off stops the timing.
+    std::unique_ptr<Model> copy(model.clone());
+    ASSERT(!copy->getProfiling());
+    model.setProfiling(false);
+    const double total = model.getProfiler().getTotalSelfTime();
+    state.updTime() = 1.0;
+    model.realizeAcceleration(state);
+    ASSERT(model.getProfiler().getTotalSelfTime() == total);
+
+    model.resetProfiler();
+    ASSERT(model.getProfiler().getRecords().empty());
+}
@@ -0,0 +1,287 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  testKinematicsAnalyses.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+//  testKinematicsAnalyses tests the rows recorded by the BodyKinematics and
+//  PointKinematics analyses against the same quantities computed body by body
+//  with the SimbodyEngine helpers, on a 30-body chain in random states.
+//  Tests Include:
+//      1. BodyKinematics in radians and degrees, in ground and body frames,
+//         including the whole-body center of mass rows.
+//      2. PointKinematics in ground and relative to another body.
+//      3. Timing of recording all bodies compared to realizing the system.
+//
+//==============================================================================
+#include <iostream>
+#include <chrono>
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/BodySet.h>
+#include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
+#include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
+#include <OpenSim/Analyses/BodyKinematics.h>
+#include <OpenSim/Analyses/PointKinematics.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Vec3;
+
+const int numBodies = 30;
+const int numStates = 20;
+const double tol = 1.0e-10;
+
+// A chain of bodies with mass centers off their joint axes and joint axes in
+// varying directions, so that every quantity has nonzero components.
+Model* createChainModel();
+// Put the chain in a random configuration and speeds that depend only on k,
+// at time 0.01*k.
+void setRandomState(Model& model, SimTK::State& s, int k);
+
+void testBodyKinematics(bool inDegrees, bool inLocalFrame);
+void testPointKinematics(bool relativeToBody);
+void testBodyKinematicsTiming();
+
+int main()
+{
+    try {
+        testBodyKinematics(false, false);
+        testBodyKinematics(true, false);
+        testBodyKinematics(false, true);
+        testBodyKinematics(true, true);
+        testPointKinematics(false);
+        testPointKinematics(true);
+        testBodyKinematicsTiming();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+Model* createChainModel()
+{
+    Model* model = new Model;
+    model->setName("chain");
+    const PhysicalFrame* parent = &model->getGround();
+    for (int i = 0; i < numBodies; ++i) {
+        const string index = to_string(i);
+        OpenSim::Body* body = new OpenSim::Body("body" + index, 1.0 + 0.1*i,
+            Vec3(0.02, -0.25, 0.01*i), SimTK::Inertia(0.1, 0.2, 0.3));
+        PinJoint* joint = new PinJoint("joint" + index,
+            *parent, Vec3(0, -0.5, 0), Vec3(0.3*i, 0.7, -0.2*i),
+            *body, Vec3(0), Vec3(0));
+        model->addBody(body);
+        model->addJoint(joint);
+        parent = body;
+    }
+    return model;
+}
+
+void setRandomState(Model& model, SimTK::State& s, int k)
+{
+    SimTK::Random::Uniform random(-1.0, 1.0);
+    random.setSeed(k);
+    s.updTime() = 0.01*k;
+    for (int i = 0; i < s.getNQ(); ++i) s.updQ()[i] = random.getValue();
+    for (int i = 0; i < s.getNU(); ++i) s.updU()[i] = random.getValue();
+    model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+}
+
+// The row of a storage at index k, as a pointer to its first value.
+const double* getRow(Storage& storage, int k)
+{
+    return &storage.getStateVector(k)->getData()[0];
+}
+
+void checkVec3(const Vec3& expected, const double* actual, const string& what)
+{
+    for (int j = 0; j < 3; ++j)
+        ASSERT_EQUAL(expected[j], actual[j], tol*(1.0 + fabs(expected[j])),
+            __FILE__, __LINE__, "Kinematics analysis: " + what + " differs from "
+            "the SimbodyEngine value.");
+}
+
+void testBodyKinematics(bool inDegrees, bool inLocalFrame)
+{
+    Model* model = createChainModel();
+    SimTK::State& s = model->initSystem();
+
+    // Record every body and the whole-body center of mass.
+    BodyKinematics kin;
+    Array<string> bodies;
+    bodies.append("all");
+    kin.setBodiesToRecord(bodies);
+    kin.setInDegrees(inDegrees);
+    kin.setExpressResultsInLocalFrame(inLocalFrame);
+    kin.setModel(*model);
+
+    for (int k = 0; k < numStates; ++k) {
+        setRandomState(*model, s, k);
+        if (k == 0) kin.begin(s);
+        else kin.step(s, k);
+    }
+    ASSERT(kin.getPositionStorage()->getSize() == numStates);
+    ASSERT(kin.getVelocityStorage()->getSize() == numStates);
+    ASSERT(kin.getAccelerationStorage()->getSize() == numStates);
+
+    // Recompute each row as record() used to, body by body through the
+    // SimbodyEngine helpers.
+    const SimbodyEngine& engine = model->getSimbodyEngine();
+    const Ground& ground = model->getGround();
+    const BodySet& bs = model->getBodySet();
+    const double scale = inDegrees ? SimTK_RADIAN_TO_DEGREE : 1.0;
+    const int rowSize = 6*bs.getSize() + 3;
+    for (int k = 0; k < numStates; ++k) {
+        setRandomState(*model, s, k);
+        ASSERT(kin.getPositionStorage()->getStateVector(k)->getSize()
+               == rowSize);
+        const double* pRow = getRow(*kin.getPositionStorage(), k);
+        const double* vRow = getRow(*kin.getVelocityStorage(), k);
+        const double* aRow = getRow(*kin.getAccelerationStorage(), k);
+
+        double mass = 0.0;
+        Vec3 rP(0), rV(0), rA(0);
+        for (int i = 0; i < bs.getSize(); ++i) {
+            const Body& body = bs.get(i);
+            const Vec3& com = body.get_mass_center();
+            Vec3 pos, vel, acc, angles, angVel, angAcc;
+            double dirCos[3][3];
+            engine.getPosition(s, body, com, pos);
+            engine.getDirectionCosines(s, body, dirCos);
+            engine.convertDirectionCosinesToAngles(dirCos,
+                &angles[0], &angles[1], &angles[2]);
+            engine.getVelocity(s, body, com, vel);
+            engine.getAcceleration(s, body, com, acc);
+
+            mass += body.get_mass();
+            rP += body.get_mass()*pos;
+            rV += body.get_mass()*vel;
+            rA += body.get_mass()*acc;
+
+            if (inLocalFrame) {
+                engine.transform(s, ground, vel, body, vel);
+                engine.transform(s, ground, acc, body, acc);
+                engine.getAngularVelocityBodyLocal(s, body, angVel);
+                engine.getAngularAccelerationBodyLocal(s, body, angAcc);
+            } else {
+                engine.getAngularVelocity(s, body, angVel);
+                engine.getAngularAcceleration(s, body, angAcc);
+            }
+
+            const int I = 6*i;
+            checkVec3(pos, &pRow[I], body.getName() + " position");
+            checkVec3(scale*angles, &pRow[I+3], body.getName() + " angles");
+            checkVec3(vel, &vRow[I], body.getName() + " velocity");
+            checkVec3(scale*angVel, &vRow[I+3],
+                      body.getName() + " angular velocity");
+            checkVec3(acc, &aRow[I], body.getName() + " acceleration");
+            checkVec3(scale*angAcc, &aRow[I+3],
+                      body.getName() + " angular acceleration");
+        }
+
+        // The center of mass rows are always in ground.
+        const int I = 6*bs.getSize();
+        checkVec3(rP/mass, &pRow[I], "center of mass position");
+        checkVec3(rV/mass, &vRow[I], "center of mass velocity");
+        checkVec3(rA/mass, &aRow[I], "center of mass acceleration");
+    }
+
+    delete model;
+}
+
+void testPointKinematics(bool relativeToBody)
+{
+    Model* model = createChainModel();
+    SimTK::State& s = model->initSystem();
+
+    Body& body = model->updBodySet().get("body20");
+    Body& relativeTo = model->updBodySet().get("body7");
+    const Vec3 point(0.1, -0.3, 0.05);
+
+    PointKinematics kin;
+    kin.setBody(&body);
+    kin.setPoint(point);
+    if (relativeToBody) kin.setRelativeToBody(&relativeTo);
+    kin.setModel(*model);
+
+    for (int k = 0; k < numStates; ++k) {
+        setRandomState(*model, s, k);
+        if (k == 0) kin.begin(s);
+        else kin.step(s, k);
+    }
+    ASSERT(kin.getPositionStorage()->getSize() == numStates);
+
+    const SimbodyEngine& engine = model->getSimbodyEngine();
+    const Ground& ground = model->getGround();
+    for (int k = 0; k < numStates; ++k) {
+        setRandomState(*model, s, k);
+        Vec3 pos, vel, acc;
+        engine.getPosition(s, body, point, pos);
+        engine.getVelocity(s, body, point, vel);
+        engine.getAcceleration(s, body, point, acc);
+        if (relativeToBody) {
+            engine.transformPosition(s, ground, pos, relativeTo, pos);
+            engine.transform(s, ground, vel, relativeTo, vel);
+            engine.transform(s, ground, acc, relativeTo, acc);
+        }
+        checkVec3(pos, getRow(*kin.getPositionStorage(), k), "point position");
+        checkVec3(vel, getRow(*kin.getVelocityStorage(), k), "point velocity");
+        checkVec3(acc, getRow(*kin.getAccelerationStorage(), k),
+                  "point acceleration");
+    }
+
+    delete model;
+}
+
+void testBodyKinematicsTiming()
+{
+    Model* model = createChainModel();
+    SimTK::State& s = model->initSystem();
+
+    BodyKinematics kin;
+    kin.setModel(*model);
+    kin.setStorageCapacityIncrements(1000);
+
+    // Realize random states to Acceleration, as an integrator would for each
+    // step, with and without recording the kinematics of all bodies.
+    const int n = 1000;
+    double ms[2];
+    for (int withAnalysis = 0; withAnalysis < 2; ++withAnalysis) {
+        const auto startTime = std::chrono::steady_clock::now();
+        for (int k = 0; k < n; ++k) {
+            setRandomState(*model, s, k);
+            if (withAnalysis) kin.step(s, k);
+        }
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - startTime;
+        ms[withAnalysis] = elapsed.count()/n;
+    }
+    ASSERT(kin.getPositionStorage()->getSize() == n);
+    cout << "BodyKinematics of " << numBodies << " bodies: "
+         << ms[1] - ms[0] << " ms per step to record, "
+         << ms[0] << " ms per step to realize." << endl;
+
+    delete model;
+}
@@ -0,0 +1,239 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  testManager.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include <OpenSim/Simulation/Manager/Manager.h>
+#include <OpenSim/Simulation/Manager/SimulationCheckpoint.h>
+#include <OpenSim/Simulation/Control/ControlSetController.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <cstdint>
+#include <fstream>
+
+using namespace OpenSim;
+using namespace std;
+
+//==============================================================================
+// testDenseOutput tests that reporting at specified time steps by interpolation
+// gives the same output times as forcing the integrator to take those steps,
+// with states as accurate at every report time.
+//==============================================================================
+void testDenseOutput(const string& modelFile);
+//==============================================================================
+// testCheckpoint tests that an integration resumed from a checkpoint written
+// part way through ends in the same state, with the same recorded states, as
+// the uninterrupted integration.
+//==============================================================================
+void testCheckpoint(const string& modelFile);
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testDenseOutput("arm26.osim");
+        testCheckpoint("arm26.osim");
+    }
+    catch (const Exception& e) {
+        cout << "testManager failed: ";
+        e.print(cout); 
+        return 1;
+    }
+    catch (const std::exception& e) {
+        cout << "testManager failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+//==============================================================================
+// Test Cases
+//==============================================================================
+void testDenseOutput(const string& modelFile)
+{
+    using namespace SimTK;
+
+    Model model(modelFile);
+    ControlSetController* controller = new ControlSetController();
+    controller->setControlSetFileName("arm26_StaticOptimization_controls.xml");
+    model.addController(controller);
+    State& initState = model.initSystem();
+    model.equilibrateMuscles(initState);
+
+    // The time array covers the final time, which is summed as the manager
+    // sums the time array so that the last report falls on it exactly.
+    const double reportInterval = 5.0e-4;
+    const int numReports = 200;
+    Array<double> dtArray(reportInterval, numReports + 1);
+    double finalTime = 0.0;
+    for (int i = 0; i < numReports; ++i) finalTime += reportInterval;
+
+    // Simulate with the integrator forced to take the report steps and with
+    // the report times interpolated; return the number of steps taken.
+    auto simulate = [&](bool useDenseOutput, double accuracy,
+                        bool returnEveryInternalStep, Storage& rStates) {
+        State s = initState;
+        RungeKuttaMersonIntegrator integrator(model.getMultibodySystem());
+        integrator.setAccuracy(accuracy);
+        integrator.setReturnEveryInternalStep(returnEveryInternalStep);
+        Manager manager(model, integrator);
+        manager.setInitialTime(0.0);
+        manager.setFinalTime(finalTime);
+        manager.setUseSpecifiedDT(true);
+        manager.setDTArray(numReports + 1, &dtArray[0], 0.0);
+        manager.setUseDenseOutput(useDenseOutput);
+        ASSERT(manager.getUseDenseOutput() == useDenseOutput);
+        manager.integrate(s);
+        ASSERT_EQUAL(finalTime, s.getTime(), SimTK::SignificantReal);
+        rStates = manager.getStateStorage();
+        return integrator.getNumStepsTaken();
+    };
+
+    Storage fixedStates, denseStates, internalStepStates, referenceStates;
+    int fixedSteps = simulate(false, 1.0e-6, false, fixedStates);
+    int denseSteps = simulate(true, 1.0e-6, false, denseStates);
+    simulate(true, 1.0e-6, true, internalStepStates);
+    simulate(true, 1.0e-10, false, referenceStates);
+    cout << "testDenseOutput: " << fixedSteps << " fixed steps, "
+         << denseSteps << " adaptive steps." << endl;
+
+    // Same output grid, whether or not the integrator returns after each
+    // of its internal steps.
+    ASSERT(fixedStates.getSize() == numReports + 1);
+    ASSERT(denseStates.getSize() == numReports + 1);
+    ASSERT(internalStepStates.getSize() == numReports + 1);
+    ASSERT(referenceStates.getSize() == numReports + 1);
+    for (int i = 0; i < denseStates.getSize(); ++i) {
+        ASSERT_EQUAL(fixedStates.getStateVector(i)->getTime(),
+                     denseStates.getStateVector(i)->getTime(), 1.0e-10);
+        ASSERT_EQUAL(i*reportInterval,
+                     denseStates.getStateVector(i)->getTime(), 1.0e-10);
+        ASSERT_EQUAL(i*reportInterval,
+                     internalStepStates.getStateVector(i)->getTime(), 1.0e-10);
+    }
+
+    // At every report time the interpolated states are as accurate as the
+    // states of the fixed steps, compared to a tightly integrated reference.
+    for (int i = 0; i < referenceStates.getSize(); ++i) {
+        const Array<double>& refY = referenceStates.getStateVector(i)->getData();
+        const Array<double>& fixedY = fixedStates.getStateVector(i)->getData();
+        const Array<double>& denseY = denseStates.getStateVector(i)->getData();
+        const Array<double>& internalY =
+            internalStepStates.getStateVector(i)->getData();
+        ASSERT(refY.getSize() == denseY.getSize());
+        for (int j = 0; j < refY.getSize(); ++j) {
+            const double tol = 1.0e-3*(1.0 + fabs(refY[j]));
+            ASSERT_EQUAL(refY[j], fixedY[j], tol);
+            ASSERT_EQUAL(refY[j], denseY[j], tol);
+            ASSERT_EQUAL(denseY[j], internalY[j], tol);
+        }
+    }
+}
+
+void testCheckpoint(const string& modelFile)
+{
+    using namespace SimTK;
+
+    Model model(modelFile);
+    ControlSetController* controller = new ControlSetController();
+    controller->setControlSetFileName("arm26_StaticOptimization_controls.xml");
+    model.addController(controller);
+    State& initState = model.initSystem();
+    model.equilibrateMuscles(initState);
+
+    const double stepSize = 1.0e-3;
+    const int numSteps = 100;
+    Array<double> dtArray(stepSize, numSteps + 1);
+    double finalTime = 0.0;
+    for (int i = 0; i < numSteps; ++i) finalTime += stepSize;
+    const string checkpointFile = "testManager_checkpoint.ockpt";
+
+    auto setup = [&](Manager& manager) {
+        manager.setInitialTime(0.0);
+        manager.setFinalTime(finalTime);
+        manager.setUseSpecifiedDT(true);
+        manager.setDTArray(numSteps + 1, &dtArray[0], 0.0);
+    };
+
+    // Uninterrupted integration, writing one checkpoint part way through.
+    State s1 = initState;
+    RungeKuttaMersonIntegrator integrator1(model.getMultibodySystem());
+    Manager manager1(model, integrator1);
+    setup(manager1);
+    manager1.setCheckpointInterval(0.06);
+    manager1.setCheckpointFileName(checkpointFile);
+    int numCallbacks = 0;
+    manager1.setCheckpointCallback([&numCallbacks](SimulationCheckpoint& c) {
+        c.setData("test.counter", SimTK::Vector(1, (double)++numCallbacks));
+    });
+    manager1.integrate(s1);
+    ASSERT(numCallbacks == 1);
+
+    SimulationCheckpoint checkpoint(checkpointFile);
+    ASSERT_EQUAL(0.06, checkpoint.getTime(), 2*stepSize);
+    ASSERT(checkpoint.getStep() > 0);
+    ASSERT(checkpoint.hasStorage("states"));
+    ASSERT(checkpoint.getData("test.counter")[0] == 1.0);
+    ASSERT_THROW(Exception, checkpoint.getData("missing"));
+
+    // Resume in a new state and manager.
+    State s2 = model.initializeState();
+    RungeKuttaMersonIntegrator integrator2(model.getMultibodySystem());
+    Manager manager2(model, integrator2);
+    setup(manager2);
+    manager2.resume(s2, checkpoint);
+
+    ASSERT_EQUAL(s1.getTime(), s2.getTime(), 0.0);
+    for (int i = 0; i < s1.getNY(); ++i)
+        ASSERT_EQUAL(s1.getY()[i], s2.getY()[i], 0.0);
+
+    const Storage& states1 = manager1.getStateStorage();
+    const Storage& states2 = manager2.getStateStorage();
+    ASSERT(states1.getSize() == states2.getSize());
+    for (int i = 0; i < states1.getSize(); ++i) {
+        ASSERT_EQUAL(states1.getStateVector(i)->getTime(),
+                     states2.getStateVector(i)->getTime(), 0.0);
+    }
+
+    // A checkpoint cannot be restored into a State of a different model.
+    Model pendulum("double_pendulum.osim");
+    State& other = pendulum.initSystem();
+    ASSERT_THROW(Exception, checkpoint.restoreState(other));
+
+    // A discrete variable outside its subsystem makes the checkpoint corrupt.
+    // The discrete variables follow the magic number, format version, time,
+    // step, step size, Y and the subsystems' numbers of discrete variables;
+    // each starts with its subsystem and index.
+    {
+        fstream file(checkpointFile.c_str(),
+                     ios_base::in | ios_base::out | ios_base::binary);
+        const long discreteStart = 8 + 4 + 8 + 4 + 8 + (4 + 8*s1.getNY()) +
+                                   (4 + 4*s1.getNumSubsystems());
+        int32_t numDiscrete = 0;
+        file.seekg(discreteStart);
+        file.read((char*)&numDiscrete, sizeof(numDiscrete));
+        ASSERT(numDiscrete > 0);
+        const int32_t index = 1 << 30;
+        file.seekp(discreteStart + 4 + 4);
+        file.write((const char*)&index, sizeof(index));
+    }
+    ASSERT_THROW(Exception, SimulationCheckpoint corrupt(checkpointFile));
+}
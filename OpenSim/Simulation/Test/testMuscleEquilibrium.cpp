@@ -0,0 +1,169 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testMuscleEquilibrium.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testMuscleEquilibrium equilibrates the muscles of the gait2354 model over
+// a sweep of the legs' range of motion, as when replaying a trajectory. It
+// checks that solving for the muscles' equilibria concurrently gives the
+// same fiber lengths as equilibrating them one at a time, and that starting
+// each frame from the previous frame's equilibrium takes fewer iterations
+// than starting from the solvers' default guesses. The time taken by each
+// approach is reported, including warm starts solved on the calling thread,
+// which avoids starting threads at every frame.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <chrono>
+
+using namespace OpenSim;
+using namespace std;
+
+const int numFrames = 50;
+
+// Set the legs' configuration for frame k of a sweep through the range of
+// motion of the hips, knees and ankles.
+void setFrame(const Model& model, SimTK::State& s, int k)
+{
+    const char* names[] = { "hip_flexion_r", "knee_angle_r", "ankle_angle_r",
+                            "hip_flexion_l", "knee_angle_l", "ankle_angle_l" };
+    const double f = 0.5 - 0.5*cos(2*SimTK::Pi*k/numFrames);
+    for (const char* name : names) {
+        const Coordinate& coord = model.getCoordinateSet().get(name);
+        coord.setValue(s, coord.getRangeMin() +
+            f*(coord.getRangeMax() - coord.getRangeMin()), false);
+        coord.setSpeedValue(s, 0);
+    }
+}
+
+double maxFiberLengthDifference(const Model& model, const SimTK::State& s1,
+                                const SimTK::State& s2)
+{
+    double maxDiff = 0;
+    const Set<Muscle>& muscles = model.getMuscles();
+    for (int i = 0; i < muscles.getSize(); ++i)
+        maxDiff = max(maxDiff, abs(muscles.get(i).getFiberLength(s1) -
+                                   muscles.get(i).getFiberLength(s2)));
+    return maxDiff;
+}
+
+void testConcurrentMatchesSerial()
+{
+    Model model("gait2354_simbody.osim");
+    SimTK::State& s = model.initSystem();
+
+    double maxDiff = 0;
+    for (int k = 0; k < numFrames; k += 5) {
+        setFrame(model, s, k);
+        SimTK::State serial(s), concurrent(s), oneThread(s);
+        model.equilibrateMuscles(serial);
+        const int iterations = model.equilibrateMuscles(concurrent, false, 4);
+        ASSERT(model.equilibrateMuscles(oneThread, false, 1) == iterations);
+        ASSERT(iterations > 0);
+        model.realizeVelocity(serial);
+        model.realizeVelocity(concurrent);
+        model.realizeVelocity(oneThread);
+        maxDiff = max(maxDiff,
+                      maxFiberLengthDifference(model, serial, concurrent));
+        ASSERT(maxFiberLengthDifference(model, concurrent, oneThread) == 0);
+    }
+    cout << "Largest difference in fiber length between serial and "
+            "concurrent equilibration: " << maxDiff << " m" << endl;
+    // The same solver runs from the same guess in both cases.
+    ASSERT(maxDiff == 0);
+}
+
+void testWarmStartTakesFewerIterations()
+{
+    Model model("gait2354_simbody.osim");
+    SimTK::State& s = model.initSystem();
+    SimTK::State cold(s), warm(s), warmOneThread(s);
+
+    int coldIterations = 0, warmIterations = 0, warmOneThreadIterations = 0;
+    double coldSeconds = 0, warmSeconds = 0, serialSeconds = 0;
+    double warmOneThreadSeconds = 0;
+    double maxDiff = 0;
+    for (int k = 0; k < numFrames; ++k) {
+        setFrame(model, cold, k);
+        setFrame(model, warm, k);
+        setFrame(model, warmOneThread, k);
+        SimTK::State serial(cold);
+
+        auto start = chrono::steady_clock::now();
+        model.equilibrateMuscles(serial);
+        serialSeconds += chrono::duration<double>(
+            chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        coldIterations += model.equilibrateMuscles(cold, false);
+        coldSeconds += chrono::duration<double>(
+            chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        warmIterations += model.equilibrateMuscles(warm, k > 0);
+        warmSeconds += chrono::duration<double>(
+            chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        warmOneThreadIterations +=
+            model.equilibrateMuscles(warmOneThread, k > 0, 1);
+        warmOneThreadSeconds += chrono::duration<double>(
+            chrono::steady_clock::now() - start).count();
+
+        model.realizeVelocity(cold);
+        model.realizeVelocity(warm);
+        model.realizeVelocity(warmOneThread);
+        maxDiff = max(maxDiff, maxFiberLengthDifference(model, cold, warm));
+        ASSERT(maxFiberLengthDifference(model, warm, warmOneThread) == 0);
+    }
+
+    cout << "Equilibrating " << model.getMuscles().getSize()
+         << " muscles at " << numFrames << " frames:" << endl;
+    cout << "  one at a time:          " << serialSeconds << " s" << endl;
+    cout << "  concurrently:           " << coldSeconds << " s, "
+         << coldIterations << " iterations" << endl;
+    cout << "  concurrently, warm:     " << warmSeconds << " s, "
+         << warmIterations << " iterations" << endl;
+    cout << "  one thread, warm:       " << warmOneThreadSeconds << " s, "
+         << warmOneThreadIterations << " iterations" << endl;
+    cout << "Largest difference in fiber length between warm and cold "
+            "starts: " << maxDiff << " m" << endl;
+    ASSERT(warmIterations < coldIterations);
+    ASSERT(warmOneThreadIterations == warmIterations);
+    // Both converge to within the force tolerance of the same equilibrium.
+    ASSERT(maxDiff < 1e-6);
+}
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testConcurrentMatchesSerial();
+        testWarmStartTakesFewerIterations();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
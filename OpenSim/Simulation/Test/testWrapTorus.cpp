@@ -0,0 +1,174 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  testWrapTorus.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testWrapTorus wraps line segments that pass around the tube of a torus,
+// like a muscle pulled around a pulley, and checks that solving for the
+// closest point on the torus' circle with Newton's method gives the same
+// wraps as the Lmdif solver. It also reports the time per wrap of the torus,
+// with either solver, and of a sphere and a cylinder of similar size.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <chrono>
+#include <utility>
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Vec3;
+
+const double circleRadius = 0.05;
+const double tubeRadius = 0.015;
+
+// Segments whose ends are on opposite sides of the plane of the torus, near
+// its circle, so that most of them wrap around the tube.
+vector<pair<Vec3, Vec3> > createSegments(int n)
+{
+    SimTK::Random::Uniform random(-1.0, 1.0);
+    random.setSeed(42);
+    vector<pair<Vec3, Vec3> > segments;
+    for (int i = 0; i < n; ++i) {
+        const double angle1 = SimTK::Pi*random.getValue();
+        const double angle2 = angle1 + 0.3*random.getValue();
+        const double r1 = circleRadius*(1 + 0.4*random.getValue());
+        const double r2 = circleRadius*(1 + 0.4*random.getValue());
+        segments.push_back(make_pair(
+            Vec3(r1*cos(angle1), r1*sin(angle1), -0.1 - 0.05*random.getValue()),
+            Vec3(r2*cos(angle2), r2*sin(angle2), 0.1 + 0.05*random.getValue())));
+    }
+    return segments;
+}
+
+int wrap(const WrapObject& wrapObject, const pair<Vec3, Vec3>& segment,
+         WrapResult& result)
+{
+    static const SimTK::State s;
+    static const PathWrap pathWrap;
+    Vec3 p1 = segment.first, p2 = segment.second;
+    bool flag;
+    result.wrap_pts.setSize(0);
+    result.wrap_path_length = 0;
+    result.r1 = result.r2 = Vec3(0);
+    return wrapObject.wrapLine(s, p1, p2, pathWrap, result, flag);
+}
+
+// Microseconds per wrap of all segments over a wrap object.
+double timeWraps(const WrapObject& wrapObject,
+                 const vector<pair<Vec3, Vec3> >& segments)
+{
+    WrapResult result;
+    const int repeats = 10;
+    const auto start = chrono::steady_clock::now();
+    for (int k = 0; k < repeats; ++k)
+        for (const auto& segment : segments)
+            wrap(wrapObject, segment, result);
+    const double seconds = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+    return 1e6*seconds/(repeats*segments.size());
+}
+
+void testNewtonMatchesLmdif()
+{
+    WrapTorus newton;
+    newton.setInnerRadius(tubeRadius);
+    newton.setOuterRadius(circleRadius);
+    newton.setQuadrantName("all");
+    WrapTorus lmdif(newton);
+    lmdif.setQuadrantName("all");
+    lmdif.setUseLmdif(true);
+    ASSERT(!newton.getUseLmdif() && lmdif.getUseLmdif());
+
+    const vector<pair<Vec3, Vec3> > segments = createSegments(2000);
+    int numWrapped = 0;
+    double maxPointError = 0, maxLengthError = 0;
+    for (const auto& segment : segments) {
+        WrapResult fromNewton, fromLmdif;
+        ASSERT(wrap(newton, segment, fromNewton) ==
+               wrap(lmdif, segment, fromLmdif));
+        ASSERT((fromNewton.wrap_pts.getSize() > 0) ==
+               (fromLmdif.wrap_pts.getSize() > 0));
+        if (fromNewton.wrap_pts.getSize() == 0)
+            continue;
+        ++numWrapped;
+        maxPointError = max(maxPointError, max(
+            (fromNewton.r1 - fromLmdif.r1).norm(),
+            (fromNewton.r2 - fromLmdif.r2).norm()));
+        maxLengthError = max(maxLengthError,
+            abs(fromNewton.wrap_path_length - fromLmdif.wrap_path_length));
+    }
+
+    cout << numWrapped << " of " << segments.size() << " segments wrapped; "
+         << "largest difference between Newton and Lmdif: tangent points "
+         << maxPointError << ", wrap length " << maxLengthError << endl;
+    ASSERT(numWrapped > int(segments.size())/2);
+    // Lmdif's tolerances are loose (1e-4), but on these segments it
+    // converges to the same root as Newton's method to near roundoff.
+    ASSERT(maxPointError < 1e-7);
+    ASSERT(maxLengthError < 1e-7);
+}
+
+void benchmarkWrapObjects()
+{
+    WrapTorus torus;
+    torus.setInnerRadius(tubeRadius);
+    torus.setOuterRadius(circleRadius);
+    torus.setQuadrantName("all");
+    WrapTorus torusLmdif(torus);
+    torusLmdif.setQuadrantName("all");
+    torusLmdif.setUseLmdif(true);
+
+    WrapSphere sphere;
+    sphere.setRadius(circleRadius);
+    sphere.setQuadrantName("all");
+
+    // A cylinder along Z would not be crossed by the segments.
+    WrapCylinder cylinder;
+    cylinder.setRadius(tubeRadius);
+    cylinder.setLength(1.0);
+    cylinder.setQuadrantName("all");
+    vector<pair<Vec3, Vec3> > segments = createSegments(2000);
+    vector<pair<Vec3, Vec3> > rotated;
+    for (const auto& segment : segments)
+        rotated.push_back(make_pair(
+            Vec3(segment.first[2], segment.first[1], segment.first[0]),
+            Vec3(segment.second[2], segment.second[1], segment.second[0])));
+
+    cout << "Microseconds per wrap:" << endl;
+    cout << "  torus (Newton)   " << timeWraps(torus, segments) << endl;
+    cout << "  torus (Lmdif)    " << timeWraps(torusLmdif, segments) << endl;
+    cout << "  sphere           " << timeWraps(sphere, segments) << endl;
+    cout << "  cylinder         " << timeWraps(cylinder, rotated) << endl;
+}
+
+int main()
+{
+    try {
+        testNewtonMatchesLmdif();
+        benchmarkWrapObjects();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
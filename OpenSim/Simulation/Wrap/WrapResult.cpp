@@ -59,7 +59,12 @@ WrapResult::~WrapResult()
  */
 void WrapResult::copyData(const WrapResult& aWrapResult)
 {
-    wrap_pts = aWrapResult.wrap_pts;
+    // Copy the points into the existing array rather than assigning it, so
+    // that a WrapResult that is reused for every path computation only
+    // allocates when it needs more room.
+    wrap_pts.setSize(aWrapResult.wrap_pts.getSize());
+    for (int j = 0; j < wrap_pts.getSize(); j++)
+        wrap_pts[j] = aWrapResult.wrap_pts[j];
     wrap_path_length = aWrapResult.wrap_path_length;
 
     startPoint = aWrapResult.startPoint;
@@ -76,6 +76,7 @@ public:
     const char* getWrapTypeName() const override;
     std::string getDimensionsString() const override;
     double getRadius() const;
+    void setRadius(double aRadius) { _radius = aRadius; }
 
     void scale(const SimTK::Vec3& aScaleFactors) override;
     void connectToModelAndBody(Model& aModel, PhysicalFrame& aBody) override;
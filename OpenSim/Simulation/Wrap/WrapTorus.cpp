@@ -59,6 +59,7 @@ WrapTorus::WrapTorus() :
 {
     setNull();
     setupProperties();
+    updateCylinder();
 }
 
 //_____________________________________________________________________________
@@ -95,6 +96,19 @@ WrapTorus::WrapTorus(const WrapTorus& aWrapTorus) :
  */
 void WrapTorus::setNull()
 {
+    _useLmdif = false;
+}
+
+//_____________________________________________________________________________
+/**
+ * Configure the cylinder that paths are wrapped over to match the inner
+ * radius of the torus.
+ */
+void WrapTorus::updateCylinder()
+{
+    _cylinder.setRadius(_innerRadius);
+    _cylinder.setLength(CYL_LENGTH);
+    _cylinder.setQuadrantName("+x");
 }
 
 //_____________________________________________________________________________
@@ -144,6 +158,7 @@ void WrapTorus::scale(const SimTK::Vec3& aScaleFactors)
    double averageXYScale = (localScaleVector[0].norm() + localScaleVector[1].norm()) * 0.5;
    _innerRadius *= averageXYScale;
    _outerRadius *= averageXYScale;
+   updateCylinder();
 }
 
 //_____________________________________________________________________________
@@ -171,6 +186,8 @@ void WrapTorus::connectToModelAndBody(Model& aModel, PhysicalFrame& aBody)
         string errorMessage = "Error: outer_radius for WrapTorus " + getName() + " is less than or equal to inner_radius.";
         throw Exception(errorMessage);
     }
+
+    updateCylinder();
 /*  Torus* torus = new Torus(_innerRadius, (_outerRadius-_innerRadius));
     setGeometryQuadrants(torus);
 */
@@ -189,6 +206,8 @@ void WrapTorus::copyData(const WrapTorus& aWrapTorus)
 
     _innerRadius = aWrapTorus._innerRadius;
     _outerRadius = aWrapTorus._outerRadius;
+    _useLmdif = aWrapTorus._useLmdif;
+    updateCylinder();
 }
 
 //_____________________________________________________________________________
@@ -237,6 +256,17 @@ SimTK::Real WrapTorus::getOuterRadius() const
 {
     return SimTK::Real(_outerRadius);
 }
+//_____________________________________________________________________________
+/**
+ * Set the inner radius of the torus
+ *
+ * @param aRadius The inner radius of the torus
+ */
+void WrapTorus::setInnerRadius(double aRadius)
+{
+    _innerRadius = aRadius;
+    updateCylinder();
+}
 //=============================================================================
 // OPERATORS
 //=============================================================================
@@ -281,13 +311,8 @@ int WrapTorus::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec3
         return noWrap;
 
     // Now put a cylinder at closestPt and call the cylinder wrap code.
-    WrapCylinder cyl;//(rot, trans, quadrant, body, radius, length);
     SimTK::Vec3 cylXaxis, cylYaxis, cylZaxis; // cylinder axes in torus reference frame
 
-    cyl.setRadius(_innerRadius);
-    cyl.setLength(CYL_LENGTH);
-    cyl.setQuadrantName("+x");
-
     closestPt *= -1;
 
     cylXaxis = closestPt;
@@ -307,7 +332,7 @@ int WrapTorus::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec3
     cylinderToTorus.setP(closestPtCyl);
     Vec3 p1 = cylinderToTorus.shiftFrameStationToBase(aPoint1);
     Vec3 p2 = cylinderToTorus.shiftFrameStationToBase(aPoint2);
-    int return_code = cyl.wrapLine(s, p1, p2, aPathWrap, aWrapResult, aFlag);
+    int return_code = _cylinder.wrapLine(s, p1, p2, aPathWrap, aWrapResult, aFlag);
    if (aFlag == true && return_code > 0) {
         aWrapResult.r1 = cylinderToTorus.shiftBaseStationToFrame(aWrapResult.r1);
         aWrapResult.r2 = cylinderToTorus.shiftBaseStationToFrame(aWrapResult.r2);
@@ -338,21 +363,8 @@ int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
                                           double* xc, double* yc, double* zc,
                                           int wrap_sign, int wrap_axis) const
 {
-   int info;                  // output flag
-   int num_func_calls;        // number of calls to func (nfev)
-   int ldfjac = 1;            // leading dimension of fjac (nres)
-   int numResid = 1;
-   int numQs = 1;
-   double q[2], resid[2], fjac[2];            // m X n array
    CircleCallback cb;
    bool constrained = (bool) (wrap_sign != 0);
-   // solution parameters
-   int mode = 1, nprint = 0, max_iter = 500;
-   double ftol = 1e-4, xtol = 1e-4, gtol = 0.0;
-   double epsfcn = 0.0, step_factor = 0.2;
-   // work arrays
-   int ipvt[2];  
-   double diag[2], qtf[2], wa1[2], wa2[2], wa3[2], wa4[2];
    // Circle variables
    double u, mag, nx, ny, nz, x, y, z, a1[3], a2[3], distance1, distance2, betterPt = 0;
 
@@ -364,14 +376,7 @@ int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
    cb.p2[2] = p2[2];
    cb.r = radius;
 
-   q[0] = 0.0;
-
-   lmdif_C(calcCircleResids, numResid, numQs, q, resid,
-           ftol, xtol, gtol, max_iter, epsfcn, diag, mode, step_factor,
-           nprint, &info, &num_func_calls, fjac, ldfjac, ipvt, qtf,
-           wa1, wa2, wa3, wa4, (void*)&cb);
-
-   u = q[0];
+   u = solveCircleResids(cb);
 
    mag = sqrt((p2[0]-p1[0])*(p2[0]-p1[0]) + (p2[1]-p1[1])*(p2[1]-p1[1]) + (p2[2]-p1[2])*(p2[2]-p1[2]));
 
@@ -399,14 +404,7 @@ int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
    cb.p2[2] = p1[2];
    cb.r = radius;
 
-   q[0] = 0.0;
-
-   lmdif_C(calcCircleResids, numResid, numQs, q, resid,
-           ftol, xtol, gtol, max_iter, epsfcn, diag, mode, step_factor,
-           nprint, &info, &num_func_calls, fjac, ldfjac, ipvt, qtf,
-           wa1, wa2, wa3, wa4, (void*)&cb);
-
-   u = q[0];
+   u = solveCircleResids(cb);
 
    mag = sqrt((p2[0]-p1[0])*(p2[0]-p1[0]) + (p2[1]-p1[1])*(p2[1]-p1[1]) + (p2[2]-p1[2])*(p2[2]-p1[2]));
 
@@ -480,6 +478,122 @@ int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
    return 1;
 }
 
+//_____________________________________________________________________________
+/**
+ * Solve for the distance along the line from cb.p1 toward cb.p2 at which the
+ * residual calculated by calcCircleResids is zero. Newton's method is tried
+ * first; if it does not converge, or if _useLmdif is set, the Lmdif
+ * least-squares solver is used instead. Both start at cb.p1.
+ *
+ * @param cb The line and the radius of the circle
+ * @return The distance along the line from cb.p1
+ */
+double WrapTorus::solveCircleResids(CircleCallback& cb) const
+{
+   double u = 0.0;
+   if (!_useLmdif && solveCircleResidsNewton(cb, u))
+      return u;
+
+   int info;                  // output flag
+   int num_func_calls;        // number of calls to func (nfev)
+   int ldfjac = 1;            // leading dimension of fjac (nres)
+   int numResid = 1;
+   int numQs = 1;
+   double q[2], resid[2], fjac[2];            // m X n array
+   // solution parameters
+   int mode = 1, nprint = 0, max_iter = 500;
+   double ftol = 1e-4, xtol = 1e-4, gtol = 0.0;
+   double epsfcn = 0.0, step_factor = 0.2;
+   // work arrays
+   int ipvt[2];  
+   double diag[2], qtf[2], wa1[2], wa2[2], wa3[2], wa4[2];
+
+   q[0] = 0.0;
+
+   lmdif_C(calcCircleResids, numResid, numQs, q, resid,
+           ftol, xtol, gtol, max_iter, epsfcn, diag, mode, step_factor,
+           nprint, &info, &num_func_calls, fjac, ldfjac, ipvt, qtf,
+           wa1, wa2, wa3, wa4, (void*)&cb);
+
+   return q[0];
+}
+
+//_____________________________________________________________________________
+/**
+ * Find a zero of the residual calculated by calcCircleResids with Newton's
+ * method. The derivative of the residual with respect to u is
+ * 2 - 4 r (c4 c5 - c3^2) / c6^3, in the notation of calcCircleResids. Steps
+ * are limited to the radius of the circle and halved until they reduce the
+ * magnitude of the residual, which keeps the iteration near the root that
+ * Lmdif would find from the same starting point.
+ *
+ * @param cb The line and the radius of the circle
+ * @param u The starting distance along the line on input, and the
+ * solution on output
+ * @return Whether the iteration converged to a zero of the residual
+ */
+bool WrapTorus::solveCircleResidsNewton(const CircleCallback& cb, double& u)
+{
+   const int max_iter = 50, max_halvings = 30;
+   double mag, nx, ny, nz, c2, c3, c4, c5, k;
+
+   mag = sqrt((cb.p2[0]-cb.p1[0])*(cb.p2[0]-cb.p1[0]) + (cb.p2[1]-cb.p1[1])*(cb.p2[1]-cb.p1[1]) +
+      (cb.p2[2]-cb.p1[2])*(cb.p2[2]-cb.p1[2]));
+
+   nx = (cb.p2[0]-cb.p1[0]) / mag;
+   ny = (cb.p2[1]-cb.p1[1]) / mag;
+   nz = (cb.p2[2]-cb.p1[2]) / mag;
+
+   c2 = 2.0 * (cb.p1[0]*nx + cb.p1[1]*ny + cb.p1[2]*nz);
+   c3 = cb.p1[0]*nx + cb.p1[1]*ny;
+   c4 = nx*nx + ny*ny;
+   c5 = cb.p1[0]*cb.p1[0] + cb.p1[1]*cb.p1[1];
+   k = c4 * c5 - c3 * c3;
+
+   // c6 is zero only where the line crosses the Z axis.
+   double c6 = sqrt(u * u * c4 + 2.0 * c3 * u + c5);
+   if (!(c6 > 0.0))
+      return false;
+   double resid = c2 + 2.0 * u - 4.0 * cb.r * (c4 * u + c3) / c6;
+
+   for (int i = 0; i < max_iter; i++) {
+      // Stop once the residual is at the level of roundoff, where no step
+      // can reduce it further.
+      if (fabs(resid) <= 1e-12 * (1.0 + fabs(c2) + fabs(u)))
+         return true;
+
+      const double slope = 2.0 - 4.0 * cb.r * k / (c6 * c6 * c6);
+      if (!(fabs(slope) > SimTK::Eps))
+         return false;
+      double du = -resid / slope;
+      if (fabs(du) > cb.r)
+         du = du > 0.0 ? cb.r : -cb.r;
+
+      // Halve the step until it reduces the residual.
+      double newU = u, newC6 = c6, newResid = resid;
+      int j;
+      for (j = 0; j < max_halvings; j++, du *= 0.5) {
+         newU = u + du;
+         newC6 = sqrt(newU * newU * c4 + 2.0 * c3 * newU + c5);
+         if (!(newC6 > 0.0))
+            continue;
+         newResid = c2 + 2.0 * newU - 4.0 * cb.r * (c4 * newU + c3) / newC6;
+         if (fabs(newResid) < fabs(resid))
+            break;
+      }
+      if (j == max_halvings)
+         return false;
+
+      u = newU;
+      c6 = newC6;
+      resid = newResid;
+      if (fabs(du) <= 1e-12 * (1.0 + fabs(u)))
+         return true;
+   }
+
+   return false;
+}
+
 //_____________________________________________________________________________
 /**
  * A utility function used by findClosestPoint. The single residual that it
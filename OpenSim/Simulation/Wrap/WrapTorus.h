@@ -31,6 +31,7 @@
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Common/PropertyDbl.h>
 #include "WrapObject.h"
+#include "WrapCylinder.h"
 
 namespace OpenSim {
 
@@ -66,6 +67,15 @@ private:
     PropertyDbl _outerRadiusProp;
     double& _outerRadius;
 
+    // The cylinder that the path is wrapped over once the closest point on
+    // the torus' circle has been found. It is configured whenever the inner
+    // radius changes rather than constructed for every wrap.
+    WrapCylinder _cylinder;
+
+    // Whether to solve for the closest point with Lmdif only, skipping
+    // Newton's method.
+    bool _useLmdif;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -85,6 +95,15 @@ public:
     std::string getDimensionsString() const override;
     SimTK::Real getInnerRadius() const;
     SimTK::Real getOuterRadius() const;
+    void setInnerRadius(double aRadius);
+    void setOuterRadius(double aRadius) { _outerRadius = aRadius; }
+
+    /** The closest point on the torus' circle to a path segment is found
+    with Newton's method, falling back to the Lmdif least-squares solver
+    when Newton's method does not converge. Set this flag to always use
+    Lmdif instead, e.g., to compare the two solvers. */
+    void setUseLmdif(bool aUseLmdif) { _useLmdif = aUseLmdif; }
+    bool getUseLmdif() const { return _useLmdif; }
 
     void scale(const SimTK::Vec3& aScaleFactors) override;
     void connectToModelAndBody(Model& aModel, PhysicalFrame& aBody) override;
@@ -97,6 +116,9 @@ protected:
 
 private:
     void setNull();
+    void updateCylinder();
+    double solveCircleResids(CircleCallback& cb) const;
+    static bool solveCircleResidsNewton(const CircleCallback& cb, double& u);
     int findClosestPoint(double radius, double p1[], double p2[],
         double* xc, double* yc, double* zc,
         int wrap_sign, int wrap_axis) const;
@@ -27,6 +27,7 @@
 #include "Model/Bhargava2004MuscleMetabolicsProbe.h"
 #include "Model/Model.h"
 #include "Model/ModelDisplayHints.h"
+#include "Model/ModelSnapshot.h"
 #include "Model/ModelVisualizer.h"
 #include "Model/ForceSet.h"
 #include "Model/BodyScale.h"
@@ -41,6 +42,7 @@
 #include "Model/CoordinateSet.h"
 #include "Model/ElasticFoundationForce.h"
 #include "Model/HuntCrossleyForce.h"
+#include "Model/SmoothSphereHalfSpaceForce.h"
 #include "Model/Ligament.h"
 #include "Model/JointSet.h"
 #include "Model/Marker.h"
@@ -72,6 +74,7 @@
 #include "Model/Ground.h"
 
 #include "Manager/Manager.h"
+#include "Manager/SimulationCheckpoint.h"
 
 #include "Control/ControlSet.h"
 #include "Control/ControlSetController.h"
@@ -0,0 +1,294 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  benchmarkOpenSim.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Times the core pipelines on the models and setups bundled with the tests,
+   and writes the results as JSON so that they can be compared between
+   commits. This is not a pass/fail test; build and run it with the
+   "benchmark" target.
+
+   Usage: benchmarkOpenSim [results.json] [filter]
+
+   Only benchmarks whose name contains the filter are run. */
+
+// INCLUDE
+#include <OpenSim/OpenSim.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/getRSS.h>
+#include <chrono>
+#include <fstream>
+#include <functional>
+
+using namespace OpenSim;
+using namespace SimTK;
+using namespace std;
+
+namespace {
+
+struct BenchmarkResult {
+    string name;
+    string model;
+    string unit;
+    double value;
+    int    count;
+    size_t rss;
+    string error;
+};
+
+vector<BenchmarkResult> results;
+string filter;
+
+double secondsSince(const chrono::steady_clock::time_point& start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void record(const string& name, const string& model, const string& unit,
+            double value, int count)
+{
+    results.push_back({name, model, unit, value, count, getCurrentRSS(), ""});
+    cout << name << " [" << model << "]: " << value << " " << unit
+         << " (n=" << count << ")" << endl;
+}
+
+// Run a benchmark in the given directory, recording any error instead of
+// stopping the remaining benchmarks.
+void run(const string& name, const string& model, const string& directory,
+         const function<void()>& benchmark)
+{
+    if (name.find(filter) == string::npos)
+        return;
+    const string cwd = IO::getCwd();
+    try {
+        IO::chDir(directory);
+        benchmark();
+    }
+    catch (const std::exception& e) {
+        results.push_back({name, model, "", 0, 0, getCurrentRSS(), e.what()});
+        cout << name << " [" << model << "] failed: " << e.what() << endl;
+    }
+    IO::chDir(cwd);
+}
+
+string quoted(const string& str)
+{
+    string json = "\"";
+    for (char c : str) {
+        if (c == '"' || c == '\\') json += '\\';
+        if (c == '\n') { json += "\\n"; continue; }
+        json += c;
+    }
+    return json + "\"";
+}
+
+void writeJSON(const string& fileName)
+{
+    ofstream out(fileName.c_str());
+    out.precision(9);
+    out << "{\n  \"peak_rss_bytes\": " << getPeakRSS() << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": " << quoted(r.name)
+            << ", \"model\": " << quoted(r.model)
+            << ", \"unit\": " << quoted(r.unit)
+            << ", \"value\": " << r.value
+            << ", \"count\": " << r.count
+            << ", \"rss_bytes\": " << r.rss;
+        if (!r.error.empty())
+            out << ", \"error\": " << quoted(r.error);
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+//==============================================================================
+// MODEL BENCHMARKS
+//==============================================================================
+// Load and initialize the model, then time evaluation of the system's
+// derivatives, muscle equilibrium and a forward simulation.
+void benchmarkModel(const string& modelFile, double simulatedTime)
+{
+    run("load_and_init_system", modelFile, "Models", [&]() {
+        const int n = 3;
+        const auto start = chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i) {
+            Model model(modelFile);
+            model.initSystem();
+        }
+        record("load_and_init_system", modelFile, "ms", 1e3*secondsSince(start)/n, n);
+    });
+
+    run("rhs_evaluation", modelFile, "Models", [&]() {
+        Model model(modelFile);
+        State& state = model.initSystem();
+        model.equilibrateMuscles(state);
+        const int n = 200;
+        const auto start = chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i) {
+            // Changing time invalidates everything computed from the state.
+            state.updTime() = 1e-3*i;
+            model.getMultibodySystem().realize(state, Stage::Acceleration);
+        }
+        record("rhs_evaluation", modelFile, "us", 1e6*secondsSince(start)/n, n);
+    });
+
+    run("muscle_equilibrium", modelFile, "Models", [&]() {
+        Model model(modelFile);
+        State& state = model.initSystem();
+        const int n = 20;
+        const auto start = chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i) {
+            state.updTime() = 1e-3*i;
+            model.equilibrateMuscles(state);
+        }
+        record("muscle_equilibrium", modelFile, "ms", 1e3*secondsSince(start)/n, n);
+    });
+
+    run("forward_simulation", modelFile, "Models", [&]() {
+        Model model(modelFile);
+        State& state = model.initSystem();
+        model.equilibrateMuscles(state);
+        RungeKuttaMersonIntegrator integrator(model.getMultibodySystem());
+        integrator.setAccuracy(1e-4);
+        Manager manager(model, integrator);
+        manager.setInitialTime(0.0);
+        manager.setFinalTime(simulatedTime);
+        const auto start = chrono::steady_clock::now();
+        manager.integrate(state);
+        record("forward_simulation", modelFile, "s per simulated s",
+               secondsSince(start)/simulatedTime, integrator.getNumStepsTaken());
+    });
+}
+
+//==============================================================================
+// TOOL BENCHMARKS
+//==============================================================================
+void benchmarkTools()
+{
+    run("inverse_kinematics", "subject01_simbody.osim", "IK", [&]() {
+        InverseKinematicsTool ik("subject01_Setup_InverseKinematics.xml");
+        const auto start = chrono::steady_clock::now();
+        ik.run();
+        const double elapsed = secondsSince(start);
+        const int frames = Storage(ik.getOutputMotionFileName()).getSize();
+        record("inverse_kinematics", "subject01_simbody.osim", "ms per frame",
+               1e3*elapsed/frames, frames);
+    });
+
+    run("inverse_dynamics", "arm26.osim", "ID", [&]() {
+        InverseDynamicsTool id("arm26_Setup_InverseDynamics.xml");
+        const auto start = chrono::steady_clock::now();
+        id.run();
+        const double elapsed = secondsSince(start);
+        const int frames = Storage(id.getResultsDir() + "/" +
+                                   id.getOutputGenForceFileName()).getSize();
+        record("inverse_dynamics", "arm26.osim", "ms per frame",
+               1e3*elapsed/frames, frames);
+    });
+
+    run("static_optimization", "arm26.osim", "Analyze", [&]() {
+        AnalyzeTool analyze("arm26_Setup_StaticOptimization.xml");
+        const auto start = chrono::steady_clock::now();
+        analyze.run();
+        const double elapsed = secondsSince(start);
+        const int frames = Storage(analyze.getResultsDir() + "/" +
+            analyze.getName() + "_StaticOptimization_activation.sto").getSize();
+        record("static_optimization", "arm26.osim", "ms per frame",
+               1e3*elapsed/frames, frames);
+    });
+
+    run("computed_muscle_control", "arm26.osim", "CMC", [&]() {
+        CMCTool cmc("arm26_Setup_CMC.xml");
+        const auto start = chrono::steady_clock::now();
+        cmc.run();
+        const double elapsed = secondsSince(start);
+        const int intervals = (int)std::ceil(
+            (cmc.getFinalTime() - cmc.getInitialTime())/cmc.getTimeWindow()
+            - 1e-9);
+        record("computed_muscle_control", "arm26.osim", "ms per interval",
+               1e3*elapsed/intervals, intervals);
+    });
+}
+
+//==============================================================================
+// STORAGE BENCHMARKS
+//==============================================================================
+void benchmarkStorage()
+{
+    run("storage_write", "", ".", [&]() {
+        const int nRows = 20000, nColumns = 50;
+        Storage storage(nRows);
+        Array<string> labels("", nColumns + 1);
+        labels[0] = "time";
+        for (int j = 0; j < nColumns; ++j)
+            labels[j + 1] = "column_" + to_string(j);
+        storage.setColumnLabels(labels);
+        Array<double> row(0.0, nColumns);
+        for (int i = 0; i < nRows; ++i) {
+            for (int j = 0; j < nColumns; ++j)
+                row[j] = sin(1e-3*i + j);
+            storage.append(1e-3*i, nColumns, &row[0]);
+        }
+
+        auto start = chrono::steady_clock::now();
+        storage.print("benchmarkStorage.sto");
+        double elapsed = secondsSince(start);
+        ifstream file("benchmarkStorage.sto", ios_base::binary | ios_base::ate);
+        const double megabytes = (double)file.tellg()/(1024*1024);
+        file.close();
+        record("storage_write", "", "MB/s", megabytes/elapsed, nRows);
+
+        start = chrono::steady_clock::now();
+        Storage readBack("benchmarkStorage.sto");
+        elapsed = secondsSince(start);
+        if (readBack.getSize() != nRows)
+            throw Exception("Storage read back the wrong number of rows.");
+        record("storage_read", "", "MB/s", megabytes/elapsed, nRows);
+    });
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    const string resultsFile = argc > 1 ? argv[1] : "benchmark_results.json";
+    filter = argc > 2 ? argv[2] : "";
+
+    LoadOpenSimLibrary("osimActuators");
+
+    benchmarkModel("arm26.osim", 1.0);
+    benchmarkModel("gait10dof18musc_subject01.osim", 0.1);
+    benchmarkModel("test_wrapCylinder_vasint.osim", 0.1);
+    benchmarkModel("test_wrapEllipsoid_vasint.osim", 0.1);
+    benchmarkModel("TestShoulderModel.osim", 0.1);
+    benchmarkTools();
+    benchmarkStorage();
+
+    writeJSON(resultsFile);
+    cout << "Wrote " << results.size() << " results to " << resultsFile
+         << "; peak RSS " << getPeakRSS()/(1024*1024) << " MB." << endl;
+
+    for (const BenchmarkResult& r : results)
+        if (!r.error.empty())
+            return 1;
+    return 0;
+}
@@ -40,6 +40,7 @@
 #include "StateTrackingTask.h"
 
 #include <OpenSim/Common/Storage.h>
+#include <vector>
 
 using namespace std;
 using namespace OpenSim;
@@ -68,7 +69,7 @@ ActuatorForceTargetFast::~ActuatorForceTargetFast()
  */
 ActuatorForceTargetFast::
 ActuatorForceTargetFast(SimTK::State& s, int aNX,CMC *aController):
-    OptimizationTarget(aNX), _controller(aController)
+    OptimizationTarget(aNX), _controller(aController), _useWarmStart(false)
 {
     // NUMBER OF CONTROLS
     if(getNumParameters()<=0) {
@@ -132,19 +133,19 @@ prepareToOptimize(SimTK::State& s, double *x)
     _constraintMatrix.resize(nc,nf);
     _constraintVector.resize(nc);
 
-    Vector f(nf), c(nc);
-
-    // Build linear constraint matrix and constant constraint vector
-    f = 0;
-
-    computeConstraintVector(s, f, _constraintVector);
-
-    for(int j=0; j<nf; j++) {
-        f[j] = 1;
-        computeConstraintVector(s, f, c);
-        _constraintMatrix(j) = (c - _constraintVector);
-        f[j] = 0;
-    }
+    // Build linear constraint matrix and constant constraint vector:
+    // forward differences about zero force with unit perturbations, each
+    // column evaluated on a copy of the state.
+    Vector f(nf, 0.0);
+    std::vector<double> unitDX(nf, 1.0);
+    FiniteDifferences::Function constraints =
+        [this](SimTK::State& ws, const Vector& x, Vector& c) {
+            computeConstraintVector(ws, x, c);
+            return 0;
+        };
+    FiniteDifferences::calcJacobian(s, constraints,
+        FiniteDifferences::ForwardDifference, f, &unitDX[0],
+        _constraintMatrix, &_constraintVector);
 #endif
 
     // use temporary copy of state because computeIsokineticForceAssumingInfinitelyStiffTendon
@@ -175,8 +176,139 @@ prepareToOptimize(SimTK::State& s, double *x)
 
         _recipOptForceSquared[i] = 1.0 / (fOpt*fOpt);   
     }
-    
-    // return false to indicate that we still need to proceed with optimization (did not do a lapack direct solve)
+
+    // TRY THE PREVIOUS ACTIVE SET
+    // x holds the previous interval's solution.
+    bool solved = false;
+#ifdef USE_LINEAR_CONSTRAINT_MATRIX
+    if(_useWarmStart) solved = solveFromActiveSet(x);
+#endif
+
+    // Remember this interval's bounds for the next one.
+    if(getHasLimits()) {
+        double *lower, *upper;
+        getParameterLimits(&lower, &upper);
+        _lastLowerBounds = Vector(getNumParameters(), lower);
+        _lastUpperBounds = Vector(getNumParameters(), upper);
+    }
+
+    // return false to indicate that we still need to proceed with optimization
+    // (true if the previous active set gave the solution directly)
+    return solved;
+}
+//______________________________________________________________________________
+/**
+ * Solve the problem directly with a primal-dual active set method started
+ * from the bounds that were active at the previous solution x.
+ *
+ * With the bounded forces fixed at their bounds, minimizing
+ * sum(r_i*f_i^2) subject to the linear constraints A*f + b = 0 has the
+ * closed-form solution f_i = (A'*mu)_i / r_i, where mu solves
+ * (A_F * R_F^-1 * A_F') * mu = -(b + A_B*f_B) over the free forces F. The
+ * solution is optimal if the free forces are within their bounds and the
+ * multipliers of the bounded forces have the right signs; otherwise the
+ * violating forces are moved into or out of the active set and the system
+ * is solved again. Only a few iterations are tried before giving up.
+ *
+ * @param x On entry, the previous solution; on successful return, the
+ * solution.
+ * @return True if the optimum was found.
+ */
+bool ActuatorForceTargetFast::
+solveFromActiveSet(double *x) const
+{
+    const int nf = getNumParameters();
+    const int nc = getNumConstraints();
+    if(nc<=0 || !getHasLimits()) return false;
+
+    // State tracking tasks make the objective non-quadratic.
+    const CMC_TaskSet& tset = _controller->getTaskSet();
+    for(int t=0; t<tset.getSize(); t++)
+        if(dynamic_cast<const StateTrackingTask*>(&tset.get(t))) return false;
+
+    double *lower, *upper;
+    getParameterLimits(&lower, &upper);
+
+    // WEIGHTS OF THE OBJECTIVE
+    const Set<Actuator>& fSet = _controller->getActuatorSet();
+    Vector r(nf);
+    for(int i=0; i<nf; i++) {
+        r[i] = dynamic_cast<const Muscle*>(&fSet[i]) ?
+            _recipOptForceSquared[i] : _recipAreaSquared[i];
+        if(r[i] <= 0) return false;
+    }
+
+    // INITIAL ACTIVE SET: -1 at lower bound, 1 at upper bound, 0 free.
+    std::vector<int> active(nf, 0);
+    if(_lastLowerBounds.size()==nf && _lastUpperBounds.size()==nf) {
+        for(int i=0; i<nf; i++) {
+            double tol = 1.0e-6*(1.0 + fabs(x[i]));
+            if(x[i] <= _lastLowerBounds[i] + tol) active[i] = -1;
+            else if(x[i] >= _lastUpperBounds[i] - tol) active[i] = 1;
+        }
+    }
+    for(int i=0; i<nf; i++) if(upper[i] <= lower[i]) active[i] = -1;
+
+    const Matrix& A = _constraintMatrix;
+    const Vector& b = _constraintVector;
+    Vector f(nf), mu(nc), d(nc);
+    Matrix M(nc, nc);
+    const int maxIterations = 10;
+    for(int iter=0; iter<maxIterations; iter++) {
+
+        // REDUCED SYSTEM OVER THE FREE FORCES
+        int numFree = 0;
+        M = 0;
+        d = -b;
+        for(int i=0; i<nf; i++) {
+            if(active[i]==0) {
+                numFree++;
+                for(int j=0; j<nc; j++) {
+                    double aj = A(j,i) / r[i];
+                    for(int k=0; k<nc; k++) M(j,k) += aj*A(k,i);
+                }
+            } else {
+                f[i] = (active[i] < 0) ? lower[i] : upper[i];
+                for(int j=0; j<nc; j++) d[j] -= A(j,i)*f[i];
+            }
+        }
+        if(numFree < nc) return false;
+
+        SimTK::FactorLU lu(M);
+        if(lu.isSingular()) return false;
+        lu.solve(d, mu);
+        Vector Atmu = ~A * mu;
+
+        // FREE FORCES MUST BE WITHIN THEIR BOUNDS
+        bool changed = false;
+        for(int i=0; i<nf; i++) {
+            if(active[i]!=0) continue;
+            f[i] = Atmu[i] / r[i];
+            double tol = 1.0e-8*(1.0 + fabs(f[i]));
+            if(f[i] < lower[i] - tol) { active[i] = -1; changed = true; }
+            else if(f[i] > upper[i] + tol) { active[i] = 1; changed = true; }
+        }
+        if(changed) continue;
+
+        // BOUNDED FORCES MUST BE PUSHED AGAINST THEIR BOUNDS
+        for(int i=0; i<nf; i++) {
+            if(active[i]==0 || upper[i] <= lower[i]) continue;
+            double g = 2.0*(r[i]*f[i] - Atmu[i]);
+            double tol = 1.0e-8*(1.0 + fabs(2.0*r[i]*f[i]));
+            if((active[i] < 0 && g < -tol) || (active[i] > 0 && g > tol)) {
+                active[i] = 0;
+                changed = true;
+            }
+        }
+        if(changed) continue;
+
+        // CHECK THE CONSTRAINTS
+        Vector c = A*f + b;
+        if(c.normInf() > 1.0e-6*(1.0 + b.normInf())) return false;
+
+        for(int i=0; i<nf; i++) x[i] = f[i];
+        return true;
+    }
     return false;
 }
 
@@ -202,6 +334,7 @@ prepareToOptimize(SimTK::State& s, double *x)
 int ActuatorForceTargetFast::
 objectiveFunc(const Vector &aF, const bool new_coefficients, Real& rP) const
 {
+    ++_numObjectiveEvaluations;
     const Set<Actuator>& fSet = _controller->getActuatorSet();
     double p = 0.0;
     const CMC_TaskSet& tset=_controller->getTaskSet();
@@ -243,6 +376,7 @@ objectiveFunc(const Vector &aF, const bool new_coefficients, Real& rP) const
 int ActuatorForceTargetFast::
 gradientFunc(const Vector &x, const bool new_coefficients, Vector &gradient) const
 {
+    ++_numGradientEvaluations;
     const Set<Actuator>& fSet = _controller->getActuatorSet();
     double p = 0.0;
     for(int i=0,index=0;i<fSet.getSize();i++) {
@@ -319,10 +453,12 @@ computeConstraintVector(SimTK::State& s, const Vector &x,Vector &c) const
     }
     _controller->getModel().getMultibodySystem().realize(s, SimTK::Stage::Acceleration );
 
-    taskSet.computeAccelerations(s);
+    // Accelerations go to a local array rather than the task set's, so that
+    // evaluating the constraints does not modify the task set.
+    Array<double> a(0.0);
+    taskSet.calcAccelerations(s, a);
     Array<double> &w = taskSet.getWeights();
     Array<double> &aDes = taskSet.getDesiredAccelerations();
-    Array<double> &a = taskSet.getAccelerations();
 
     // CONSTRAINTS
     for(int i=0; i<getNumConstraints(); i++)
@@ -350,8 +486,14 @@ constraintJacobian(const SimTK::Vector &x, const bool new_coefficients, SimTK::M
 {
 #ifndef USE_LINEAR_CONSTRAINT_MATRIX
 
-    // Compute gradient using callbacks to constraintFunc
-    OptimizationTarget::CentralDifferencesConstraint(this,&_dx[0],x,jac);
+    // Compute gradient by perturbing a copy of the saved state
+    FiniteDifferences::Function constraints =
+        [this](SimTK::State& ws, const Vector& f, Vector& c) {
+            computeConstraintVector(ws, f, c);
+            return 0;
+        };
+    FiniteDifferences::calcJacobian(_saveState, constraints,
+        getDifferenceScheme(), x, &_dx[0], jac);
 
 #else
 
@@ -96,6 +96,14 @@ private:
     
     // Save a (copy) of the state for state tracking purposes
     SimTK::State    _saveState;
+
+    /** Whether to try solving from the previous interval's active set
+    before running the optimizer. */
+    bool _useWarmStart;
+    /** Bounds on the forces in the previous interval, used to recover which
+    bounds were active at the previous solution. */
+    SimTK::Vector _lastLowerBounds;
+    SimTK::Vector _lastUpperBounds;
 //==============================================================================
 // METHODS
 //==============================================================================
@@ -113,6 +121,15 @@ public:
 
     bool prepareToOptimize(SimTK::State& s, double *x) override;
 
+    /** When warm starting, prepareToOptimize() first solves the problem
+    directly, starting from the bounds that were active at the previous
+    solution, and returns true if that gives the optimum, in which case the
+    optimizer need not be run. Consecutive intervals usually share the same
+    active set, so most intervals are then solved with a few small linear
+    solves. Ignored if there are state tracking tasks. */
+    void setUseWarmStart(bool aTrueFalse) { _useWarmStart = aTrueFalse; }
+    bool getUseWarmStart() const { return _useWarmStart; }
+
     //--------------------------------------------------------------------------
     // REQUIRED OPTIMIZATION TARGET METHODS
     //--------------------------------------------------------------------------
@@ -123,6 +140,7 @@ public:
     CMC* getController() {return (_controller); }
 private:
     void computeConstraintVector(SimTK::State& s, const SimTK::Vector &x, SimTK::Vector &c) const;
+    bool solveFromActiveSet(double *x) const;
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 };  // END class ActuatorForceTargetFast
@@ -34,6 +34,7 @@
 #include <OpenSim/Analyses/ProbeReporter.h>
 #include <OpenSim/Simulation/Model/PrescribedForce.h>
 #include <OpenSim/Actuators/Thelen2003Muscle.h>
+#include <memory>
 
 using namespace OpenSim;
 using namespace std;
@@ -193,6 +194,7 @@ setNull()
     _lowpassCutoffFrequency = -1.0;
 
     _statesStore = NULL;
+    _numResultCacheHits = 0;
 
     _printResultFiles = true;
     _replaceForceSet = false;
@@ -236,6 +238,7 @@ void AnalyzeTool::setupProperties()
     _lowpassCutoffFrequencyProp.setName("lowpass_cutoff_frequency_for_coordinates");
     _propertySet.append( &_lowpassCutoffFrequencyProp );
 
+    _resultCache.appendTo(_propertySet);
 }
 
 
@@ -259,6 +262,7 @@ operator=(const AnalyzeTool &aTool)
     _coordinatesFileName = aTool._coordinatesFileName;
     _speedsFileName = aTool._speedsFileName;
     _lowpassCutoffFrequency= aTool._lowpassCutoffFrequency;
+    _resultCache = aTool._resultCache;
     _statesStore = aTool._statesStore;
     _printResultFiles = aTool._printResultFiles;
     return(*this);
@@ -536,14 +540,14 @@ bool AnalyzeTool::run(bool plotting)
 
     bool completed = true;
 
+    // SET OUTPUT PRECISION for the results written while the tool runs
+    IO::ThreadPrecision outputPrecision(_outputPrecision);
+
     try {
 
     // VERIFY THE CONTROL SET, STATES, AND PSEUDO STATES ARE TENABLE
     verifyControlsStates();
 
-    // SET OUTPUT PRECISION
-    IO::SetPrecision(_outputPrecision);
-
     // ANALYSIS SET
     AnalysisSet& analysisSet = _model->updAnalysisSet();
     if(analysisSet.getSize()<=0) {
@@ -567,8 +571,41 @@ bool AnalyzeTool::run(bool plotting)
     //  _statesStore->getTime(++iInitial,ti);
     //}
 
+    // Write the results of the analyses to files as they are recorded, on a
+    // background thread, while keeping every row in memory; printResults()
+    // moves the files to the usual result file names (see
+    // Analysis::setStreamResults()).
+    if(_printResultFiles) {
+        for(int i=0;i<analysisSet.getSize();i++) {
+            Analysis& analysis = analysisSet.get(i);
+            if(analysis.getOn() && analysis.getPrintResultFiles() &&
+               !analysis.getStreamResults()) {
+                analysis.setStreamResults(true);
+                analysis.setStreamWindow(iFinal-iInitial+1);
+            }
+        }
+    }
+
+    // Reuse the muscle equilibria of frames solved before with the same
+    // model, which includes the actuators and controllers set by the tool.
+    std::unique_ptr<ResultCache> equilibriumCache;
+    _numResultCacheHits = 0;
+    if(_resultCache.getUse() && _solveForEquilibriumForAuxiliaryStates) {
+        ResultCache::Hash key;
+        key.add("AnalyzeTool muscle equilibrium").add(*_model);
+        equilibriumCache.reset(new ResultCache(getResultCachePath(), key,
+                                              _resultCache.getSizeLimit()));
+    }
+
     cout<<"Executing the analyses from "<<ti<<" to "<<tf<<"..."<<endl;
-    run(s, *_model, iInitial, iFinal, *_statesStore, _solveForEquilibriumForAuxiliaryStates);
+    run(s, *_model, iInitial, iFinal, *_statesStore, _solveForEquilibriumForAuxiliaryStates,
+        equilibriumCache.get());
+    if(equilibriumCache) {
+        equilibriumCache->save();
+        _numResultCacheHits = equilibriumCache->getNumHits();
+        cout<<"AnalyzeTool: reused the muscle equilibria of "<<equilibriumCache->getNumHits()
+            <<" of "<<iFinal-iInitial+1<<" frames from "<<equilibriumCache->getFileName()<<"."<<endl;
+    }
     _model->getMultibodySystem().realize(s, SimTK::Stage::Position );
     } catch (const Exception& x) {
         x.print(cout);
@@ -590,7 +627,8 @@ bool AnalyzeTool::run(bool plotting)
 //=============================================================================
 // HELPER
 //=============================================================================
-void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium)
+void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium,
+                      ResultCache* aEquilibriumCache)
 {
     AnalysisSet& analysisSet = aModel.updAnalysisSet();
 
@@ -613,6 +651,11 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
     SimTK::Vector stateData;
     stateData.resize(numOpenSimStates);
 
+    // Iterations taken to equilibrate the muscles over all frames
+    int equilibriumIterations = 0;
+    // Auxiliary states (e.g., fiber lengths) at equilibrium
+    std::vector<double> equilibrium;
+
     for(int i=iInitial;i<=iFinal;i++) {
         tPrev = t;
         aStatesStore.getTime(i,s.updTime()); // time
@@ -631,13 +674,38 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
         // Adjust configuration to match constraints and other goals
         aModel.assemble(s);
 
+        // The equilibrium depends only on the model, which keys the cache,
+        // and the time and states of the frame.
+        ResultCache::Hash frame;
+        if(aSolveForEquilibrium && aEquilibriumCache)
+            frame.add(t).add(stateData);
+
         // equilibrateMuscles before realization as it may affect forces
-        if(aSolveForEquilibrium){
+        if(aSolveForEquilibrium && aEquilibriumCache &&
+                aEquilibriumCache->find(frame, equilibrium) &&
+                (int)equilibrium.size() == s.getNZ()){
+            for(int j=0; j<s.getNZ(); ++j)
+                s.updZ()[j] = equilibrium[j];
+        }
+        else if(aSolveForEquilibrium){
             try{// might not be able to equilibrate if model is in
                 // a non-physical pose. For example, a pose where the 
                 // muscle length is shorter than the tendon slack-length.
                 // the muscle will throw an Exception in this case.
-                aModel.equilibrateMuscles(s);
+                // After the first frame, start each muscle from the fiber
+                // length in the state: the frame's own value when the
+                // states file has one, else the previous frame's
+                // equilibrium. Warm-started solves take a few iterations,
+                // so solving on this thread is faster than starting and
+                // joining threads at every frame.
+                equilibriumIterations +=
+                    aModel.equilibrateMuscles(s, i > iInitial, 1);
+                if(aEquilibriumCache){
+                    equilibrium.resize(s.getNZ());
+                    for(int j=0; j<s.getNZ(); ++j)
+                        equilibrium[j] = s.getZ()[j];
+                    aEquilibriumCache->insert(frame, equilibrium);
+                }
             }
             catch (const std::exception& e) {
                 cout << "WARNING- AnalyzeTool::run() unable to equilibrate muscles ";
@@ -657,4 +725,10 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
             analysisSet.step(s,i);
         }
     }
+
+    if(aSolveForEquilibrium) {
+        cout << "AnalyzeTool::run() equilibrated muscles at "
+             << iFinal-iInitial+1 << " frames in " << equilibriumIterations
+             << " solver iterations." << endl;
+    }
 }
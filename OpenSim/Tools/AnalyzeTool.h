@@ -27,6 +27,7 @@
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyStr.h>
 #include <OpenSim/Common/PropertyInt.h>
+#include <OpenSim/Common/ResultCache.h>
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Simulation/Model/AbstractTool.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
@@ -68,6 +69,11 @@ private:
     /** Low-pass cut-off frequency for filtering the coordinates (does not apply to states). */
     PropertyDbl _lowpassCutoffFrequencyProp;
     double &_lowpassCutoffFrequency;
+    /** Whether and where to keep the muscle equilibria of frames solved by
+    earlier runs on the same model and states. */
+    ResultCacheSettings _resultCache;
+    /** Number of frames whose muscle equilibria the last run reused. */
+    int _numResultCacheHits;
 
     /** Storage for the model states. */
     Storage *_statesStore;
@@ -121,6 +127,13 @@ public:
     void setLowpassCutoffFrequency(double aLowpassCutoffFrequency) { _lowpassCutoffFrequency = aLowpassCutoffFrequency; }
     const bool getLoadModelAndInput() const { return _loadModelAndInput; }
     void setLoadModelAndInput(bool b) { _loadModelAndInput = b; }
+    const ResultCacheSettings& getResultCacheSettings() const { return _resultCache; }
+    ResultCacheSettings& updResultCacheSettings() { return _resultCache; }
+    /** The directory in which results are kept between runs. */
+    std::string getResultCachePath() const { return _resultCache.getPath(getResultsDir()); }
+    /** Number of frames whose muscle equilibria the last run reused from
+    the result cache. */
+    int getNumResultCacheHits() const { return _numResultCacheHits; }
 
     //--------------------------------------------------------------------------
     // UTILITIES
@@ -140,7 +153,11 @@ public:
     // HELPER
     //--------------------------------------------------------------------------
 #ifndef SWIG
-    static void run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium);
+    /** Run the model's analyses over frames iInitial to iFinal of the states.
+    If aEquilibriumCache is given, the muscle equilibria of frames found in it
+    are reused and those of other frames are added to it. */
+    static void run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium,
+                    ResultCache* aEquilibriumCache = NULL);
 #endif
 //=============================================================================
 };  // END of class AnalyzeTool
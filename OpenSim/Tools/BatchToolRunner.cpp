@@ -0,0 +1,341 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  BatchToolRunner.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "BatchToolRunner.h"
+#include "AnalyzeTool.h"
+#include "InverseDynamicsTool.h"
+#include "InverseKinematicsTool.h"
+#include "ScaleTool.h"
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/XMLDocument.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace OpenSim {
+
+namespace {
+
+// A trial whose setup file has been read and whose model has been copied,
+// ready to run on any thread.
+struct PreparedTrial {
+    int index;
+    unique_ptr<Object> tool;
+    unique_ptr<Model> model;
+    function<bool()> run;
+};
+
+bool isAssigned(const string& fileName)
+{
+    return fileName != "" && fileName != "Unassigned";
+}
+
+// The file name as an absolute path, where a relative name is relative to
+// directory, which is absolute and ends with a separator.
+string absolutePath(const string& fileName, const string& directory)
+{
+    return IO::resolvePath(fileName, directory);
+}
+
+// The models read from file, each read once and copied for every trial.
+class ModelCache {
+public:
+    Model* copyModel(const string& fileName)
+    {
+        unique_ptr<Model>& model = _models[fileName];
+        if (!model)
+            model.reset(new Model(fileName));
+        return model->clone();
+    }
+private:
+    map<string, unique_ptr<Model> > _models;
+};
+
+// Read the trial's tool from its setup file and copy the model it runs on.
+// The working directory is the directory of the setup file, and
+// invocationDirectory is the directory from which the batch was run.
+PreparedTrial prepareTrial(int index, const string& setupFile,
+                           const string& toolType,
+                           const string& invocationDirectory,
+                           ModelCache& models)
+{
+    PreparedTrial trial;
+    trial.index = index;
+    const string setupDirectory = IO::getParentDirectory(setupFile);
+
+    if (toolType == "ScaleTool") {
+        // The generic model is processed by the tool itself, as by the
+        // scale application.
+        ScaleTool* tool = new ScaleTool(setupFile);
+        trial.tool.reset(tool);
+        trial.model.reset(tool->createModel());
+        if (!trial.model)
+            throw Exception("ScaleTool " + tool->getName() +
+                ": could not load the generic model.", __FILE__, __LINE__);
+        Model* model = trial.model.get();
+        trial.run = [tool, model]() {
+            if (!tool->isDefaultModelScaler() &&
+                    tool->getModelScaler().getApply() &&
+                    !tool->getModelScaler().processModel(model,
+                        tool->getPathToSubject(), tool->getSubjectMass()))
+                return false;
+            if (!tool->isDefaultMarkerPlacer() &&
+                    !tool->getMarkerPlacer().processModel(model,
+                        tool->getPathToSubject()))
+                return false;
+            return true;
+        };
+    }
+    else if (toolType == "InverseKinematicsTool") {
+        // The ik application reads the model relative to the directory from
+        // which it is run.
+        InverseKinematicsTool* tool =
+            new InverseKinematicsTool(setupFile, false);
+        trial.tool.reset(tool);
+        trial.model.reset(models.copyModel(
+            absolutePath(tool->getModelFileName(), invocationDirectory)));
+        tool->setModel(*trial.model);
+        trial.run = [tool]() { return tool->run(); };
+    }
+    else if (toolType == "InverseDynamicsTool") {
+        InverseDynamicsTool* tool = new InverseDynamicsTool(setupFile, false);
+        trial.tool.reset(tool);
+        trial.model.reset(models.copyModel(
+            absolutePath(tool->getModelFileName(), invocationDirectory)));
+        tool->setModel(*trial.model);
+        // Name the inputs by absolute paths, so that the trial does not
+        // depend on the working directory while it runs.
+        if (isAssigned(tool->getCoordinatesFileName()))
+            tool->setCoordinatesFileName(absolutePath(
+                tool->getCoordinatesFileName(), setupDirectory));
+        if (isAssigned(tool->getExternalLoadsFileName()))
+            tool->setExternalLoadsFileName(absolutePath(
+                tool->getExternalLoadsFileName(), setupDirectory));
+        trial.run = [tool]() { return tool->run(); };
+    }
+    else if (toolType == "AnalyzeTool") {
+        // Set up the model as AnalyzeTool(setupFile) would, but on a copy;
+        // the model is read relative to the setup file.
+        AnalyzeTool* tool = new AnalyzeTool(setupFile, false);
+        trial.tool.reset(tool);
+        trial.model.reset(models.copyModel(
+            absolutePath(tool->getModelFilename(), setupDirectory)));
+        tool->updateModelForces(*trial.model, setupFile);
+        tool->setModel(*trial.model);
+        tool->setToolOwnsModel(false);
+        tool->setLoadModelAndInput(true);
+        // Name the inputs by absolute paths, so that the trial does not
+        // depend on the working directory while it runs.
+        if (isAssigned(tool->getStatesFileName()))
+            tool->setStatesFileName(absolutePath(
+                tool->getStatesFileName(), setupDirectory));
+        if (isAssigned(tool->getCoordinatesFileName()))
+            tool->setCoordinatesFileName(absolutePath(
+                tool->getCoordinatesFileName(), setupDirectory));
+        if (isAssigned(tool->getSpeedsFileName()))
+            tool->setSpeedsFileName(absolutePath(
+                tool->getSpeedsFileName(), setupDirectory));
+        if (isAssigned(tool->getExternalLoadsFileName()))
+            tool->setExternalLoadsFileName(absolutePath(
+                tool->getExternalLoadsFileName(), setupDirectory));
+        trial.run = [tool]() { return tool->run(); };
+    }
+    else {
+        throw Exception("BatchToolRunner: " + setupFile +
+            " is not the setup of a ScaleTool, InverseKinematicsTool, "
+            "InverseDynamicsTool or AnalyzeTool.", __FILE__, __LINE__);
+    }
+    return trial;
+}
+
+} // end of anonymous namespace
+
+BatchToolRunner::BatchToolRunner(int numThreads) :
+    _numThreads(numThreads > 0 ? numThreads :
+                std::max(1, (int)thread::hardware_concurrency()))
+{
+}
+
+void BatchToolRunner::addSetupFile(const std::string& setupFile)
+{
+    _setupFiles.push_back(setupFile);
+}
+
+std::string BatchToolRunner::getToolType(const std::string& setupFile)
+{
+    try {
+        XMLDocument doc(setupFile);
+        string rootName = doc.getRootTag();
+        if (rootName == "OpenSimDocument")
+            rootName = doc.getRootElement().element_begin()->getElementTag();
+        return rootName;
+    }
+    catch (...) {
+        return "";
+    }
+}
+
+const std::vector<BatchToolRunner::TrialResult>& BatchToolRunner::run()
+{
+    const string invocationDirectory = IO::getCwd() + "/";
+    const int numTrials = (int)_setupFiles.size();
+    _results.assign(numTrials, TrialResult());
+    for (int i = 0; i < numTrials; ++i) {
+        _results[i].setupFile = _setupFiles[i];
+        _results[i].toolType = getToolType(_setupFiles[i]);
+        if (_results[i].toolType.empty())
+            _results[i].error = "Could not read the setup file.";
+    }
+
+    const char* phases[] = { "ScaleTool", "InverseKinematicsTool",
+                             "InverseDynamicsTool", "AnalyzeTool" };
+    for (const char* phase : phases) {
+        // The trials of this phase, by the directory of their setup files.
+        map<string, vector<int> > directories;
+        for (int i = 0; i < numTrials; ++i) {
+            if (_results[i].toolType != phase) continue;
+            const string setupFile =
+                absolutePath(_setupFiles[i], invocationDirectory);
+            directories[IO::getParentDirectory(setupFile)].push_back(i);
+        }
+
+        ModelCache models;
+        for (const auto& directory : directories) {
+            IO::chDir(directory.first);
+
+            vector<PreparedTrial> trials;
+            for (int i : directory.second) {
+                try {
+                    trials.push_back(prepareTrial(i,
+                        absolutePath(_setupFiles[i], invocationDirectory),
+                        phase, invocationDirectory, models));
+                }
+                catch (const std::exception& x) {
+                    _results[i].error = x.what();
+                }
+            }
+
+            auto runTrial = [&](PreparedTrial& trial) {
+                TrialResult& result = _results[trial.index];
+                const auto start = chrono::steady_clock::now();
+                try {
+                    result.succeeded = trial.run();
+                    if (!result.succeeded)
+                        result.error = "The tool reported a failure.";
+                }
+                catch (const std::exception& x) {
+                    result.error = x.what();
+                }
+                catch (...) {
+                    result.error = "Unknown exception.";
+                }
+                result.seconds = chrono::duration<double>(
+                    chrono::steady_clock::now() - start).count();
+                // Release the trial's model as soon as it is done.
+                trial.tool.reset();
+                trial.model.reset();
+            };
+
+            // Deal the trials out to the threads. Each thread runs the
+            // trials at the front of its queue, and takes trials from the
+            // back of other threads' queues once its own is empty; no trials
+            // are added once the threads start.
+            const int numThreads =
+                std::min(_numThreads, std::max(1, (int)trials.size()));
+            vector<deque<int> > queues(numThreads);
+            vector<unique_ptr<mutex> > queueMutexes;
+            for (int t = 0; t < numThreads; ++t)
+                queueMutexes.emplace_back(new mutex);
+            for (int k = 0; k < (int)trials.size(); ++k)
+                queues[k % numThreads].push_back(k);
+
+            auto takeTrial = [&](int t, int& k) {
+                for (int i = 0; i < numThreads; ++i) {
+                    const int q = (t + i) % numThreads;
+                    lock_guard<mutex> lock(*queueMutexes[q]);
+                    if (queues[q].empty()) continue;
+                    if (q == t) {
+                        k = queues[q].front();
+                        queues[q].pop_front();
+                    }
+                    else {
+                        k = queues[q].back();
+                        queues[q].pop_back();
+                    }
+                    return true;
+                }
+                return false;
+            };
+            auto work = [&](int t) {
+                int k;
+                while (takeTrial(t, k))
+                    runTrial(trials[k]);
+            };
+
+            vector<thread> threads;
+            for (int t = 1; t < numThreads; ++t)
+                threads.push_back(thread(work, t));
+            work(0);
+            for (thread& th : threads)
+                th.join();
+        }
+        IO::chDir(invocationDirectory);
+    }
+    return _results;
+}
+
+int BatchToolRunner::getNumFailures() const
+{
+    return (int)std::count_if(_results.begin(), _results.end(),
+        [](const TrialResult& result) { return !result.succeeded; });
+}
+
+void BatchToolRunner::printReport(std::ostream& out) const
+{
+    double total = 0;
+    for (const TrialResult& result : _results) {
+        out << std::setw(24) << std::left
+            << (result.toolType.empty() ? "?" : result.toolType)
+            << std::setw(10) << std::right << std::fixed
+            << std::setprecision(2) << result.seconds << " s  "
+            << (result.succeeded ? "ok      " : "FAILED  ")
+            << result.setupFile;
+        if (!result.succeeded)
+            out << ": " << result.error;
+        out << std::endl;
+        total += result.seconds;
+    }
+    out << _results.size() - getNumFailures() << " of " << _results.size()
+        << " trials succeeded, in " << total << " s of trial time on "
+        << _numThreads << " threads." << std::endl;
+}
+
+} // end of namespace OpenSim
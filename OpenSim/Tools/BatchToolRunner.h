@@ -0,0 +1,110 @@
+#ifndef OPENSIM_BATCH_TOOL_RUNNER_H_
+#define OPENSIM_BATCH_TOOL_RUNNER_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  BatchToolRunner.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+/**
+ * Runs many trials, each given by the setup file of a ScaleTool,
+ * InverseKinematicsTool, InverseDynamicsTool or AnalyzeTool, in one process
+ * on a pool of threads.
+ *
+ * Trials run in phases by tool type, in the order of a processing pipeline:
+ * all ScaleTool trials first, then InverseKinematicsTool, InverseDynamicsTool
+ * and AnalyzeTool trials, so that a trial may use the outputs (e.g., the
+ * scaled model or the coordinates) of trials of an earlier phase.
+ *
+ * Each distinct model file is read once per phase. Every trial runs on its
+ * own copy of that model, since tools add analyses, forces and external
+ * loads to the model they run on. Within a phase, trials are spread over
+ * the threads, and a thread that runs out of trials takes trials queued for
+ * other threads.
+ *
+ * The tools resolve file names relative to the current working directory,
+ * which is shared by all threads. Setup files and models are therefore
+ * read, models copied, and the input files of each trial named by absolute
+ * paths, by the calling thread before the trials of a phase start. The
+ * trials of a phase whose setup files are in the same directory then run
+ * concurrently, with that directory as the working directory, to which
+ * their results are written relative. Each tool writes its results with its
+ * own output precision (see IO::ThreadPrecision).
+ *
+ * A trial that fails, by throwing an exception or by its tool reporting
+ * failure, is recorded as failed and the remaining trials still run.
+ */
+class OSIMTOOLS_API BatchToolRunner {
+public:
+    /** The outcome of one trial. */
+    struct TrialResult {
+        std::string setupFile;
+        /** The type of tool, e.g., "InverseKinematicsTool". */
+        std::string toolType;
+        bool succeeded;
+        /** Wall-clock time taken to run the trial, not including reading
+        its setup file and copying its model. */
+        double seconds;
+        /** Why the trial failed, if it did. */
+        std::string error;
+
+        TrialResult() : succeeded(false), seconds(0) {}
+    };
+
+    /** Run trials on numThreads threads, or on as many threads as the
+    hardware supports if numThreads is not positive. */
+    explicit BatchToolRunner(int numThreads = 0);
+
+    void addSetupFile(const std::string& setupFile);
+    int getNumSetupFiles() const { return (int)_setupFiles.size(); }
+    int getNumThreads() const { return _numThreads; }
+
+    /**
+     * Run all the trials, and return their results in the order in which
+     * their setup files were added.
+     */
+    const std::vector<TrialResult>& run();
+
+    const std::vector<TrialResult>& getResults() const { return _results; }
+    int getNumFailures() const;
+    /** Print the time taken by, and the outcome of, each trial. */
+    void printReport(std::ostream& out) const;
+
+    /**
+     * The type of tool whose setup is in a file, read from the file's root
+     * element, or an empty string if the file cannot be read.
+     */
+    static std::string getToolType(const std::string& setupFile);
+
+private:
+    std::vector<std::string> _setupFiles;
+    std::vector<TrialResult> _results;
+    int _numThreads;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_BATCH_TOOL_RUNNER_H_
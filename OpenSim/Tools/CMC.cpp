@@ -30,13 +30,17 @@
 // INCLUDES
 //=============================================================================
 #include <OpenSim/Simulation/osimSimulationDLL.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <OpenSim/Common/Exception.h>
 #include <OpenSim/Common/Array.h>
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Common/RootSolver.h>
+#include <OpenSim/Common/Logger.h>
 #include <OpenSim/Simulation/Model/AnalysisSet.h>
+#include <OpenSim/Simulation/Manager/SimulationCheckpoint.h>
 #include <OpenSim/Simulation/Model/Muscle.h>
 #include <OpenSim/Simulation/Model/Actuator.h>
 #include "VectorFunctionForActuators.h"
@@ -58,6 +62,20 @@ using SimTK::Vector;
 using namespace OpenSim;
 using namespace SimTK;
 
+// Create the storage for the statistics of the optimization in each interval.
+static Storage* newOptimizationStatisticsStorage()
+{
+    Array<string> labels;
+    labels.append("time");
+    labels.append("solved_directly");
+    labels.append("num_objective_evaluations");
+    labels.append("num_gradient_evaluations");
+    labels.append("optimization_time");
+    Storage* store = new Storage(1000,"OptimizationStatistics");
+    store->setColumnLabels(labels);
+    return store;
+}
+
 #define MIN_CMC_CONTROL_VALUE 0.02
 #define MAX_CMC_CONTROL_VALUE 1.00
 
@@ -150,6 +168,7 @@ CMC::CMC(Model *aModel,CMC_TaskSet *aTaskSet) :
     _vErrStore = new Storage(1000,"VelocityErrors");
     _pErrStore->setColumnLabels(labels);
     _stressTermWeightStore = new Storage(1000,"StressTermWeight");
+    _optimizationStatsStore = newOptimizationStatisticsStorage();
 }
 
 void CMC::copyData( const CMC &aCmc ) 
@@ -162,6 +181,7 @@ void CMC::copyData( const CMC &aCmc )
    _pErrStore             = aCmc._pErrStore;
    _vErrStore             = aCmc._vErrStore;
    _stressTermWeightStore = aCmc._stressTermWeightStore;
+   _optimizationStatsStore = aCmc._optimizationStatsStore;
    _controlSet            = aCmc._controlSet;
    _taskSet               = aCmc._taskSet;
    _paramList             = aCmc._paramList;
@@ -213,6 +233,7 @@ setNull()
     _pErrStore = NULL;
     _vErrStore = NULL;
     _stressTermWeightStore = NULL;
+    _optimizationStatsStore = NULL;
     _useCurvatureFilter = false;
     _verbose = false;
     _paramList.setSize(0);
@@ -498,6 +519,22 @@ getStressTermWeightStorage() const
 {
     return(_stressTermWeightStore);
 }
+//_____________________________________________________________________________
+/**
+ * Get the storage of the optimization statistics. For each control interval
+ * there is a row with whether the previous interval's active set gave the
+ * solution directly (1) or the optimizer was run (0), the numbers of
+ * objective and gradient evaluations (the latter approximating the number
+ * of optimizer iterations), and the wall-clock time in seconds taken by the
+ * optimization.
+ *
+ * @return Optimization statistics storage.
+ */
+Storage* CMC::
+getOptimizationStatisticsStorage() const
+{
+    return(_optimizationStatsStore);
+}
 
 
 //=============================================================================
@@ -718,10 +755,10 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     double tiReal = s.getTime(); 
     double tfReal = _tf; 
 
-    cout<<"CMC.computeControls:  t = "<<s.getTime()<<endl;
+    OPENSIM_LOG_INFO("CMC.computeControls:  t = "<<s.getTime());
     if(_verbose) { 
-        cout<<"\n\n----------------------------------\n";
-        cout<<"integration step size = "<<_targetDT<<",  target time = "<<_tf<<endl;
+        OPENSIM_LOG_INFO("\n\n----------------------------------\n"
+            <<"integration step size = "<<_targetDT<<",  target time = "<<_tf);
     }
 
     // SET CORRECTIONS 
@@ -747,15 +784,15 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     _predictor->getCMCActSubsys()->setSpeedCorrections(&uCorrection[0]);
 
     if( _verbose ) {
-        cout << "\n=============================" << endl;
-        cout << "\nCMC:computeControls"  << endl;
-        cout << "\nq's = " << s.getQ() << endl;
-        cout << "\nu's = " << s.getU() << endl;
-        cout << "\nz's = " << s.getZ() << endl;
-        cout<<"\nqDesired:"<<qDesired << endl;
-        cout<<"\nuDesired:"<<uDesired << endl;
-        cout<<"\nQCorrections:"<<qCorrection << endl;
-        cout<<"\nUCorrections:"<<uCorrection << endl;
+        OPENSIM_LOG_INFO("\n=============================\n"
+            << "\nCMC:computeControls\n"
+            << "\nq's = " << s.getQ() << "\n"
+            << "\nu's = " << s.getU() << "\n"
+            << "\nz's = " << s.getZ() << "\n"
+            << "\nqDesired:" << qDesired << "\n"
+            << "\nuDesired:" << uDesired << "\n"
+            << "\nQCorrections:" << qCorrection << "\n"
+            << "\nUCorrections:" << uCorrection);
     }
 
     // realize to Velocity because some tasks (eg. CMC_Point) need to be
@@ -767,7 +804,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     _taskSet->recordErrorsAsLastErrors();
     Array<double> &pErr = _taskSet->getPositionErrors();
     Array<double> &vErr = _taskSet->getVelocityErrors();
-    if(_verbose) cout<<"\nErrors at time "<<s.getTime()<<":"<<endl;
+    if(_verbose) OPENSIM_LOG_INFO("\nErrors at time "<<s.getTime()<<":");
     int e=0;
     for(i=0;i<_taskSet->getSize();i++) {
         
@@ -775,8 +812,8 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
 
         if(_verbose) {
             for(j=0;j<task.getNumTaskFunctions();j++) {
-                cout<<task.getName()<<":  ";
-                cout<<"pErr="<<pErr[e]<<" vErr="<<vErr[e]<<endl;
+                OPENSIM_LOG_INFO(task.getName()<<":  "
+                    <<"pErr="<<pErr[e]<<" vErr="<<vErr[e]);
                 e++;
             }
         }
@@ -806,12 +843,12 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
                 CMC_Joint& jointTask = dynamic_cast<CMC_Joint&>(_taskSet->get(i));
                 if(jointTask.getLimit()) {
                     double w = ForwardTool::SigmaDn(jointTask.getLimit() * relativeTau, jointTask.getLimit(), fabs(pErr[i]));
-                    if(_verbose) cout << "Task " << i << ": err=" << pErr[i] << ", limit=" << jointTask.getLimit() << ", sigmoid=" << w << endl;
+                    if(_verbose) OPENSIM_LOG_INFO("Task " << i << ": err=" << pErr[i] << ", limit=" << jointTask.getLimit() << ", sigmoid=" << w);
                     stressTermWeight = min(stressTermWeight, w);
                 }
             }
         }
-        if(_verbose) cout << "Setting stress term weight to " << stressTermWeight << " (relativeTau was " << relativeTau << ")" << std::endl;
+        if(_verbose) OPENSIM_LOG_INFO("Setting stress term weight to " << stressTermWeight << " (relativeTau was " << relativeTau << ")");
         realTarget->setStressTermWeight(stressTermWeight);
 
         for(i=0;i<vErr.getSize();i++) err[i] = vErr[i];
@@ -828,8 +865,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     }
 
     if(_verbose) {
-        cout<<"\nxmin:\n"<<xmin<<endl;
-        cout<<"\nxmax:\n"<<xmax<<endl;
+        OPENSIM_LOG_INFO("\nxmin:\n"<<xmin<<"\n"<<"\nxmax:\n"<<xmax);
     }
 
     // COMPUTE BOUNDS ON MUSCLE FORCES
@@ -844,12 +880,10 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     SimTK::State newState = _predictor->getCMCActSubsys()->getCompleteState();
     
      if(_verbose) {
-        cout<<endl<<endl;
-        cout<<"\ntiReal = "<<tiReal<<"  tfReal = "<<tfReal<<endl;
-        cout<<"Min forces:\n";
-        cout<<fmin<<endl;
-        cout<<"Max forces:\n";
-        cout<<fmax<<endl;
+        OPENSIM_LOG_INFO("\n\n"
+            <<"\ntiReal = "<<tiReal<<"  tfReal = "<<tfReal<<"\n"
+            <<"Min forces:\n"<<fmin<<"\n"
+            <<"Max forces:\n"<<fmax);
     }
 
     // Print actuator force range if range is small
@@ -857,9 +891,9 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     for(i=0;i<N;i++) {
         range = fmax[i] - fmin[i];
         if(range<1.0) {
-            cout << "CMC::computeControls WARNING- small force range for "
+            OPENSIM_LOG_WARN("CMC::computeControls WARNING- small force range for "
                  << getActuatorSet()[i].getName()
-                 << " ("<<fmin[i]<<" to "<<fmax[i]<<")\n" << endl;
+                 << " ("<<fmin[i]<<" to "<<fmax[i]<<")\n");
             // if the force range is so small it means the control value, x, 
             // is inconsequential and we might as well choose the smallest control
             // value possible, or else the RootSolver will choose the last value
@@ -890,7 +924,12 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     // OPTIMIZER ERROR TRAP
     _f.setSize(N);
 
-    if(!_target->prepareToOptimize(newState, &_f[0])) {
+    _target->resetEvaluationCounts();
+    std::chrono::steady_clock::time_point optimizationStart =
+        std::chrono::steady_clock::now();
+    bool solvedDirectly = _target->prepareToOptimize(newState, &_f[0]);
+
+    if(!solvedDirectly) {
         // No direct solution, need to run optimizer
         Vector fVector(N,&_f[0],true);
 
@@ -898,9 +937,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
             _optimizer->optimize(fVector);
         }
         catch (const SimTK::Exception::Base& ex) {
-            cout << ex.getMessage() << endl;
-            cout << "OPTIMIZATION FAILED..." << endl;
-            cout<<endl;
+            OPENSIM_LOG_ERROR(ex.getMessage() << "\nOPTIMIZATION FAILED...\n");
 
             ostringstream msg;
             msg << "CMC.computeControls: ERROR- Optimizer could not find a solution." << endl;
@@ -910,7 +947,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
             msg << "2. there are tracking tasks for locked coordinates, and/or" << endl;
             msg << "3. there are unnecessary control constraints on reserve/residual actuators." << endl;
                    
-            cout<<"\n"<<msg.str()<<endl<<endl;
+            OPENSIM_LOG_ERROR("\n"<<msg.str()<<"\n");
 
          throw(new OpenSim::Exception(msg.str(), __FILE__,__LINE__));
         }
@@ -918,11 +955,19 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
         // Got a direct solution, don't need to run optimizer
     }
 
+    // OPTIMIZATION STATISTICS
+    double stats[4];
+    stats[0] = solvedDirectly ? 1.0 : 0.0;
+    stats[1] = _target->getNumObjectiveEvaluations();
+    stats[2] = _target->getNumGradientEvaluations();
+    stats[3] = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - optimizationStart).count();
+    _optimizationStatsStore->append(tiReal,4,stats);
+
     if(_verbose) _target->printPerformance(&_f[0]);
 
     if(_verbose) {
-        cout<<"\nDesired actuator forces:\n";
-        cout<<_f<<endl;
+        OPENSIM_LOG_INFO("\nDesired actuator forces:\n"<<_f);
     }
 
 
@@ -934,7 +979,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     Array<double> controls(0.0,N);
     controls = rootSolver.solve(s, xmin,xmax,tol);
     if(_verbose) {
-       cout<<"\n\nXXX t=" << _tf << "   Controls:" <<controls<<endl;
+       OPENSIM_LOG_INFO("\n\nXXX t=" << _tf << "   Controls:" <<controls);
     }
     
     // FILTER OSCILLATIONS IN CONTROL VALUES
@@ -971,6 +1016,93 @@ getUseCurvatureFilter() const
     return(_useCurvatureFilter);
 }
 
+//=============================================================================
+// CHECKPOINTS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Add the state of the CMC algorithm to a checkpoint. The nodes of linear
+ * controls are recorded as interleaved times and values; the parameters of
+ * other controls are recorded as values.
+ */
+void CMC::
+captureCheckpoint(SimulationCheckpoint& rCheckpoint) const
+{
+    SimTK::Vector scalars(3);
+    scalars[0] = _tf;
+    scalars[1] = _lastDT;
+    scalars[2] = _restoreDT ? 1.0 : 0.0;
+    rCheckpoint.setData("CMC.scalars", scalars);
+
+    SimTK::Vector forces(_f.getSize());
+    for(int i=0; i<_f.getSize(); ++i) forces[i] = _f[i];
+    rCheckpoint.setData("CMC.forces", forces);
+
+    for(int i=0; i<_controlSet.getSize(); ++i) {
+        const Control& control = _controlSet.get(i);
+        const int np = control.getNumParameters();
+        const bool isLinear = dynamic_cast<const ControlLinear*>(&control) != 0;
+        SimTK::Vector nodes(isLinear ? 2*np : np);
+        for(int j=0; j<np; ++j) {
+            if(isLinear) {
+                nodes[2*j] = control.getParameterTime(j);
+                nodes[2*j+1] = control.getParameterValue(j);
+            } else {
+                nodes[j] = control.getParameterValue(j);
+            }
+        }
+        rCheckpoint.setData("CMC.control." + control.getName(), nodes);
+    }
+
+    rCheckpoint.setStorage("CMC.positionErrors", *_pErrStore);
+    rCheckpoint.setStorage("CMC.velocityErrors", *_vErrStore);
+    rCheckpoint.setStorage("CMC.stressTermWeight", *_stressTermWeightStore);
+    rCheckpoint.setStorage("CMC.optimizationStatistics",
+                           *_optimizationStatsStore);
+}
+//_____________________________________________________________________________
+/**
+ * Restore the state of the CMC algorithm from a checkpoint written by
+ * captureCheckpoint(). Controls that are not in the checkpoint are left as
+ * they are.
+ */
+void CMC::
+restoreCheckpoint(const SimulationCheckpoint& aCheckpoint)
+{
+    const SimTK::Vector& scalars = aCheckpoint.getData("CMC.scalars");
+    _tf = scalars[0];
+    _lastDT = scalars[1];
+    _restoreDT = scalars[2] != 0.0;
+
+    const SimTK::Vector& forces = aCheckpoint.getData("CMC.forces");
+    _f.setSize(forces.size());
+    for(int i=0; i<forces.size(); ++i) _f[i] = forces[i];
+
+    for(int i=0; i<_controlSet.getSize(); ++i) {
+        Control& control = _controlSet.get(i);
+        const string key = "CMC.control." + control.getName();
+        if(!aCheckpoint.hasData(key)) continue;
+        const SimTK::Vector& nodes = aCheckpoint.getData(key);
+        ControlLinear* linear = dynamic_cast<ControlLinear*>(&control);
+        if(linear) {
+            linear->clearControlNodes();
+            for(int j=0; j+1<nodes.size(); j+=2)
+                linear->setControlValue(nodes[j], nodes[j+1]);
+        } else {
+            const int np = std::min(nodes.size(), control.getNumParameters());
+            for(int j=0; j<np; ++j)
+                control.setParameterValue(j, nodes[j]);
+        }
+    }
+
+    aCheckpoint.restoreStorage("CMC.positionErrors", *_pErrStore);
+    aCheckpoint.restoreStorage("CMC.velocityErrors", *_vErrStore);
+    aCheckpoint.restoreStorage("CMC.stressTermWeight",
+                               *_stressTermWeightStore);
+    aCheckpoint.restoreStorage("CMC.optimizationStatistics",
+                               *_optimizationStatsStore);
+}
+
 const CMC_TaskSet& CMC::getTaskSet() const{
    return( *_taskSet );
 }
@@ -1013,11 +1145,11 @@ FilterControls(const SimTK::State& s, const ControlSet &aControlSet,double aDT,
                OpenSim::Array<double> &rControls,bool aVerbosePrinting)
 {
     if(aDT <= SimTK::Zero) {
-        if(aVerbosePrinting) cout<<"\nCMC.filterControls: aDT is practically 0.0, skipping!\n\n";
+        if(aVerbosePrinting) OPENSIM_LOG_INFO("\nCMC.filterControls: aDT is practically 0.0, skipping!\n");
         return;
     }
 
-    if(aVerbosePrinting) cout<<"\n\nFiltering controls to limit curvature...\n";
+    if(aVerbosePrinting) OPENSIM_LOG_INFO("\n\nFiltering controls to limit curvature...");
 
     int i;
     int size = rControls.getSize();
@@ -1060,10 +1192,10 @@ FilterControls(const SimTK::State& s, const ControlSet &aControlSet,double aDT,
         rControls[i] = (3.0*x2[i] + 2.0*x1[i] + x0[i]) / 6.0;
 
         // PRINT
-        if(aVerbosePrinting) cout<<aControlSet[i].getName()<<": old="<<x2[i]<<" new="<<rControls[i]<<endl;
+        if(aVerbosePrinting) OPENSIM_LOG_INFO(aControlSet[i].getName()<<": old="<<x2[i]<<" new="<<rControls[i]);
     }
 
-    if(aVerbosePrinting) cout<<endl<<endl;
+    if(aVerbosePrinting) OPENSIM_LOG_INFO("\n");
 }
 
 
@@ -1101,6 +1233,7 @@ void CMC::extendConnectToModel(Model& model)
     _vErrStore = new Storage(1000,"VelocityErrors");
     _pErrStore->setColumnLabels(labels);
     _stressTermWeightStore = new Storage(1000,"StressTermWeight");
+    _optimizationStatsStore = newOptimizationStatisticsStorage();
 
 }
 // for adding any components to the model
@@ -45,6 +45,7 @@ namespace OpenSim {
 class OptimizationTarget;
 class VectorFunctionForActuators;
 class CMC_TaskSet;
+class SimulationCheckpoint;
 
 //=============================================================================
 //=============================================================================
@@ -118,6 +119,9 @@ protected:
     Storage *_vErrStore;
     /** Storage object for the stress term weight. */
     Storage *_stressTermWeightStore;
+    /** Storage object for the statistics of the optimization in each
+    interval (see getOptimizationStatisticsStorage()). */
+    Storage *_optimizationStatsStore;
 
     ControlSet _controlSet;
     /** List of parameters in the control set that are serving as the
@@ -176,6 +180,7 @@ public:
     Storage* getPositionErrorStorage() const;
     Storage* getVelocityErrorStorage() const;
     Storage* getStressTermWeightStorage() const;
+    Storage* getOptimizationStatisticsStorage() const;
     bool getUseReflexes() const;
     void setUseVerbosePrinting(bool aTrueFalse);
     bool getUseVerbosePrinting() const;
@@ -205,6 +210,16 @@ public:
     /** CMC algorithm */
     virtual void computeControls(SimTK::State& s, ControlSet &rX);
 
+    //--------------------------------------------------------------------------
+    // CHECKPOINTS
+    //--------------------------------------------------------------------------
+    /** Add to a checkpoint the state of the algorithm that is not held in the
+    model's State: the target time, the computed control nodes, the last
+    optimal actuator forces and the error and statistics storages. */
+    void captureCheckpoint(SimulationCheckpoint& rCheckpoint) const;
+    /** Restore the state added to a checkpoint by captureCheckpoint(). */
+    void restoreCheckpoint(const SimulationCheckpoint& aCheckpoint);
+
     //--------------------------------------------------------------------------
     // STATIC
     //--------------------------------------------------------------------------
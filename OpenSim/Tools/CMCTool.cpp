@@ -29,6 +29,7 @@
 #include <OpenSim/Simulation/Model/BodySet.h>
 #include "VectorFunctionForActuators.h"
 #include <OpenSim/Simulation/Manager/Manager.h>
+#include <OpenSim/Simulation/Manager/SimulationCheckpoint.h>
 #include <OpenSim/Simulation/Control/ControlLinear.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
 #include <OpenSim/Simulation/Model/CMCActuatorSubsystem.h>
@@ -40,6 +41,7 @@
 #include "CMC_TaskSet.h"
 #include "ActuatorForceTarget.h"
 #include "ActuatorForceTargetFast.h"
+#include <memory>
 
 using namespace std;
 using namespace SimTK;
@@ -75,6 +77,7 @@ CMCTool::CMCTool() :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useWarmStart(_useWarmStartProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -105,6 +108,7 @@ CMCTool::CMCTool(const string &aFileName, bool aLoadModel) :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useWarmStart(_useWarmStartProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -175,6 +179,7 @@ CMCTool(const CMCTool &aTool) :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useWarmStart(_useWarmStartProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -207,6 +212,7 @@ setNull()
     _targetDT = 0.010;           
     //_useCurvatureFilter = false;       
     _useFastTarget = true;
+    _useWarmStart = false;
     _optimizerAlgorithm = "ipopt";
     _numericalDerivativeStepSize = 1.0e-4;
     _optimizationConvergenceTolerance = 1.0e-4;
@@ -299,6 +305,14 @@ void CMCTool::setupProperties()
     _useFastTargetProp.setName("use_fast_optimization_target");          
     _propertySet.append( &_useFastTargetProp );
 
+    comment = "Flag (true or false) indicating whether the fast target should first try to ";
+    comment += "solve each time window directly from the actuator force bounds that were ";
+    comment += "active in the previous window, running the optimizer only if that fails. ";
+    comment += "Statistics of each window's optimization are written to the results directory.";
+    _useWarmStartProp.setComment(comment);
+    _useWarmStartProp.setName("use_warm_start");
+    _propertySet.append( &_useWarmStartProp );
+
     comment = "Preferred optimizer algorithm (currently support \"ipopt\" or \"cfsqp\", "
                  "the latter requiring the osimCFSQP library.";
     _optimizerAlgorithmProp.setComment(comment);
@@ -366,6 +380,7 @@ operator=(const CMCTool &aTool)
     _numericalDerivativeStepSize = aTool._numericalDerivativeStepSize;
     _optimizationConvergenceTolerance = aTool._optimizationConvergenceTolerance;
     _useFastTarget = aTool._useFastTarget;
+    _useWarmStart = aTool._useWarmStart;
     _optimizerAlgorithm = aTool._optimizerAlgorithm;
     _maxIterations = aTool._maxIterations;
     _printLevel = aTool._printLevel;
@@ -403,10 +418,10 @@ bool CMCTool::run()
     string directoryOfSetupFile = IO::getParentDirectory(getDocumentFileName());
     IO::chDir(directoryOfSetupFile);
 
-    try {
+    // SET OUTPUT PRECISION for the results written while the tool runs
+    IO::ThreadPrecision outputPrecision(_outputPrecision);
 
-    // SET OUTPUT PRECISION
-    IO::SetPrecision(_outputPrecision);
+    try {
 
     bool externalLoads = createExternalLoads(_externalLoadsFileName, *_model);
 
@@ -684,7 +699,10 @@ bool CMCTool::run()
     // Optimization target
     OptimizationTarget *target = NULL;
     if(_useFastTarget) {
-        target = new ActuatorForceTargetFast(s, na,controller);
+        ActuatorForceTargetFast *fastTarget =
+            new ActuatorForceTargetFast(s, na,controller);
+        fastTarget->setUseWarmStart(_useWarmStart);
+        target = fastTarget;
     } else {
         target = new ActuatorForceTarget(na,controller);
     }
@@ -750,11 +768,29 @@ bool CMCTool::run()
     // Initialize integrand controls using controls read in from file (which specify min/max control values)
     initializeControlSetUsingConstraints(rraControlSet,controlConstraints, controller->updControlSet());
 
+    // Checkpoints record the controller's progress along with the states
+    if(_checkpointInterval > 0.0) {
+        IO::makeDir(getResultsDir());
+        manager.setCheckpointInterval(_checkpointInterval);
+        manager.setCheckpointFileName(getCheckpointFilePath());
+        manager.setCheckpointCallback([controller](SimulationCheckpoint& checkpoint) {
+            controller->captureCheckpoint(checkpoint);
+        });
+    }
+    std::unique_ptr<SimulationCheckpoint> checkpoint;
+    if(_resumeFromCheckpoint) {
+        checkpoint.reset(new SimulationCheckpoint(getCheckpointFilePath()));
+        checkpoint->restoreState(s);
+        controller->restoreCheckpoint(*checkpoint);
+    }
+
     // Initial auxiliary states
     time_t startTime,finishTime;
     struct tm *localTime;
     double elapsedTime;
-    if( s.getNZ() > 0) { // If there are actuator states (i.e. muscles dynamics)
+    if( checkpoint ) {
+        cout<<"\nResuming from the checkpoint at t = "<<checkpoint->getTime()<<".\n";
+    } else if( s.getNZ() > 0) { // If there are actuator states (i.e. muscles dynamics)
         cout<<"\n\n\n";
         cout<<"================================================================\n";
         cout<<"================================================================\n";
@@ -809,9 +845,11 @@ bool CMCTool::run()
     cout<<"================================================================\n";
     cout<<"================================================================\n";
     cout<<"Using CMC to track the specified kinematics\n";
-    cout<<"Integrating from "<<_ti<<" to "<<_tf<<endl;
-    s.updTime() = _ti;
-    controller->setTargetTime( _ti );
+    const double tStart = checkpoint ? checkpoint->getTime() : _ti;
+    cout<<"Integrating from "<<tStart<<" to "<<_tf<<endl;
+    s.updTime() = tStart;
+    // A resumed controller keeps its restored target time
+    if( !checkpoint ) controller->setTargetTime( _ti );
     time(&startTime);
     localTime = localtime(&startTime);
     cout<<"Start time = "<<asctime(localTime);
@@ -823,11 +861,15 @@ bool CMCTool::run()
 
     cmcActSubsystem.setCompleteState( s );
 
-    // Set output file names so that files are flushed regularly in case we fail
+    // Write the states to their file as they are computed. The rows are
+    // formatted and written on a background thread; if the tool fails, the
+    // catch blocks below complete the file with the states computed so far.
     IO::makeDir(getResultsDir());   // Create directory for output in case it doesn't exist
     manager.getStateStorage().setOutputFileName(getResultsDir() + "/" + getName() + "_states.sto");
+    manager.getStateStorage().setAsynchronousOutput(true);
     try {
-        manager.integrate(s);
+        if( checkpoint ) manager.resume(s, *checkpoint);
+        else manager.integrate(s);
     }
     catch(const Exception& x) {
         // TODO: eventually might want to allow writing of partial results
@@ -871,6 +913,7 @@ bool CMCTool::run()
     statesDegrees.print(getResultsDir() + "/" + getName() + "_states_degrees.mot");
     */
     controller->getPositionErrorStorage()->print(getResultsDir() + "/" + getName() + "_pErr.sto");
+    controller->getOptimizationStatisticsStorage()->print(getResultsDir() + "/" + getName() + "_optimizationStatistics.sto");
 
     //_model->removeController(controller); // So that if this model is from GUI it doesn't double-delete it.
 
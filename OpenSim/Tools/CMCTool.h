@@ -107,6 +107,11 @@ private:
     meets them as well as it can. */         
     PropertyBool _useFastTargetProp;         
     bool &_useFastTarget;
+    /** Flag indicating whether the fast target should first try to solve
+    each interval directly from the bounds that were active in the previous
+    interval, running the optimizer only if that fails. */
+    PropertyBool _useWarmStartProp;
+    bool &_useWarmStart;
 
     /** Preferred optimizer algorithm. */
     PropertyStr _optimizerAlgorithmProp;
@@ -196,6 +201,8 @@ public:
     // Target selection
     bool getUseFastTarget() const { return _useFastTarget;};         
     void setUseFastTarget(bool useFastTarget) const {  _useFastTarget=useFastTarget; };
+    bool getUseWarmStart() const { return _useWarmStart; }
+    void setUseWarmStart(bool useWarmStart) { _useWarmStart = useWarmStart; }
 
 
     //--------------------------------------------------------------------------
@@ -364,13 +364,26 @@ computeDesiredAccelerations(const SimTK::State& s, double aTI,double aTF)
 void CMC_Joint::
 computeAccelerations(const SimTK::State& s )
 {
-    _a=SimTK::NaN;
+    _a = calcAccelerations(s);
+}
+//_____________________________________________________________________________
+/**
+ * Compute the acceleration of the generalized coordinate without changing
+ * this task.
+ *
+ * @see computeAccelerations()
+ */
+SimTK::Vec3 CMC_Joint::
+calcAccelerations(const SimTK::State& s) const
+{
+    SimTK::Vec3 a(SimTK::NaN);
 
     // CHECK
-    if(_model==NULL) return;
+    if(_model==NULL) return a;
 
     // ACCELERATION
-    _a[0] = _q->getAccelerationValue(s);
+    a[0] = _q->getAccelerationValue(s);
+    return a;
 }
 
 
@@ -104,6 +104,7 @@ public:
     void computeDesiredAccelerations(const SimTK::State& s, double aT) override;
     void computeDesiredAccelerations(const SimTK::State& s, double aTI,double aTF) override;
     void computeAccelerations(const SimTK::State& s ) override;
+    SimTK::Vec3 calcAccelerations(const SimTK::State& s) const override;
 
     //--------------------------------------------------------------------------
     // XML
@@ -430,35 +430,53 @@ computeAccelerations(const SimTK::State& s )
     // CHECK
     if(_model==NULL) return;
 
+    if(_wrtBodyName != "center_of_mass")
+        _wrtBody =  &_model->updBodySet().get(_wrtBodyName);
+
+    _a = calcAccelerations(s);
+}
+//_____________________________________________________________________________
+/**
+ * Compute the acceleration of the point without changing this task.
+ *
+ * @see computeAccelerations()
+ */
+SimTK::Vec3 CMC_Point::
+calcAccelerations(const SimTK::State& s) const
+{
+    // CHECK
+    if(_model==NULL) return _a;
+
     // ACCELERATION
-    _a = 0;
-    BodySet& bs = _model->updBodySet();
+    SimTK::Vec3 a(0);
+    const BodySet& bs = _model->getBodySet();
     if(_wrtBodyName == "center_of_mass") {
 
-        SimTK::Vec3 pVec,vVec,aVec,com;
+        SimTK::Vec3 aVec,com;
         double Mass = 0.0;
         for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
+            const Body& body = bs.get(i);
             com = body.get_mass_center();
             _model->getSimbodyEngine().getAcceleration(s, body,com,aVec);
             if(aVec[0] != aVec[0]) throw Exception("CMC_Point.computeAccelerations: ERROR- point task '" + getName() 
                                             + "' references invalid acceleration components",__FILE__,__LINE__);
             // ADD TO WHOLE BODY MASS
             Mass += body.get_mass();
-            _a += body.get_mass() * aVec;
+            a += body.get_mass() * aVec;
         }
 
         //COMPUTE COM ACCELERATION OF WHOLE BODY
-        _a /= Mass;
+        a /= Mass;
 
     } else {
 
-        _wrtBody =  &bs.get(_wrtBodyName);
+        const Body& wrtBody = bs.get(_wrtBodyName);
 
-        _model->getSimbodyEngine().getAcceleration(s, *_wrtBody,_point,_a);
-        if(_a[0] != _a[0]) throw Exception("CMC_Point.computeAccelerations: ERROR- point task '" + getName() 
+        _model->getSimbodyEngine().getAcceleration(s, wrtBody,_point,a);
+        if(a[0] != a[0]) throw Exception("CMC_Point.computeAccelerations: ERROR- point task '" + getName() 
                                             + "' references invalid acceleration components",__FILE__,__LINE__);
     }
+    return a;
 }
 
 //=============================================================================
@@ -214,6 +214,10 @@ public:
     virtual void computeDesiredAccelerations(const SimTK::State& s, double aT) = 0;
     virtual void computeDesiredAccelerations(const SimTK::State& s, double aTI,double aTF) = 0;
     virtual void computeAccelerations(const SimTK::State& s ) = 0;
+    /** Compute the accelerations of the task from a State realized to
+    Acceleration without changing the task, so that the accelerations of
+    several States can be computed concurrently. */
+    virtual SimTK::Vec3 calcAccelerations(const SimTK::State& s) const = 0;
     virtual void computeJacobian();
     virtual void computeEffectiveMassMatrix();
 
@@ -917,5 +917,29 @@ computeAccelerations(const SimTK::State& s)
     //printf("CMC_TaskSet.computeAccelerations: %d ",_a.size());
     //printf("track goals are active.\n");
 }
+//_____________________________________________________________________________
+/**
+ * Compute the accelerations of the active track goals into
+ * rAccelerations, in the same order as computeAccelerations(), without
+ * changing the task set or its tasks. States realized to Acceleration
+ * can therefore be evaluated on several threads at once.
+ */
+void CMC_TaskSet::
+calcAccelerations(const SimTK::State& s, Array<double>& rAccelerations) const
+{
+    rAccelerations.setSize(0);
+
+    for(int i=0;i<getSize();i++) {
+
+        const CMC_Task* task = dynamic_cast<const CMC_Task*>(&get(i));
+        if(task==NULL) continue;
+
+        SimTK::Vec3 a = task->calcAccelerations(s);
+        for(int j=0;j<3;j++) {
+            if(!task->getActive(j)) continue;
+            rAccelerations.append(a[j]);
+        }
+    }
+}
 
 
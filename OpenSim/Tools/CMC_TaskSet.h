@@ -153,6 +153,8 @@ public:
     void computeDesiredAccelerations(const SimTK::State& s, double aT);
     void computeDesiredAccelerations(const SimTK::State& s, double aTCurrent,double aTFuture);
     void computeAccelerations(const SimTK::State& s );
+    void calcAccelerations(const SimTK::State& s,
+                           Array<double>& rAccelerations) const;
 
 
 //=============================================================================
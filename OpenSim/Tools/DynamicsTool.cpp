@@ -228,10 +228,9 @@ bool DynamicsTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         return false;
     }
 
-    // This is required so that the references to other files inside ExternalLoads file are interpreted 
-    // as relative paths
-    std::string savedCwd = IO::getCwd();
-    IO::chDir(IO::getParentDirectory(aExternalLoadsFileName));
+    // The files named inside the ExternalLoads file are relative to its
+    // directory; resolve them without changing the working directory.
+    const std::string loadsDirectory = IO::getParentDirectory(aExternalLoadsFileName);
     // Create external forces
     try {
         _externalLoads = ExternalLoads(aModel, aExternalLoadsFileName);
@@ -241,10 +240,12 @@ bool DynamicsTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         // And then we can re-throw the exception
          cout << "Error: failed to construct ExternalLoads from file " << aExternalLoadsFileName
              << ". Please make sure the file exists and that it contains an ExternalLoads object or create a fresh one." << endl;
-        if(getDocument()) IO::chDir(savedCwd);
         throw(ex);
     }
     _externalLoads.setMemoryOwner(false);
+    string dataFileName = _externalLoads.getDataFileName();
+    IO::TrimWhitespace(dataFileName);
+    _externalLoads.setDataFileName(IO::resolvePath(dataFileName, loadsDirectory));
     _externalLoads.invokeConnectToModel(aModel);
 
     string loadKinematicsFileName = _externalLoads.getExternalLoadsModelKinematicsFileName();
@@ -260,9 +261,8 @@ bool DynamicsTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
         Storage *temp = NULL;
         // fine if there are no kinematics as long as it was not assigned
         if(!(loadKinematicsFileName == "") && !(loadKinematicsFileName == "Unassigned")){
-            temp = new Storage(loadKinematicsFileName);
+            temp = new Storage(IO::resolvePath(loadKinematicsFileName, loadsDirectory));
             if(!temp){
-                IO::chDir(savedCwd);
                 throw Exception("DynamicsTool: could not find external loads kinematics file '"+loadKinematicsFileName+"'."); 
             }
         }
@@ -301,6 +301,5 @@ bool DynamicsTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
     if(!loadKinematics)
         delete loadKinematics;
 
-    IO::chDir(savedCwd);
     return(true);
 }
@@ -27,6 +27,7 @@
 #include "ForwardTool.h"
 #include <OpenSim/Common/IO.h>
 
+#include <OpenSim/Simulation/Manager/SimulationCheckpoint.h>
 #include <OpenSim/Simulation/Control/Controller.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
 #include <OpenSim/Simulation/Control/ControlSetController.h>
@@ -242,8 +243,8 @@ bool ForwardTool::run()
         throw(Exception(msg,__FILE__,__LINE__));
     }
 
-    // SET OUTPUT PRECISION
-    IO::SetPrecision(_outputPrecision);
+    // SET OUTPUT PRECISION for the results written while the tool runs
+    IO::ThreadPrecision outputPrecision(_outputPrecision);
 
     // Do the maneuver to change then restore working directory 
     // so that the parsing code behaves properly if called from a different directory.
@@ -290,6 +291,13 @@ bool ForwardTool::run()
     manager.setInitialTime(_ti);
     manager.setFinalTime(_tf);
 
+    // CHECKPOINTS
+    if(_checkpointInterval > 0.0) {
+        IO::makeDir(getResultsDir());
+        manager.setCheckpointInterval(_checkpointInterval);
+        manager.setCheckpointFileName(getCheckpointFilePath());
+    }
+
     // get values for state variables in rawData then assign by name to model
     int numStateVariables = _model->getNumStateVariables();
     Array<double> rawData = Array<double>(0.0, numStateVariables);
@@ -309,14 +317,29 @@ bool ForwardTool::run()
     }
 
 
+    // Write the states to a file as they are computed. The rows are
+    // formatted and written on a background thread; printResults() moves
+    // the file to its final name.
+    if(_printResultFiles) {
+        IO::makeDir(getResultsDir());
+        manager.getStateStorage().setOutputFileName(getResultsDir() + "/" + getName() + "_states_streaming.sto");
+        manager.getStateStorage().setAsynchronousOutput(true);
+    }
+
     bool completed = true;
 
     try {
         // INTEGRATE
         _model->printDetailedInfo(s, std::cout );
 
-        cout<<"\n\nIntegrating from "<<_ti<<" to "<<_tf<<endl;
-        manager.integrate(s);
+        if(_resumeFromCheckpoint) {
+            SimulationCheckpoint checkpoint(getCheckpointFilePath());
+            cout<<"\n\nResuming from "<<checkpoint.getTime()<<" to "<<_tf<<endl;
+            manager.resume(s, checkpoint);
+        } else {
+            cout<<"\n\nIntegrating from "<<_ti<<" to "<<_tf<<endl;
+            manager.integrate(s);
+        }
     } catch(const std::exception& x) {
         cout << "ForwardTool::run() caught exception \n";
         cout << x.what() << endl;
@@ -353,7 +376,7 @@ void ForwardTool::printResults()
     AbstractTool::printResults(getName(),getResultsDir()); // this will create results directory if necessary
     if(_model) {
         _model->printControlStorage(getResultsDir() + "/" + getName() + "_controls.sto");
-        getManager().getStateStorage().print(getResultsDir() + "/" + getName() + "_states.sto");
+        Storage::printResult(&getManager().getStateStorage(), getName() + "_states", getResultsDir(), -1, ".sto");
 
         Storage statesDegrees(getManager().getStateStorage());
         _model->getSimbodyEngine().convertRadiansToDegrees(statesDegrees);
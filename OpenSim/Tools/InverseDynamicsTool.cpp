@@ -38,7 +38,9 @@
 #include <OpenSim/Common/FunctionSet.h> 
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/ResultCache.h>
 #include "AnalyzeTool.h"
+#include <memory>
 
 using namespace OpenSim;
 using namespace std;
@@ -242,6 +244,7 @@ bool InverseDynamicsTool::run()
 {
     bool success = false;
     bool modelFromFile=true;
+    _numResultCacheHits = 0;
     try{
         //Load and create the indicated model
         if (!_model) 
@@ -333,9 +336,80 @@ bool InverseDynamicsTool::run()
         // Preallocate results
         Array_<Vector> genForceTraj(nt, Vector(nq, 0.0));
 
+        // Reuse the generalized forces of frames solved before with the same
+        // model, coordinates and external loads. Analyses added to the model
+        // are stepped by the solver, so then every frame is solved.
+        std::unique_ptr<ResultCache> cache;
+        if(_resultCache.getUse() && _model->getAnalysisSet().getSize() == 0){
+            ResultCache::Hash key;
+            key.add("InverseDynamicsTool").add(*_model);
+            for(int i=0; i<_excludedForces.getSize(); ++i)
+                key.add(_excludedForces[i]);
+            const Array<string>& coordinateLabels = _coordinateValues->getColumnLabels();
+            for(int i=0; i<coordinateLabels.getSize(); ++i)
+                key.add(coordinateLabels[i]);
+            for(int i=0; i<_coordinateValues->getSize(); ++i){
+                const StateVector& row = *_coordinateValues->getStateVector(i);
+                key.add(row.getTime());
+                for(int j=0; j<row.getSize(); ++j)
+                    key.add(row.getData()[j]);
+            }
+            if(externalLoads){
+                // The data file has been resolved by createExternalLoads(); the
+                // kinematics file is named relative to the external loads file.
+                key.add(_externalLoads);
+                key.addFile(_externalLoads.getDataFileName());
+                string loadKinematicsFileName = _externalLoads.getExternalLoadsModelKinematicsFileName();
+                IO::TrimWhitespace(loadKinematicsFileName);
+                if(loadKinematicsFileName != "" && loadKinematicsFileName != "Unassigned")
+                    key.addFile(IO::resolvePath(loadKinematicsFileName,
+                        IO::getParentDirectory(_externalLoadsFileName)));
+            }
+            cache.reset(new ResultCache(getResultCachePath(), key,
+                                        _resultCache.getSizeLimit()));
+        }
+
+        // Frames whose generalized forces are not in the cache.
+        Array_<double> solveTimes;
+        Array_<int> solveFrames;
+        std::vector<double> cached;
+        for(int i=0; i<nt; i++){
+            if(cache && cache->find(ResultCache::Hash().add(times[i]), cached)
+                    && (int)cached.size() == nq){
+                for(int j=0; j<nq; ++j)
+                    genForceTraj[i][j] = cached[j];
+            }
+            else{
+                solveTimes.push_back(times[i]);
+                solveFrames.push_back(i);
+            }
+        }
+
         // solve for the trajectory of generalized forces that correspond to the 
         // coordinate trajectories provided
-        ivdSolver.solve(s, *coordFunctions, times, genForceTraj);
+        if(int(solveFrames.size()) == nt)
+            ivdSolver.solve(s, *coordFunctions, times, genForceTraj);
+        else if(!solveFrames.empty()){
+            Array_<Vector> solvedForces(solveTimes.size(), Vector(nq, 0.0));
+            ivdSolver.solve(s, *coordFunctions, solveTimes, solvedForces);
+            for(unsigned k=0; k<solveFrames.size(); ++k)
+                genForceTraj[solveFrames[k]] = solvedForces[k];
+        }
+
+        if(cache){
+            for(unsigned k=0; k<solveFrames.size(); ++k){
+                const Vector& forces = genForceTraj[solveFrames[k]];
+                std::vector<double> values(nq);
+                for(int j=0; j<nq; ++j)
+                    values[j] = forces[j];
+                cache->insert(ResultCache::Hash().add(times[solveFrames[k]]), values);
+            }
+            cache->save();
+            _numResultCacheHits = cache->getNumHits();
+            cout << "InverseDynamicsTool: reused the results of "
+                 << nt - int(solveFrames.size()) << " of " << nt
+                 << " time frames from " << cache->getFileName() << "." << endl;
+        }
 
 
         success = true;
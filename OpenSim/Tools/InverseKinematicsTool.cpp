@@ -33,10 +33,13 @@
 #include <OpenSim/Simulation/InverseKinematicsSolver.h>
 
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Logger.h>
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Common/FunctionSet.h>
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/ResultCache.h>
+#include <memory>
 #include <OpenSim/Common/XMLDocument.h>
 
 #include <OpenSim/Analyses/Kinematics.h>
@@ -259,6 +262,7 @@ bool InverseKinematicsTool::run()
 {
     bool success = false;
     bool modelFromFile=true;
+    _numResultCacheHits = 0;
     try{
         //Load and create the indicated model
         if (!_model) 
@@ -357,10 +361,24 @@ bool InverseKinematicsTool::run()
         // create the solver given the input data
         InverseKinematicsSolver ikSolver(*_model, markersReference, coordinateReferences, _constraintWeight);
         ikSolver.setAccuracy(_accuracy);
+        // Start each frame from the constant-velocity extrapolation of the
+        // previous two frames.
+        ikSolver.setPredictorOrder(1);
         s.updTime() = start_time;
         ikSolver.assemble(s);
         kinematicsReporter.begin(s);
 
+        // Write the motion to a file as it is computed. The rows are
+        // formatted and written on a background thread, and the file is
+        // moved to the output motion file name once every frame is tracked.
+        const bool writeMotion =
+            _outputMotionFileName!= "" && _outputMotionFileName!="Unassigned";
+        if (writeMotion){
+            kinematicsReporter.getPositionStorage()->setOutputFileName(
+                _outputMotionFileName + ".streaming");
+            kinematicsReporter.getPositionStorage()->setAsynchronousOutput(true);
+        }
+
         const clock_t start = clock();
         double dt = 1.0/markersReference.getSamplingFrequency();
         int Nframes = int((final_time-start_time)/dt)+1;
@@ -372,12 +390,59 @@ bool InverseKinematicsTool::run()
         SimTK::Array_<Vec3> markerLocations(nm, Vec3(0));
         
         Storage *modelMarkerLocations = _reportMarkerLocations ? new Storage(Nframes, "ModelMarkerLocations") : NULL;
+        Storage *solverIterations = _reportErrors ? new Storage(Nframes, "SolverIterations") : NULL;
+
+        // Reuse the solutions of frames tracked before with the same model,
+        // tasks, coordinate data and marker positions.
+        std::unique_ptr<ResultCache> cache;
+        if(_resultCache.getUse()){
+            ResultCache::Hash key;
+            key.add("InverseKinematicsTool").add(*_model).add(_ikTaskSet)
+               .add(_accuracy).add(_constraintWeight);
+            if(haveCoordinateFile) key.addFile(_coordinateFileName);
+            cache.reset(new ResultCache(getResultCachePath(), key,
+                                        _resultCache.getSizeLimit()));
+        }
+        SimTK::Array_<Vec3> frameMarkers;
+        std::vector<double> cached;
+        // A cached solution of another size is not of this model's free
+        // coordinates, and the frame is tracked again.
+        const int numFreeQs = ikSolver.getSolution().size();
 
         for (int i = 0; i < Nframes; i++) {
             s.updTime() = start_time + i*dt;
-            ikSolver.track(s);
+            if(cache){
+                ResultCache::Hash frame;
+                frame.add(s.getTime());
+                markersReference.getValues(s, frameMarkers);
+                for(const Vec3& marker : frameMarkers)
+                    frame.add(marker[0]).add(marker[1]).add(marker[2]);
+
+                if(cache->find(frame, cached) && (int)cached.size() == numFreeQs){
+                    SimTK::Vector solution((int)cached.size());
+                    for(int j=0; j<solution.size(); ++j)
+                        solution[j] = cached[j];
+                    ikSolver.trackSolution(s, solution);
+                }
+                else{
+                    ikSolver.track(s);
+                    SimTK::Vector solution = ikSolver.getSolution();
+                    cached.resize(solution.size());
+                    for(int j=0; j<solution.size(); ++j)
+                        cached[j] = solution[j];
+                    cache->insert(frame, cached);
+                }
+            }
+            else
+                ikSolver.track(s);
+
+            if(solverIterations){
+                double numIterations = ikSolver.getNumIterations();
+                solverIterations->append(s.getTime(), 1, &numIterations);
+            }
             
-            if(_reportErrors){
+            // Skip computing the errors if they would not be printed.
+            if(_reportErrors && Logger::shouldLog(Logger::Level::Info)){
                 double totalSquaredMarkerError = 0.0;
                 double maxSquaredMarkerError = 0.0;
                 int worst = -1;
@@ -390,10 +455,11 @@ bool InverseKinematicsTool::run()
                         worst = j;
                     }
                 }
-                cout << "Frame " << i << " (t=" << s.getTime() << "):\t";
-                cout << "total squared error = " << totalSquaredMarkerError;
-                cout << ", marker error: RMS=" << sqrt(totalSquaredMarkerError/nm);
-                cout << ", max=" << sqrt(maxSquaredMarkerError) << " (" << ikSolver.getMarkerNameForIndex(worst) << ")" << endl;
+                OPENSIM_LOG_INFO("Frame " << i << " (t=" << s.getTime() << "):\t"
+                    << "total squared error = " << totalSquaredMarkerError
+                    << ", marker error: RMS=" << sqrt(totalSquaredMarkerError/nm)
+                    << ", max=" << sqrt(maxSquaredMarkerError) << " (" << ikSolver.getMarkerNameForIndex(worst) << ")"
+                    << ", iterations=" << ikSolver.getNumIterations());
             }
 
             if(_reportMarkerLocations){
@@ -414,8 +480,10 @@ bool InverseKinematicsTool::run()
 
         // Do the maneuver to change then restore working directory 
         // so that output files are saved to same folder as setup file.
-        if (_outputMotionFileName!= "" && _outputMotionFileName!="Unassigned"){
-            kinematicsReporter.getPositionStorage()->print(_outputMotionFileName);
+        if (writeMotion){
+            Storage::printResult(kinematicsReporter.getPositionStorage(),
+                IO::GetFileNameFromURI(_outputMotionFileName),
+                IO::getParentDirectory(_outputMotionFileName), -1, "");
         }
 
         if(modelMarkerLocations){
@@ -437,6 +505,26 @@ bool InverseKinematicsTool::run()
             delete modelMarkerLocations;
         }
 
+        if(solverIterations){
+            Array<string> labels("", 2);
+            labels[0] = "time";
+            labels[1] = "num_iterations";
+            solverIterations->setColumnLabels(labels);
+            solverIterations->setName("Inverse Kinematics Solver Iterations");
+
+            IO::makeDir(getResultsDir());
+            Storage::printResult(solverIterations, "ik_solver_iterations", getResultsDir(), -1, ".sto");
+
+            delete solverIterations;
+        }
+
+        if(cache){
+            cache->save();
+            _numResultCacheHits = cache->getNumHits();
+            cout << "InverseKinematicsTool: reused the solutions of " << cache->getNumHits()
+                 << " of " << Nframes << " frames from " << cache->getFileName() << "." << endl;
+        }
+
         IO::chDir(saveWorkingDirectory);
 
         success = true;
@@ -127,6 +127,8 @@ public:
 
     //---- Setters and getters for various attributes
     void setModel(Model& aModel) { _model = &aModel; };
+    const std::string& getModelFileName() const { return _modelFileName; };
+    void setModelFileName(const std::string& aFileName) { _modelFileName = aFileName; };
     void setStartTime(double d) { _timeRange[0] = d; };
     double getStartTime() const {return  _timeRange[0]; };
 
@@ -365,10 +365,10 @@ bool RRATool::run()
     string directoryOfSetupFile = IO::getParentDirectory(getDocumentFileName());
     IO::chDir(directoryOfSetupFile);
 
-    try {
+    // SET OUTPUT PRECISION for the results written while the tool runs
+    IO::ThreadPrecision outputPrecision(_outputPrecision);
 
-    // SET OUTPUT PRECISION
-    IO::SetPrecision(_outputPrecision);
+    try {
 
 
     // CHECK PROPERTIES FOR ERRORS/INCONSISTENCIES
@@ -810,9 +810,12 @@ bool RRATool::run()
 
     cmcActSubsystem.setCompleteState( s );
 
-    // Set output file names so that files are flushed regularly in case we fail
+    // Write the states to their file as they are computed. The rows are
+    // formatted and written on a background thread; if the tool fails, the
+    // catch blocks below complete the file with the states computed so far.
     IO::makeDir(getResultsDir());   // Create directory for output in case it doesn't exist
     manager.getStateStorage().setOutputFileName(getResultsDir() + "/" + getName() + "_states.sto");
+    manager.getStateStorage().setAsynchronousOutput(true);
     try {
         manager.integrate(s);
     }
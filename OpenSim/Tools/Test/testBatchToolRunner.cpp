@@ -0,0 +1,340 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  testBatchToolRunner.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testBatchToolRunner runs many inverse dynamics trials of the arm26 model
+// with a BatchToolRunner on several threads, and checks that each trial gives
+// the same results as running its InverseDynamicsTool on its own. Pairs of
+// inverse kinematics and analyze trials in the same batch must also match
+// their tools run alone. Inverse dynamics trials whose external loads are in
+// another directory, and analyze trials with their own output precision, run
+// alongside the others and must match too. Trials with a missing model or a
+// setup file that is not a tool's must fail without stopping the others.
+//=============================================================================
+#include <OpenSim/Tools/BatchToolRunner.h>
+#include <OpenSim/Tools/InverseDynamicsTool.h>
+#include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+#include <OpenSim/Tools/IKMarkerTask.h>
+#include <OpenSim/Analyses/Kinematics.h>
+#include <OpenSim/Simulation/Model/ExternalLoads.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+const int numTrials = 8;
+const int numPairTrials = 2;
+const int numLoadTrials = 2;
+
+// The shoulder and elbow angles of arm26, in degrees, at time t.
+void armAngles(double t, double q[2])
+{
+    q[0] = 30 + 20*sin(2*SimTK::Pi*t);
+    q[1] = 60 - 40*cos(2*SimTK::Pi*t);
+}
+
+// Write a motion of arm26's shoulder and elbow, in degrees.
+void writeArmMotion(const string& fileName)
+{
+    Storage motion;
+    Array<string> labels;
+    labels.append("time");
+    labels.append("r_shoulder_elev");
+    labels.append("r_elbow_flex");
+    motion.setColumnLabels(labels);
+    motion.setInDegrees(true);
+    for (int i = 0; i <= 100; ++i) {
+        const double t = 0.01*i;
+        double q[2];
+        armAngles(t, q);
+        motion.append(t, 2, q);
+    }
+    motion.print(fileName);
+}
+
+// Write the locations of arm26's markers in ground for the same motion, at
+// the 250 Hz rate at which marker files are read.
+void writeArmMarkers(const string& fileName)
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    const MarkerSet& markers = model.getMarkerSet();
+    const CoordinateSet& coordinates = model.getCoordinateSet();
+
+    Storage locations;
+    Array<string> labels;
+    labels.append("time");
+    for (int m = 0; m < markers.getSize(); ++m) {
+        labels.append(markers[m].getName() + ".x");
+        labels.append(markers[m].getName() + ".y");
+        labels.append(markers[m].getName() + ".z");
+    }
+    locations.setColumnLabels(labels);
+    for (int i = 0; i <= 100; ++i) {
+        const double t = 0.004*i;
+        double q[2];
+        armAngles(t, q);
+        coordinates.get("r_shoulder_elev").setValue(s,
+            SimTK::convertDegreesToRadians(q[0]), false);
+        coordinates.get("r_elbow_flex").setValue(s,
+            SimTK::convertDegreesToRadians(q[1]));
+        model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+        Array<double> row(0.0, 3*markers.getSize());
+        for (int m = 0; m < markers.getSize(); ++m) {
+            const SimTK::Vec3 r =
+                markers[m].findLocationInFrame(s, model.getGround());
+            for (int j = 0; j < 3; ++j)
+                row[3*m + j] = r[j];
+        }
+        locations.append(t, row.getSize(), &row[0]);
+    }
+    locations.print(fileName);
+}
+
+// Write external loads that push up on arm26's hand, in a directory of their
+// own, with the forces in a data file named relative to that directory.
+string writeArmLoads()
+{
+    const string directory = "batch_loads";
+    IO::makeDir(directory);
+    Storage forces;
+    Array<string> labels;
+    labels.append("time");
+    const char* columns[] = { "forceX", "forceY", "forceZ",
+                              "pointX", "pointY", "pointZ" };
+    for (const char* column : columns)
+        labels.append(column);
+    forces.setColumnLabels(labels);
+    for (int i = 0; i <= 100; ++i) {
+        const double row[] = { 0, 10 + 5*sin(2*SimTK::Pi*0.01*i), 0,
+                               0, -0.1, 0 };
+        forces.append(0.01*i, 6, row);
+    }
+    forces.print(directory + "/batch_arm26_forces.sto");
+
+    Model model("arm26.osim");
+    ExternalLoads loads(model);
+    loads.setName("batch_arm26_loads");
+    loads.setDataFileName("batch_arm26_forces.sto");
+    ExternalForce* force = new ExternalForce(forces, "force", "point", "",
+        "r_ulna_radius_hand", "ground", "r_ulna_radius_hand");
+    force->setName("hand_push");
+    loads.adoptAndAppend(force);
+    const string loadsFile = directory + "/batch_arm26_loads.xml";
+    loads.print(loadsFile);
+    return loadsFile;
+}
+
+string writeSetup(const string& name, const string& modelFile,
+                  const string& externalLoadsFile = "")
+{
+    InverseDynamicsTool id;
+    id.setName(name);
+    id.setModelFileName(modelFile);
+    if (externalLoadsFile != "")
+        id.setExternalLoadsFileName(externalLoadsFile);
+    id.setCoordinatesFileName("batch_arm26_motion.mot");
+    id.setLowpassCutoffFrequency(6.0);
+    id.setStartTime(0);
+    id.setEndTime(1);
+    Array<string> excluded;
+    excluded.append("muscles");
+    id.setExcludedForces(excluded);
+    id.setResultsDir("Results");
+    id.setOutputGenForceFileName(name + "_InverseDynamics.sto");
+    id.updResultCacheSettings().setUse(false);
+    const string setupFile = name + "_Setup_InverseDynamics.xml";
+    id.print(setupFile);
+    return setupFile;
+}
+
+string writeIKSetup(const string& name)
+{
+    InverseKinematicsTool ik;
+    ik.setName(name);
+    ik.setModelFileName("arm26.osim");
+    ik.setMarkerDataFileName("batch_arm26_markers.sto");
+    ik.setStartTime(0);
+    ik.setEndTime(0.4);
+    const char* markers[] =
+        { "r_acromion", "r_humerus_epicondyle", "r_radius_styloid" };
+    for (int m = 0; m < 3; ++m) {
+        IKMarkerTask* task = new IKMarkerTask();
+        task->setName(markers[m]);
+        task->setApply(true);
+        task->setWeight(1.0);
+        ik.getIKTaskSet().adoptAndAppend(task);
+    }
+    // Each trial writes its solver iterations to its own directory.
+    ik.setResultsDir("Results_" + name);
+    ik.setOutputMotionFileName(name + "_ik.mot");
+    ik.updResultCacheSettings().setUse(false);
+    const string setupFile = name + "_Setup_IK.xml";
+    ik.print(setupFile);
+    return setupFile;
+}
+
+string writeAnalyzeSetup(const string& name, int outputPrecision = 8)
+{
+    AnalyzeTool analyze;
+    analyze.setName(name);
+    analyze.setOutputPrecision(outputPrecision);
+    analyze.setModelFilename("arm26.osim");
+    analyze.setCoordinatesFileName("batch_arm26_motion.mot");
+    analyze.setLowpassCutoffFrequency(6.0);
+    analyze.setInitialTime(0);
+    analyze.setFinalTime(1);
+    analyze.getAnalysisSet().adoptAndAppend(new Kinematics());
+    analyze.setResultsDir("Results");
+    analyze.updResultCacheSettings().setUse(false);
+    const string setupFile = name + "_Setup_Analyze.xml";
+    analyze.print(setupFile);
+    return setupFile;
+}
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        writeArmMotion("batch_arm26_motion.mot");
+        writeArmMarkers("batch_arm26_markers.sto");
+        const string loadsFile = writeArmLoads();
+
+        BatchToolRunner runner(4);
+        for (int k = 0; k < numTrials; ++k)
+            runner.addSetupFile(writeSetup("batch_arm26_" + to_string(k),
+                                           "arm26.osim"));
+        runner.addSetupFile(writeSetup("batch_missing", "missing.osim"));
+        runner.addSetupFile("arm26.osim");
+        for (int k = 0; k < numPairTrials; ++k) {
+            runner.addSetupFile(writeIKSetup("batch_ik_" + to_string(k)));
+            runner.addSetupFile(
+                writeAnalyzeSetup("batch_analyze_" + to_string(k)));
+        }
+        for (int k = 0; k < numLoadTrials; ++k)
+            runner.addSetupFile(writeSetup("batch_loads_" + to_string(k),
+                                           "arm26.osim", loadsFile));
+        runner.addSetupFile(writeAnalyzeSetup("batch_analyze_precise", 4));
+        runner.run();
+        runner.printReport(cout);
+
+        const vector<BatchToolRunner::TrialResult>& results =
+            runner.getResults();
+        ASSERT(results.size() ==
+               numTrials + 2 + 2*numPairTrials + numLoadTrials + 1);
+        ASSERT(runner.getNumFailures() == 2);
+        for (int k = 0; k < numTrials; ++k) {
+            ASSERT(results[k].succeeded);
+            ASSERT(results[k].toolType == "InverseDynamicsTool");
+        }
+        ASSERT(!results[numTrials].succeeded);
+        ASSERT(!results[numTrials].error.empty());
+        ASSERT(!results[numTrials + 1].succeeded);
+        ASSERT(results[numTrials + 1].toolType == "Model");
+        for (int k = 0; k < numPairTrials; ++k) {
+            const int ik = numTrials + 2 + 2*k;
+            ASSERT(results[ik].succeeded);
+            ASSERT(results[ik].toolType == "InverseKinematicsTool");
+            ASSERT(results[ik + 1].succeeded);
+            ASSERT(results[ik + 1].toolType == "AnalyzeTool");
+        }
+
+        // Each trial matches the same trial run by its tool alone.
+        InverseDynamicsTool alone(writeSetup("batch_alone", "arm26.osim"));
+        ASSERT(alone.run());
+        Storage standard("Results/batch_alone_InverseDynamics.sto");
+        for (int k = 0; k < numTrials; ++k) {
+            Storage result("Results/batch_arm26_" + to_string(k) +
+                           "_InverseDynamics.sto");
+            CHECK_STORAGE_AGAINST_STANDARD(result, standard,
+                Array<double>(1e-8, 3), __FILE__, __LINE__,
+                "Batch trial differs from running its tool alone.");
+        }
+
+        // So do the inverse kinematics and analyze trials, which ran
+        // alongside the others.
+        InverseKinematicsTool ikAlone(writeIKSetup("batch_ik_alone"));
+        ASSERT(ikAlone.run());
+        Storage ikStandard("batch_ik_alone_ik.mot");
+        AnalyzeTool analyzeAlone(writeAnalyzeSetup("batch_analyze_alone"));
+        ASSERT(analyzeAlone.run());
+        Storage analyzeStandard(
+            "Results/batch_analyze_alone_Kinematics_q.sto");
+        for (int k = 0; k < numPairTrials; ++k) {
+            Storage ik("batch_ik_" + to_string(k) + "_ik.mot");
+            CHECK_STORAGE_AGAINST_STANDARD(ik, ikStandard,
+                Array<double>(1e-8, 3), __FILE__, __LINE__,
+                "Batch IK trial differs from running its tool alone.");
+            Storage analyze("Results/batch_analyze_" + to_string(k) +
+                            "_Kinematics_q.sto");
+            CHECK_STORAGE_AGAINST_STANDARD(analyze, analyzeStandard,
+                Array<double>(1e-8, 3), __FILE__, __LINE__,
+                "Batch analyze trial differs from running its tool alone.");
+        }
+
+        // The external loads are read from their own directory while other
+        // trials run, and change the generalized forces.
+        InverseDynamicsTool loadsAlone(
+            writeSetup("batch_loads_alone", "arm26.osim", loadsFile));
+        ASSERT(loadsAlone.run());
+        Storage loadsStandard("Results/batch_loads_alone_InverseDynamics.sto");
+        for (int k = 0; k < numLoadTrials; ++k) {
+            Storage result("Results/batch_loads_" + to_string(k) +
+                           "_InverseDynamics.sto");
+            CHECK_STORAGE_AGAINST_STANDARD(result, loadsStandard,
+                Array<double>(1e-8, 3), __FILE__, __LINE__,
+                "Batch trial with external loads differs from running its "
+                "tool alone.");
+        }
+        Array<double> withLoads, withoutLoads;
+        loadsStandard.getDataColumn("r_elbow_flex_moment", withLoads);
+        standard.getDataColumn("r_elbow_flex_moment", withoutLoads);
+        ASSERT(withLoads.getSize() == withoutLoads.getSize());
+        double maxDifference = 0;
+        for (int i = 0; i < withLoads.getSize(); ++i)
+            maxDifference = std::max(maxDifference,
+                                     std::abs(withLoads[i] - withoutLoads[i]));
+        ASSERT(maxDifference > 0.1);
+
+        // The analyze trial with its own precision wrote its results with
+        // 4 decimal places while the others wrote theirs with 8.
+        Storage precise("Results/batch_analyze_precise_Kinematics_q.sto");
+        CHECK_STORAGE_AGAINST_STANDARD(precise, analyzeStandard,
+            Array<double>(1e-4, 3), __FILE__, __LINE__,
+            "Batch analyze trial with its own precision differs.");
+        for (int i = 0; i < precise.getSize(); ++i) {
+            const StateVector& row = *precise.getStateVector(i);
+            for (int j = 0; j < row.getSize(); ++j) {
+                const double scaled = 1e4*row.getData()[j];
+                ASSERT_EQUAL(std::round(scaled), scaled, 1e-6);
+            }
+        }
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
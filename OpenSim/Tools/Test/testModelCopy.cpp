@@ -30,6 +30,7 @@ using namespace OpenSim;
 using namespace std;
 
 void testCopyModel(string fileName);
+void testCloneFootprint(string fileName, int numClones);
 
 int main()
 {
@@ -37,6 +38,7 @@ int main()
         LoadOpenSimLibrary("osimActuators");
         testCopyModel("arm26.osim");
         testCopyModel("Neck3dof_point_constraint.osim");
+        testCloneFootprint("gait2354_simbody.osim", 8);
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -95,3 +97,34 @@ void testCopyModel(string fileName)
     cout << "Memory change AFTER copy and init and delete:  " 
          << double(delta)/mem1*100 << "%." << endl;
 }
+
+// Report the memory and time each additional, initialized copy of a model
+// costs, as a pool of workers that each simulate their own copy would incur.
+void testCloneFootprint(string fileName, int numClones)
+{
+    Model model(fileName);
+    SimTK::State& state = model.initSystem();
+    const SimTK::Vector y = state.getY();
+
+    size_t mem1 = getCurrentRSS();
+    double t1 = SimTK::realTime();
+
+    std::vector<Model*> clones;
+    for (int i = 0; i < numClones; ++i) {
+        clones.push_back(model.fork());
+        SimTK::State& cloneState = clones.back()->initSystem();
+        ASSERT(cloneState.getNY() == y.size());
+        ASSERT((cloneState.getY() - y).norm() < SimTK::SignificantReal);
+    }
+
+    double t2 = SimTK::realTime();
+    size_t mem2 = getCurrentRSS();
+
+    cout << fileName << ": " << numClones << " initialized clones took "
+         << (t2 - t1)/numClones*1000 << " ms and "
+         << double(int64_t(mem2) - int64_t(mem1))/numClones/1024
+         << " KB each." << endl;
+
+    for (Model* clone : clones)
+        delete clone;
+}
@@ -29,6 +29,7 @@
 #include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/PropertyObj.h>
 #include <OpenSim/Common/ArrayPtrs.h>
+#include <OpenSim/Common/ResultCache.h>
 
 
 namespace OpenSim { 
@@ -65,6 +66,11 @@ protected:
     PropertyStr _resultsDirProp;
     std::string &_resultsDir;
     
+    /** Whether and where to keep results between runs. */
+    ResultCacheSettings _resultCache;
+    /** Number of results the last run reused from the result cache. */
+    int _numResultCacheHits;
+
     /** How much details to put out while running. */
     VerboseLevel _verboseLevel;
     
@@ -122,6 +128,7 @@ private:
         setupProperties();
         _resultsDir = "./"; 
         _inputsDir = "";
+        _numResultCacheHits = 0;
         _verboseLevel = Progress;
     };
     
@@ -140,6 +147,8 @@ private:
         _inputsDirProp.setComment(comment);
         _inputsDirProp.setName("input_directory");
         _propertySet.append( &_inputsDirProp );
+
+        _resultCache.appendTo(_propertySet);
     };
     
 
@@ -160,6 +169,7 @@ public:
             Super::operator=(source);   
             _resultsDir   = source._resultsDir; 
             _inputsDir    = source._inputsDir;
+            _resultCache = source._resultCache;
             _verboseLevel = source._verboseLevel;
         }
         return *this;
@@ -195,6 +205,18 @@ public:
     const std::string& getResultsDir() const { return _resultsDir; }
     void setResultsDir(const std::string& aString) { _resultsDir = aString; }
 
+    /**
+    * Get/set whether results are kept between runs, where they are kept and
+    * the size to which they are limited.
+    */
+    const ResultCacheSettings& getResultCacheSettings() const { return _resultCache; }
+    ResultCacheSettings& updResultCacheSettings() { return _resultCache; }
+    /** The directory in which results are kept between runs. */
+    std::string getResultCachePath() const { return _resultCache.getPath(_resultsDir); }
+    /** Number of results (e.g., time frames) the last run reused from the
+    result cache. */
+    int getNumResultCacheHits() const { return _numResultCacheHits; }
+
     /**
      * Get/Set verbose level
      */
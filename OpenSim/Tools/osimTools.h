@@ -29,6 +29,7 @@
 #include "AnalyzeTool.h"
 
 #include "InverseKinematicsTool.h"
+#include "BatchToolRunner.h"
 #include "GenericModelMaker.h"
 #include "TrackingTask.h"
 #include "MuscleStateTrackingTask.h"
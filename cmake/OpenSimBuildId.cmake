@@ -0,0 +1,48 @@
+# Write to OUTPUT_FILE a header that defines OSIM_BUILD_ID, which identifies
+# the sources in SOURCE_DIR being built: the git commit and, if there are
+# uncommitted changes, a hash of them. Results cached by one build (see
+# OpenSim/Common/ResultCache.h) are not reused by a build of other sources.
+#
+# Run in script mode on every build:
+#   cmake -DSOURCE_DIR=<dir> -DOUTPUT_FILE=<file> [-DGIT_EXECUTABLE=<git>]
+#         -P OpenSimBuildId.cmake
+# The file is only rewritten when the identity changes, so that unchanged
+# sources are not recompiled.
+
+if(NOT GIT_EXECUTABLE)
+    find_program(GIT_EXECUTABLE git)
+endif()
+
+set(BUILD_ID "")
+if(GIT_EXECUTABLE)
+    execute_process(COMMAND "${GIT_EXECUTABLE}" rev-parse HEAD
+        WORKING_DIRECTORY "${SOURCE_DIR}"
+        RESULT_VARIABLE GIT_RESULT
+        OUTPUT_VARIABLE GIT_COMMIT
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        ERROR_QUIET)
+    if(GIT_RESULT EQUAL 0)
+        set(BUILD_ID "${GIT_COMMIT}")
+        execute_process(COMMAND "${GIT_EXECUTABLE}" diff HEAD
+            WORKING_DIRECTORY "${SOURCE_DIR}"
+            OUTPUT_VARIABLE GIT_CHANGES
+            ERROR_QUIET)
+        if(NOT "${GIT_CHANGES}" STREQUAL "")
+            string(SHA1 CHANGES_HASH "${GIT_CHANGES}")
+            set(BUILD_ID "${BUILD_ID}+${CHANGES_HASH}")
+        endif()
+    endif()
+endif()
+if("${BUILD_ID}" STREQUAL "")
+    # Without the history of the sources, every build is another build.
+    string(TIMESTAMP BUILD_ID "%Y%m%d%H%M%S")
+endif()
+
+set(CONTENTS "#define OSIM_BUILD_ID \"${BUILD_ID}\"\n")
+set(OLD_CONTENTS "")
+if(EXISTS "${OUTPUT_FILE}")
+    file(READ "${OUTPUT_FILE}" OLD_CONTENTS)
+endif()
+if(NOT "${CONTENTS}" STREQUAL "${OLD_CONTENTS}")
+    file(WRITE "${OUTPUT_FILE}" "${CONTENTS}")
+endif()